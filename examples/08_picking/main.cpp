@@ -4,12 +4,13 @@
  * into a point in space. The mesh point that minimizes the distance
  * from it is then selected and colored in RED for visual feedback.
  *
- * Notice that despite this implementation of picking is sub-optimal
- * (its complexity is O(n), with n being the number of mesh vertices)
- * it is fast enough to work in real time with meshes of moderate size.
+ * Vertices can also be selected in groups, drawing a lasso on the
+ * canvas. Each vertex is projected on the screen, and selected if
+ * it falls inside the lasso.
  *
- * For huge meshes, better performances can be achieved by using a spatial
- * data structure, such as Octrees or AABB trees.
+ * Both queries are answered by a spatial index (a kd-tree) that the mesh
+ * builds at the first query, hence their cost is logarithmic in the number
+ * of mesh vertices, and picking runs in real time on huge meshes too.
  *
  * Enjoy!
 */
@@ -37,8 +38,10 @@ int main(int argc, char **argv)
     gui.show();
     gui.push_obj(&m);
     gui.push_marker(vec2i(10, gui.height()-20), "CMD + click to select a vertex", Color::BLACK(), 12, 0);
+    gui.push_marker(vec2i(10, gui.height()-40), "SHIFT + drag to select vertices with a lasso", Color::BLACK(), 12, 0);
 
     Profiler profiler;
+    std::vector<vec2d> lasso;
 
     gui.callback_mouse_press = [&](GLcanvas *c, QMouseEvent *e)
     {
@@ -56,6 +59,36 @@ int main(int argc, char **argv)
                 c->updateGL();
             }
         }
+        else if (e->modifiers() == Qt::ShiftModifier)
+        {
+            lasso = { vec2d(e->x(), e->y()) };
+            c->skip_default_mouse_move_handler = true; // do not rotate the scene while drawing
+        }
+    };
+
+    gui.callback_mouse_move = [&](GLcanvas *, QMouseEvent *e)
+    {
+        if (!lasso.empty()) lasso.push_back(vec2d(e->x(), e->y()));
+    };
+
+    gui.callback_mouse_release = [&](GLcanvas *c, QMouseEvent *)
+    {
+        if (lasso.empty()) return;
+        auto project = [c](const vec3d & p)
+        {
+            vec2i p2d;
+            GLdouble depth;
+            c->project(p, p2d, depth);
+            return vec2d(p2d.x(), p2d.y());
+        };
+        profiler.push("Lasso Selection");
+        std::vector<uint> vids = m.pick_verts(lasso, project);
+        profiler.pop();
+        for(uint vid : vids) m.vert_data(vid).color = Color::RED();
+        lasso.clear();
+        c->skip_default_mouse_move_handler = false;
+        m.updateGL();
+        c->updateGL();
     };
 
     // CMD+1 to show mesh controls.
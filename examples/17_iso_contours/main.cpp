@@ -1,6 +1,7 @@
 /* This sample program computes on-the-fly iso-contours
  * of a scalar field embedded in the vertices of a surface
- * mesh.
+ * mesh. Checking "Contour plot" extracts many levels at
+ * once, in a single pass over the mesh.
  *
  * Enjoy!
 */
@@ -8,11 +9,13 @@
 #include <QApplication>
 #include <QSlider>
 #include <QPushButton>
+#include <QCheckBox>
 #include <QGridLayout>
 #include <cinolib/meshes/meshes.h>
 #include <cinolib/geodesics.h>
 #include <cinolib/profiler.h>
 #include <cinolib/drawable_isocontour.h>
+#include <cinolib/drawable_isocontours.h>
 #include <cinolib/gui/qt/qt_gui_tools.h>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -26,12 +29,14 @@ int main(int argc, char **argv)
     QWidget     window;
     QSlider     sl_iso(Qt::Horizontal);
     QPushButton but_tessellate("Tessellate");
+    QCheckBox   cb_plot("Contour plot");
     QGridLayout layout;
     GLcanvas    gui(&window);
     sl_iso.setMaximum(100);
     sl_iso.setMinimum(0);
     sl_iso.setValue(50);
-    layout.addWidget(&sl_iso,0,0,1,9);
+    layout.addWidget(&sl_iso,0,0,1,8);
+    layout.addWidget(&cb_plot,0,8,1,1);
     layout.addWidget(&but_tessellate,0,9,1,1);
     layout.addWidget(&gui,2,0,1,10);
     window.setLayout(&layout);
@@ -50,6 +55,9 @@ int main(int argc, char **argv)
     iso.thickness = 3.0;
     gui.push_obj(&iso, false);
 
+    DrawableIsocontours<> plot;
+    gui.push_obj(&plot, false);
+
     Profiler profiler;
 
     QSlider::connect(&sl_iso, &QSlider::valueChanged, [&]()
@@ -63,12 +71,31 @@ int main(int argc, char **argv)
     QSlider::connect(&but_tessellate, &QPushButton::clicked, [&]()
     {
         profiler.push("tessellate iso-contour");
-        iso.tessellate(m);
+        if(cb_plot.isChecked()) plot.tessellate(m);
+        else                    iso.tessellate(m);
         profiler.pop();
+        // the mesh has changed: contours extracted from the old one are no longer valid
+        iso = DrawableIsocontour<>(m, static_cast<float>(sl_iso.value())/100.0);
+        if(cb_plot.isChecked())
+        {
+            plot = DrawableIsocontours<>(m, 50u);
+            plot.thickness = 2.0;
+            plot.updateGL();
+        }
         m.updateGL();
         gui.updateGL();
     });
 
+    QCheckBox::connect(&cb_plot, &QCheckBox::stateChanged, [&]()
+    {
+        profiler.push("update contour plot");
+        plot = (cb_plot.isChecked()) ? DrawableIsocontours<>(m, 50u) : DrawableIsocontours<>();
+        plot.thickness = 2.0;
+        plot.updateGL();
+        profiler.pop();
+        gui.updateGL();
+    });
+
     // CMD+1 to show mesh controls.
     SurfaceMeshControlPanel<DrawableTrimesh<>> panel(&m, &gui);
     QApplication::connect(new QShortcut(QKeySequence(Qt::CTRL+Qt::Key_1), &gui), &QShortcut::activated, [&](){panel.show();});
@@ -74,9 +74,10 @@ int main(int argc, char **argv)
                         val -= (brush_size-dist)/brush_size;
                         if(val<0) val = 0.f;
                         m.vert_data(vid).color = Color(1,val,val);
+                        m.vert_set_dirty(vid, UPDATE_GL_COLORS);
                     }
                 }
-                m.updateGL();
+                m.updateGL_dirty(); // refresh only the colors of the painted area
                 c->updateGL();
             }
         }
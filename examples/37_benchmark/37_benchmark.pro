@@ -0,0 +1,14 @@
+TEMPLATE        = app
+TARGET          = $$PWD/../37_benchmark_demo
+CONFIG         += c++11 release console
+CONFIG         -= app_bundle qt
+INCLUDEPATH    += $$PWD/../../external/eigen
+INCLUDEPATH    += $$PWD/../../include
+DATA_PATH       = \\\"$$PWD/../data/\\\"
+DEFINES        += DATA_PATH=$$DATA_PATH
+SOURCES        += main.cpp
+
+# just for Linux
+unix:!macx {
+LIBS    += -pthread
+}
@@ -0,0 +1,448 @@
+/* This sample program is a headless benchmark that times the hot paths
+ * of the library (mesh loading and initialization, adjacency queries,
+ * octree construction and queries, self intersections, Laplacian assembly
+ * and linear solves, geodesics, iso-surfacing, remeshing and IO) on the
+ * models in the data folder, and on procedurally scaled variants of them.
+ * The effect of element ordering (see mesh_reordering.h) is measured by
+ * timing Laplacian and octree operations on shuffled and reordered copies.
+ *
+ * Each benchmark is executed multiple times, and min/median/max wall
+ * clock times (in milliseconds) are emitted in JSON format, so that
+ * results can be archived and compared across commits and machines.
+ *
+ * Usage: ./37_benchmark_demo [output.json] [num_runs] [scale]
+ *
+ * where scale (default 1) controls the size of the synthetic meshes.
+ * If no output file is given, results are printed to the standard output
+ * (mixed with the log messages of the library, which also go there).
+ * Progress is reported on the standard error.
+ *
+ * Enjoy!
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/octree.h>
+#include <cinolib/find_intersections.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/linear_solvers.h>
+#include <cinolib/geodesics.h>
+#include <cinolib/marching_tets.h>
+#include <cinolib/remesh_BotschKobbelt2004.h>
+#include <cinolib/grid_mesh.h>
+#include <cinolib/subdivision_midpoint.h>
+#include <cinolib/tetrahedralization.h>
+#include <cinolib/random_generator.h>
+#include <cinolib/mesh_reordering.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct BenchmarkResult
+{
+    std::string         name;
+    std::string         dataset;
+    uint                size; // number of elements of the input
+    std::vector<double> times_ms;
+};
+
+std::vector<BenchmarkResult> results;
+uint                         n_runs = 5;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// runs setup() and then work() n_runs times, timing work() only
+void benchmark(const std::string           & name,
+               const std::string           & dataset,
+               const uint                    size,
+               const std::function<void()> & setup,
+               const std::function<void()> & work)
+{
+    BenchmarkResult res;
+    res.name    = name;
+    res.dataset = dataset;
+    res.size    = size;
+    for(uint i=0; i<n_runs; ++i)
+    {
+        setup();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        work();
+        auto t1 = std::chrono::high_resolution_clock::now();
+        res.times_ms.push_back(std::chrono::duration<double,std::milli>(t1-t0).count());
+    }
+    std::sort(res.times_ms.begin(), res.times_ms.end());
+    std::cerr << "  " << std::left << std::setw(28) << name << std::setw(24) << dataset
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+              << res.times_ms.front() << " ms" << std::endl;
+    results.push_back(res);
+}
+
+void benchmark(const std::string           & name,
+               const std::string           & dataset,
+               const uint                    size,
+               const std::function<void()> & work)
+{
+    benchmark(name, dataset, size, [](){}, work);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+std::string to_json()
+{
+    std::stringstream ss;
+    ss << std::setprecision(6) << std::fixed;
+    ss << "{\n";
+    ss << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    ss << "  \"runs\": " << n_runs << ",\n";
+    ss << "  \"benchmarks\": [\n";
+    for(uint i=0; i<results.size(); ++i)
+    {
+        const BenchmarkResult & r = results.at(i);
+        ss << "    { \"name\": \""    << r.name    << "\""
+           <<    ", \"dataset\": \""  << r.dataset << "\""
+           <<    ", \"size\": "       << r.size
+           <<    ", \"min_ms\": "     << r.times_ms.front()
+           <<    ", \"median_ms\": "  << r.times_ms.at(r.times_ms.size()/2)
+           <<    ", \"max_ms\": "     << r.times_ms.back()
+           <<    ", \"times_ms\": [";
+        for(uint j=0; j<r.times_ms.size(); ++j) ss << (j>0 ? ", " : "") << r.times_ms.at(j);
+        ss << "] }" << ((i+1<results.size()) ? ",\n" : "\n");
+    }
+    ss << "  ]\n}\n";
+    return ss.str();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// a bumpy triangulated grid with 2*n*n triangles
+void synthetic_trimesh(const uint n, Trimesh<> & m)
+{
+    Quadmesh<> grid;
+    grid_mesh(n, n, grid);
+    std::vector<vec3d> verts = grid.vector_verts();
+    for(vec3d & p : verts)
+    {
+        p /= static_cast<double>(n);
+        p.z() = 0.1 * sin(8*M_PI*p.x()) * cos(8*M_PI*p.y());
+    }
+    std::vector<uint> tris;
+    for(uint pid=0; pid<grid.num_polys(); ++pid)
+    {
+        const std::vector<uint> & t = grid.poly_tessellation(pid);
+        tris.insert(tris.end(), t.begin(), t.end());
+    }
+    m = Trimesh<>(verts, tris);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark_adjacency(Mesh & m, const std::string & dataset)
+{
+    benchmark("adjacency_queries", dataset, m.num_polys(), [&]()
+    {
+        volatile uint acc = 0;
+        for(uint vid=0; vid<m.num_verts(); ++vid)
+        {
+            for(uint nbr : m.adj_v2v(vid)) acc += nbr;
+            for(uint pid : m.adj_v2p(vid)) acc += pid;
+        }
+        for(uint eid=0; eid<m.num_edges(); ++eid)
+        {
+            for(uint pid : m.adj_e2p(eid)) acc += pid;
+        }
+        for(uint pid=0; pid<m.num_polys(); ++pid)
+        {
+            for(uint nbr : m.adj_p2p(pid)) acc += nbr;
+            for(uint eid : m.adj_p2e(pid)) acc += eid;
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark_octree(const Mesh & m, const std::string & dataset, const bool with_rays)
+{
+    const uint n_queries = 10000;
+    RandomStream rnd(dataset.size());
+    AABB box = m.bbox();
+    std::vector<vec3d> points(n_queries), dirs(n_queries);
+    for(uint i=0; i<n_queries; ++i)
+    {
+        points.at(i) = vec3d(rnd.next_double(box.min.x(), box.max.x()),
+                             rnd.next_double(box.min.y(), box.max.y()),
+                             rnd.next_double(box.min.z(), box.max.z()));
+        dirs.at(i)   = vec3d(rnd.next_normal(), rnd.next_normal(), rnd.next_normal());
+    }
+
+    std::unique_ptr<Octree> o;
+    benchmark("octree_build", dataset, m.num_polys(),
+              [&](){ o.reset(new Octree()); },
+              [&](){ o->build_from_mesh_polys(m); });
+
+    benchmark("octree_closest_point", dataset, n_queries, [&]()
+    {
+        for(const vec3d & p : points) o->closest_point(p);
+    });
+
+    if(with_rays)
+    {
+        benchmark("octree_ray_query", dataset, n_queries, [&]()
+        {
+            for(uint i=0; i<n_queries; ++i)
+            {
+                double t;
+                uint   id;
+                o->intersects_ray(points.at(i), dirs.at(i), t, id);
+            }
+        });
+    }
+    else
+    {
+        benchmark("octree_point_location", dataset, n_queries, [&]()
+        {
+            for(const vec3d & p : points)
+            {
+                uint id;
+                o->contains(p, false, id);
+            }
+        });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark_laplacian(Mesh & m, const std::string & dataset)
+{
+    Eigen::SparseMatrix<double> L;
+    benchmark("laplacian_assembly", dataset, m.num_verts(), [&]()
+    {
+        L = laplacian(m, COTANGENT);
+    });
+
+    // harmonic field with two Dirichlet constraints
+    std::map<uint,double> bc;
+    bc[0] = 0.0;
+    bc[m.num_verts()-1] = 1.0;
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m.num_verts());
+    Eigen::VectorXd x;
+    benchmark("laplacian_solve", dataset, m.num_verts(), [&]()
+    {
+        solve_square_system_with_bc(-L, rhs, x, bc, SIMPLICIAL_LDLT);
+    });
+
+    Eigen::VectorXd y = Eigen::VectorXd::Ones(m.num_verts());
+    benchmark("laplacian_spmv_x100", dataset, m.num_verts(), [&]()
+    {
+        for(uint i=0; i<100; ++i) y = (L * y).eval() * 1e-3 + y;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// compares a randomly shuffled copy of the mesh with its reordered versions
+template<class Mesh>
+void benchmark_reordering(const Mesh & m, const std::string & dataset)
+{
+    Mesh shuffled = m;
+    std::vector<uint> v_order(m.num_verts()), p_order(m.num_polys());
+    std::iota(v_order.begin(), v_order.end(), 0);
+    std::iota(p_order.begin(), p_order.end(), 0);
+    RandomStream rnd(1);
+    for(uint i=v_order.size()-1; i>0; --i) std::swap(v_order[i], v_order[rnd.next_uint()%(i+1)]);
+    for(uint i=p_order.size()-1; i>0; --i) std::swap(p_order[i], p_order[rnd.next_uint()%(i+1)]);
+    MeshReordering r;
+    reorder_mesh(shuffled, v_order, p_order, r);
+
+    std::vector<std::pair<std::string,int>> modes =
+    {
+        { "shuffled", -1            },
+        { "morton",   MORTON_ORDER  },
+        { "hilbert",  HILBERT_ORDER },
+        { "rcm",      RCM_ORDER     },
+    };
+    for(const auto & mode : modes)
+    {
+        std::string name = dataset + "_" + mode.first;
+        Mesh tmp;
+        if(mode.second>=0)
+        {
+            benchmark("reorder_mesh", name, m.num_polys(),
+                      [&](){ tmp = shuffled; },
+                      [&](){ reorder_mesh(tmp, mode.second, r); });
+        }
+        else tmp = shuffled;
+
+        benchmark_adjacency(tmp, name);
+        benchmark_laplacian(tmp, name);
+        std::unique_ptr<Octree> o;
+        benchmark("octree_build", name, tmp.num_polys(),
+                  [&](){ o.reset(new Octree()); },
+                  [&](){ o->build_from_mesh_polys(tmp); });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark_geodesics(Mesh & m, const std::string & dataset)
+{
+    benchmark("geodesics_heat", dataset, m.num_verts(), [&]()
+    {
+        compute_geodesics(m, {0}, COTANGENT);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void benchmark_io(const Mesh & m, const std::string & dataset, const std::string & ext)
+{
+    std::string filename = "benchmark_tmp." + ext;
+    benchmark("io_write_" + ext, dataset, m.num_polys(), [&](){ m.save(filename.c_str()); });
+    benchmark("io_read_"  + ext, dataset, m.num_polys(), [&](){ Mesh tmp(filename.c_str()); });
+    std::remove(filename.c_str());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void benchmark_trimesh(Trimesh<> & m, const std::string & dataset)
+{
+    benchmark_adjacency(m, dataset);
+    benchmark_octree(m, dataset, true);
+
+    benchmark("find_intersections", dataset, m.num_polys(), [&]()
+    {
+        std::set<ipair> inters;
+        find_intersections(m, inters);
+    });
+
+    benchmark_laplacian(m, dataset);
+    benchmark_geodesics(m, dataset);
+
+    Trimesh<> tmp;
+    benchmark("remesh_Botsch_Kobbelt", dataset, m.num_polys(),
+              [&](){ tmp = m; },
+              [&](){ remesh_Botsch_Kobbelt_2004(tmp); });
+
+    benchmark_io(m, dataset, "obj");
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void benchmark_tetmesh(Tetmesh<> & m, const std::string & dataset)
+{
+    benchmark_adjacency(m, dataset);
+    benchmark_octree(m, dataset, false);
+    benchmark_laplacian(m, dataset);
+
+    // iso-surface the z coordinate at half height
+    for(uint vid=0; vid<m.num_verts(); ++vid) m.vert_data(vid).uvw[0] = m.vert(vid).z();
+    double iso = m.bbox().center().z();
+    benchmark("marching_tets", dataset, m.num_polys(), [&]()
+    {
+        std::vector<vec3d> verts, norms;
+        std::vector<uint>  tris;
+        marching_tets(m, iso, verts, tris, norms);
+    });
+
+    benchmark_io(m, dataset, "mesh");
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void benchmark_hexmesh(Hexmesh<> & m, const std::string & dataset)
+{
+    benchmark_adjacency(m, dataset);
+    benchmark_io(m, dataset, "mesh");
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    std::string out_file = (argc>1) ? std::string(argv[1]) : "";
+    if(argc>2) n_runs = std::max(1, atoi(argv[2]));
+    uint scale = (argc>3) ? std::max(1, atoi(argv[3])) : 1;
+
+    std::string data = std::string(DATA_PATH);
+
+    // surface meshes ::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    std::cerr << "triangle meshes" << std::endl;
+    std::string bunny = data + "/bunny.obj";
+    Trimesh<> tm;
+    benchmark("load_init", "bunny", 0, [&](){ tm = Trimesh<>(bunny.c_str()); });
+    results.back().size = tm.num_polys();
+    benchmark_trimesh(tm, "bunny");
+    benchmark_reordering(tm, "bunny");
+
+    uint n = 256*scale;
+    std::string grid_name = "grid_" + std::to_string(n) + "x" + std::to_string(n);
+    Trimesh<> grid;
+    benchmark("generate", grid_name, 2*n*n, [&](){ synthetic_trimesh(n, grid); });
+    benchmark_trimesh(grid, grid_name);
+
+    // volume meshes :::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    std::cerr << "tetrahedral meshes" << std::endl;
+    std::string sphere = data + "/sphere.mesh";
+    Tetmesh<> tet;
+    benchmark("load_init", "sphere", 0, [&](){ tet = Tetmesh<>(sphere.c_str()); });
+    results.back().size = tet.num_polys();
+    benchmark_tetmesh(tet, "sphere");
+    benchmark_reordering(tet, "sphere");
+
+    std::cerr << "hexahedral meshes" << std::endl;
+    std::string rockerarm = data + "/rockerarm.mesh";
+    Hexmesh<> hex;
+    benchmark("load_init", "rockerarm", 0, [&](){ hex = Hexmesh<>(rockerarm.c_str()); });
+    results.back().size = hex.num_polys();
+    benchmark_hexmesh(hex, "rockerarm");
+
+    // scaled variants: midpoint subdivision (x8 hexa per level) and tetrahedralization
+    Hexmesh<> hex_fine = hex;
+    for(uint i=0; i<scale; ++i)
+    {
+        Hexmesh<> tmp;
+        subdivision_midpoint(hex_fine, tmp);
+        hex_fine = tmp;
+    }
+    std::string fine_name = "rockerarm_sub" + std::to_string(scale);
+    benchmark_hexmesh(hex_fine, fine_name);
+
+    Tetmesh<> tet_fine;
+    benchmark("hex_to_tets", fine_name, hex_fine.num_polys(),
+              [&](){ tet_fine.clear(); },
+              [&](){ hex_to_tets(hex_fine, tet_fine); });
+    std::cerr << "tetrahedral meshes (from hexa)" << std::endl;
+    benchmark_tetmesh(tet_fine, fine_name + "_tets");
+
+    // output ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    std::string json = to_json();
+    if(out_file.empty())
+    {
+        std::cout << json;
+    }
+    else
+    {
+        std::ofstream f(out_file.c_str());
+        f << json;
+        std::cerr << "results written to " << out_file << std::endl;
+    }
+    return 0;
+}
@@ -35,158 +35,445 @@
 *********************************************************************************/
 #include <cinolib/Poisson_sampling.h>
 #include <cinolib/random_generator.h>
-#include <cinolib/serialize_index.h>
-#include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdint.h>
 
 namespace cinolib
 {
 
-/* This is almost a 1:1 copy of the reference implementation of the Fast Poisson disk sampling in arbitrary
- * dimensions released by Robert Bridson (https://www.cs.ubc.ca/~rbridson/download/curlnoise.tar.gz). See:
- *
- * Fast Poisson Disk Sampling in Arbitrary Dimensions
- * Robert Bridson
- * SIGGRAPH Technical Sketch, 2007
-*/
+// integer coordinates of the grid cell containing p. Coordinates (and those
+// of the neighbor cells) must be representable as int
+template<uint Dim, class Point>
+CINO_INLINE
+std::array<int,Dim> Poisson_sampling_cell(const Point & p, const double radius)
+{
+    std::array<int,Dim> c;
+    for(uint i=0; i<Dim; ++i)
+    {
+        double x = std::floor(p[i]/radius);
+        assert(x > std::numeric_limits<int>::min()+1 && x < std::numeric_limits<int>::max()-1);
+        c[i] = static_cast<int>(x);
+    }
+    return c;
+}
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<uint Dim, class Point>
-void sample_annulus(const double radius, const Point & center, uint & seed, Point & x)
+// open addressing hash table mapping the (full) coordinates of the non empty grid
+// cells to consecutive ids. Lookups are much cheaper than with std::unordered_map,
+// and can be done concurrently (as long as no one is inserting)
+template<uint Dim>
+class PoissonSamplingCells
 {
-    Point r;
-    for(;;)
-    {
-        for(uint i=0; i<Dim; ++i)
+    public:
+
+        typedef std::array<int,Dim> Cell;
+
+        PoissonSamplingCells() : mask(1023), n(0), keys(1024), ids(1024,-1) {}
+
+        uint size() const { return n; }
+
+        int find(const Cell & key) const
         {
-            r[i]=4*(random_uint(seed++)/static_cast<double>(max_uint)-0.5);
+            for(uint64_t h=hash(key);; h=(h+1)&mask)
+            {
+                if(ids[h]<0 || keys[h]==key) return ids[h];
+            }
         }
-        double r2=r.length_squared();
-        if(r2>1 && r2<=4) break;
-    }
-    x=center+radius*r;
-}
+
+        uint insert(const Cell & key)
+        {
+            if(2*(n+1)>mask) grow();
+            uint64_t h = hash(key);
+            while(ids[h]>=0 && keys[h]!=key) h = (h+1)&mask;
+            if(ids[h]<0)
+            {
+                keys[h] = key;
+                ids[h]  = n++;
+            }
+            return ids[h];
+        }
+
+    protected:
+
+        uint64_t hash(const Cell & key) const
+        {
+            uint64_t h = 0;
+            for(uint i=0; i<Dim; ++i)
+            {
+                h ^= uint64_t(uint32_t(key[i])) + 0x9e3779b97f4a7c15ull + (h<<6) + (h>>2);
+            }
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h & mask;
+        }
+
+        void grow()
+        {
+            std::vector<Cell> old_keys;
+            std::vector<int>  old_ids;
+            old_keys.swap(keys);
+            old_ids.swap(ids);
+            mask = 2*mask+1;
+            keys.resize(mask+1);
+            ids.resize(mask+1, -1);
+            for(uint i=0; i<old_ids.size(); ++i)
+            {
+                if(old_ids[i]<0) continue;
+                uint64_t h = hash(old_keys[i]);
+                while(ids[h]>=0) h = (h+1)&mask;
+                keys[h] = old_keys[i];
+                ids[h]  = old_ids[i];
+            }
+        }
+
+        uint64_t          mask;
+        uint              n;
+        std::vector<Cell> keys;
+        std::vector<int>  ids;
+};
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<uint Dim, class Point>
+/* Core of the sampler. At each round, gen(round,darts) fills darts with a set of
+ * candidate samples (ideally about one per grid cell), which are bucketed in the
+ * grid cells and then processed phase group by phase group. The cells of a group
+ * are processed in parallel: each of them tests its darts against the samples in
+ * the surrounding cells, and accepts those having no sample closer than radius.
+ * Accepted darts are appended to the samples once the whole group is done.
+*/
+template<uint Dim, class Point, class Gen>
 CINO_INLINE
-void Poisson_sampling(const double          radius,
-                      const Point           min,
-                      const Point           max,
-                      std::vector<Point> &  samples,
-                      uint                  seed,
-                      const int             max_attempts)
+void Poisson_sampling_engine(const double         radius,
+                             const uint           n_rounds,
+                             const uint           seed,
+                             const Gen          & gen,
+                             std::vector<Point> & samples)
 {
-    samples.clear();
-    std::vector<uint> active_list;
+    typedef std::array<int,Dim> Cell;
 
-    // acceleration grid
-    double step = 0.999*radius/std::sqrt(static_cast<double>(Dim)); // a grid cell this size can have at most one sample in it
-    std::array<uint,Dim> dim_extent;
-    unsigned long int grid_size = 1;
-    for(uint i=0; i<Dim; ++i)
+    const uint   n_slots  = 1u << Dim; // a cell cannot contain more than 2^Dim samples
+    const uint   n_groups = 1u << Dim;
+    const double r_sqrd   = radius*radius;
+
+    // offsets of the neighbor cells, sorted by number of non zero entries, so that
+    // the closest cells (where conflicts are more likely) are tested first
+    std::vector<Cell> nbr_offsets;
     {
-        dim_extent[i] = static_cast<uint>(std::ceil((max[i]-min[i])/step));
-        grid_size *= dim_extent[i];
+        uint n_nbrs = 1;
+        for(uint i=0; i<Dim; ++i) n_nbrs *= 3;
+        for(uint nbr=0; nbr<n_nbrs; ++nbr)
+        {
+            Cell off;
+            for(uint j=0, id=nbr; j<Dim; ++j, id/=3) off[j] = int(id%3) - 1;
+            nbr_offsets.push_back(off);
+        }
+        std::stable_sort(nbr_offsets.begin(), nbr_offsets.end(), [](const Cell & a, const Cell & b)
+        {
+            uint na = 0, nb = 0;
+            for(uint j=0; j<Dim; ++j) { na += (a[j]!=0); nb += (b[j]!=0); }
+            return na < nb;
+        });
     }
-    std::vector<int> grid(grid_size, -1); // -1 indicates no sample there; otherwise index of sample point
 
-    // first sample
-    Point x;
-    for(uint i=0; i<Dim; ++i)
+    samples.clear();
+    PoissonSamplingCells<Dim> cells;   // cell coordinates => cell id
+    std::vector<Cell>         cell_coords;
+    std::vector<int>          slots;   // n_slots sample ids per cell (-1 if empty)
+
+    auto dist_sqrd = [](const Point & a, const Point & b) -> double
     {
-        x[i] = (max[i]-min[i])*(random_uint(seed++)/static_cast<double>(max_uint)) + min[i];
-    }
-    samples.push_back(x);
-    active_list.push_back(0);
-    uint index = serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
-    grid[index] = 0;
+        double d = 0;
+        for(uint i=0; i<Dim; ++i) d += (a[i]-b[i])*(a[i]-b[i]);
+        return d;
+    };
 
-    while(!active_list.empty())
+    std::vector<Point> darts;
+    for(uint round=0; round<n_rounds; ++round)
     {
-        uint r = static_cast<int>(random_float(seed++, 0, active_list.size()-0.0001f));
-        int  p = active_list[r];
-        bool found_sample = false;
-        Point j, jmin, jmax;
+        gen(round, darts);
+        uint n_darts = darts.size();
+        if(n_darts==0) continue;
 
-        for(int attempt=0; attempt<max_attempts; ++attempt)
+        // find the cell of each dart (adding the cells never seen before)
+        std::vector<int> dart_cell(n_darts);
+        PARALLEL_FOR(0, n_darts, 10000, [&](uint i)
         {
-            sample_annulus<Dim,Point>(radius, samples[p], seed, x);
-
-            // check this sample is within bounds
-            for(uint i=0; i<Dim; ++i)
+            dart_cell[i] = cells.find(Poisson_sampling_cell<Dim>(darts[i], radius));
+        });
+        for(uint i=0; i<n_darts; ++i)
+        {
+            if(dart_cell[i]>=0) continue;
+            Cell c = Poisson_sampling_cell<Dim>(darts[i], radius);
+            dart_cell[i] = cells.insert(c);
+            if(dart_cell[i]==(int)cell_coords.size())
             {
-                if(x[i]<min[i] || x[i]>max[i]) goto reject_sample;
+                cell_coords.push_back(c);
+                slots.resize(slots.size()+n_slots, -1);
             }
+        }
 
-            // test proximity to nearby samples
-            for(uint i=0; i<Dim; ++i)
-            {
-                int this_min = static_cast<int>((x[i]-radius-min[i])/step);
-
-                if(this_min<0) this_min=0;
-                else if(this_min>=(int)dim_extent[i]) this_min=dim_extent[i]-1;
+        // bucket darts per cell (counting sort, stable)
+        uint n_cells = cells.size();
+        std::vector<uint> cell_beg(n_cells+1, 0);
+        for(uint i=0; i<n_darts; ++i) ++cell_beg[dart_cell[i]+1];
+        for(uint c=0; c<n_cells; ++c) cell_beg[c+1] += cell_beg[c];
+        std::vector<uint> sorted_darts(n_darts);
+        {
+            std::vector<uint> pos(cell_beg.begin(), cell_beg.end()-1);
+            for(uint i=0; i<n_darts; ++i) sorted_darts[pos[dart_cell[i]]++] = i;
+        }
 
-                jmin[i]=(uint)this_min;
-                int this_max=(int)((x[i]+radius-min[i])/step);
+        // non empty cells, split by phase group
+        std::vector<std::vector<uint>> group_cells(n_groups);
+        for(uint c=0; c<n_cells; ++c)
+        {
+            if(cell_beg[c]==cell_beg[c+1]) continue;
+            uint g = 0;
+            for(uint j=0; j<Dim; ++j) g |= uint(cell_coords[c][j] & 1) << j;
+            group_cells[g].push_back(c);
+        }
 
-                if(this_max<0) this_max=0;
-                else if(this_max>=(int)dim_extent[i]) this_max=dim_extent[i]-1;
+        // the visiting order of the groups changes at each round
+        RandomStream      rs = RandomStream(seed).split(round);
+        std::vector<uint> group_order(n_groups);
+        std::iota(group_order.begin(), group_order.end(), 0);
+        for(uint i=n_groups-1; i>0; --i)
+        {
+            uint j = std::min(i, static_cast<uint>(rs.double_at(i)*(i+1)));
+            std::swap(group_order[i], group_order[j]);
+        }
 
-                jmax[i]=(uint)this_max;
-            }
+        std::vector<char> accepted(n_darts, false);
+        for(uint g : group_order)
+        {
+            const std::vector<uint> & group = group_cells[g];
 
-            for(j=jmin;;)
+            PARALLEL_FOR(0, group.size(), 256, [&](uint k)
             {
-                // check if there's a sample at j that's too close to x
-                index = serialize_nD_index<Dim,Point>(dim_extent, j);
-                if(grid[index]>=0 && grid[index]!=p)
-                {
-                    // if there is a sample point different from p
-                    if((x - samples[grid[index]]).length_squared()<radius*radius) goto reject_sample;
-                }
+                uint   cid   = group[k];
+                int  * own   = &slots[cid*n_slots];
+                uint   n_own = 0;
+                while(n_own<n_slots && own[n_own]>=0) ++n_own;
 
-                // move on to next j
-                for(uint i=0; i<Dim; ++i)
+                const Cell & c = cell_coords[cid];
+                for(uint pos=cell_beg[cid]; pos<cell_beg[cid+1] && n_own<n_slots; ++pos)
                 {
-                    ++j[i];
-                    if(j[i]<=jmax[i])
+                    const Point & x = darts[sorted_darts[pos]];
+                    bool ok = true;
+
+                    // test against the darts already accepted in this cell
+                    for(uint prev=cell_beg[cid]; ok && prev<pos; ++prev)
                     {
-                        break;
+                        if(accepted[prev] && dist_sqrd(x, darts[sorted_darts[prev]])<r_sqrd) ok = false;
                     }
-                    else
+
+                    // test against the samples in this cell and in the neighbor ones
+                    for(uint nbr=0; ok && nbr<nbr_offsets.size(); ++nbr)
                     {
-                        if(i==Dim-1) goto done_j_loop;
-                        else j[i]=jmin[i]; // and try incrementing the next dimension along
+                        const Cell & off = nbr_offsets[nbr];
+                        Cell   nc;
+                        double d = 0;
+                        for(uint j=0; j<Dim; ++j)
+                        {
+                            nc[j] = c[j] + off[j];
+                            if(off[j]<0) d += (x[j] - c[j]*radius)*(x[j] - c[j]*radius);
+                            if(off[j]>0) d += ((c[j]+1)*radius - x[j])*((c[j]+1)*radius - x[j]);
+                        }
+                        if(d>=r_sqrd) continue; // the cell is too far away
+
+                        const int * nbr_slots = own;
+                        if(nbr>0)
+                        {
+                            int nid = cells.find(nc);
+                            if(nid<0) continue;
+                            nbr_slots = &slots[nid*n_slots];
+                        }
+                        for(uint s=0; ok && s<n_slots && nbr_slots[s]>=0; ++s)
+                        {
+                            if(dist_sqrd(x, samples[nbr_slots[s]])<r_sqrd) ok = false;
+                        }
+                    }
+
+                    if(ok)
+                    {
+                        accepted[pos] = true;
+                        ++n_own;
                     }
                 }
-            }
+            });
 
-            done_j_loop:
-            // if we made it here, we're good!
-            found_sample=true;
-            break;
-            // if we goto here, x is too close to an existing sample
-            reject_sample:
-            ; // nothing to do except go to the next iteration in this loop
+            // append the accepted darts to the samples (in cell order)
+            std::vector<uint> count(group.size());
+            PARALLEL_FOR(0, group.size(), 1000, [&](uint k)
+            {
+                uint cid = group[k];
+                count[k] = 0;
+                for(uint pos=cell_beg[cid]; pos<cell_beg[cid+1]; ++pos) count[k] += accepted[pos] ? 1 : 0;
+            });
+            PARALLEL_PREFIX_SUM(count, 10000);
+            uint offset = samples.size();
+            if(!count.empty()) samples.resize(offset + count.back());
+            PARALLEL_FOR(0, group.size(), 1000, [&](uint k)
+            {
+                uint  cid = group[k];
+                int * own = &slots[cid*n_slots];
+                uint  s   = 0;
+                uint  id  = offset + ((k>0) ? count[k-1] : 0);
+                while(s<n_slots && own[s]>=0) ++s;
+                for(uint pos=cell_beg[cid]; pos<cell_beg[cid+1]; ++pos)
+                {
+                    if(!accepted[pos]) continue;
+                    samples[id] = darts[sorted_darts[pos]];
+                    own[s++]    = id++;
+                }
+            });
         }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        if(found_sample)
+// samples the simplices of a mesh (triangles or tets). At each round each element
+// throws a number of darts proportional to its size (i.e. about one per grid cell)
+template<class Mesh>
+CINO_INLINE
+void Poisson_sampling_simplices(const Mesh                & m,
+                                const uint                  n_corners,
+                                const std::vector<double> & size, // element size, in grid cells
+                                const double                radius,
+                                const uint                  seed,
+                                const uint                  n_rounds,
+                                std::vector<vec3d>        & samples)
+{
+    uint n_elems = m.num_polys();
+    auto gen = [&](const uint round, std::vector<vec3d> & darts)
+    {
+        // per element number of darts (stochastic rounding keeps the expected
+        // count proportional to the element size, also for tiny elements)
+        RandomStream rs_count = RandomStream(seed,1).split(round);
+        RandomStream rs_darts = RandomStream(seed,2).split(round);
+        std::vector<uint> offset(n_elems);
+        PARALLEL_FOR(0, n_elems, 10000, [&](uint pid)
         {
-            uint id=samples.size(); // the index of the new sample
-            samples.push_back(x);
-            active_list.push_back(id);
-            index=serialize_nD_index<Dim,Point>(dim_extent, (x-min)/step);
-            grid[index]=(int)id;
-        }
-        else
+            offset[pid] = static_cast<uint>(std::floor(size[pid] + rs_count.double_at(pid)));
+        });
+        PARALLEL_PREFIX_SUM(offset, 10000);
+        darts.resize(n_elems>0 ? offset.back() : 0);
+
+        PARALLEL_FOR(0, n_elems, 1000, [&](uint pid)
         {
-            // since we couldn't find a sample on p's disk, we remove p from the active list
-            active_list[r]=active_list.back();
-            active_list.pop_back();
-        }
+            uint beg = (pid>0) ? offset[pid-1] : 0;
+            for(uint i=beg; i<offset[pid]; ++i)
+            {
+                // uniform barycentric coordinates are the gaps
+                // between n_corners-1 sorted uniform variables
+                std::array<uint32_t,4> r = rs_darts.block_at(i);
+                std::array<double,4>   u;
+                for(uint j=0; j+1<n_corners; ++j) u[j] = (r[j] + 0.5) * (1.0/4294967296.0);
+                std::sort(u.begin(), u.begin()+n_corners-1);
+                vec3d  p(0,0,0);
+                double prev = 0;
+                for(uint j=0; j+1<n_corners; ++j)
+                {
+                    p   += (u[j]-prev) * m.poly_vert(pid,j);
+                    prev = u[j];
+                }
+                p += (1.0-prev) * m.poly_vert(pid,n_corners-1);
+                darts[i] = p;
+            }
+        });
+    };
+    Poisson_sampling_engine<3,vec3d>(radius, n_rounds, seed, gen, samples);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint Dim, class Point>
+CINO_INLINE
+void Poisson_sampling(const double          radius,
+                      const Point           min,
+                      const Point           max,
+                      std::vector<Point> &  samples,
+                      uint                  seed,
+                      const int             max_attempts)
+{
+    // cells intersecting the box. At each round every cell throws
+    // one dart in its intersection with the box
+    std::array<int,Dim> c_min = Poisson_sampling_cell<Dim>(min, radius);
+    std::array<int,Dim> c_max = Poisson_sampling_cell<Dim>(max, radius);
+    std::array<int,Dim> c_ext;
+    uint64_t n_cells = 1;
+    for(uint i=0; i<Dim; ++i)
+    {
+        c_ext[i] = c_max[i] - c_min[i] + 1;
+        assert(c_ext[i]>0);
+        n_cells *= uint64_t(c_ext[i]);
+        assert(n_cells <= std::numeric_limits<uint>::max()); // one dart per cell and round
     }
+
+    auto gen = [&](const uint round, std::vector<Point> & darts)
+    {
+        RandomStream rs = RandomStream(seed,1).split(round);
+        darts.resize(n_cells);
+        PARALLEL_FOR(0, n_cells, 10000, [&](uint id)
+        {
+            uint  tmp = id;
+            Point x;
+            for(uint i=0; i<Dim; ++i)
+            {
+                int    c  = c_min[i] + int(tmp % c_ext[i]);
+                double lo = std::max(double(min[i]), c*radius);
+                double hi = std::min(double(max[i]), (c+1)*radius);
+                x[i] = lo + (hi-lo)*rs.double_at(uint64_t(Dim)*id+i);
+                tmp /= c_ext[i];
+            }
+            darts[id] = x;
+        });
+    };
+    Poisson_sampling_engine<Dim,Point>(radius, max_attempts, seed, gen, samples);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const Trimesh<M,V,E,P> & m,
+                      const double             radius,
+                      std::vector<vec3d>     & samples,
+                      uint                     seed,
+                      const int                max_attempts)
+{
+    std::vector<double> size(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 10000, [&](uint pid)
+    {
+        size[pid] = m.poly_area(pid)/(radius*radius);
+    });
+    Poisson_sampling_simplices(m, 3, size, radius, seed, max_attempts, samples);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void Poisson_sampling(const Tetmesh<M,V,E,F,P> & m,
+                      const double               radius,
+                      std::vector<vec3d>       & samples,
+                      uint                       seed,
+                      const int                  max_attempts)
+{
+    std::vector<double> size(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 10000, [&](uint pid)
+    {
+        size[pid] = m.poly_volume(pid)/(radius*radius*radius);
+    });
+    Poisson_sampling_simplices(m, 4, size, radius, seed, max_attempts, samples);
 }
 
 }
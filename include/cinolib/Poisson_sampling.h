@@ -37,17 +37,30 @@
 #define CINO_POISSON_SAMPLING
 
 #include <cinolib/cino_inline.h>
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/meshes/tetmesh.h>
 #include <sys/types.h>
+#include <vector>
 
 namespace cinolib
 {
 
-/* This is almost a 1:1 copy of the reference implementation of the Fast Poisson disk sampling in arbitrary
- * dimensions released by Robert Bridson (https://www.cs.ubc.ca/~rbridson/download/curlnoise.tar.gz). See:
+/* Parallel Poisson disk sampling, based on the phase group approach described in:
  *
- * Fast Poisson Disk Sampling in Arbitrary Dimensions
- * Robert Bridson
- * SIGGRAPH Technical Sketch, 2007
+ * Parallel Poisson Disk Sampling
+ * Li-Yi Wei
+ * ACM Transactions on Graphics (SIGGRAPH), 2008
+ *
+ * Space is partitioned into a sparse (hashed) grid of cubic cells having edge radius,
+ * and only the cells actually touched by the domain are stored. Cells are split into
+ * 2^Dim phase groups according to the parity of their coordinates: cells in the same
+ * group are at least radius apart, hence darts thrown in them can be tested against
+ * the existing samples (and accepted) in parallel, without conflicts. Sampling goes
+ * on for a number of rounds, each throwing (on average) one dart per cell.
+ *
+ * The output is deterministic for a given seed, regardless of the number of threads.
+ * Cells are identified by their full integer coordinates, which must fit in an int
+ * (i.e. all coordinates must be less than about 2^31 radii away from the origin).
 */
 
 template<uint Dim, class Point>
@@ -59,6 +72,32 @@ void Poisson_sampling(const double         radius,
                       uint                 seed=0,
                       const int            max_attempts=30);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Poisson disk sampling of a triangle mesh surface. Darts are
+// thrown on the triangles, proportionally to their area
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Poisson_sampling(const Trimesh<M,V,E,P> & m,
+                      const double             radius,
+                      std::vector<vec3d>     & samples,
+                      uint                     seed=0,
+                      const int                max_attempts=30);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Poisson disk sampling of the volume of a tetrahedral mesh. Darts
+// are thrown inside the tets, proportionally to their volume
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void Poisson_sampling(const Tetmesh<M,V,E,F,P> & m,
+                      const double               radius,
+                      std::vector<vec3d>       & samples,
+                      uint                       seed=0,
+                      const int                  max_attempts=30);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,213 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/RBF_Hermite_compact.h>
+#include <cinolib/parallel_for.h>
+#include <Eigen/Sparse>
+
+namespace cinolib
+{
+
+template<class RBF>
+CINO_INLINE
+Hermite_RBF_compact<RBF>::Hermite_RBF_compact(const std::vector<vec3d> & points,
+                                              const std::vector<vec3d> & normals,
+                                              const double               support_radius,
+                                              const int                  solver)
+: radius(support_radius)
+, grid(support_radius)
+{
+    assert(points.size()==normals.size());
+    assert(radius>0);
+
+    uint np = points.size();
+    grid.build(points);
+
+    // find the centers within the support of each center
+    std::vector<std::vector<uint>> nbrs(np);
+    PARALLEL_FOR(0, np, 1000, [&](uint i)
+    {
+        grid.points_in_ball(points.at(i), radius, nbrs.at(i));
+        std::sort(nbrs.at(i).begin(), nbrs.at(i).end());
+    });
+
+    // assemble the sparse system directly in compressed (row major) form.
+    // Each center i controls four consecutive rows (the interpolation of
+    // the value and of the three gradient components at point i), and
+    // each row has four entries for each center j in its support. Note:
+    // gradient rows (and normals) are negated w.r.t. Hermite_RBF, so that
+    // the matrix becomes symmetric (and positive definite for PD kernels)
+    typedef Eigen::SparseMatrix<double,Eigen::RowMajor> RowMajorMatrix;
+    uint size = 4*np;
+    std::vector<uint> offset(np+1, 0);
+    for(uint i=0; i<np; ++i) offset.at(i+1) = offset.at(i) + 16*nbrs.at(i).size();
+
+    RowMajorMatrix A(size, size);
+    A.resizeNonZeros(offset.back());
+    Eigen::VectorXd f(size);
+
+    int    *outer = A.outerIndexPtr();
+    int    *inner = A.innerIndexPtr();
+    double *value = A.valuePtr();
+    outer[size] = offset.back();
+
+    double R   = radius;
+    double R_2 = radius*radius;
+    PARALLEL_FOR(0, np, 1000, [&](uint i)
+    {
+        const vec3d & p = points.at(i);
+        const vec3d & n = normals.at(i);
+
+        uint ii = 4*i;
+        f(ii  ) =  0;
+        f(ii+1) = -n.x();
+        f(ii+2) = -n.y();
+        f(ii+3) = -n.z();
+
+        uint row_size = 4*nbrs.at(i).size();
+        for(uint r=0; r<4; ++r) outer[ii+r] = offset.at(i) + r*row_size;
+
+        for(uint k=0; k<nbrs.at(i).size(); ++k)
+        {
+            uint   j    = nbrs.at(i).at(k);
+            vec3d  diff = p - points.at(j);
+            double len  = diff.length();
+            double blk[4][4];
+
+            if(len==0)
+            {
+                // limit for len->0: phi(0) and the Hessian of phi at 0
+                for(uint r=0; r<4; ++r) for(uint c=0; c<4; ++c) blk[r][c] = 0;
+                blk[0][0] = RBF::eval_f(0);
+                for(uint d=1; d<4; ++d) blk[d][d] = -RBF::eval_ddf(0)/R_2;
+            }
+            else
+            {
+                double w    = RBF::eval_f(len/R);
+                double dw_l = RBF::eval_df(len/R)/(R*len);
+                double ddw  = RBF::eval_ddf(len/R)/R_2;
+                vec3d  g    = diff*dw_l;
+                blk[0][0] = w;
+                for(uint d=0; d<3; ++d)
+                {
+                    blk[0][d+1] =  g[d];
+                    blk[d+1][0] = -g[d];
+                    for(uint e=0; e<3; ++e)
+                    {
+                        blk[d+1][e+1] = -(ddw - dw_l)/(len*len) * diff[d]*diff[e];
+                    }
+                    blk[d+1][d+1] -= dw_l;
+                }
+            }
+
+            for(uint r=0; r<4; ++r)
+            for(uint c=0; c<4; ++c)
+            {
+                uint pos = outer[ii+r] + 4*k + c;
+                inner[pos] = 4*j + c;
+                value[pos] = blk[r][c];
+            }
+        }
+    });
+
+    Eigen::VectorXd x;
+    solve_square_system(Eigen::SparseMatrix<double>(A), f, x, solver);
+
+    alpha.resize(np);
+    beta.resize(np);
+    for(uint i=0; i<np; ++i)
+    {
+        alpha.at(i) = x(4*i);
+        beta.at(i)  = vec3d(x(4*i+1), x(4*i+2), x(4*i+3));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+ScalarField Hermite_RBF_compact<RBF>::eval(const std::vector<vec3d> & plist) const
+{
+    ScalarField f(plist.size());
+    PARALLEL_FOR(0, plist.size(), 1000, [&](uint i)
+    {
+        f[i] = eval(plist.at(i));
+    });
+    return f;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+double Hermite_RBF_compact<RBF>::eval(const vec3d & p) const
+{
+    double val = 0;
+    grid.for_each_point_in_ball(p, radius, [&](const uint i, const double d_sqrd)
+    {
+        double l = std::sqrt(d_sqrd);
+        val += alpha.at(i) * RBF::eval_f(l/radius);
+        if(l>0) val += beta.at(i).dot(p - grid.point(i))*RBF::eval_df(l/radius)/(radius*l);
+    });
+    return val;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+vec3d Hermite_RBF_compact<RBF>::eval_grad(const vec3d & p) const
+{
+    vec3d grad(0,0,0);
+    grid.for_each_point_in_ball(p, radius, [&](const uint i, const double d_sqrd)
+    {
+        double len = std::sqrt(d_sqrd);
+        if(len>1e-10)
+        {
+            vec3d  diff  = p - grid.point(i);
+            vec3d  dir   = diff/len;
+            double dphi  = RBF::eval_df (len/radius)/radius;
+            double ddphi = RBF::eval_ddf(len/radius)/(radius*radius);
+            double b_d_l = beta.at(i).dot(diff)/len;
+
+            grad += dir * (alpha.at(i)*dphi);
+            grad += (dir*ddphi - diff*dphi/d_sqrd)*b_d_l + beta.at(i)*dphi/len;
+        }
+        else grad += beta.at(i)*RBF::eval_ddf(0)/(radius*radius);
+    });
+    return grad;
+}
+
+}
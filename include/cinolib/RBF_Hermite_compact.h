@@ -0,0 +1,105 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_RBF_HERMITE_COMPACT_H
+#define CINO_RBF_HERMITE_COMPACT_H
+
+#include <cinolib/geometry/vec3.h>
+#include <cinolib/scalar_field.h>
+#include <cinolib/linear_solvers.h>
+#include <cinolib/hash_grid.h>
+
+namespace cinolib
+{
+
+/* Scalable variant of Hermite_RBF, meant to be used with compactly supported kernels
+ * (e.g. WendlandRBF). Each center only interacts with the centers that are within
+ * distance support_radius, therefore the interpolation system is sparse. Gradient rows
+ * are negated to make the system symmetric, and for positive definite kernels it is
+ * also positive definite, hence it can be efficiently solved with the conjugate gradient
+ * method (default), or with a sparse Cholesky factorization. Neighbors are
+ * found with a HashGrid, and both the system assembly and the evaluation at multiple
+ * points run in parallel. This makes it possible to fit hundreds of thousands of oriented
+ * points, which is unfeasible with the dense O(n^3) system used by Hermite_RBF.
+ *
+ * Kernels are defined in [0,1], and distances are rescaled w.r.t. support_radius.
+ * The support radius should be a few times the average sampling density (each point
+ * should see at least 10-20 neighbors). Note that the resulting implicit function
+ * vanishes at distances greater than support_radius from the input points, hence
+ * its zero level set is meaningful only within a narrow band around the samples.
+ *
+ * Typical usage, to extract the reconstructed surface on a (tetrahedral) grid:
+ *
+ *     Hermite_RBF_compact<WendlandRBF> HRBF(points, normals, radius);
+ *     ScalarField f = HRBF.eval(grid.vector_verts());
+ *     f.copy_to_mesh(grid);
+ *     DrawableIsosurface<> iso(grid, 0);
+*/
+
+template<class RBF>
+class Hermite_RBF_compact
+{
+    public:
+
+        Hermite_RBF_compact(const std::vector<vec3d> & points,
+                            const std::vector<vec3d> & normals,
+                            const double               support_radius,
+                            const int                  solver = CONJUGATE_GRADIENT);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate RBF at points plist (in parallel)
+        double      eval     (const vec3d & p) const;                  // evaluate RBF at point p
+        vec3d       eval_grad(const vec3d & p) const;                  // evaluate nabla RBF at point p
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        double support_radius() const { return radius; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        std::vector<double> alpha;  // per center scalar values alpha
+        std::vector<vec3d>  beta;   // per center vector values beta
+        double              radius; // kernel support
+        HashGrid            grid;   // spatial index of the centers
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "RBF_Hermite_compact.cpp"
+#endif
+
+#endif // CINO_RBF_HERMITE_COMPACT_H
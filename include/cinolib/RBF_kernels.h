@@ -36,6 +36,8 @@
 #ifndef CINO_RBF_KERNELS_H
 #define CINO_RBF_KERNELS_H
 
+#include <cmath>
+
 namespace cinolib
 {
 
@@ -47,6 +49,24 @@ class CubicRBF
     static inline double eval_ddf(const double x) { return 6*x;   } // second derivative
 };
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Wendland's C2 kernel, compactly supported in [0,1]. It must be used with
+// Hermite_RBF_compact, which rescales distances w.r.t. the support radius
+//
+//     Piecewise polynomial, positive definite and compactly supported
+//     radial functions of minimal degree
+//     H. Wendland
+//     Advances in Computational Mathematics (1995)
+//
+class WendlandRBF
+{
+    public:
+    static inline double eval_f  (const double x) { return (x<1) ? std::pow(1-x,4)*(4*x+1)     : 0; }
+    static inline double eval_df (const double x) { return (x<1) ? -20*x*std::pow(1-x,3)       : 0; } // first  derivative
+    static inline double eval_ddf(const double x) { return (x<1) ? 20*std::pow(1-x,2)*(4*x-1)  : 0; } // second derivative
+};
+
 }
 
 #endif // CINO_RBF_KERNELS_H
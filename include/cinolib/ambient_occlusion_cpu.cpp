@@ -0,0 +1,278 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/ambient_occlusion_cpu.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/random_generator.h>
+#include <cinolib/pi.h>
+
+namespace cinolib
+{
+
+template<class Mesh>
+CINO_INLINE
+AO_srf_CPU<Mesh>::AO_srf_CPU(const Mesh   & m,
+                             const uint     n_dirs,
+                             const bool     per_vert,
+                             const double   max_dist)
+: per_vert(per_vert)
+, max_dist(max_dist)
+{
+    // index only the visible part of the mesh
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) continue;
+        for(uint i=0; i<m.poly_tessellation(pid).size()/3; ++i)
+        {
+            vec3d v0 = m.vert(m.poly_tessellation(pid).at(3*i+0));
+            vec3d v1 = m.vert(m.poly_tessellation(pid).at(3*i+1));
+            vec3d v2 = m.vert(m.poly_tessellation(pid).at(3*i+2));
+            octree.push_triangle(pid, {v0,v1,v2});
+        }
+    }
+    octree.build();
+
+    // ray origins are slightly offset along the normal to avoid self hits
+    eps = m.bbox().diag()*1e-5;
+
+    uint size = (per_vert) ? m.num_verts() : m.num_polys();
+    ao.resize(size, 1.0);
+    n_samples.resize(size, 0);
+
+    refine(m, n_dirs);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AO_srf_CPU<Mesh>::refine(const Mesh & m, const uint n_dirs)
+{
+    if(octree.items.empty() || n_dirs==0) return;
+
+    PARALLEL_FOR(0, ao.size(), 100, [&](uint id)
+    {
+        vec3d p, n;
+        if(per_vert)
+        {
+            if(!m.vert_is_visible(id)) return;
+            p = m.vert(id);
+            n = m.vert_data(id).normal;
+        }
+        else
+        {
+            if(m.poly_data(id).flags[HIDDEN]) return;
+            p = m.poly_centroid(id);
+            n = m.poly_data(id).normal;
+        }
+        if(n.length_squared()==0) return;
+
+        uint hits = AO_unoccluded_rays(octree, p + n*eps, n, id, n_samples.at(id), n_dirs, max_dist);
+        ao.at(id) = (ao.at(id)*n_samples.at(id) + hits)/double(n_samples.at(id) + n_dirs);
+        n_samples.at(id) += n_dirs;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AO_srf_CPU<Mesh>::copy_to_mesh(Mesh & m) const
+{
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN])
+        {
+            m.poly_data(pid).AO = 1.0;
+        }
+        else if(per_vert)
+        {
+            double avg = 0.0;
+            for(uint vid : m.adj_p2v(pid)) avg += ao.at(vid);
+            m.poly_data(pid).AO = avg/m.verts_per_poly(pid);
+        }
+        else m.poly_data(pid).AO = ao.at(pid);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+AO_vol_CPU<Mesh>::AO_vol_CPU(const Mesh   & m,
+                             const uint     n_dirs,
+                             const bool     per_vert,
+                             const double   max_dist)
+: per_vert(per_vert)
+, max_dist(max_dist)
+{
+    // index only the faces exposed on the surface of the visible part of the mesh
+    std::vector<bool> f_visible(m.num_faces(), false);
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        uint pid_beneath;
+        if(!m.face_is_visible(fid, pid_beneath)) continue;
+        f_visible.at(fid) = true;
+        std::vector<uint> tris = m.face_tessellation(fid);
+        for(uint i=0; i<tris.size()/3; ++i)
+        {
+            octree.push_triangle(fid, {m.vert(tris.at(3*i+0)),
+                                       m.vert(tris.at(3*i+1)),
+                                       m.vert(tris.at(3*i+2))});
+        }
+    }
+    octree.build();
+
+    // ray origins are slightly offset along the normal to avoid self hits
+    eps = m.bbox().diag()*1e-5;
+
+    if(per_vert)
+    {
+        visible.resize(m.num_verts(), false);
+        for(uint vid=0; vid<m.num_verts(); ++vid)
+        {
+            for(uint fid : m.adj_v2f(vid)) if(f_visible.at(fid)) visible.at(vid) = true;
+        }
+    }
+    else visible = f_visible;
+
+    ao.resize(visible.size(), 1.0);
+    n_samples.resize(visible.size(), 0);
+
+    refine(m, n_dirs);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AO_vol_CPU<Mesh>::refine(const Mesh & m, const uint n_dirs)
+{
+    if(octree.items.empty() || n_dirs==0) return;
+
+    PARALLEL_FOR(0, ao.size(), 100, [&](uint id)
+    {
+        if(!visible.at(id)) return;
+
+        vec3d p, n(0,0,0);
+        uint  pid_beneath;
+        if(per_vert)
+        {
+            p = m.vert(id);
+            for(uint fid : m.adj_v2f(id))
+            {
+                if(m.face_is_visible(fid, pid_beneath)) n += m.poly_face_normal(pid_beneath, fid);
+            }
+            if(n.length_squared()==0) return;
+            n.normalize();
+        }
+        else
+        {
+            m.face_is_visible(id, pid_beneath);
+            p = m.face_centroid(id);
+            n = m.poly_face_normal(pid_beneath, id);
+        }
+
+        uint hits = AO_unoccluded_rays(octree, p + n*eps, n, id, n_samples.at(id), n_dirs, max_dist);
+        ao.at(id) = (ao.at(id)*n_samples.at(id) + hits)/double(n_samples.at(id) + n_dirs);
+        n_samples.at(id) += n_dirs;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AO_vol_CPU<Mesh>::copy_to_mesh(Mesh & m) const
+{
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        if(per_vert)
+        {
+            double avg = 0.0;
+            for(uint vid : m.adj_f2v(fid)) avg += ao.at(vid);
+            m.face_data(fid).AO = avg/m.verts_per_face(fid);
+        }
+        else m.face_data(fid).AO = (visible.at(fid)) ? ao.at(fid) : 1.0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint AO_unoccluded_rays(const Octree & octree,
+                        const vec3d  & p,
+                        const vec3d  & n,
+                        const uint     seed,
+                        const uint     first,
+                        const uint     n_dirs,
+                        const double   max_dist)
+{
+    if(n_dirs==0) return 0;
+
+    // local frame (u,v,n)
+    vec3d u = (std::fabs(n.x())>0.9) ? vec3d(0,1,0) : vec3d(1,0,0);
+    u = n.cross(u);
+    u.normalize();
+    vec3d v = n.cross(u);
+
+    // split the unit square in k1 x k2 strata (k1*k2 = n_dirs, with k1 the largest divisor
+    // of n_dirs not exceeding its square root), and jitter one sample inside each of them.
+    // Strata always tile the whole square, hence the estimator is unbiased for any n_dirs.
+    // Using Malley's method, samples are then lifted from the unit disk to the hemisphere,
+    // obtaining a cosine weighted distribution of directions (i.e. each unoccluded ray
+    // has the same weight)
+    uint k1 = std::floor(std::sqrt(double(n_dirs)));
+    while(k1>1 && n_dirs%k1!=0) --k1;
+    uint k2    = n_dirs/k1;
+    uint count = 0;
+    RandomStream rs(seed);
+    for(uint i=0; i<n_dirs; ++i)
+    {
+        uint64_t s   = first + i;
+        double   u1  = ((i%k1) + rs.double_at(2*s  ))/double(k1);
+        double   u2  = ((i/k1) + rs.double_at(2*s+1))/double(k2);
+        double   r   = std::sqrt(u1);
+        double   phi = 2.0*M_PI*u2;
+        vec3d    dir = u*(r*std::cos(phi)) + v*(r*std::sin(phi)) + n*std::sqrt(std::max(0.0, 1.0-u1));
+
+        double t;
+        uint   id;
+        if(!octree.intersects_ray(p, dir, t, id) || t>max_dist) ++count;
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,135 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_AMBIENT_OCCLUSION_CPU_H
+#define CINO_AMBIENT_OCCLUSION_CPU_H
+
+#include <cinolib/octree.h>
+
+namespace cinolib
+{
+
+/* Headless counterpart of AO_srf and AO_vol. Instead of rendering the mesh on an
+ * offscreen buffer, visibility is tested by casting rays against an Octree built
+ * on the (visible part of the) mesh surface. Each sample point (a poly/face centroid,
+ * or a vertex if per_vert is true) shoots n_dirs rays over its hemisphere, using a
+ * jittered stratified cosine-weighted distribution. Occlusion can therefore be
+ * computed without Qt or an OpenGL context (e.g. in batch jobs). Samples are
+ * processed in parallel, and are fully deterministic regardless of the number of
+ * threads used.
+ *
+ * AO values are in [0,1], where 1 means fully visible. Progressive refinement is
+ * supported: each call to refine(m,n_dirs) shoots n_dirs more rays per sample,
+ * improving the estimate without throwing away previous results.
+ *
+ * max_dist bounds the length of the rays (i.e. only occluders closer than max_dist
+ * count). Use inf_double for the classical, unbounded, ambient occlusion.
+*/
+
+template<class Mesh>
+class AO_srf_CPU
+{
+    public:
+
+        explicit AO_srf_CPU(const Mesh   & m,
+                            const uint     n_dirs   = 256,
+                            const bool     per_vert = false,
+                            const double   max_dist = inf_double);
+
+        void refine(const Mesh & m, const uint n_dirs);
+        void copy_to_mesh(Mesh & m) const;
+
+        const std::vector<double> & AO_values() const { return ao; }
+
+    protected:
+
+        Octree              octree;
+        bool                per_vert;
+        double              max_dist;
+        double              eps;
+        std::vector<double> ao;        // per poly (or per vert) AO value
+        std::vector<uint>   n_samples; // number of rays shot so far
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+class AO_vol_CPU
+{
+    public:
+
+        explicit AO_vol_CPU(const Mesh   & m,
+                            const uint     n_dirs   = 256,
+                            const bool     per_vert = false,
+                            const double   max_dist = inf_double);
+
+        void refine(const Mesh & m, const uint n_dirs);
+        void copy_to_mesh(Mesh & m) const;
+
+        const std::vector<double> & AO_values() const { return ao; }
+
+    protected:
+
+        Octree              octree;
+        bool                per_vert;
+        double              max_dist;
+        double              eps;
+        std::vector<bool>   visible;   // per face (or per vert) visibility w.r.t. HIDDEN flags
+        std::vector<double> ao;        // per face (or per vert) AO value
+        std::vector<uint>   n_samples; // number of rays shot so far
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// shoots n_dirs rays over the hemisphere centered at p and oriented as n, and returns
+// the number of rays that do not hit the octree within max_dist. The sequence of
+// directions depends only on the seed and on the index of the first ray (first),
+// which allows to progressively refine the estimation in a repeatable manner
+CINO_INLINE
+uint AO_unoccluded_rays(const Octree & octree,
+                        const vec3d  & p,
+                        const vec3d  & n,
+                        const uint     seed,
+                        const uint     first,
+                        const uint     n_dirs,
+                        const double   max_dist);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "ambient_occlusion_cpu.cpp"
+#endif
+
+#endif // CINO_AMBIENT_OCCLUSION_CPU_H
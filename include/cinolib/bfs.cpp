@@ -36,7 +36,12 @@
 #include <cinolib/bfs.h>
 //
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <queue>
+#include <stdint.h>
 
 namespace cinolib
 {
@@ -265,4 +270,248 @@ void bfs_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Core of all the bfs_levels variants. The graph has n_nodes nodes, and is implicitly
+ * defined by two functions: arcs(node) returns the list of arcs leaving node (e.g. its
+ * adjacent vertices, or its faces), and head(node,arc) returns the node reached through
+ * an arc, or -1 if the arc is a barrier. Nodes flagged in mask (if not empty) are never
+ * visited.
+ *
+ * Switching between top-down and bottom-up follows Beamer et al. "Direction-Optimizing
+ * Breadth-First Search" (SC 2012), with node counts in place of edge counts: go bottom-up
+ * when the frontier is bigger than 1/14 of the unvisited nodes, and get back to top-down
+ * when it becomes smaller than 1/24 of the graph.
+*/
+template<class Arcs, class Head>
+CINO_INLINE
+void bfs_levels(const uint                n_nodes,
+                const uint                source,
+                const std::vector<bool> & mask,
+                const Arcs              & arcs,
+                const Head              & head,
+                      std::vector<int>  & dist)
+{
+    dist.assign(n_nodes, -1);
+    dist.at(source) = 0;
+
+    uint n_words = (n_nodes + 63)/64;
+    std::vector<std::atomic<uint64_t>> visited(n_words);
+    std::vector<std::atomic<uint64_t>> next_bits(n_words);
+    std::vector<uint64_t>              front_bits(n_words);
+    std::vector<uint>                  word_count(n_words);
+
+    // masked nodes (and the padding of the last word) are flagged as already visited
+    PARALLEL_FOR(0, n_words, 10000, [&](uint w)
+    {
+        uint64_t bits = 0;
+        uint     beg  = w*64;
+        uint     end  = std::min(beg+64, n_nodes);
+        if(!mask.empty())
+        {
+            for(uint i=beg; i<end; ++i) if(mask[i]) bits |= uint64_t(1) << (i-beg);
+        }
+        if(end-beg<64) bits |= ~uint64_t(0) << (end-beg);
+        visited[w].store(bits, std::memory_order_relaxed);
+        next_bits[w].store(0, std::memory_order_relaxed);
+        word_count[w] = 64 - std::bitset<64>(bits).count();
+    });
+    visited[source/64].fetch_or(uint64_t(1) << (source%64), std::memory_order_relaxed);
+
+    uint n_unvisited = 0;
+    for(uint c : word_count) n_unvisited += c;
+    n_unvisited -= (mask.empty() || !mask[source]) ? 1 : 0;
+
+    // marks nbr as visited, and returns true if it wasn't already
+    auto claim = [&](const uint nbr) -> bool
+    {
+        uint64_t bit = uint64_t(1) << (nbr%64);
+        if(visited[nbr/64].load(std::memory_order_relaxed) & bit) return false;
+        return !(visited[nbr/64].fetch_or(bit, std::memory_order_relaxed) & bit);
+    };
+
+    // converts next_bits into a sorted list of nodes (and clears it)
+    auto extract_next = [&](std::vector<uint> & next)
+    {
+        PARALLEL_FOR(0, n_words, 10000, [&](uint w)
+        {
+            word_count[w] = std::bitset<64>(next_bits[w].load(std::memory_order_relaxed)).count();
+        });
+        PARALLEL_PREFIX_SUM(word_count, 10000);
+        next.resize(word_count.back());
+        PARALLEL_FOR(0, n_words, 10000, [&](uint w)
+        {
+            uint64_t bits = next_bits[w].load(std::memory_order_relaxed);
+            if(bits==0) return;
+            uint pos = (w>0) ? word_count[w-1] : 0;
+            for(uint b=0; b<64; ++b) if((bits >> b) & 1) next[pos++] = w*64+b;
+            next_bits[w].store(0, std::memory_order_relaxed);
+        });
+    };
+
+    std::vector<uint> frontier(1, source);
+    std::vector<uint> next;
+    bool bottom_up = false;
+    int  level     = 0;
+
+    while(!frontier.empty())
+    {
+        n_unvisited -= (level>0) ? frontier.size() : 0;
+        bottom_up = bottom_up ? (frontier.size()*24 >= n_nodes)
+                              : (frontier.size() >= 1024 && frontier.size()*14 > n_unvisited);
+        ++level;
+
+        if(bottom_up)
+        {
+            std::fill(front_bits.begin(), front_bits.end(), uint64_t(0));
+            for(uint node : frontier) front_bits[node/64] |= uint64_t(1) << (node%64);
+
+            // each word of the bitmaps is owned by a single thread
+            PARALLEL_FOR(0, n_words, 1000, [&](uint w)
+            {
+                uint64_t todo  = ~visited[w].load(std::memory_order_relaxed);
+                uint64_t found = 0;
+                for(uint b=0; todo!=0 && b<64; ++b)
+                {
+                    if(!((todo >> b) & 1)) continue;
+                    todo &= ~(uint64_t(1) << b);
+                    uint node = w*64+b;
+                    for(uint arc : arcs(node))
+                    {
+                        int nbr = head(node,arc);
+                        if(nbr>=0 && ((front_bits[nbr/64] >> (nbr%64)) & 1))
+                        {
+                            found |= uint64_t(1) << b;
+                            break;
+                        }
+                    }
+                }
+                if(found==0) return;
+                visited[w].fetch_or(found, std::memory_order_relaxed);
+                next_bits[w].store(found, std::memory_order_relaxed);
+                for(uint b=0; b<64; ++b) if((found >> b) & 1) dist[w*64+b] = level;
+            });
+            extract_next(next);
+        }
+        else if(frontier.size() < 1024)
+        {
+            next.clear();
+            for(uint node : frontier)
+            for(uint arc  : arcs(node))
+            {
+                int nbr = head(node,arc);
+                if(nbr>=0 && claim(nbr))
+                {
+                    dist[nbr] = level;
+                    next.push_back(nbr);
+                }
+            }
+        }
+        else
+        {
+            PARALLEL_FOR(0, frontier.size(), 256, [&](uint i)
+            {
+                for(uint arc : arcs(frontier[i]))
+                {
+                    int nbr = head(frontier[i],arc);
+                    if(nbr>=0 && claim(nbr))
+                    {
+                        dist[nbr] = level;
+                        next_bits[nbr/64].fetch_or(uint64_t(1) << (nbr%64), std::memory_order_relaxed);
+                    }
+                }
+            });
+            extract_next(next);
+        }
+        frontier.swap(next);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void bfs_levels(const std::vector<std::vector<uint>> & nodes_adjacency,
+                const uint                             source,
+                      std::vector<int>               & dist)
+{
+    bfs_levels(nodes_adjacency.size(), source, std::vector<bool>(),
+               [&](const uint node) -> const std::vector<uint> & { return nodes_adjacency.at(node); },
+               [&](const uint, const uint nbr) -> int { return nbr; }, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels(const AbstractMesh<M,V,E,P> & m,
+                const uint                    source,
+                      std::vector<int>      & dist)
+{
+    bfs_levels(m.num_verts(), source, std::vector<bool>(),
+               [&](const uint vid) -> const std::vector<uint> & { return m.adj_v2v(vid); },
+               [&](const uint, const uint nbr) -> int { return nbr; }, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels(const AbstractMesh<M,V,E,P> & m,
+                const uint                    source,
+                const std::vector<bool>     & mask, // if mask[vid] = true, path cannot pass through vertex vid
+                      std::vector<int>      & dist)
+{
+    bfs_levels(m.num_verts(), source, mask,
+               [&](const uint vid) -> const std::vector<uint> & { return m.adj_v2v(vid); },
+               [&](const uint, const uint nbr) -> int { return nbr; }, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels_on_dual(const AbstractMesh<M,V,E,P> & m,
+                        const uint                    source,
+                        const std::vector<bool>     & mask, // if mask[p] = true, bfs cannot visit polygon/polyhedron p
+                              std::vector<int>      & dist)
+{
+    bfs_levels(m.num_polys(), source, mask,
+               [&](const uint pid) -> const std::vector<uint> & { return m.adj_p2p(pid); },
+               [&](const uint, const uint nbr) -> int { return nbr; }, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                        const uint                           source,
+                                        const std::vector<bool>            & mask_edges, // if mask[e] = true, bfs cannot expand through edge e
+                                              std::vector<int>             & dist)
+{
+    bfs_levels(m.num_polys(), source, std::vector<bool>(),
+               [&](const uint pid) -> const std::vector<uint> & { return m.adj_p2p(pid); },
+               [&](const uint pid, const uint nbr) -> int
+               {
+                   return mask_edges.at(m.edge_shared(pid,nbr)) ? -1 : int(nbr);
+               }, dist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void bfs_levels_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                        const uint                                source,
+                                        const std::vector<bool>                 & mask_faces, // if mask[f] = true, bfs cannot expand through face f
+                                              std::vector<int>                  & dist)
+{
+    bfs_levels(m.num_polys(), source, std::vector<bool>(),
+               [&](const uint pid) -> const std::vector<uint> & { return m.adj_p2f(pid); },
+               [&](const uint pid, const uint fid) -> int
+               {
+                   return mask_faces.at(fid) ? -1 : m.poly_adj_through_face(pid,fid);
+               }, dist);
+}
+
 }
@@ -114,6 +114,78 @@ void bfs_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                                  const uint                                source,
                                  const std::vector<bool>                 & mask_faces, // if mask[f] = true, bfs cannot expand through face f
                                  std::unordered_set<uint>                & visited);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* The functions below implement a parallel, level synchronous BFS, and return
+ * the BFS level (i.e. the number of hops from the source) of each node as a flat
+ * array, with -1 for nodes that cannot be reached. Each level is expanded either
+ * top-down (the frontier claims its unvisited neighbors) or bottom-up (unvisited
+ * nodes search for a neighbor in the frontier), depending on the frontier size.
+ * Frontiers and visited nodes are stored as bitmaps, so memory usage is linear
+ * and tiny compared to hash sets, even when the whole graph is visited.
+ *
+ * NOTE: the bottom-up step assumes symmetric adjacency (and barriers).
+*/
+
+// general graphs (i.e. not meshes)
+//
+CINO_INLINE
+void bfs_levels(const std::vector<std::vector<uint>> & nodes_adjacency,
+                const uint                             source,
+                      std::vector<int>               & dist);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels(const AbstractMesh<M,V,E,P> & m,
+                const uint                    source,
+                      std::vector<int>      & dist);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// with vertex barriers
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels(const AbstractMesh<M,V,E,P> & m,
+                const uint                    source,
+                const std::vector<bool>     & mask, // if mask[vid] = true, path cannot pass through vertex vid
+                      std::vector<int>      & dist);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on the dual mesh (polygons/polyhedra instead of vertices)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels_on_dual(const AbstractMesh<M,V,E,P> & m,
+                        const uint                    source,
+                        const std::vector<bool>     & mask, // if mask[p] = true, bfs cannot visit polygon/polyhedron p
+                              std::vector<int>      & dist);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on the dual mesh (with barriers on edges)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void bfs_levels_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                        const uint                           source,
+                                        const std::vector<bool>            & mask_edges, // if mask[e] = true, bfs cannot expand through edge e
+                                              std::vector<int>             & dist);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on the dual mesh (with barriers on faces)
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void bfs_levels_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                        const uint                                source,
+                                        const std::vector<bool>                 & mask_faces, // if mask[f] = true, bfs cannot expand through face f
+                                              std::vector<int>                  & dist);
 }
 
 #ifndef  CINO_STATIC_LIB
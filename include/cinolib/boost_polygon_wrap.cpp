@@ -163,6 +163,17 @@ BoostMultiPolygon polygon_intersection(const Poly0 & p0, const Poly1 & p1)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<typename Poly0, typename Poly1>
+CINO_INLINE
+BoostMultiPolygon polygon_symmetric_difference(const Poly0 & p0, const Poly1 & p1)
+{
+    BoostMultiPolygon res;
+    boost::geometry::sym_difference(p0, p1, res);
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void polygon_get_edges(const std::vector<BoostPoint> & poly,
                              std::vector<vec2d>      & verts,
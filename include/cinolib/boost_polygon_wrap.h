@@ -111,6 +111,12 @@ namespace cinolib
 
     //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+    template<typename Poly0, typename Poly1>
+    CINO_INLINE
+    BoostMultiPolygon polygon_symmetric_difference(const Poly0 & p0, const Poly1 & p1);
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
     CINO_INLINE
     void polygon_get_edges(const std::vector<BoostPoint> & poly,
                                  std::vector<vec2d>      & verts,
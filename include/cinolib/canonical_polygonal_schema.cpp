@@ -68,11 +68,13 @@ void canonical_polygonal_schema(      Trimesh<M,V,E,P>  & m_in,
             m_in.vert_data(vid).label = lid;
         }
     }
-    std::unordered_map<uint,std::vector<uint>> v_map;
+    uint nv = m_in.num_verts();
+    std::vector<uint> v_map;
     cut_mesh_along_marked_edges(m_in, v_map);
 
     // detect all the 4g copies of the basis' root
-    std::vector<uint> copies_of_root = v_map.at(basis.root);
+    std::vector<uint> copies_of_root;
+    for(uint i=0; i<v_map.size(); ++i) if(v_map[i]==basis.root) copies_of_root.push_back(nv+i);
     copies_of_root.push_back(basis.root);
     assert(!copies_of_root.empty());
     m_in.vert_set_flag(MARKED,false);
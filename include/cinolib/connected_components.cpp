@@ -34,7 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/connected_components.h>
-#include <cinolib/bfs.h>
+#include <cinolib/union_find.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -43,8 +44,8 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m)
 {
-    std::vector<std::unordered_set<uint>> ccs;
-    return connected_components(m, ccs);
+    std::vector<int> labels;
+    return connected_components(m, labels);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -54,24 +55,117 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs)
 {
+    std::vector<int> labels;
+    uint n_ccs = connected_components(m, labels);
+
     ccs.clear();
-    uint seed = 0;
-    std::vector<bool> visited(m.num_verts(), false);
+    ccs.resize(n_ccs);
+    for(uint vid=0; vid<m.num_verts(); ++vid) ccs.at(labels.at(vid)).insert(vid);
+
+    return n_ccs;
+}
 
-    do
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint connected_components(const std::vector<std::vector<uint>> & nodes_adjacency,
+                          std::vector<int>                     & labels)
+{
+    UnionFind uf(nodes_adjacency.size());
+    PARALLEL_FOR(0, nodes_adjacency.size(), 1000, [&](uint i)
     {
-        std::unordered_set<uint> cc;
-        bfs(m, seed, cc);
+        for(uint j : nodes_adjacency.at(i)) uf.merge(i,j);
+    });
+    return uf.labels(labels);
+}
 
-        ccs.push_back(cc);
-        for(uint vid : cc) visited.at(vid) = true;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        seed = 0;
-        while (seed < num_verts() && visited.at(seed)) ++seed;
-    }
-    while (seed < m.num_verts());
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          std::vector<int>            & labels)
+{
+    UnionFind uf(m.num_verts());
+    PARALLEL_FOR(0, m.num_edges(), 1000, [&](uint eid)
+    {
+        uf.merge(m.edge_vert_id(eid,0), m.edge_vert_id(eid,1));
+    });
+    return uf.labels(labels);
+}
 
-    return ccs.size();
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          const std::vector<bool>     & mask,
+                          std::vector<int>            & labels)
+{
+    UnionFind uf(m.num_verts());
+    PARALLEL_FOR(0, m.num_edges(), 1000, [&](uint eid)
+    {
+        uint v0 = m.edge_vert_id(eid,0);
+        uint v1 = m.edge_vert_id(eid,1);
+        if(!mask.at(v0) && !mask.at(v1)) uf.merge(v0,v1);
+    });
+    return uf.labels(labels, mask);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                  const std::vector<bool>     & mask,
+                                  std::vector<int>            & labels)
+{
+    UnionFind uf(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        if(mask.at(pid)) return;
+        for(uint nbr : m.adj_p2p(pid))
+        {
+            if(nbr>pid && !mask.at(nbr)) uf.merge(pid,nbr);
+        }
+    });
+    return uf.labels(labels, mask);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                  const std::vector<bool>            & mask_edges,
+                                                  std::vector<int>                   & labels)
+{
+    UnionFind uf(m.num_polys());
+    PARALLEL_FOR(0, m.num_edges(), 1000, [&](uint eid)
+    {
+        if(mask_edges.at(eid)) return;
+        const std::vector<uint> & polys = m.adj_e2p(eid);
+        for(uint i=1; i<polys.size(); ++i) uf.merge(polys.front(), polys.at(i));
+    });
+    return uf.labels(labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                                  const std::vector<bool>                 & mask_faces,
+                                                  std::vector<int>                        & labels)
+{
+    UnionFind uf(m.num_polys());
+    PARALLEL_FOR(0, m.num_faces(), 1000, [&](uint fid)
+    {
+        if(mask_faces.at(fid)) return;
+        const std::vector<uint> & polys = m.adj_f2p(fid);
+        if(polys.size()==2) uf.merge(polys.front(), polys.back());
+    });
+    return uf.labels(labels);
 }
 
 }
@@ -37,9 +37,10 @@
 #define CINO_CONNECTED_COMPONENTS_H
 
 #include <vector>
+#include <unordered_set>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
-#include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/meshes/meshes.h>
 
 namespace cinolib
 {
@@ -55,6 +56,69 @@ CINO_INLINE
 uint connected_components(const AbstractMesh<M,V,E,P> & m,
                           std::vector<std::unordered_set<uint>> & ccs);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* The functions below compute connected components with a parallel, lock-free
+ * union-find over the arcs of the graph (see union_find.h), and return them as
+ * a flat array of labels: labels[i] is the component of node i, in [0,#ccs).
+ * Components are numbered in order of their lowest node id. Masked nodes are
+ * not part of any component, and get label -1. The number of components is
+ * returned.
+*/
+
+// general graphs (i.e. not meshes)
+//
+CINO_INLINE
+uint connected_components(const std::vector<std::vector<uint>> & nodes_adjacency,
+                          std::vector<int>                     & labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          std::vector<int>            & labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// with vertex barriers
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components(const AbstractMesh<M,V,E,P> & m,
+                          const std::vector<bool>     & mask, // if mask[vid] = true, vid is excluded from the graph
+                          std::vector<int>            & labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on the dual mesh (labels are per polygon/polyhedron)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual(const AbstractMesh<M,V,E,P> & m,
+                                  const std::vector<bool>     & mask, // if mask[pid] = true, pid is excluded from the graph
+                                  std::vector<int>            & labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on the dual mesh, with barriers on edges
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_edge_barriers(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                  const std::vector<bool>            & mask_edges, // if mask[e] = true, polys cannot connect through edge e
+                                                  std::vector<int>                   & labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on the dual mesh, with barriers on faces
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint connected_components_on_dual_w_face_barriers(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                                  const std::vector<bool>                 & mask_faces, // if mask[f] = true, polys cannot connect through face f
+                                                  std::vector<int>                        & labels);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,56 +34,179 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/cut_mesh.h>
+#include <cinolib/stl_container_utilities.h>
+#include <algorithm>
 
 namespace cinolib
 {
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P> & m)
+void cut_mesh_along_edges(AbstractPolygonMesh<M,V,E,P> & m,
+                          const std::vector<uint>      & eids,
+                          std::vector<uint>            & v_map)
 {
-    std::unordered_map<uint,std::vector<uint>> v_map;
-    cut_mesh_along_marked_edges(m, v_map);
-}
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
-template<class M, class V, class E, class P>
-CINO_INLINE
-void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P>               & m,
-                                 std::unordered_map<uint,std::vector<uint>> & v_map)
-{
-    m.vert_set_flag(MARKED,false);
     v_map.clear();
-
     uint nv = m.num_verts();
-    for(uint vid=0; vid<nv; ++vid)
-    {
-        assert(nv<=m.num_verts());
 
-        if(m.vert_data(vid).flags[MARKED]) continue;
-        m.vert_data(vid).flags[MARKED] = true;
+    std::vector<uint> cut = eids;
+    std::sort(cut.begin(), cut.end());
+    cut.erase(std::unique(cut.begin(), cut.end()), cut.end());
 
-        std::vector<std::vector<uint>> clusters;
-        m.vert_cluster_one_ring(vid, clusters, true);
+    std::vector<uint> cut_verts;
+    for(uint eid : cut)
+    {
+        cut_verts.push_back(m.edge_vert_id(eid,0));
+        cut_verts.push_back(m.edge_vert_id(eid,1));
+    }
+    REMOVE_DUPLICATES_FROM_VEC(cut_verts);
+
+    for(uint vid : cut_verts)
+    {
+        // 1) cluster the polys incident to vid, using boundary and cut edges as barriers
+        std::vector<uint> star = m.adj_v2p(vid);
+        std::vector<int>  cluster(star.size(), -1);
+        int n_clusters = 0;
+        for(uint i=0; i<star.size(); ++i)
+        {
+            if(cluster[i]>=0) continue;
+            cluster[i] = n_clusters;
+            std::vector<uint> q(1,star[i]);
+            while(!q.empty())
+            {
+                uint pid = q.back();
+                q.pop_back();
+                for(uint eid : m.adj_p2e(pid))
+                {
+                    if(!m.edge_contains_vert(eid,vid)) continue;
+                    if(std::binary_search(cut.begin(), cut.end(), eid)) continue;
+                    for(uint nbr : m.adj_e2p(eid))
+                    {
+                        uint j = std::find(star.begin(), star.end(), nbr) - star.begin();
+                        if(cluster[j]>=0) continue;
+                        cluster[j] = n_clusters;
+                        q.push_back(nbr);
+                    }
+                }
+            }
+            ++n_clusters;
+        }
+        if(n_clusters<2) continue;
 
-        std::vector<uint> to_remove;
-        for(uint i=1; i<clusters.size(); ++i)
+        // 2) the first cluster keeps vid, the others get a copy of it
+        std::vector<uint> c2v(1,vid);
+        for(int c=1; c<n_clusters; ++c)
         {
             uint new_vid = m.vert_add(m.vert(vid));
             m.vert_data(new_vid) = m.vert_data(vid);
-            v_map[vid].push_back(new_vid);
+            c2v.push_back(new_vid);
+            v_map.push_back(vid);
+        }
+        m.adj_v2p(vid).clear();
+        for(uint i=0; i<star.size(); ++i)
+        {
+            uint new_vid = c2v[cluster[i]];
+            m.adj_v2p(new_vid).push_back(star[i]);
+            if(new_vid==vid) continue;
+            for(uint & id : m.adj_p2v(star[i])) if(id==vid) id = new_vid;
+            m.update_p_tessellation(star[i]);
+        }
+
+        // 3) edges incident to vid are split according to the clusters of their polys.
+        //    The group of the first poly keeps the edge, the others get a copy of it
+        std::vector<uint> e_star = m.adj_v2e(vid);
+        for(uint eid : e_star)
+        {
+            if(m.adj_e2p(eid).empty()) continue;
+            uint off = (m.edge_vert_id(eid,0)==vid) ? 0 : 1;
+            uint opp = m.edge_vert_id(eid,1-off);
 
-            for(uint pid : clusters.at(i))
+            std::vector<std::vector<uint>> groups(n_clusters);
+            for(uint pid : m.adj_e2p(eid))
             {
-                auto verts = m.poly_verts_id(pid);
-                for(uint & id : verts) if(id==vid) id = new_vid;
-                m.poly_add(verts);
-                to_remove.push_back(pid);
+                uint i = std::find(star.begin(), star.end(), pid) - star.begin();
+                groups[cluster[i]].push_back(pid);
+            }
+            int first = cluster[std::find(star.begin(), star.end(), m.adj_e2p(eid).front()) - star.begin()];
+
+            if(first>0)
+            {
+                uint new_vid = c2v[first];
+                m.vector_edges()[2*eid+off] = new_vid;
+                REMOVE_FROM_VEC(m.adj_v2e(vid), eid);
+                REMOVE_FROM_VEC(m.adj_v2v(vid), opp);
+                REMOVE_FROM_VEC(m.adj_v2v(opp), vid);
+                m.adj_v2e(new_vid).push_back(eid);
+                m.adj_v2v(new_vid).push_back(opp);
+                m.adj_v2v(opp).push_back(new_vid);
+            }
+            m.adj_e2p(eid) = groups[first];
+
+            for(int c=0; c<n_clusters; ++c)
+            {
+                if(c==first || groups[c].empty()) continue;
+                uint new_eid = m.edge_add(c2v[c], opp);
+                m.edge_data(new_eid) = m.edge_data(eid);
+                m.adj_e2p(new_eid) = groups[c];
+                for(uint pid : groups[c])
+                {
+                    for(uint & id : m.adj_p2e(pid)) if(id==eid) id = new_eid;
+                }
+            }
+        }
+
+        // 4) poly adjacencies can only change within the star of vid
+        for(uint pid : star)
+        {
+            m.adj_p2p(pid).clear();
+            for(uint eid : m.adj_p2e(pid))
+            for(uint nbr : m.adj_e2p(eid))
+            {
+                if(nbr!=pid && DOES_NOT_CONTAIN_VEC(m.adj_p2p(pid),nbr)) m.adj_p2p(pid).push_back(nbr);
             }
         }
-        if(!to_remove.empty()) m.polys_remove(to_remove);
     }
+    assert(m.num_verts()==nv+v_map.size());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P> & m)
+{
+    std::vector<uint> v_map;
+    cut_mesh_along_marked_edges(m, v_map);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P> & m,
+                                 std::vector<uint>            & v_map)
+{
+    std::vector<uint> eids;
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        if(m.edge_data(eid).flags[MARKED]) eids.push_back(eid);
+    }
+    cut_mesh_along_edges(m, eids, v_map);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P>               & m,
+                                 std::unordered_map<uint,std::vector<uint>> & v_map)
+{
+    uint nv = m.num_verts();
+    std::vector<uint> flat_map;
+    cut_mesh_along_marked_edges(m, flat_map);
+
+    v_map.clear();
+    for(uint i=0; i<flat_map.size(); ++i) v_map[flat_map[i]].push_back(nv+i);
 }
 
 }
@@ -42,12 +42,39 @@
 namespace cinolib
 {
 
+/* Cuts the mesh open along a set of edges, duplicating the vertices around them.
+ * Cutting is done in place: only vertices incident to the cut get duplicated,
+ * and only their one rings are rewired (polygon vertex lists and v2v, v2e,
+ * v2p, e2p, p2e, p2p adjacencies), so the cost is proportional to the length
+ * of the cut rather than to the size of the mesh. Existing vertex, edge and
+ * polygon ids are preserved; new vertices and edges are appended at the end.
+ *
+ * The vertex map is a flat array: new vertex nv+i (where nv is the number of
+ * vertices before cutting) is a copy of vertex v_map[i].
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cut_mesh_along_edges(AbstractPolygonMesh<M,V,E,P> & m,
+                          const std::vector<uint>      & eids,
+                          std::vector<uint>            & v_map);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P> & m);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P> & m,
+                                 std::vector<uint>            & v_map);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// v_map[vid] lists all the copies of vertex vid
 template<class M, class V, class E, class P>
 CINO_INLINE
 void cut_mesh_along_marked_edges(AbstractPolygonMesh<M,V,E,P>               & m,
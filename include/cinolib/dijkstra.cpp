@@ -69,7 +69,7 @@ void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
                          const uint                    source,
                                std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
+    dist.assign(m.num_verts(), inf_double); // reuses the memory of dist, if any
     dist.at(source) = 0.0;
 
     std::set<std::pair<double,uint>> q;
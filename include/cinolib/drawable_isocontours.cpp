@@ -0,0 +1,133 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/drawable_isocontours.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+DrawableIsocontours<M,V,E,P>::DrawableIsocontours() : Isocontours<M,V,E,P>()
+{
+    color          = Color::RED();
+    color_by_level = false;
+    thickness      = 1.0;
+    updateGL();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+DrawableIsocontours<M,V,E,P>::DrawableIsocontours(const AbstractPolygonMesh<M,V,E,P> & m, const std::vector<double> & iso_values)
+    : Isocontours<M,V,E,P>(m, iso_values)
+{
+    color          = Color::RED();
+    color_by_level = false;
+    thickness      = 1.0;
+    updateGL();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+DrawableIsocontours<M,V,E,P>::DrawableIsocontours(const AbstractPolygonMesh<M,V,E,P> & m, const uint n_levels)
+    : Isocontours<M,V,E,P>(m, n_levels)
+{
+    color          = Color::RED();
+    color_by_level = false;
+    thickness      = 1.0;
+    updateGL();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void DrawableIsocontours<M,V,E,P>::draw(const float) const
+{
+    render(drawlist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void DrawableIsocontours<M,V,E,P>::updateGL()
+{
+    // contour points are shared, hence the buffers are filled directly rather than with buffer_resize()
+    drawlist.draw_mode = DRAW_SEGS;
+    drawlist.seg_width = thickness;
+    drawlist.segs      = this->segs;
+    drawlist.seg_coords.resize(3*this->num_verts());
+    drawlist.seg_colors.resize(4*this->num_verts());
+
+    for(uint vid=0; vid<this->num_verts(); ++vid)
+    {
+        const vec3d & p = this->verts[vid];
+        Color c = (color_by_level) ? Color::parula_ramp(this->num_levels(), this->level_rank[this->v_level[vid]]) : color;
+        drawlist.seg_coords[3*vid+0] = p.x();
+        drawlist.seg_coords[3*vid+1] = p.y();
+        drawlist.seg_coords[3*vid+2] = p.z();
+        drawlist.seg_colors[4*vid+0] = c.r;
+        drawlist.seg_colors[4*vid+1] = c.g;
+        drawlist.seg_colors[4*vid+2] = c.b;
+        drawlist.seg_colors[4*vid+3] = c.a;
+    }
+    buffer_set_dirty(drawlist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d DrawableIsocontours<M,V,E,P>::scene_center() const
+{
+    return vec3d();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+float DrawableIsocontours<M,V,E,P>::scene_radius() const
+{
+    return 0.0;
+}
+
+}
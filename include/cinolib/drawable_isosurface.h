@@ -41,6 +41,7 @@
 #include <cinolib/isosurface.h>
 #include <cinolib/meshes/tetmesh.h>
 #include <cinolib/color.h>
+#include <cinolib/gl/draw_lines_tris.h>
 
 namespace cinolib
 {
@@ -66,6 +67,14 @@ class DrawableIsosurface : public Isosurface<M,V,E,F,P>, public DrawableObject
         float      scene_radius() const;
         ObjectType object_type()  const { return DRAWABLE_ISOSURFACE; }
         Color      color;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void updateGL(); // regenerates rendering data (call it after editing verts/tris/norms/color)
+
+    protected:
+
+        RenderData drawlist;
 };
 
 }
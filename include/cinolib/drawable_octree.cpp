@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include "drawable_octree.h"
+#include <cinolib/profiler.h>
 
 #ifdef __APPLE__
 #include <gl.h>
@@ -85,6 +86,7 @@ float DrawableOctree::scene_radius() const
 CINO_INLINE
 void DrawableOctree::updateGL()
 {
+    CINO_PROFILE_SCOPE("DrawableOctree::updateGL");
     render_list.clear();
     if(this->root==nullptr) return;
     updateGL(this->root);
@@ -105,6 +107,25 @@ void DrawableOctree::updateGL(const OctreeNode *node)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+MemoryFootprint DrawableOctree::memory_footprint() const
+{
+    MemoryFootprint mf = Octree::memory_footprint();
+    mf.add("render_list", render_list);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DrawableOctree::shrink_to_fit()
+{
+    Octree::shrink_to_fit();
+    render_list.shrink_to_fit();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void DrawableOctree::set_color(const Color & c)
 {
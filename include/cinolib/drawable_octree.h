@@ -69,6 +69,11 @@ class DrawableOctree : public Octree, public DrawableObject
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        MemoryFootprint memory_footprint() const override;
+        void            shrink_to_fit() override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         void set_color(const Color & c);
         void set_thickness(float t);
 
@@ -87,6 +87,20 @@ class DrawableSlicedObj : public AbstractDrawablePolygonMesh<SlicedObj<M,V,E,P>>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        explicit DrawableSlicedObj(const Trimesh<M,V,E,P>    & m,
+                                   const std::vector<double> & z_levels,
+                                   const double                hatch_size = 0.01)
+        : SlicedObj<M,V,E,P>(m, z_levels, hatch_size)
+        {
+            this->init_drawable_stuff();
+            this->show_marked_edge_color(Color::BLACK());
+            this->show_marked_edge_width(3.0);
+            this->show_wireframe(false);
+            this->updateGL();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         ObjectType object_type() const { return DRAWABLE_SLICED_OBJ; }
 };
 
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/dual_mesh.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -63,129 +64,108 @@ void dual_mesh(const AbstractPolyhedralMesh<M,V,E,F,P> & primal,
                      std::vector<std::vector<bool>>    & dual_polys_winding,
                const bool                                with_clipped_cells)
 {
+    // Each dual face is generated either by a primal edge, or by a surface
+    // vertex (the cap of a clipped cell), and each dual cell by a primal vertex.
+    // Their ids are therefore assigned from primal ids (prefix sums over the
+    // elements that are actually used), and everything is filled in parallel
+    //
     dual_verts.clear();
     dual_faces.clear();
     dual_polys.clear();
     dual_polys_winding.clear();
 
-    // Initialize vertices with face centroids
-    dual_verts.resize(primal.num_polys());
-    for(uint pid=0; pid<primal.num_polys(); ++pid)
-    {
-        dual_verts.at(pid) = primal.poly_centroid(pid);
-    }
+    uint nv = primal.num_verts();
+    uint ne = primal.num_edges();
+    uint nf = primal.num_faces();
+    uint np = primal.num_polys();
 
-    std::map<std::vector<uint>,uint> f_map;
+    // vertices: poly centroids followed by surface face centroids
+    std::vector<uint> f_off(nf+1,0);
+    PARALLEL_FOR(0, nf, 1000, [&](uint fid)
+    {
+        if(primal.face_is_on_srf(fid)) f_off[fid+1] = 1;
+    });
+    PARALLEL_PREFIX_SUM(f_off, 1000);
 
-    // For clipped dual cells: add boundary vertices,
-    // boundary edges midpoints and surface face midpoints
-    //
-    //std::map<uint,uint> v2verts;
-    //std::map<uint,uint> e2verts;
-    std::map<uint,uint> f2verts;
-    //for(uint vid=0; vid<primal.num_verts(); ++vid)
-    //{
-    //    if (primal.vert_is_on_srf(vid))
-    //    {
-    //        v2verts[vid] = dual_verts.size();
-    //        dual_verts.push_back(primal.vert(vid));
-    //    }
-    //}
-    //for(uint eid=0; eid<primal.num_edges(); ++eid)
-    //{
-    //    if (primal.edge_is_on_srf(eid))
-    //    {
-    //        e2verts[eid] = dual_verts.size();
-    //        dual_verts.push_back(primal.edge_sample_at(eid, 0.5));
-    //    }
-    //}
-    for(uint fid=0; fid<primal.num_faces(); ++fid)
+    dual_verts.resize(np + f_off.back());
+    PARALLEL_FOR(0, np, 1000, [&](uint pid) { dual_verts[pid] = primal.poly_centroid(pid); });
+    PARALLEL_FOR(0, nf, 1000, [&](uint fid)
     {
-        if (primal.face_is_on_srf(fid))
-        {
-            f2verts[fid] = dual_verts.size();
-            dual_verts.push_back(primal.face_centroid(fid));
-        }
-    }
+        if(f_off[fid+1]>f_off[fid]) dual_verts[np + f_off[fid]] = primal.face_centroid(fid);
+    });
 
-    // Make dual polyhedral cells
-    for(uint vid=0; vid<primal.num_verts(); ++vid)
+    // dual cells (one per kept vertex) and caps (one per kept surface vertex)
+    std::vector<uint> c_off(nv+1,0), cap_off(nv+1,0);
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
     {
         bool clipped_cell = primal.vert_is_on_srf(vid);
-        if (clipped_cell && !with_clipped_cells) continue;
+        if(clipped_cell && !with_clipped_cells) return;
+        c_off[vid+1] = 1;
+        if(clipped_cell) cap_off[vid+1] = 1;
+    });
+    PARALLEL_PREFIX_SUM(c_off, 1000);
+    PARALLEL_PREFIX_SUM(cap_off, 1000);
+    auto kept = [&](const uint vid) { return c_off[vid+1]>c_off[vid]; };
+
+    // dual faces: one per edge incident to at least one kept vertex, then caps
+    std::vector<uint> e_off(ne+1,0);
+    PARALLEL_FOR(0, ne, 1000, [&](uint eid)
+    {
+        if(kept(primal.edge_vert_id(eid,0)) || kept(primal.edge_vert_id(eid,1))) e_off[eid+1] = 1;
+    });
+    PARALLEL_PREFIX_SUM(e_off, 1000);
 
-        std::vector<uint> p;
-        std::vector<bool> p_winding;
+    dual_faces.resize(e_off.back() + cap_off.back());
+    PARALLEL_FOR(0, ne, 1000, [&](uint eid)
+    {
+        if(e_off[eid+1]==e_off[eid]) return;
+        std::vector<uint> f = primal.edge_ordered_poly_ring(eid);
+        if(primal.edge_is_on_srf(eid))
+        {
+            assert(primal.edge_adj_srf_faces(eid).size()==2);
+            uint srf_beg = primal.edge_adj_srf_faces(eid).front();
+            uint srf_end = primal.edge_adj_srf_faces(eid).back();
+            uint p_beg   = f.front();
+            uint p_end   = f.back();
+            if (!primal.poly_contains_face(p_beg, srf_beg)) std::swap(srf_beg, srf_end);
+            assert(primal.poly_contains_face(p_beg, srf_beg));
+            assert(primal.poly_contains_face(p_end, srf_end));
+            f.push_back(np + f_off[srf_end]);
+            f.push_back(np + f_off[srf_beg]);
+        }
+        dual_faces[e_off[eid]] = f;
+    });
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+    {
+        if(cap_off[vid+1]==cap_off[vid]) return;
+        std::vector<uint> & f = dual_faces[e_off.back() + cap_off[vid]];
+        for(uint fid : primal.vert_ordered_srf_face_ring(vid))
+        {
+            f.push_back(np + f_off[fid]);
+        }
+    });
 
+    // dual cells. A face shared by two cells keeps its winding
+    // in the cell generated by the vertex with lowest id
+    dual_polys.resize(c_off.back());
+    dual_polys_winding.resize(c_off.back());
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+    {
+        if(!kept(vid)) return;
+        std::vector<uint> & p         = dual_polys[c_off[vid]];
+        std::vector<bool> & p_winding = dual_polys_winding[c_off[vid]];
         for(uint eid : primal.adj_v2e(vid))
         {
-            std::vector<uint> f = primal.edge_ordered_poly_ring(eid);
-
-            if (primal.edge_is_on_srf(eid))
-            {
-                assert(primal.edge_adj_srf_faces(eid).size()==2);
-                uint srf_beg = primal.edge_adj_srf_faces(eid).front();
-                uint srf_end = primal.edge_adj_srf_faces(eid).back();
-                uint p_beg   = f.front();
-                uint p_end   = f.back();
-                if (!primal.poly_contains_face(p_beg, srf_beg)) std::swap(srf_beg, srf_end);
-                assert(primal.poly_contains_face(p_beg, srf_beg));
-                assert(primal.poly_contains_face(p_end, srf_end));
-                f.push_back(f2verts.at(srf_end));
-                //f.push_back(e2verts.at(eid));
-                f.push_back(f2verts.at(srf_beg));
-            }
-
-            std::vector<uint> sorted_f = f;
-            sort(sorted_f.begin(), sorted_f.end());
-            auto query = f_map.find(sorted_f);
-
-            if (query == f_map.end())
-            {
-                uint fresh_id = dual_faces.size();
-                f_map[sorted_f] = fresh_id;
-                dual_faces.push_back(f);
-
-                p.push_back(fresh_id);
-                p_winding.push_back(true);
-            }
-            else
-            {
-                p.push_back(query->second);
-                p_winding.push_back(false);
-            }
+            uint opp = primal.vert_opposite_to(eid,vid);
+            p.push_back(e_off[eid]);
+            p_winding.push_back(!kept(opp) || vid<opp);
         }
-
-        if (clipped_cell)
+        if(cap_off[vid+1]>cap_off[vid])
         {
-            std::vector<uint> f;
-            for(uint fid : primal.vert_ordered_srf_face_ring(vid))
-            {
-                f.push_back(f2verts.at(fid));
-            }
-            std::vector<uint> sorted_f = f;
-            sort(sorted_f.begin(), sorted_f.end());
-            auto query = f_map.find(sorted_f);
-
-            if (query == f_map.end())
-            {
-                uint fresh_id = dual_faces.size();
-                f_map[sorted_f] = fresh_id;
-                dual_faces.push_back(f);
-
-                p.push_back(fresh_id);
-                p_winding.push_back(true);
-            }
-            else
-            {
-                p.push_back(query->second);
-                p_winding.push_back(false);
-            }
+            p.push_back(e_off.back() + cap_off[vid]);
+            p_winding.push_back(true);
         }
-
-        dual_polys.push_back(p);
-        dual_polys_winding.push_back(p_winding);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
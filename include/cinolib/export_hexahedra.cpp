@@ -34,76 +34,107 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/export_hexahedra.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/vector_serialization.h>
 
 namespace cinolib
 {
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>       m_in,
-                            Hexmesh<M,V,E,F,P>            & m_out,
-                            std::unordered_map<uint,uint> & v_map) // (m_in to m_out)
+void export_hexahedra(const Polyhedralmesh<M,V,E,F,P> & m_in,
+                            Hexmesh<M,V,E,F,P>        & m_out,
+                            std::vector<int>          & v_map,    // (m_in to m_out, -1 for dropped verts)
+                            std::vector<uint>         & hex2poly) // (m_out to m_in)
 {
-    m_out.clear();
-    v_map.clear();
+    uint nv = m_in.num_verts();
+    uint np = m_in.num_polys();
+
+    // offsets of the hexahedra
+    std::vector<uint> p_off(np+1,0);
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
+    {
+        if(m_in.poly_is_hexahedron(pid)) p_off[pid+1] = 1;
+    });
+    PARALLEL_PREFIX_SUM(p_off, 1000);
 
-    // add vertices incident to at least one hexa
-    for(uint vid=0; vid<m_in.num_verts(); ++vid)
+    // offsets of the vertices incident to at least one hexa
+    std::vector<uint> v_off(nv+1,0);
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
     {
-        bool touches_hexa = false;
         for(uint pid : m_in.adj_v2p(vid))
         {
-            if(m_in.poly_is_hexahedron(pid))
+            if(p_off[pid+1]>p_off[pid])
             {
-                touches_hexa = true;
+                v_off[vid+1] = 1;
                 break;
             }
         }
-        if(touches_hexa)
-        {
-            uint fresh_id = v_map.size();
-            v_map[vid] = fresh_id;
-            m_out.vert_add(m_in.vert(vid));
-        }
-    }
+    });
+    PARALLEL_PREFIX_SUM(v_off, 1000);
 
-    // add faces incident to at least one hexa
-    std::unordered_map<uint,uint> f_map;
-    for(uint fid=0; fid<m_in.num_faces(); ++fid)
+    std::vector<vec3d> verts(v_off.back());
+    v_map.resize(nv);
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
     {
-        bool touches_hexa = false;
-        for(uint pid : m_in.adj_f2p(fid))
+        if(v_off[vid+1]>v_off[vid])
         {
-            if(m_in.poly_is_hexahedron(pid))
-            {
-                touches_hexa = true;
-                break;
-            }
+            v_map[vid] = v_off[vid];
+            verts[v_off[vid]] = m_in.vert(vid);
         }
-        if(touches_hexa)
-        {
-            uint fresh_id = f_map.size();
-            f_map[fid] = fresh_id;
-            std::vector<uint> f_verts;
-            for(uint vid : m_in.adj_f2v(fid)) f_verts.push_back(v_map.at(vid));
-            m_out.face_add(f_verts);
-        }
-    }
+        else v_map[vid] = -1;
+    });
 
-    // make hexa
-    for(uint pid=0; pid<m_in.num_polys(); ++pid)
+    // make hexa (with standard vertex ordering)
+    std::vector<uint> hexas(8*p_off.back());
+    hex2poly.resize(p_off.back());
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
     {
-        if(m_in.poly_is_hexahedron(pid))
-        {
-            std::vector<uint> f;
-            std::vector<bool> w;
-            for(uint fid : m_in.adj_p2f(pid))
-            {
-                f.push_back(f_map.at(fid));
-                w.push_back(m_in.poly_face_is_CCW(pid,fid));
-            }
-            m_out.poly_add(f,w);
-        }
+        if(p_off[pid+1]==p_off[pid]) return;
+        uint hid = p_off[pid];
+        hex2poly[hid] = pid;
+        std::vector<uint> vlist = m_in.poly_ordered_verts_id(pid);
+        for(uint i=0; i<8; ++i) hexas[8*hid+i] = v_map[vlist[i]];
+    });
+
+    m_out.clear();
+    m_out.init(verts, polys_from_serialized_vids(hexas,8));
+
+    // inherit attributes, retaining the normals and quality computed for the new mesh
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+    {
+        if(v_map[vid]<0) return;
+        V & data = m_out.vert_data(v_map[vid]);
+        vec3d n = data.normal;
+        data = m_in.vert_data(vid);
+        data.normal = n;
+    });
+    PARALLEL_FOR(0, m_out.num_polys(), 1000, [&](uint hid)
+    {
+        P & data = m_out.poly_data(hid);
+        float q = data.quality;
+        data = m_in.poly_data(hex2poly[hid]);
+        data.quality = q;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>     & m_in,
+                            Hexmesh<M,V,E,F,P>            & m_out,
+                            std::unordered_map<uint,uint> & v_map) // (m_in to m_out)
+{
+    std::vector<int>  vmap;
+    std::vector<uint> hex2poly;
+    export_hexahedra(m_in, m_out, vmap, hex2poly);
+
+    v_map.clear();
+    v_map.reserve(m_out.num_verts());
+    for(uint vid=0; vid<vmap.size(); ++vid)
+    {
+        if(vmap[vid]>=0) v_map[vid] = vmap[vid];
     }
 }
 
@@ -111,12 +142,12 @@ void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>       m_in,
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>   m_in,
+void export_hexahedra(const Polyhedralmesh<M,V,E,F,P> & m_in,
                             Hexmesh<M,V,E,F,P>        & m_out)
 {
-    std::unordered_map<uint,uint> v_map;
-    export_hexahedra(m_in, m_out, v_map);
+    std::vector<int>  v_map;
+    std::vector<uint> hex2poly;
+    export_hexahedra(m_in, m_out, v_map, hex2poly);
 }
 
 }
-
@@ -42,9 +42,25 @@
 namespace cinolib
 {
 
+/* Exports the hexahedra of a polyhedral mesh into a hexmesh, dropping all the other
+ * elements (and the vertices that are not incident to any hexahedron). Hexahedra are
+ * written in parallel into a flat buffer, and the output mesh is assembled with the
+ * bulk Hexmesh constructor. Vert and poly attributes (e.g. labels) are inherited from
+ * the input mesh.
+*/
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void export_hexahedra(const Polyhedralmesh<M,V,E,F,P> & m_in,
+                            Hexmesh<M,V,E,F,P>        & m_out,
+                            std::vector<int>          & v_map,     // (m_in to m_out, -1 for dropped verts)
+                            std::vector<uint>         & hex2poly); // (m_out to m_in)
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>       m_in,
+void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>     & m_in,
                             Hexmesh<M,V,E,F,P>            & m_out,
                             std::unordered_map<uint,uint> & v_map); // (m_in to m_out)
 
@@ -52,7 +68,7 @@ void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>       m_in,
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void export_hexahedra(const Polyhedralmesh<M,V,E,F,P>   m_in,
+void export_hexahedra(const Polyhedralmesh<M,V,E,F,P> & m_in,
                             Hexmesh<M,V,E,F,P>        & m_out);
 
 }
@@ -39,6 +39,7 @@
 #include <cinolib/laplacian.h>
 #include <cinolib/vertex_mass.h>
 #include <cinolib/linear_solvers.h>
+#include <cinolib/profiler.h>
 
 namespace cinolib
 {
@@ -51,6 +52,7 @@ ScalarField compute_geodesics(      Mesh              & m,
                               const float               time_scalar,
                               const bool                hard_constrain_charges)
 {
+    CINO_PROFILE_SCOPE("compute_geodesics");
     // optimize position and scale to get better numerical precision
     double d = m.bbox().diag();
     vec3d  c = m.bbox().center();
@@ -108,6 +110,7 @@ ScalarField compute_geodesics_amortized(      Mesh              & m,
                                         const int                 laplacian_mode,
                                         const float               time_scalar)
 {
+    CINO_PROFILE_SCOPE("compute_geodesics_amortized");
     // first call, heavy solve (matrix factorization + gradient matrix)
     if (cache.heat_flow_cache == NULL)
     {
@@ -183,5 +183,24 @@ double polygon_is_convex(const std::vector<vec2d> & poly)
     return true;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool polygon_contains(const std::vector<vec2d> & poly, const vec2d & p)
+{
+    // count the crossings between the polygon and a horizontal ray starting at p
+    bool inside = false;
+    for(uint curr=0, prev=poly.size()-1; curr<poly.size(); prev=curr++)
+    {
+        const vec2d & a = poly.at(curr);
+        const vec2d & b = poly.at(prev);
+        if((a.y() > p.y()) != (b.y() > p.y()) &&
+           p.x() < a.x() + (b.x()-a.x()) * (p.y()-a.y()) / (b.y()-a.y()))
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
 }
 
+}
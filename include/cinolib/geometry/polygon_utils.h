@@ -66,6 +66,12 @@ double polygon_is_convex(const std::vector<vec2d> & poly);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// even-odd rule (also for self-intersecting polygons, such as a lasso drawn by hand)
+CINO_INLINE
+bool polygon_contains(const std::vector<vec2d> & poly, const vec2d & p);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 vec3d polygon_normal(const std::vector<vec3d> & poly);
 
@@ -34,23 +34,170 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/gl/draw_lines_tris.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
 
 namespace cinolib
 {
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// upload statistics are collected only if CINOLIB_GL_STATS is defined
+#ifdef CINOLIB_GL_STATS
+CINO_INLINE
+void count_upload(GLBuffers & gpu, const size_t bytes)
+{
+    gpu.num_uploads    += 1;
+    gpu.uploaded_bytes += bytes;
+}
+#else
+CINO_INLINE
+void count_upload(GLBuffers & /*gpu*/, const size_t /*bytes*/) {}
+#endif
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// interleaves vertices [beg,end) of the triangle buffers and uploads them into the VBO.
+// If the vertex layout (or count) changed, the whole VBO is reallocated
+CINO_INLINE
+void upload_tris(const RenderData & data)
+{
+    GLBuffers & gpu = data.gpu;
+
+    uint n_verts = data.tri_coords.size()/3;
+    int  n_off   = (n_verts > 0 && data.tri_v_norms.size()  == 3*n_verts) ? 3 : -1;
+    int  c_off   = (n_verts > 0 && data.tri_v_colors.size() == 4*n_verts) ? ((n_off > 0) ? 6 : 3) : -1;
+    uint t_size  = (n_verts > 0) ? data.tri_text.size()/n_verts : 0;
+    int  t_off   = (t_size  > 0) ? 3 + ((n_off > 0) ? 3 : 0) + ((c_off > 0) ? 4 : 0) : -1;
+    uint stride  = 3 + ((n_off > 0) ? 3 : 0) + ((c_off > 0) ? 4 : 0) + t_size;
+
+    bool realloc = (gpu.tri_vbo    == 0       ||
+                    gpu.tri_verts  != n_verts ||
+                    gpu.tri_stride != stride  ||
+                    gpu.tri_n_off  != n_off   ||
+                    gpu.tri_c_off  != c_off   ||
+                    gpu.tri_t_off  != t_off);
+
+    uint beg = (realloc) ? 0       : std::min(gpu.dirty_tri_beg, n_verts);
+    uint end = (realloc) ? n_verts : std::min(gpu.dirty_tri_end, n_verts);
+
+    if (beg < end || realloc)
+    {
+        std::vector<float> buf(stride*(end-beg));
+        for(uint vid=beg; vid<end; ++vid)
+        {
+            float *dst = buf.data() + stride*(vid-beg);
+            std::copy(data.tri_coords.begin()+3*vid, data.tri_coords.begin()+3*vid+3, dst);
+            if (n_off > 0) std::copy(data.tri_v_norms.begin() +3*vid,      data.tri_v_norms.begin() +3*vid+3,        dst+n_off);
+            if (c_off > 0) std::copy(data.tri_v_colors.begin()+4*vid,      data.tri_v_colors.begin()+4*vid+4,        dst+c_off);
+            if (t_off > 0) std::copy(data.tri_text.begin()    +t_size*vid, data.tri_text.begin()    +t_size*(vid+1), dst+t_off);
+        }
+
+        if (gpu.tri_vbo == 0) glGenBuffers(1, &gpu.tri_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.tri_vbo);
+        if (realloc) glBufferData(GL_ARRAY_BUFFER, buf.size()*sizeof(float), buf.data(), GL_DYNAMIC_DRAW);
+        else         glBufferSubData(GL_ARRAY_BUFFER, stride*beg*sizeof(float), buf.size()*sizeof(float), buf.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        count_upload(gpu, buf.size()*sizeof(float));
+
+        gpu.tri_verts  = n_verts;
+        gpu.tri_stride = stride;
+        gpu.tri_n_off  = n_off;
+        gpu.tri_c_off  = c_off;
+        gpu.tri_t_off  = t_off;
+        gpu.tri_t_size = t_size;
+    }
+    gpu.dirty_tri_beg = gpu.dirty_tri_end = 0;
+
+    if (gpu.tri_ibo == 0 || gpu.tri_elems != data.tris.size() || gpu.dirty_tri_elems)
+    {
+        if (gpu.tri_ibo == 0) glGenBuffers(1, &gpu.tri_ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.tri_ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.tris.size()*sizeof(uint), data.tris.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        count_upload(gpu, data.tris.size()*sizeof(uint));
+        gpu.tri_elems       = data.tris.size();
+        gpu.dirty_tri_elems = false;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as upload_tris, for segments (position + rgba)
+CINO_INLINE
+void upload_segs(const RenderData & data)
+{
+    GLBuffers & gpu = data.gpu;
+
+    uint n_verts = data.seg_coords.size()/3;
+    bool realloc = (gpu.seg_vbo == 0 || gpu.seg_verts != n_verts);
+
+    uint beg = (realloc) ? 0       : std::min(gpu.dirty_seg_beg, n_verts);
+    uint end = (realloc) ? n_verts : std::min(gpu.dirty_seg_end, n_verts);
+
+    if (beg < end || realloc)
+    {
+        std::vector<float> buf(7*(end-beg), 1.f);
+        for(uint vid=beg; vid<end; ++vid)
+        {
+            float *dst = buf.data() + 7*(vid-beg);
+            std::copy(data.seg_coords.begin()+3*vid, data.seg_coords.begin()+3*vid+3, dst);
+            if (data.seg_colors.size() == 4*n_verts)
+            {
+                std::copy(data.seg_colors.begin()+4*vid, data.seg_colors.begin()+4*vid+4, dst+3);
+            }
+        }
+
+        if (gpu.seg_vbo == 0) glGenBuffers(1, &gpu.seg_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.seg_vbo);
+        if (realloc) glBufferData(GL_ARRAY_BUFFER, buf.size()*sizeof(float), buf.data(), GL_DYNAMIC_DRAW);
+        else         glBufferSubData(GL_ARRAY_BUFFER, 7*beg*sizeof(float), buf.size()*sizeof(float), buf.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        count_upload(gpu, buf.size()*sizeof(float));
+
+        gpu.seg_verts = n_verts;
+    }
+    gpu.dirty_seg_beg = gpu.dirty_seg_end = 0;
+
+    if (gpu.seg_ibo == 0 || gpu.seg_elems != data.segs.size() || gpu.dirty_seg_elems)
+    {
+        if (gpu.seg_ibo == 0) glGenBuffers(1, &gpu.seg_ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.seg_ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.segs.size()*sizeof(uint), data.segs.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        count_upload(gpu, data.segs.size()*sizeof(uint));
+        gpu.seg_elems       = data.segs.size();
+        gpu.dirty_seg_elems = false;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// byte offset of the i-th float in a buffer object
+#define CINO_VBO_OFFSET(i) (reinterpret_cast<const GLvoid*>(sizeof(float)*(i)))
+
 CINO_INLINE
 void render_tris(const RenderData & data)
 {
+    upload_tris(data);
+
+    const GLBuffers & gpu = data.gpu;
+    if (gpu.tri_verts == 0) return;
+
+    GLsizei stride = gpu.tri_stride*sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.tri_vbo);
+
     if (data.draw_mode & DRAW_TRI_POINTS)
     {
-        glEnableClientState(GL_COLOR_ARRAY);
-        glColorPointer(4, GL_FLOAT, 0, data.tri_v_colors.data());
+        if (gpu.tri_c_off > 0)
+        {
+            glEnableClientState(GL_COLOR_ARRAY);
+            glColorPointer(4, GL_FLOAT, stride, CINO_VBO_OFFSET(gpu.tri_c_off));
+        }
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.tri_coords.data());
+        glVertexPointer(3, GL_FLOAT, stride, CINO_VBO_OFFSET(0));
         glPointSize(data.seg_width);
-        glDrawArrays(GL_POINTS, 0, data.tri_coords.size()/3);
+        glDrawArrays(GL_POINTS, 0, gpu.tri_verts);
         glDisableClientState(GL_VERTEX_ARRAY);
         glDisableClientState(GL_COLOR_ARRAY);
     }
@@ -65,7 +212,7 @@ void render_tris(const RenderData & data)
             glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_R,     GL_REPEAT);
 
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glTexCoordPointer(1, GL_FLOAT, 0, data.tri_text.data());
+            glTexCoordPointer(1, GL_FLOAT, stride, CINO_VBO_OFFSET(gpu.tri_t_off));
             glColor3f(1,1,1);
             glEnable(GL_COLOR_MATERIAL);
             glEnable(GL_TEXTURE_1D);
@@ -81,7 +228,7 @@ void render_tris(const RenderData & data)
             glGenerateMipmap(GL_TEXTURE_2D);
 
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glTexCoordPointer(2, GL_FLOAT, 0, data.tri_text.data());
+            glTexCoordPointer(2, GL_FLOAT, stride, CINO_VBO_OFFSET(gpu.tri_t_off));
             glColor3f(1,1,1);
             glEnable(GL_COLOR_MATERIAL);
             glEnable(GL_TEXTURE_2D);
@@ -89,14 +236,22 @@ void render_tris(const RenderData & data)
         else
         {
             glEnable(GL_COLOR_MATERIAL);
-            glEnableClientState(GL_COLOR_ARRAY);
-            glColorPointer(4, GL_FLOAT, 0, data.tri_v_colors.data());
+            if (gpu.tri_c_off > 0)
+            {
+                glEnableClientState(GL_COLOR_ARRAY);
+                glColorPointer(4, GL_FLOAT, stride, CINO_VBO_OFFSET(gpu.tri_c_off));
+            }
         }
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.tri_coords.data());
-        glEnableClientState(GL_NORMAL_ARRAY);
-        glNormalPointer(GL_FLOAT, 0, data.tri_v_norms.data());
-        glDrawElements(GL_TRIANGLES, data.tris.size(), GL_UNSIGNED_INT, data.tris.data());
+        glVertexPointer(3, GL_FLOAT, stride, CINO_VBO_OFFSET(0));
+        if (gpu.tri_n_off > 0)
+        {
+            glEnableClientState(GL_NORMAL_ARRAY);
+            glNormalPointer(GL_FLOAT, stride, CINO_VBO_OFFSET(gpu.tri_n_off));
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.tri_ibo);
+        glDrawElements(GL_TRIANGLES, gpu.tri_elems, GL_UNSIGNED_INT, CINO_VBO_OFFSET(0));
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glDisableClientState(GL_VERTEX_ARRAY);
         glDisableClientState(GL_NORMAL_ARRAY);
         if (data.draw_mode & DRAW_TRI_TEXTURE1D)
@@ -117,6 +272,8 @@ void render_tris(const RenderData & data)
             glDisable(GL_COLOR_MATERIAL);
         }
     }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -126,19 +283,31 @@ void render_segs(const RenderData & data)
 {
     if (data.draw_mode & DRAW_SEGS)
     {
+        upload_segs(data);
+
+        const GLBuffers & gpu = data.gpu;
+        if (gpu.seg_verts == 0) return;
+
+        GLsizei stride = 7*sizeof(float);
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.seg_vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.seg_ibo);
+
         glEnable(GL_LINE_SMOOTH);
         glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);        
         glDisable(GL_LIGHTING);
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.seg_coords.data());
+        glVertexPointer(3, GL_FLOAT, stride, CINO_VBO_OFFSET(0));
         glLineWidth(data.seg_width);
         glEnableClientState(GL_COLOR_ARRAY);
-        glColorPointer(4, GL_FLOAT, 0, data.seg_colors.data());
-        glDrawElements(GL_LINES, data.segs.size(), GL_UNSIGNED_INT, data.segs.data());
+        glColorPointer(4, GL_FLOAT, stride, CINO_VBO_OFFSET(3));
+        glDrawElements(GL_LINES, gpu.seg_elems, GL_UNSIGNED_INT, CINO_VBO_OFFSET(0));
         glDisableClientState(GL_COLOR_ARRAY);
         glDisableClientState(GL_VERTEX_ARRAY);
         glEnable(GL_LIGHTING);
         glDisable(GL_LINE_SMOOTH);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 }
 
@@ -188,4 +357,108 @@ void render(const RenderData & data)
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int buffer_layout(const int draw_mode)
+{
+    int layout = draw_mode & (DRAW_TRI_SMOOTH | DRAW_TRI_FLAT | DRAW_TRI_TEXTURE1D | DRAW_TRI_TEXTURE2D);
+    if (draw_mode & (DRAW_TRI_FACECOLOR | DRAW_TRI_VERTCOLOR | DRAW_TRI_QUALITY)) layout |= DRAW_TRI_FACECOLOR;
+    return layout;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void buffer_resize(RenderData & data, const uint n_tris, const uint n_segs)
+{
+    uint n_norms  = (data.draw_mode & (DRAW_TRI_SMOOTH | DRAW_TRI_FLAT)) ? 9*n_tris : 0;
+    uint n_colors = (buffer_layout(data.draw_mode) & DRAW_TRI_FACECOLOR) ? 12*n_tris : 0;
+    uint n_text   = (data.draw_mode & DRAW_TRI_TEXTURE1D) ? 3*n_tris :
+                    (data.draw_mode & DRAW_TRI_TEXTURE2D) ? 6*n_tris : 0;
+
+    data.tris.resize(3*n_tris);
+    data.tri_coords.resize(9*n_tris);
+    data.tri_v_norms.resize(n_norms);
+    data.tri_v_colors.resize(n_colors);
+    data.tri_text.resize(n_text);
+    data.segs.resize(2*n_segs);
+    data.seg_coords.resize(6*n_segs);
+    data.seg_colors.resize(8*n_segs);
+
+    for(uint i=0; i<data.tris.size(); ++i) data.tris[i] = i;
+    for(uint i=0; i<data.segs.size(); ++i) data.segs[i] = i;
+
+    buffer_set_dirty(data);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void buffer_set_dirty(RenderData & data)
+{
+    data.gpu.dirty_tri_beg   = 0;
+    data.gpu.dirty_tri_end   = max_uint;
+    data.gpu.dirty_seg_beg   = 0;
+    data.gpu.dirty_seg_end   = max_uint;
+    data.gpu.dirty_tri_elems = true;
+    data.gpu.dirty_seg_elems = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void buffer_set_dirty_tris(RenderData & data, const uint beg, const uint end)
+{
+    if (beg >= end) return;
+    GLBuffers & gpu = data.gpu;
+    bool empty = (gpu.dirty_tri_beg >= gpu.dirty_tri_end);
+    gpu.dirty_tri_beg = (empty) ? 3*beg : std::min(gpu.dirty_tri_beg, 3*beg);
+    gpu.dirty_tri_end = (empty) ? 3*end : std::max(gpu.dirty_tri_end, 3*end);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void buffer_set_dirty_segs(RenderData & data, const uint beg, const uint end)
+{
+    if (beg >= end) return;
+    GLBuffers & gpu = data.gpu;
+    bool empty = (gpu.dirty_seg_beg >= gpu.dirty_seg_end);
+    gpu.dirty_seg_beg = (empty) ? 2*beg : std::min(gpu.dirty_seg_beg, 2*beg);
+    gpu.dirty_seg_end = (empty) ? 2*end : std::max(gpu.dirty_seg_end, 2*end);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MemoryFootprint buffer_memory_footprint(const RenderData & data)
+{
+    MemoryFootprint mf;
+    mf.add("tris",         data.tris);
+    mf.add("tri_coords",   data.tri_coords);
+    mf.add("tri_v_norms",  data.tri_v_norms);
+    mf.add("tri_v_colors", data.tri_v_colors);
+    mf.add("tri_text",     data.tri_text);
+    mf.add("segs",         data.segs);
+    mf.add("seg_coords",   data.seg_coords);
+    mf.add("seg_colors",   data.seg_colors);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void buffer_shrink_to_fit(RenderData & data)
+{
+    data.tris.shrink_to_fit();
+    data.tri_coords.shrink_to_fit();
+    data.tri_v_norms.shrink_to_fit();
+    data.tri_v_colors.shrink_to_fit();
+    data.tri_text.shrink_to_fit();
+    data.segs.shrink_to_fit();
+    data.seg_coords.shrink_to_fit();
+    data.seg_colors.shrink_to_fit();
+}
+
 }
@@ -51,6 +51,7 @@
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/color.h>
+#include <cinolib/memory_footprint.h>
 #include <cinolib/textures/textures.h>
 
 namespace cinolib
@@ -70,6 +71,17 @@ enum
     DRAW_SEGS                 = 0x00000200,
 };
 
+// rendering attributes that can be selectively refreshed by drawable
+// meshes (see updateGL_dirty() in the drawable polygon/polyhedral meshes)
+enum
+{
+    UPDATE_GL_COORDS          = 0x00000001,
+    UPDATE_GL_NORMALS         = 0x00000002,
+    UPDATE_GL_COLORS          = 0x00000004,
+    UPDATE_GL_TEXTURES        = 0x00000008,
+    UPDATE_GL_ALL             = 0x0000000F,
+};
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 // https://www.khronos.org/registry/OpenGL-Refpages/es1.1/xhtml/glMaterial.xml
@@ -95,6 +107,67 @@ Material;
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// GPU side copy of the buffers of a RenderData. Triangle and segment vertices are
+// stored interleaved (position, normal, color, texture coordinates, as float) in
+// vertex buffer objects, element lists in index buffer objects. render() uploads
+// only the parts that changed since the last frame (see buffer_set_dirty), hence
+// static data is drawn without any CPU-to-GPU transfer. GL objects are created
+// lazily at the first rendering, and released on destruction. Copies do not share
+// GL objects: they start empty and will upload their data at the first rendering
+typedef struct GLBuffers
+{
+    GLuint tri_vbo     = 0;
+    GLuint tri_ibo     = 0;
+    GLuint seg_vbo     = 0;
+    GLuint seg_ibo     = 0;
+    //
+    // layout of the interleaved triangle vertices (offsets in floats, -1 if missing)
+    uint   tri_verts   = 0; // number of vertices in tri_vbo
+    uint   tri_stride  = 0; // floats per vertex
+    int    tri_n_off   = -1;
+    int    tri_c_off   = -1;
+    int    tri_t_off   = -1;
+    uint   tri_t_size  = 0; // texture coordinates per vertex (1 or 2)
+    uint   tri_elems   = 0; // number of indices in tri_ibo
+    //
+    uint   seg_verts   = 0; // number of vertices in seg_vbo (position + rgba)
+    uint   seg_elems   = 0; // number of indices in seg_ibo
+    //
+    // ranges of vertices modified since the last upload
+    uint   dirty_tri_beg   = 0;
+    uint   dirty_tri_end   = 0;
+    uint   dirty_seg_beg   = 0;
+    uint   dirty_seg_end   = 0;
+    bool   dirty_tri_elems = true;
+    bool   dirty_seg_elems = true;
+    //
+#ifdef CINOLIB_GL_STATS
+    // number of buffer uploads (glBufferData/glBufferSubData calls) issued so far, and
+    // amount of transferred data. Debug only, to check that static data is not sent again
+    uint   num_uploads    = 0;
+    size_t uploaded_bytes = 0;
+#endif
+    //
+    GLBuffers() {}
+    GLBuffers(const GLBuffers &) {}
+    GLBuffers & operator=(const GLBuffers &) { release(); return *this; }
+    ~GLBuffers() { release(); }
+    //
+    void release()
+    {
+        if (tri_vbo > 0) glDeleteBuffers(1, &tri_vbo);
+        if (tri_ibo > 0) glDeleteBuffers(1, &tri_ibo);
+        if (seg_vbo > 0) glDeleteBuffers(1, &seg_vbo);
+        if (seg_ibo > 0) glDeleteBuffers(1, &seg_ibo);
+        tri_vbo = tri_ibo = seg_vbo = seg_ibo = 0;
+        tri_verts = tri_elems = seg_verts = seg_elems = 0;
+        dirty_tri_elems = dirty_seg_elems = true;
+    }
+}
+GLBuffers;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 typedef struct
 {
     Material           material;
@@ -113,6 +186,7 @@ typedef struct
     std::vector<float> seg_colors; // rgba
     GLfloat            seg_width = 1;
     //
+    mutable GLBuffers  gpu;
 }
 RenderData;
 
@@ -121,6 +195,46 @@ RenderData;
 CINO_INLINE
 void render(const RenderData & data);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// subset of the draw mode flags that determines the size of the per
+// triangle buffers of a RenderData (normals, colors and texture coordinates).
+// Drawable meshes use it to detect when their buffers must be reallocated
+CINO_INLINE
+int buffer_layout(const int draw_mode);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// allocates room for n_tris unshared triangles and n_segs unshared segments,
+// according to the current draw mode. Element lists (tris, segs) are filled
+// with consecutive indices, all the other buffers are left for the caller
+CINO_INLINE
+void buffer_resize(RenderData & data, const uint n_tris, const uint n_segs);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// notify render() that the CPU side buffers changed and must be uploaded again. Changes
+// in the number of triangles/segments are detected automatically, in-place edits are not.
+// Ranges [beg,end) refer to triangles (resp. segments), and are accumulated until the
+// next rendering
+CINO_INLINE
+void buffer_set_dirty(RenderData & data);
+
+CINO_INLINE
+void buffer_set_dirty_tris(RenderData & data, const uint beg, const uint end);
+
+CINO_INLINE
+void buffer_set_dirty_segs(RenderData & data, const uint beg, const uint end);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// host memory used by the CPU side buffers (the GPU copy is not accounted for)
+CINO_INLINE
+MemoryFootprint buffer_memory_footprint(const RenderData & data);
+
+CINO_INLINE
+void buffer_shrink_to_fit(RenderData & data);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,104 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/graph_coloring.h>
+#include <algorithm>
+
+namespace cinolib
+{
+
+template<class Adj>
+CINO_INLINE
+std::vector<std::vector<uint>> greedy_coloring(const uint n_nodes, const Adj & adj)
+{
+    std::vector<uint> order(n_nodes);
+    for(uint i=0; i<n_nodes; ++i) order.at(i) = i;
+    std::stable_sort(order.begin(), order.end(), [&](const uint a, const uint b)
+    {
+        return adj(a).size() > adj(b).size();
+    });
+
+    std::vector<int>  color(n_nodes, -1);
+    std::vector<uint> forbidden; // forbidden[c] == node <=> color c is used by a neighbor of node
+    std::vector<std::vector<uint>> sets;
+
+    for(uint node : order)
+    {
+        for(uint nbr : adj(node))
+        {
+            if(color.at(nbr)>=0) forbidden.at(color.at(nbr)) = node;
+        }
+
+        uint c = 0;
+        while(c<sets.size() && forbidden.at(c)==node) ++c;
+        if(c==sets.size())
+        {
+            sets.push_back(std::vector<uint>());
+            forbidden.push_back(n_nodes); // i.e. not forbidden
+        }
+        color.at(node) = c;
+        sets.at(c).push_back(node);
+    }
+
+    // sort each set, for a cache friendly traversal
+    for(auto & s : sets) std::sort(s.begin(), s.end());
+
+    return sets;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<std::vector<uint>> graph_coloring(const std::vector<std::vector<uint>> & adj)
+{
+    return greedy_coloring(adj.size(), [&](const uint node) -> const std::vector<uint> &
+    {
+        return adj.at(node);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<std::vector<uint>> vert_graph_coloring(const AbstractMesh<M,V,E,P> & m)
+{
+    return greedy_coloring(m.num_verts(), [&](const uint vid) -> const std::vector<uint> &
+    {
+        return m.adj_v2v(vid);
+    });
+}
+
+}
@@ -0,0 +1,70 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_GRAPH_COLORING_H
+#define CINO_GRAPH_COLORING_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_mesh.h>
+
+namespace cinolib
+{
+
+/* Greedy coloring of a graph, visiting nodes by decreasing degree (Welsh-Powell).
+ * Adjacent nodes always receive different colors, hence nodes sharing the same
+ * color form an independent set. Nodes are returned grouped by color, which is
+ * handy to process in parallel all the nodes of a set, one set after the other
+ * (e.g. for Gauss-Seidel like updates of the vertices of a mesh).
+*/
+
+CINO_INLINE
+std::vector<std::vector<uint>> graph_coloring(const std::vector<std::vector<uint>> & adj);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// coloring of the vertex graph of a mesh (as defined by adj_v2v)
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<std::vector<uint>> vert_graph_coloring(const AbstractMesh<M,V,E,P> & m);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "graph_coloring.cpp"
+#endif
+
+#endif // CINO_GRAPH_COLORING_H
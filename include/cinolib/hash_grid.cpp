@@ -0,0 +1,277 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/hash_grid.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <cmath>
+
+namespace cinolib
+{
+
+CINO_INLINE
+HashGrid::HashGrid(const double cell_size) : h_req(cell_size), h(cell_size), o(0,0,0)
+{
+    assert(h>0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void HashGrid::build(const std::vector<vec3d> & points)
+{
+    this->points = points;
+    cells.clear();
+
+    // cell coordinates are computed w.r.t. the min corner of the bbox, and the cell size
+    // is enlarged if needed to keep the grid within 2^20 cells per side. This way integer
+    // coordinates never overflow, and keys are unique (no two cells share the same key)
+    vec3d bb_min( inf_double,  inf_double,  inf_double);
+    vec3d bb_max(-inf_double, -inf_double, -inf_double);
+    for(const vec3d & p : points)
+    {
+        bb_min = bb_min.min(p);
+        bb_max = bb_max.max(p);
+    }
+    o = points.empty() ? vec3d(0,0,0) : bb_min;
+    h = h_req;
+    if(!points.empty())
+    {
+        double extent = (bb_max-bb_min).max_entry();
+        h = std::max(h_req, extent/double(1<<20));
+    }
+
+    // sort (key,id) pairs rather than ids, to keep the keys in cache while sorting
+    std::vector<std::pair<uint64_t,uint>> keys(points.size());
+    PARALLEL_FOR(0, points.size(), 10000, [&](uint id)
+    {
+        int i,j,k;
+        cell_coords(points.at(id), i, j, k);
+        keys.at(id) = std::make_pair(cell_key(i,j,k), id);
+    });
+    std::sort(keys.begin(), keys.end());
+
+    sorted_ids.resize(points.size());
+    uint n_cells = 0;
+    for(uint i=0; i<keys.size(); ++i)
+    {
+        sorted_ids.at(i) = keys.at(i).second;
+        if(i==0 || keys.at(i).first!=keys.at(i-1).first) ++n_cells;
+    }
+
+    cells.reserve(n_cells);
+    uint beg = 0;
+    for(uint i=1; i<=keys.size(); ++i)
+    {
+        if(i==keys.size() || keys.at(i).first!=keys.at(beg).first)
+        {
+            cells[keys.at(beg).first] = std::make_pair(beg,i);
+            beg = i;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename Func>
+CINO_INLINE
+void HashGrid::for_each_point_in_ball(const vec3d & p, const double radius, const Func & func) const
+{
+    double r_sqrd = radius*radius;
+    int i_min, j_min, k_min, i_max, j_max, k_max;
+    cell_coords(p-vec3d(radius,radius,radius), i_min, j_min, k_min);
+    cell_coords(p+vec3d(radius,radius,radius), i_max, j_max, k_max);
+
+    // if the ball overlaps more cells than the non empty ones, scanning the points is cheaper
+    double n_range = double(i_max-i_min+1)*double(j_max-j_min+1)*double(k_max-k_min+1);
+    if(n_range > double(points.size()))
+    {
+        for(uint id=0; id<points.size(); ++id)
+        {
+            double d = points[id].dist_squared(p);
+            if(d<=r_sqrd) func(id,d);
+        }
+        return;
+    }
+
+    for(int i=i_min; i<=i_max; ++i)
+    for(int j=j_min; j<=j_max; ++j)
+    for(int k=k_min; k<=k_max; ++k)
+    {
+        auto query = cells.find(cell_key(i,j,k));
+        if(query==cells.end()) continue;
+
+        for(uint pos=query->second.first; pos<query->second.second; ++pos)
+        {
+            uint   id = sorted_ids[pos];
+            double d  = points[id].dist_squared(p);
+            if(d<=r_sqrd) func(id,d);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename Func>
+CINO_INLINE
+void HashGrid::for_each_pair_in_range(const double radius, const Func & func) const
+{
+    double r_sqrd = radius*radius;
+    int    n      = static_cast<int>(std::min(std::ceil(radius/h), double(1<<20)));
+
+    // if the range spans many cells, visiting all the neighbor cells is more expensive
+    // than building (and using) a coarser grid with cells as big as the range
+    if(n>1 && std::pow(2.0*n+1.0, 3.0) > double(cells.size()))
+    {
+        HashGrid coarse(radius);
+        coarse.build(points);
+        coarse.for_each_pair_in_range(radius, func);
+        return;
+    }
+
+    std::vector<std::pair<uint64_t,std::pair<uint,uint>>> cell_list(cells.begin(), cells.end());
+
+    const uint64_t mask  = (1ull<<21)-1;
+    const int      c_max = (1<<20);
+
+    auto test_pair = [&](const uint pos0, const uint pos1)
+    {
+        uint   id0 = sorted_ids[pos0];
+        uint   id1 = sorted_ids[pos1];
+        double d   = points[id0].dist_squared(points[id1]);
+        if(d<=r_sqrd) func(id0,id1,d);
+    };
+
+    PARALLEL_FOR(0, cell_list.size(), 100, [&](uint c)
+    {
+        uint64_t key = cell_list[c].first;
+        uint     beg = cell_list[c].second.first;
+        uint     end = cell_list[c].second.second;
+
+        // pairs inside the cell
+        for(uint pos0=beg;    pos0<end; ++pos0)
+        for(uint pos1=pos0+1; pos1<end; ++pos1)
+        {
+            test_pair(pos0,pos1);
+        }
+
+        // pairs with the neighbor cells that follow in lexicographic order
+        // (the others will visit this cell), so that each pair is found once.
+        // Points lie in cells [0,2^20] along each axis, so ranges are clipped
+        int i = static_cast<int>((key >> 42) & mask) - 1;
+        int j = static_cast<int>((key >> 21) & mask) - 1;
+        int k = static_cast<int>((key      ) & mask) - 1;
+        for(int ii=i;                  ii<=std::min(i+n,c_max); ++ii)
+        for(int jj=std::max(j-n,0);    jj<=std::min(j+n,c_max); ++jj)
+        for(int kk=std::max(k-n,0);    kk<=std::min(k+n,c_max); ++kk)
+        {
+            if(ii==i && (jj<j || (jj==j && kk<=k))) continue;
+
+            auto query = cells.find(cell_key(ii,jj,kk));
+            if(query==cells.end()) continue;
+
+            for(uint pos0=beg;                  pos0<end;                   ++pos0)
+            for(uint pos1=query->second.first;  pos1<query->second.second;  ++pos1)
+            {
+                test_pair(pos0,pos1);
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void HashGrid::points_in_ball(const vec3d & p, const double radius, std::vector<uint> & ids) const
+{
+    ids.clear();
+    for_each_point_in_ball(p, radius, [&ids](const uint id, const double)
+    {
+        ids.push_back(id);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int HashGrid::closest_point(const vec3d & p, const double radius) const
+{
+    int    closest  = -1;
+    double min_dist = inf_double;
+    for_each_point_in_ball(p, radius, [&](const uint id, const double d)
+    {
+        if(d<min_dist || (d==min_dist && (int)id<closest))
+        {
+            min_dist = d;
+            closest  = id;
+        }
+    });
+    return closest;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void HashGrid::cell_coords(const vec3d & p, int & i, int & j, int & k) const
+{
+    // clamp in floating point before converting to integers. Coordinates
+    // of points used to build the grid are always within [0,2^20]
+    auto coord = [&](const double x, const double x0) -> int
+    {
+        double c = std::floor((x-x0)/h);
+        return static_cast<int>(std::min(std::max(c, -1.0), double((1<<20)+1)));
+    };
+    i = coord(p.x(), o.x());
+    j = coord(p.y(), o.y());
+    k = coord(p.z(), o.z());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t HashGrid::cell_key(const int i, const int j, const int k) const
+{
+    // pack the three cell coordinates in a 64 bits key, 21 bits each. Since
+    // they range in [-1,2^20+1] (see cell_coords), keys are unique
+    assert(i>=-1 && i<=(1<<20)+1);
+    assert(j>=-1 && j<=(1<<20)+1);
+    assert(k>=-1 && k<=(1<<20)+1);
+    return (uint64_t(i+1) << 42) |
+           (uint64_t(j+1) << 21) |
+           (uint64_t(k+1));
+}
+
+}
@@ -0,0 +1,126 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_HASH_GRID_H
+#define CINO_HASH_GRID_H
+
+#include <cinolib/geometry/vec3.h>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace cinolib
+{
+
+/* Sparse uniform grid for fast proximity queries on point sets. Space is partitioned
+ * into cubic cells of edge cell_size, and only non empty cells are stored (in a hash
+ * map), therefore memory is linear in the number of points, regardless of their spread.
+ * Points are sorted by cell, so that points falling in the same cell are contiguous
+ * in memory. Queries are thread safe, and can be issued in parallel.
+ *
+ * For best performances, cell_size should be in the order of the query radius. To keep
+ * cell coordinates and keys exact, the grid never exceeds 2^20 cells per side: for tiny
+ * cells and large point sets the cell size is enlarged to extent/2^20 (see cell_size()).
+ *
+ * Usage:
+ *
+ *     HashGrid grid(radius);
+ *     grid.build(points);
+ *     grid.for_each_point_in_ball(p, radius, [&](const uint id, const double dist_sqrd)
+ *     {
+ *         ...
+ *     });
+*/
+
+class HashGrid
+{
+    public:
+
+        explicit HashGrid(const double cell_size = 1.0);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void build(const std::vector<vec3d> & points);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint          num_points()         const { return points.size();   }
+        uint          num_cells()          const { return cells.size();    }
+        double        cell_size()          const { return h;               }
+        const vec3d & point(const uint id) const { return points.at(id);   }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // calls func(id,dist_sqrd) for each point within distance radius from p
+        template<typename Func>
+        void for_each_point_in_ball(const vec3d & p, const double radius, const Func & func) const;
+
+        // returns the ids of all the points within distance radius from p
+        void points_in_ball(const vec3d & p, const double radius, std::vector<uint> & ids) const;
+
+        // returns the id of the point closest to p within distance radius (-1 if none)
+        int closest_point(const vec3d & p, const double radius) const;
+
+        // calls func(id0,id1,dist_sqrd) once for each (unordered) pair of points within
+        // distance radius from each other. Cells are processed in parallel, therefore
+        // func may be called concurrently from multiple threads
+        template<typename Func>
+        void for_each_pair_in_range(const double radius, const Func & func) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // integer coordinates of the cell containing p, relative to the min corner of the
+        // grid and clamped to [-1,2^20+1], which is safe also for far away query points
+        void     cell_coords(const vec3d & p, int & i, int & j, int & k) const;
+        uint64_t cell_key   (const int i, const int j, const int k) const;
+
+    protected:
+
+        double                h_req;      // cell size requested at construction time
+        double                h;          // actual cell size
+        vec3d                 o;          // grid origin (min corner of the points bbox)
+        std::vector<vec3d>    points;     // point coordinates
+        std::vector<uint>     sorted_ids; // point ids, sorted by cell
+        std::unordered_map<uint64_t,std::pair<uint,uint>> cells; // cell => [beg,end) range in sorted_ids
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "hash_grid.cpp"
+#endif
+
+#endif // CINO_HASH_GRID_H
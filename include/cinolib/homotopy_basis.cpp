@@ -37,6 +37,9 @@
 #include <cinolib/shortest_path_tree.h>
 #include <cinolib/mst.h>
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <atomic>
+#include <thread>
 
 namespace cinolib
 {
@@ -87,27 +90,55 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
                       std::vector<std::vector<uint>> & basis,
                       std::vector<bool>              & tree,
                       std::vector<bool>              & cotree)
+{
+    HomotopyBasisWorkspace ws;
+    return homotopy_basis(m, root, inf_double, basis, tree, cotree, ws);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const uint                           root,
+                      const double                         max_length,
+                      std::vector<std::vector<uint>>     & basis,
+                      std::vector<bool>                  & tree,
+                      std::vector<bool>                  & cotree,
+                      HomotopyBasisWorkspace             & ws)
 {
     assert(root<m.num_verts());
 
-    shortest_path_tree(m, root, tree);
+    shortest_path_tree(m, root, tree, ws.dist, ws.parent);
 
-    // Compute the cotree as the Maximum Spanning Tree of the dual of M,
-    // without considering dual edges that cross edges of primal tree.
-    //
-    // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights
-    std::vector<float> edge_weights(m.num_edges(),0);
-    std::vector<bool>  edge_mask(m.num_edges()); // restrict Dijkstra to the edges in tree only
-    for(uint eid=0; eid<m.num_edges(); ++eid) edge_mask.at(eid) = !tree.at(eid);
+    // Each edge not in tree generates a loop, made of the edge itself and the tree paths
+    // from its endpoints to the root, whose lengths are the root distances of the endpoints
+    ws.edge_weights.assign(m.num_edges(), 0.f);
+    ws.loop_lengths.clear();
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
         if(tree.at(eid)) continue;
-        std::vector<uint> tmp;
-        edge_weights.at(eid) -= m.edge_length(eid);
-        edge_weights.at(eid) -= dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, tmp);
-        edge_weights.at(eid) -= dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, tmp);
+        ws.edge_weights.at(eid) -= m.edge_length(eid);
+        ws.edge_weights.at(eid) -= ws.dist.at(m.edge_vert_id(eid,0));
+        ws.edge_weights.at(eid) -= ws.dist.at(m.edge_vert_id(eid,1));
+        ws.loop_lengths.push_back(m.edge_length(eid) + ws.dist.at(m.edge_vert_id(eid,0)) + ws.dist.at(m.edge_vert_id(eid,1)));
+    }
+
+    // The basis is made of 2g such loops: it cannot be shorter than the 2g shortest ones
+    int n_loops = (int)m.num_edges() - (int)m.num_verts() - (int)m.num_polys() + 2;
+    if(max_length < inf_double && n_loops > 0 && n_loops <= (int)ws.loop_lengths.size())
+    {
+        std::nth_element(ws.loop_lengths.begin(), ws.loop_lengths.begin()+n_loops-1, ws.loop_lengths.end());
+        double lower_bound = 0.0;
+        for(int i=0; i<n_loops; ++i) lower_bound += ws.loop_lengths.at(i);
+        if(lower_bound > max_length) return inf_double;
     }
-    MST_on_dual_mask_on_edges(m, edge_weights, tree, cotree); // use tree as edge mask
+
+    // Compute the cotree as the Maximum Spanning Tree of the dual of M,
+    // without considering dual edges that cross edges of primal tree.
+    //
+    // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights
+    MST_on_dual_mask_on_edges(m, ws.edge_weights, tree, cotree); // use tree as edge mask
 
     // Find the edges neither in tree, nor in cotree
     std::vector<uint> generators;
@@ -117,15 +148,19 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
     }
     assert(m.genus()*2 == (int)generators.size());
 
-    // Start from each such edge, and close a loop with its two endpoints
+    // Start from each such edge, and close a loop with its two endpoints,
+    // walking up the tree to the root
     basis.clear();
     double length = 0.0;
     for(uint eid : generators)
     {
+        uint v0 = m.edge_vert_id(eid,0);
+        uint v1 = m.edge_vert_id(eid,1);
+        length += m.edge_length(eid) + ws.dist.at(v0) + ws.dist.at(v1);
+
         std::vector<uint> e0_to_root, e1_to_root;
-        length += m.edge_length(eid);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, e0_to_root);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, e1_to_root);
+        for(int vid=v0; vid!=-1; vid=ws.parent.at(vid)) e0_to_root.push_back(vid);
+        for(int vid=v1; vid!=-1; vid=ws.parent.at(vid)) e1_to_root.push_back(vid);
         e1_to_root.pop_back();
         std::reverse(e1_to_root.begin(), e1_to_root.end());
         std::copy(e1_to_root.begin(), e1_to_root.end(), std::back_inserter(e0_to_root));
@@ -146,30 +181,64 @@ void homotopy_basis(AbstractPolygonMesh<M,V,E,P> & m,
     //
     if(data.globally_shortest)
     {
-        double best_length = inf_double;
-        uint   best_root;
-        std::vector<std::vector<uint>> best_basis;
-        std::vector<bool>              best_tree;
-        std::vector<bool>              best_cotree;
-
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+        // the basis centered at data.root is the first candidate, and its
+        // length is the initial bound used to prune all the other roots
+        HomotopyBasisWorkspace ws;
+        double best_length = homotopy_basis(m, data.root, inf_double, data.loops, data.tree, data.cotree, ws);
+
+        // roots are distributed among threads in a round robin fashion. Each thread keeps its
+        // own workspace and best basis, while the bound (i.e. the length of the shortest basis
+        // found so far, by any thread) is shared
+        struct Candidate
         {
-            double length = homotopy_basis(m, vid, data.loops, data.tree, data.cotree);
+            double                         length = inf_double;
+            uint                           root   = 0;
+            std::vector<std::vector<uint>> loops;
+            std::vector<bool>              tree;
+            std::vector<bool>              cotree;
+        };
+        const static unsigned n_threads_hint = std::thread::hardware_concurrency();
+        const static unsigned n_threads      = (n_threads_hint==0u) ? 8u : n_threads_hint;
+        uint n_chunks = std::max(1u, std::min(n_threads, m.num_verts()));
+        std::vector<Candidate> best(n_chunks);
+        std::atomic<double>    bound(best_length);
+
+        PARALLEL_FOR(0, n_chunks, 0, [&](uint c)
+        {
+            HomotopyBasisWorkspace         ws;
+            std::vector<std::vector<uint>> loops;
+            std::vector<bool>              tree, cotree;
+            for(uint vid=c; vid<m.num_verts(); vid+=n_chunks)
+            {
+                if(vid==data.root) continue;
+                double length = homotopy_basis(m, vid, bound.load(), loops, tree, cotree, ws);
+                if(length < best.at(c).length)
+                {
+                    best.at(c).length = length;
+                    best.at(c).root   = vid;
+                    std::swap(best.at(c).loops,  loops);
+                    std::swap(best.at(c).tree,   tree);
+                    std::swap(best.at(c).cotree, cotree);
+
+                    double b = bound.load();
+                    while(length < b && !bound.compare_exchange_weak(b, length)) {}
+                }
+            }
+        });
 
-            if(length < best_length)
+        // in case of ties, prefer the root with lowest ID
+        for(Candidate & c : best)
+        {
+            if(c.length < best_length || (c.length == best_length && c.root < data.root))
             {
-                best_root   = vid;
-                best_length = length;
-                best_basis  = data.loops;
-                best_tree   = data.tree;
-                best_cotree = data.cotree;
+                best_length = c.length;
+                data.root   = c.root;
+                std::swap(data.loops,  c.loops);
+                std::swap(data.tree,   c.tree);
+                std::swap(data.cotree, c.cotree);
             }
         }
-        data.loops  = best_basis;
-        data.root   = best_root;
         data.length = best_length;
-        data.tree   = best_tree;
-        data.cotree = best_cotree;
     }
     else
     {
@@ -111,7 +111,7 @@ std::ostream & operator<<(std::ostream & in, const RefinementStats & stats);
 typedef struct
 {
     // INPUT: SETTINGS
-    bool  globally_shortest  = false; // cost for globally shortest is O(n^2 log n). When this is set to true, root will contain the root of the globally shortest basis
+    bool  globally_shortest  = false; // cost for globally shortest is O(n^2 log n) (roots run in parallel, and are pruned early). When this is set to true, root will contain the root of the globally shortest basis
     uint  root               = 0;     // cost for a base centered at root is O(n log n)
 
     // INPUT: REFINEMENT OPTIONS AND STATISTICS
@@ -153,6 +153,33 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// working buffers of the basis computation. They can be reused across
+// roots, avoiding to reallocate them at each call (see below)
+typedef struct
+{
+    std::vector<double> dist;         // distance of each vertex from the root
+    std::vector<int>    parent;       // parent of each vertex in the shortest path tree
+    std::vector<float>  edge_weights; // (minus) length of the loop generated by each edge
+    std::vector<double> loop_lengths; // length of the loop generated by each non tree edge
+}
+HomotopyBasisWorkspace;
+
+// Computes the basis centered at root, unless its length certainly exceeds
+// max_length. In that case the basis is not computed, and inf_double is returned.
+// The bound is the sum of the 2g shortest loops generated by non tree edges, and
+// it is available right after the shortest path tree, before computing the cotree
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const uint                           root,
+                      const double                         max_length,
+                      std::vector<std::vector<uint>>     & basis,
+                      std::vector<bool>                  & tree,
+                      std::vector<bool>                  & cotree,
+                      HomotopyBasisWorkspace             & ws);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // globally detaches loops in the homotopy basis
 template<class M, class V, class E, class P>
 CINO_INLINE
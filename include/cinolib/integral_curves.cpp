@@ -0,0 +1,430 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/integral_curves.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/geometry/triangle_utils.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace cinolib
+{
+
+CINO_INLINE
+Curve IntegralCurves::curve(const uint cid) const
+{
+    Curve c;
+    for(uint i=offsets.at(cid); i<offsets.at(cid+1); ++i)
+    {
+        Curve::Sample s;
+        s.pos  = points.at(i);
+        s.pid  = samples.at(i).pid;
+        s.bary = std::vector<double>(samples.at(i).bary, samples.at(i).bary+4);
+        c.append_sample(s);
+    }
+    return c;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+IntegralCurveSample integral_curve_seed(const Mesh & m, const uint vid)
+{
+    assert(!m.adj_v2p(vid).empty());
+    IntegralCurveSample s;
+    s.pid = m.adj_v2p(vid).front();
+    s.bary[m.poly_vert_offset(s.pid,vid)] = 1;
+    return s;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+IntegralCurveSample integral_curve_seed(const uint pid, const std::vector<double> & bary)
+{
+    assert(bary.size()<=4);
+    IntegralCurveSample s;
+    s.pid = pid;
+    for(uint i=0; i<bary.size(); ++i) s.bary[i] = bary.at(i);
+    return s;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// gradients of the barycentric coordinates of an element (zero if degenerate)
+template<class M, class V, class E, class P>
+CINO_INLINE
+void integral_curve_bary_gradients(const Trimesh<M,V,E,P> & m, const uint pid, vec3d grad[4])
+{
+    vec3d  v[3] = { m.poly_vert(pid,0), m.poly_vert(pid,1), m.poly_vert(pid,2) };
+    vec3d  n    = (v[1]-v[0]).cross(v[2]-v[0]);
+    double nn   = n.dot(n);
+    for(uint i=0; i<3; ++i)
+    {
+        grad[i] = (nn>0) ? n.cross(v[(i+2)%3]-v[(i+1)%3])/nn : vec3d(0,0,0);
+    }
+    grad[3] = vec3d(0,0,0);
+}
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void integral_curve_bary_gradients(const Tetmesh<M,V,E,F,P> & m, const uint pid, vec3d grad[4])
+{
+    vec3d v[4] = { m.poly_vert(pid,0), m.poly_vert(pid,1), m.poly_vert(pid,2), m.poly_vert(pid,3) };
+    for(uint i=0; i<4; ++i)
+    {
+        const vec3d & a   = v[(i+1)%4];
+        const vec3d & b   = v[(i+2)%4];
+        const vec3d & c   = v[(i+3)%4];
+        vec3d         n   = (b-a).cross(c-a);
+        double        den = n.dot(v[i]-a);
+        grad[i] = (den!=0) ? n/den : vec3d(0,0,0);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// true if the simplex spanned by vids (vertex, edge or face) lies on the domain boundary
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool integral_curve_on_border(const Trimesh<M,V,E,P> & m, const std::vector<uint> & vids)
+{
+    switch(vids.size())
+    {
+        case 1 : return m.vert_is_boundary(vids.front());
+        case 2 : return m.edge_is_boundary(m.edge_id(vids.at(0), vids.at(1)));
+        default: return false;
+    }
+}
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool integral_curve_on_border(const Tetmesh<M,V,E,F,P> & m, const std::vector<uint> & vids)
+{
+    switch(vids.size())
+    {
+        case 1 : return m.vert_is_on_srf(vids.front());
+        case 2 : return m.edge_is_on_srf(m.edge_id(vids.at(0), vids.at(1)));
+        case 3 : return m.face_is_on_srf(m.face_id(vids));
+        default: return false;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+int integral_curve_trace(const Mesh                             & m,
+                         const VectorField                      & field,
+                         const IntegralCurveSample              & seed,
+                         const uint                               max_steps,
+                               std::vector<vec3d>               & points,
+                               std::vector<IntegralCurveSample> & samples)
+{
+    const double snap_tol = 1e-9; // barycentric coordinates below this are considered zero
+    const double dir_tol  = 1e-9; // tolerance on the sign of directional derivatives
+
+    uint   n   = m.verts_per_poly(seed.pid);
+    uint   pid = seed.pid;
+    double bary[4];
+
+    // snaps tiny coordinates to zero and restores partition of unity
+    auto snap = [&](double b[4])
+    {
+        double sum = 0;
+        for(uint k=0; k<n; ++k)
+        {
+            if(b[k]<=snap_tol) b[k] = 0;
+            sum += b[k];
+        }
+        assert(sum>0);
+        for(uint k=0; k<n; ++k) b[k] /= sum;
+    };
+
+    auto append = [&]()
+    {
+        IntegralCurveSample s;
+        vec3d p(0,0,0);
+        s.pid = pid;
+        for(uint k=0; k<n; ++k)
+        {
+            s.bary[k] = bary[k];
+            p += bary[k] * m.poly_vert(pid,k);
+        }
+        points.push_back(p);
+        samples.push_back(s);
+    };
+
+    for(uint k=0; k<n; ++k) bary[k] = seed.bary[k];
+    snap(bary);
+    append();
+
+    std::vector<uint>   sigma;      // vertices of the simplex containing the current point...
+    std::vector<double> sigma_bary; // ...and their barycentric coordinates
+    std::vector<uint>   cand;       // elements incident to the simplex
+
+    // elements entered so far, along with the simplex they were entered from (bitmask
+    // of the vanishing barycentric coordinates). Entering twice the same way means
+    // that the curve is looping
+    std::unordered_set<uint64_t> entered;
+    while(samples.size()<max_steps)
+    {
+        sigma.clear();
+        sigma_bary.clear();
+        for(uint k=0; k<n; ++k)
+        {
+            if(bary[k]>0)
+            {
+                sigma.push_back(m.poly_vert_id(pid,k));
+                sigma_bary.push_back(bary[k]);
+            }
+        }
+
+        cand.clear();
+        if(sigma.size()==n) cand.push_back(pid); else
+        {
+            for(uint c : m.adj_v2p(sigma.front()))
+            {
+                bool ok = true;
+                for(uint i=1; i<sigma.size() && ok; ++i) ok = m.poly_contains_vert(c, sigma.at(i));
+                if(ok) cand.push_back(c);
+            }
+        }
+
+        // express the current point in the barycentric coordinates of element c
+        auto transfer = [&](const uint c, double b[4])
+        {
+            for(uint k=0; k<n; ++k)
+            {
+                b[k] = 0;
+                uint vid = m.poly_vert_id(c,k);
+                for(uint i=0; i<sigma.size(); ++i) if(sigma.at(i)==vid) b[k] = sigma_bary.at(i);
+            }
+        };
+
+        // pick the incident element whose field enters it the most
+        int    best       = -1;
+        double best_score = -1;
+        double best_db[4];
+        vec3d  grad[4];
+        for(uint c : cand)
+        {
+            vec3d g = field.vec_at(c);
+            if(g.is_null()) continue;
+            g.normalize();
+            integral_curve_bary_gradients(m, c, grad);
+
+            double b[4], db[4];
+            transfer(c, b);
+            bool   valid = true;
+            double score = 0;
+            for(uint k=0; k<n; ++k)
+            {
+                db[k] = grad[k].dot(g);
+                if(b[k]==0)
+                {
+                    if(db[k]<-dir_tol) { valid = false; break; }
+                    db[k]  = std::max(db[k], 0.0);
+                    score += db[k];
+                }
+            }
+            if(valid && score>best_score)
+            {
+                best       = c;
+                best_score = score;
+                std::copy(db, db+4, best_db);
+            }
+        }
+
+        if(best==-1)
+        {
+            if(integral_curve_on_border(m, sigma)) return INTEGRAL_CURVE_END_ON_BORDER;
+
+            // the field converges onto the simplex (ridge): move along it, following the
+            // average field of the incident elements, projected onto the simplex. At vertices,
+            // move along the incident edge where such projection is maximal (if positive)
+            std::vector<uint> span = sigma;
+            vec3d d;
+            if(sigma.size()==1)
+            {
+                uint   vid      = sigma.front();
+                double best_val = dir_tol;
+                for(uint eid : m.adj_v2e(vid))
+                {
+                    vec3d u = m.vert(m.vert_opposite_to(eid,vid)) - m.vert(vid);
+                    u.normalize();
+                    vec3d g(0,0,0);
+                    for(uint c : m.adj_e2p(eid))
+                    {
+                        vec3d tmp = field.vec_at(c);
+                        if(!tmp.is_null()) g += tmp/tmp.length();
+                    }
+                    double val = g.dot(u)/m.adj_e2p(eid).size();
+                    if(val>best_val)
+                    {
+                        best_val = val;
+                        best     = m.adj_e2p(eid).front();
+                        d        = u;
+                        span     = { vid, m.vert_opposite_to(eid,vid) };
+                    }
+                }
+                if(best==-1) return INTEGRAL_CURVE_END_ON_MAXIMA;
+            }
+            else
+            {
+                vec3d g(0,0,0);
+                for(uint c : cand)
+                {
+                    vec3d tmp = field.vec_at(c);
+                    if(!tmp.is_null()) g += tmp/tmp.length();
+                }
+                if(sigma.size()==2)
+                {
+                    vec3d e = m.vert(sigma.at(1)) - m.vert(sigma.at(0));
+                    e.normalize();
+                    d = e * g.dot(e);
+                }
+                else
+                {
+                    vec3d nrm = triangle_normal(m.vert(sigma.at(0)), m.vert(sigma.at(1)), m.vert(sigma.at(2)));
+                    d = g - nrm * g.dot(nrm);
+                }
+                if(d.length()<dir_tol) return INTEGRAL_CURVE_END_ON_MAXIMA;
+                best = cand.front();
+            }
+
+            integral_curve_bary_gradients(m, best, grad);
+            for(uint k=0; k<n; ++k)
+            {
+                bool in_span = std::find(span.begin(), span.end(), m.poly_vert_id(best,k)) != span.end();
+                best_db[k] = (in_span) ? grad[k].dot(d) : 0.0;
+            }
+        }
+
+        // walk straight until the first coordinate vanishes
+        double b[4];
+        transfer(best, b);
+        uint64_t entry = 0;
+        for(uint k=0; k<n; ++k) if(b[k]==0) entry |= 1<<k;
+        if(entry>0 && !entered.insert(uint64_t(best)<<4 | entry).second) return INTEGRAL_CURVE_END_ON_LOOP;
+        double t    = inf_double;
+        int    kmin = -1;
+        for(uint k=0; k<n; ++k)
+        {
+            if(best_db[k]<0 && -b[k]/best_db[k]<t)
+            {
+                t    = -b[k]/best_db[k];
+                kmin = k;
+            }
+        }
+        if(kmin==-1) return INTEGRAL_CURVE_END_ON_MAXIMA; // no ascending direction (null field)
+
+        for(uint k=0; k<n; ++k) bary[k] = b[k] + t*best_db[k];
+        bary[kmin] = 0;
+        pid = best;
+        snap(bary);
+        append();
+    }
+    return INTEGRAL_CURVE_MAX_STEPS;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void integral_curve_trace_all(const Mesh                             & m,
+                              const VectorField                      & field,
+                              const std::vector<IntegralCurveSample> & seeds,
+                                    IntegralCurves                   & curves,
+                              const uint                               max_steps)
+{
+    assert(field.size() == 3*m.num_polys());
+
+    uint budget = (max_steps>0) ? max_steps : 2*m.num_polys();
+
+    // trace each curve in its own buffers...
+    std::vector<std::vector<vec3d>>               points (seeds.size());
+    std::vector<std::vector<IntegralCurveSample>> samples(seeds.size());
+    curves.status.resize(seeds.size());
+    PARALLEL_FOR(0, seeds.size(), 16, [&](uint i)
+    {
+        curves.status.at(i) = integral_curve_trace(m, field, seeds.at(i), budget, points.at(i), samples.at(i));
+    });
+
+    // ...and then flatten them
+    curves.offsets.assign(seeds.size()+1, 0);
+    for(uint i=0; i<seeds.size(); ++i) curves.offsets.at(i+1) = points.at(i).size();
+    PARALLEL_PREFIX_SUM(curves.offsets, 10000);
+
+    curves.points.resize(curves.offsets.back());
+    curves.samples.resize(curves.offsets.back());
+    PARALLEL_FOR(0, seeds.size(), 16, [&](uint i)
+    {
+        std::copy(points.at(i).begin(),  points.at(i).end(),  curves.points.begin()  + curves.offsets.at(i));
+        std::copy(samples.at(i).begin(), samples.at(i).end(), curves.samples.begin() + curves.offsets.at(i));
+        std::vector<vec3d>().swap(points.at(i));
+        std::vector<IntegralCurveSample>().swap(samples.at(i));
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void trace_integral_curves(const Trimesh<M,V,E,P>                 & m,
+                           const VectorField                      & field,
+                           const std::vector<IntegralCurveSample> & seeds,
+                                 IntegralCurves                   & curves,
+                           const uint                               max_steps)
+{
+    integral_curve_trace_all(m, field, seeds, curves, max_steps);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void trace_integral_curves(const Tetmesh<M,V,E,F,P>               & m,
+                           const VectorField                      & field,
+                           const std::vector<IntegralCurveSample> & seeds,
+                                 IntegralCurves                   & curves,
+                           const uint                               max_steps)
+{
+    integral_curve_trace_all(m, field, seeds, curves, max_steps);
+}
+
+}
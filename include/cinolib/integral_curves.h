@@ -0,0 +1,131 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_INTEGRAL_CURVES_H
+#define CINO_INTEGRAL_CURVES_H
+
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/meshes/tetmesh.h>
+#include <cinolib/vector_field.h>
+#include <cinolib/curve.h>
+
+namespace cinolib
+{
+
+/* Headless, batched tracing of integral curves of piecewise constant (i.e. per element)
+ * vector fields, such as the gradient of a scalar field, on triangle and tetrahedral meshes.
+ * Curves are traced in parallel, one per seed, walking from element to element in barycentric
+ * coordinates: samples are created wherever a curve crosses an element boundary. When the field
+ * converges onto a shared edge/face (e.g. along a ridge of the underlying scalar field) the curve
+ * moves along it, following the average direction of the incident elements. Tracing stops when
+ * no ascending direction exists (maxima), when the field points outside of the domain (border),
+ * when the curve enters an element through the same facet (or edge/vertex) twice (loop, e.g. in
+ * rotational fields), or when the step budget is exhausted.
+ *
+ * All curves are stored one after the other in flat buffers, and no rendering code is involved.
+ * IntegralCurves::curve() converts a single curve to a cinolib::Curve (e.g. for further processing),
+ * whereas a DrawableCurve can be built from the range of points of the curve, if rendering is needed.
+*/
+
+// compact per sample record: element id plus barycentric coordinates
+// w.r.t. its vertices (only the first three are used for triangles)
+typedef struct
+{
+    uint  pid     = 0;
+    float bary[4] = {0,0,0,0};
+}
+IntegralCurveSample;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+enum
+{
+    INTEGRAL_CURVE_END_ON_MAXIMA,
+    INTEGRAL_CURVE_END_ON_BORDER,
+    INTEGRAL_CURVE_END_ON_LOOP,
+    INTEGRAL_CURVE_MAX_STEPS,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+typedef struct IntegralCurves
+{
+    std::vector<vec3d>               points;  // curve vertices, all curves one after the other
+    std::vector<IntegralCurveSample> samples; // per point element and barycentric coordinates
+    std::vector<uint>                offsets; // curve i spans [offsets[i],offsets[i+1]) in points/samples
+    std::vector<int>                 status;  // per curve exit status (INTEGRAL_CURVE_END_ON_...)
+    //
+    uint  num_curves()              const { return status.size();                     }
+    uint  curve_size(const uint cid) const { return offsets.at(cid+1) - offsets.at(cid); }
+    Curve curve     (const uint cid) const;
+}
+IntegralCurves;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// max_steps bounds the number of samples of each curve (if zero, twice the number of mesh elements)
+template<class M, class V, class E, class P>
+CINO_INLINE
+void trace_integral_curves(const Trimesh<M,V,E,P>                 & m,
+                           const VectorField                      & field, // per triangle vectors
+                           const std::vector<IntegralCurveSample> & seeds,
+                                 IntegralCurves                   & curves,
+                           const uint                               max_steps = 0);
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void trace_integral_curves(const Tetmesh<M,V,E,F,P>               & m,
+                           const VectorField                      & field, // per tetrahedron vectors
+                           const std::vector<IntegralCurveSample> & seeds,
+                                 IntegralCurves                   & curves,
+                           const uint                               max_steps = 0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// seed located at vertex vid, or at the point having barycentric coordinates bary in element pid
+template<class Mesh>
+CINO_INLINE
+IntegralCurveSample integral_curve_seed(const Mesh & m, const uint vid);
+
+CINO_INLINE
+IntegralCurveSample integral_curve_seed(const uint pid, const std::vector<double> & bary);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "integral_curves.cpp"
+#endif
+
+#endif // CINO_INTEGRAL_CURVES_H
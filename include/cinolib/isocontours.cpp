@@ -0,0 +1,440 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/isocontours.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+Isocontours<M,V,E,P>::Isocontours()
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+Isocontours<M,V,E,P>::Isocontours(const AbstractPolygonMesh<M,V,E,P> & m, const std::vector<double> & iso_values)
+: iso_values(iso_values)
+{
+    extract(m);
+    chain();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+Isocontours<M,V,E,P>::Isocontours(const AbstractPolygonMesh<M,V,E,P> & m, const uint n_levels)
+{
+    if(m.num_verts()>0)
+    {
+        double f_min = m.vert_data(0).uvw[0];
+        double f_max = f_min;
+        for(uint vid=1; vid<m.num_verts(); ++vid)
+        {
+            f_min = std::min(f_min, m.vert_data(vid).uvw[0]);
+            f_max = std::max(f_max, m.vert_data(vid).uvw[0]);
+        }
+        double step = (f_max - f_min)/static_cast<double>(n_levels+1);
+        for(uint i=0; i<n_levels; ++i) iso_values.push_back(f_min + (i+1)*step);
+    }
+    extract(m);
+    chain();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Isocontours<M,V,E,P>::extract(const AbstractPolygonMesh<M,V,E,P> & m)
+{
+    uint nl = iso_values.size();
+    mesh_nv = m.num_verts();
+
+    level_of.resize(nl);
+    std::iota(level_of.begin(), level_of.end(), 0);
+    std::stable_sort(level_of.begin(), level_of.end(), [&](const uint a, const uint b)
+    {
+        return iso_values[a] < iso_values[b];
+    });
+    level_rank.resize(nl);
+    sorted_isos.resize(nl);
+    for(uint k=0; k<nl; ++k)
+    {
+        level_rank[level_of[k]] = k;
+        sorted_isos[k] = iso_values[level_of[k]];
+    }
+
+    // a level crosses an element having field range [f_min,f_max] if f_min < iso <= f_max,
+    // and the crossing levels form a contiguous range [lo,hi) in sorted_isos
+    auto level_range = [&](const double f_min, const double f_max, uint & lo, uint & hi)
+    {
+        lo = std::upper_bound(sorted_isos.begin(), sorted_isos.end(), f_min) - sorted_isos.begin();
+        hi = std::upper_bound(sorted_isos.begin(), sorted_isos.end(), f_max) - sorted_isos.begin();
+    };
+
+    // 1) contour points: one per crossed edge and level, grouped by edge
+    e_offsets.assign(m.num_edges()+1, 0);
+    PARALLEL_FOR(0, m.num_edges(), 1000, [&](uint eid)
+    {
+        double f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0];
+        double f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
+        uint lo, hi;
+        level_range(std::min(f0,f1), std::max(f0,f1), lo, hi);
+        e_offsets[eid+1] = hi - lo;
+    });
+    PARALLEL_PREFIX_SUM(e_offsets, 10000);
+
+    verts.resize(e_offsets.back());
+    v_edge.resize(e_offsets.back());
+    v_level.resize(e_offsets.back());
+    PARALLEL_FOR(0, m.num_edges(), 1000, [&](uint eid)
+    {
+        uint   vid0 = m.edge_vert_id(eid,0);
+        uint   vid1 = m.edge_vert_id(eid,1);
+        double f0   = m.vert_data(vid0).uvw[0];
+        double f1   = m.vert_data(vid1).uvw[0];
+        uint lo, hi;
+        level_range(std::min(f0,f1), std::max(f0,f1), lo, hi);
+        for(uint k=lo; k<hi; ++k)
+        {
+            uint   vid   = e_offsets[eid] + k - lo;
+            double alpha = (sorted_isos[k] - f0)/(f1 - f0);
+            verts[vid]   = (1.0-alpha)*m.vert(vid0) + alpha*m.vert(vid1);
+            v_edge[vid]  = eid;
+            v_level[vid] = level_of[k];
+        }
+    });
+
+    // 2) segments. Walking along the polygon boundary, the contour enters the region above
+    //    the level at an ascending edge, and leaves it at the next descending edge. Each such
+    //    pair generates a segment from the descending to the ascending edge (i.e. higher
+    //    values on the left). Polygons crossed by more than one contour of the same level
+    //    (saddles) are resolved by keeping the regions above the level apart
+    std::vector<uint> p_offsets(m.num_polys()+1, 0);
+    auto poly_segs = [&](const uint pid, uint * out_segs, uint * out_ranks) -> uint
+    {
+        const std::vector<uint> & p_verts = m.adj_p2v(pid);
+        uint n = p_verts.size();
+        std::vector<double> f(n);
+        for(uint i=0; i<n; ++i) f[i] = m.vert_data(p_verts[i]).uvw[0];
+
+        uint lo, hi;
+        level_range(*std::min_element(f.begin(), f.end()), *std::max_element(f.begin(), f.end()), lo, hi);
+        if(n==3 && out_segs==nullptr) return hi - lo; // triangles: exactly one segment per level
+
+        std::vector<uint> p_edges(n);
+        if(out_segs!=nullptr)
+        {
+            for(uint i=0; i<n; ++i) p_edges[i] = m.poly_edge_id(pid, p_verts[i], p_verts[(i+1)%n]);
+        }
+        auto crossing = [&](const uint i, const uint k)
+        {
+            uint eid = p_edges[i];
+            uint beg = e_offsets[eid];
+            return beg + k - level_rank[v_level[beg]];
+        };
+
+        uint count = 0;
+        for(uint k=lo; k<hi; ++k)
+        {
+            double iso = sorted_isos[k];
+            uint   i0  = 0;
+            while(i0<n && !(f[i0]<iso && f[(i0+1)%n]>=iso)) ++i0;
+            assert(i0<n);
+            uint up = 0;
+            for(uint j=0; j<n; ++j)
+            {
+                uint i    = (i0+j)%n;
+                bool a_in = f[i]       >= iso;
+                bool b_in = f[(i+1)%n] >= iso;
+                if(!a_in && b_in)
+                {
+                    if(out_segs!=nullptr) up = crossing(i,k);
+                }
+                else if(a_in && !b_in)
+                {
+                    if(out_segs!=nullptr)
+                    {
+                        out_segs[2*count+0] = crossing(i,k);
+                        out_segs[2*count+1] = up;
+                        out_ranks[count]    = k;
+                    }
+                    ++count;
+                }
+            }
+        }
+        return count;
+    };
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        p_offsets[pid+1] = poly_segs(pid, nullptr, nullptr);
+    });
+    PARALLEL_PREFIX_SUM(p_offsets, 10000);
+
+    std::vector<uint> tmp_segs (2*p_offsets.back());
+    std::vector<uint> tmp_ranks(p_offsets.back());
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        poly_segs(pid, tmp_segs.data() + 2*p_offsets[pid], tmp_ranks.data() + p_offsets[pid]);
+    });
+
+    // 3) group segments by level (counting sort, preserves the polygon order)
+    l_offsets.assign(nl+1, 0);
+    for(uint k : tmp_ranks) ++l_offsets[level_of[k]+1];
+    for(uint lid=0; lid<nl; ++lid) l_offsets[lid+1] += l_offsets[lid];
+    std::vector<uint> pos(l_offsets.begin(), l_offsets.end()-1);
+    segs.resize(tmp_segs.size());
+    for(uint sid=0; sid<tmp_ranks.size(); ++sid)
+    {
+        uint dst = pos[level_of[tmp_ranks[sid]]]++;
+        segs[2*dst+0] = tmp_segs[2*sid+0];
+        segs[2*dst+1] = tmp_segs[2*sid+1];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Isocontours<M,V,E,P>::chain()
+{
+    // each contour point belongs to one level only, hence
+    // levels can be chained in parallel sharing these buffers
+    std::vector<int>     next(verts.size(), -1); // segment leaving a point
+    std::vector<uint8_t> has_prev(verts.size(), false);
+    std::vector<uint8_t> visited(num_segs(), false);
+
+    chains.clear();
+    chains.resize(num_levels());
+    PARALLEL_FOR(0, num_levels(), 2, [&](uint lid)
+    {
+        for(uint sid=l_offsets[lid]; sid<l_offsets[lid+1]; ++sid)
+        {
+            next[segs[2*sid+0]]     = sid;
+            has_prev[segs[2*sid+1]] = true;
+        }
+
+        auto walk = [&](uint sid)
+        {
+            std::vector<uint> chain(1, segs[2*sid]);
+            while(true)
+            {
+                visited[sid] = true;
+                uint vid = segs[2*sid+1];
+                chain.push_back(vid);
+                if(next[vid]<0 || visited[next[vid]]) break;
+                sid = next[vid];
+            }
+            chains[lid].push_back(chain);
+        };
+
+        // open polylines first (starting at the border), then closed loops
+        for(uint sid=l_offsets[lid]; sid<l_offsets[lid+1]; ++sid)
+        {
+            if(!visited[sid] && !has_prev[segs[2*sid]]) walk(sid);
+        }
+        for(uint sid=l_offsets[lid]; sid<l_offsets[lid+1]; ++sid)
+        {
+            if(!visited[sid]) walk(sid);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+int Isocontours<M,V,E,P>::edge_crossing(const uint eid, const uint lid) const
+{
+    uint beg = e_offsets.at(eid);
+    uint end = e_offsets.at(eid+1);
+    if(beg==end) return -1;
+    uint k     = level_rank.at(lid);
+    uint first = level_rank.at(v_level.at(beg));
+    if(k<first || k-first>=end-beg) return -1;
+    return beg + k - first;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint Isocontours<M,V,E,P>::num_segs(const uint lid) const
+{
+    return l_offsets.at(lid+1) - l_offsets.at(lid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint Isocontours<M,V,E,P>::seg_vert_id(const uint lid, const uint sid, const uint off) const
+{
+    assert(sid<num_segs(lid) && off<2);
+    return segs.at(2*(l_offsets.at(lid)+sid)+off);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<vec3d> Isocontours<M,V,E,P>::polyline_verts(const uint lid, const uint i) const
+{
+    std::vector<vec3d> res;
+    for(uint vid : chains.at(lid).at(i)) res.push_back(verts.at(vid));
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> Isocontours<M,V,E,P>::tessellate(Trimesh<M,V,E,P> & m) const
+{
+    // contours must have been extracted from this very mesh
+    assert(e_offsets.size()==m.num_edges()+1 && mesh_nv==m.num_verts());
+
+    // 1) a mesh vertex for each contour point. Points falling on an existing vertex
+    //    (iso == f) and coincident points (levels having the same iso value) are
+    //    mapped to the same vertex
+    std::vector<uint> new_vids;
+    std::vector<uint> p2v(num_verts());
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    for(uint vid=e_offsets[eid]; vid<e_offsets[eid+1]; ++vid)
+    {
+        uint   v0  = m.edge_vert_id(eid,0);
+        uint   v1  = m.edge_vert_id(eid,1);
+        double iso = iso_values[v_level[vid]];
+        if(iso==m.vert_data(v0).uvw[0]) p2v[vid] = v0; else
+        if(iso==m.vert_data(v1).uvw[0]) p2v[vid] = v1; else
+        if(vid>e_offsets[eid] && iso==iso_values[v_level[vid-1]]) p2v[vid] = p2v[vid-1]; else
+        {
+            p2v[vid] = m.vert_add(verts[vid]);
+            m.vert_data(p2v[vid]).uvw[0] = iso;
+            new_vids.push_back(p2v[vid]);
+        }
+    }
+
+    // vertices along each crossed edge, from its first to its second endpoint
+    auto edge_chain = [&](const uint eid, const uint v0, const uint v1)
+    {
+        std::vector<uint> chain;
+        for(uint vid=e_offsets[eid]; vid<e_offsets[eid+1]; ++vid) chain.push_back(p2v[vid]);
+        if(m.vert_data(v0).uvw[0] > m.vert_data(v1).uvw[0]) std::reverse(chain.begin(), chain.end());
+        chain.insert(chain.begin(), v0);
+        chain.push_back(v1);
+        chain.erase(std::unique(chain.begin(), chain.end()), chain.end());
+        return chain;
+    };
+
+    // edge data will be copied to the sub edges of split edges
+    std::vector<std::pair<std::vector<uint>,E>> split_edges;
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        if(e_offsets[eid]==e_offsets[eid+1]) continue;
+        std::vector<uint> chain = edge_chain(eid, m.edge_vert_id(eid,0), m.edge_vert_id(eid,1));
+        if(chain.size()>2) split_edges.push_back(std::make_pair(chain, m.edge_data(eid)));
+    }
+
+    // 2) the field is linear within each triangle, hence the region between two consecutive
+    //    levels is a convex polygon having as vertices the boundary points (corners and contour
+    //    points) with field in between. Crossed triangles are replaced by a fan triangulation of
+    //    each such polygon (splitting one edge at a time would instead generate edges that cut
+    //    through the contours of the other levels)
+    std::vector<uint> to_remove;
+    uint np = m.num_polys();
+    for(uint pid=0; pid<np; ++pid)
+    {
+        std::vector<uint>   ring;   // triangle boundary, including contour points
+        std::vector<double> limits; // field values of the contour points
+        for(uint i=0; i<3; ++i)
+        {
+            uint v0  = m.poly_vert_id(pid,i);
+            uint v1  = m.poly_vert_id(pid,(i+1)%3);
+            uint eid = m.poly_edge_id(pid,v0,v1);
+            std::vector<uint> chain = edge_chain(eid,v0,v1);
+            ring.insert(ring.end(), chain.begin(), chain.end()-1);
+            for(uint vid=e_offsets[eid]; vid<e_offsets[eid+1]; ++vid) limits.push_back(iso_values[v_level[vid]]);
+        }
+        if(ring.size()==3) continue;
+        to_remove.push_back(pid);
+
+        limits.push_back(-inf_double);
+        limits.push_back( inf_double);
+        std::sort(limits.begin(), limits.end());
+        limits.erase(std::unique(limits.begin(), limits.end()), limits.end());
+
+        for(uint i=0; i+1<limits.size(); ++i)
+        {
+            std::vector<uint> band;
+            for(uint vid : ring)
+            {
+                double f = m.vert_data(vid).uvw[0];
+                if(f>=limits[i] && f<=limits[i+1]) band.push_back(vid);
+            }
+            for(uint j=1; j+1<band.size(); ++j)
+            {
+                uint new_pid = m.poly_add(band[0], band[j], band[j+1]);
+                m.poly_data(new_pid) = m.poly_data(pid);
+                if(m.mesh_data().update_normals) m.update_p_normal(new_pid);
+            }
+        }
+    }
+    m.polys_remove(to_remove);
+
+    for(const auto & e : split_edges)
+    {
+        for(uint i=0; i+1<e.first.size(); ++i)
+        {
+            int eid = m.edge_id(e.first[i], e.first[i+1]);
+            if(eid>=0) m.edge_data(eid) = e.second;
+        }
+    }
+    if(m.mesh_data().update_normals)
+    {
+        for(uint vid : new_vids) m.update_v_normal(vid);
+    }
+    return new_vids;
+}
+
+}
@@ -0,0 +1,137 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_ISOCONTOURS_H
+#define CINO_ISOCONTOURS_H
+
+#include <vector>
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/geometry/vec3.h>
+
+namespace cinolib
+{
+
+/* Extracts many isocontours of the scalar field stored in the vertices of a
+ * surface mesh (uvw[0]) in a single parallel pass over its polygons. This is
+ * meant for contour plots with tens/hundreds of levels, where instantiating one
+ * Isocontour per level would cost a full mesh traversal each.
+ *
+ * A vertex is considered above a level if f >= iso_value, hence every contour
+ * point lies along a mesh edge having one endpoint strictly below, and no special
+ * case is needed for curves passing exactly through vertices or edges. Contour
+ * points are shared among adjacent polygons: they are created once per crossed
+ * edge and level, and can be retrieved with edge_crossing(). Segments are grouped
+ * per level and oriented so that higher values are on their left (according to
+ * the polygon winding). Segments are also chained into polylines (one list of
+ * contour points each, closed polylines repeat their first point at the end).
+ * Chaining assumes a manifold and consistently oriented mesh; elsewhere
+ * polylines are simply broken into multiple pieces.
+*/
+
+template<class M = Mesh_std_attributes, // default template arguments
+         class V = Vert_std_attributes,
+         class E = Edge_std_attributes,
+         class P = Polygon_std_attributes>
+class Isocontours
+{
+    public:
+
+        explicit Isocontours();
+        explicit Isocontours(const AbstractPolygonMesh<M,V,E,P> & m, const std::vector<double> & iso_values);
+        explicit Isocontours(const AbstractPolygonMesh<M,V,E,P> & m, const uint n_levels); // evenly spaced within the field range
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint   num_levels()                  const { return iso_values.size();  }
+        double iso_value (const uint lid)    const { return iso_values.at(lid); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint          num_verts()                    const { return verts.size();        }
+        const vec3d & vert      (const uint vid)     const { return verts.at(vid);       }
+        uint          vert_edge (const uint vid)     const { return v_edge.at(vid);      }
+        uint          vert_level(const uint vid)     const { return v_level.at(vid);     }
+        int           edge_crossing(const uint eid, const uint lid) const; // contour point of level lid along edge eid (-1 if none)
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_segs   ()                                            const { return segs.size()/2; }
+        uint num_segs   (const uint lid)                              const;
+        uint seg_vert_id(const uint lid, const uint sid, const uint off) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        const std::vector<std::vector<uint>> & polylines     (const uint lid) const { return chains.at(lid); }
+              std::vector<vec3d>               polyline_verts(const uint lid, const uint i) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // splits the mesh edges so that all the contours of all the levels become
+        // chains of mesh edges. Returns the ids of the newly generated vertices.
+        // Contour points are addressed by edge id, hence m must be the very mesh
+        // the contours were extracted from, unchanged. After the call the mesh is
+        // changed too: contours must be extracted again to be used with it
+        std::vector<uint> tessellate(Trimesh<M,V,E,P> & m) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        void extract(const AbstractPolygonMesh<M,V,E,P> & m);
+        void chain();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint                                        mesh_nv = 0;  // number of vertices of the mesh contours were extracted from
+        std::vector<double>                         iso_values;   // per level, in the order given by the user
+        std::vector<double>                         sorted_isos;  // iso values, in ascending order
+        std::vector<uint>                           level_rank;   // position of each level in sorted_isos
+        std::vector<uint>                           level_of;     // inverse of level_rank
+        std::vector<vec3d>                          verts;        // contour points, grouped by edge
+        std::vector<uint>                           v_edge;       // per point, edge it lies on
+        std::vector<uint>                           v_level;      // per point, level it belongs to
+        std::vector<uint>                           e_offsets;    // points along edge eid are in [e_offsets[eid],e_offsets[eid+1])
+        std::vector<uint>                           segs;         // serialized pairs of points, grouped by level
+        std::vector<uint>                           l_offsets;    // segments of level lid are in [l_offsets[lid],l_offsets[lid+1])
+        std::vector<std::vector<std::vector<uint>>> chains;       // per level polylines
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "isocontours.cpp"
+#endif
+
+#endif // CINO_ISOCONTOURS_H
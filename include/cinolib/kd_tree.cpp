@@ -0,0 +1,286 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/kd_tree.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <cassert>
+
+namespace cinolib
+{
+
+CINO_INLINE
+KdTree::KdTree(const uint items_per_leaf) : items_per_leaf(std::max(items_per_leaf,1u))
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::build(const std::vector<vec3d> & points)
+{
+    build(points, std::vector<AABB>());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::build(const std::vector<vec3d> & in_points, const std::vector<AABB> & boxes)
+{
+    assert(boxes.empty() || boxes.size()==in_points.size());
+    clear();
+    if(in_points.empty()) return;
+
+    ids.resize(in_points.size());
+    for(uint i=0; i<ids.size(); ++i) ids.at(i) = i;
+
+    nodes.reserve(num_nodes(in_points.size()));
+    build_node(0, ids.size(), in_points, boxes);
+
+    points.resize(ids.size());
+    for(uint i=0; i<ids.size(); ++i) points.at(i) = in_points.at(ids.at(i));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint KdTree::build_node(const uint beg, const uint end, const std::vector<vec3d> & in_points, const std::vector<AABB> & boxes)
+{
+    uint nid = nodes.size();
+    nodes.push_back(Node());
+
+    AABB point_box, item_box;
+    for(uint i=beg; i<end; ++i) point_box.push(in_points.at(ids.at(i)));
+    if(boxes.empty()) item_box = point_box;
+    else for(uint i=beg; i<end; ++i) item_box.push(boxes.at(ids.at(i)));
+
+    uint child[2] = { 0, 0 };
+    if(end-beg > items_per_leaf)
+    {
+        // split at the median of the widest axis
+        vec3d delta = point_box.delta();
+        int   axis  = (delta[0]>=delta[1] && delta[0]>=delta[2]) ? 0 : ((delta[1]>=delta[2]) ? 1 : 2);
+        uint  mid   = beg + (end-beg)/2;
+        std::nth_element(ids.begin()+beg, ids.begin()+mid, ids.begin()+end, [&](const uint a, const uint b)
+        {
+            return in_points.at(a)[axis] < in_points.at(b)[axis];
+        });
+        child[0] = build_node(beg, mid, in_points, boxes);
+        child[1] = build_node(mid, end, in_points, boxes);
+    }
+
+    // nodes may have been reallocated by the recursive calls: fill the node only now
+    Node & n     = nodes.at(nid);
+    n.point_box  = point_box;
+    n.item_box   = item_box;
+    n.beg        = beg;
+    n.end        = end;
+    n.child[0]   = child[0];
+    n.child[1]   = child[1];
+    return nid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint KdTree::num_nodes(const uint n_items) const
+{
+    if(n_items <= items_per_leaf) return 1;
+    return 1 + num_nodes(n_items/2) + num_nodes(n_items - n_items/2);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::clear()
+{
+    nodes.clear();
+    ids.clear();
+    points.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MemoryFootprint KdTree::memory_footprint() const
+{
+    MemoryFootprint mf;
+    mf.add("nodes",  nodes);
+    mf.add("ids",    ids);
+    mf.add("points", points);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool KdTree::closest_point(const vec3d & p, uint & id, double & dist, const Skip & skip) const
+{
+    if(empty()) return false;
+    double dist_sqrd = inf_double;
+    id = ids.size(); // i.e. invalid
+    closest_point(0, p, id, dist_sqrd, skip);
+    if(id == ids.size()) return false;
+    dist = std::sqrt(dist_sqrd);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::closest_point(const uint nid, const vec3d & p, uint & id, double & dist_sqrd, const Skip & skip) const
+{
+    const Node & n = nodes.at(nid);
+    if(n.child[0]==0)
+    {
+        for(uint i=n.beg; i<n.end; ++i)
+        {
+            double d = points.at(i).dist_squared(p);
+            if(d < dist_sqrd && (!skip || !skip(ids.at(i))))
+            {
+                dist_sqrd = d;
+                id        = ids.at(i);
+            }
+        }
+        return;
+    }
+
+    // visit the closest child first, and the other one only if it may contain a closer point
+    double d0    = nodes.at(n.child[0]).point_box.dist_sqrd(p);
+    double d1    = nodes.at(n.child[1]).point_box.dist_sqrd(p);
+    uint   first = (d0<=d1) ? 0 : 1;
+    double d[2]  = { d0, d1 };
+    if(d[  first] < dist_sqrd) closest_point(n.child[  first], p, id, dist_sqrd, skip);
+    if(d[1-first] < dist_sqrd) closest_point(n.child[1-first], p, id, dist_sqrd, skip);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::points_in_box(const AABB & box, std::vector<uint> & res, const Skip & skip) const
+{
+    points_in_region([&box](const AABB  & b){ return box.intersects_box(b); },
+                     [&box](const vec3d & p){ return box.contains(p);       },
+                     res, skip);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::points_in_region(const std::function<bool(const AABB  & box)> & may_intersect,
+                              const std::function<bool(const vec3d & p)>   & contains,
+                                    std::vector<uint>                      & res,
+                              const Skip                                   & skip) const
+{
+    res.clear();
+    if(empty()) return;
+    points_in_region(0, may_intersect, contains, res, skip);
+    std::sort(res.begin(), res.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::points_in_region(const uint                                     nid,
+                              const std::function<bool(const AABB  & box)> & may_intersect,
+                              const std::function<bool(const vec3d & p)>   & contains,
+                                    std::vector<uint>                      & res,
+                              const Skip                                   & skip) const
+{
+    const Node & n = nodes.at(nid);
+    if(!may_intersect(n.point_box)) return;
+    if(n.child[0]==0)
+    {
+        for(uint i=n.beg; i<n.end; ++i)
+        {
+            if(contains(points.at(i)) && (!skip || !skip(ids.at(i)))) res.push_back(ids.at(i));
+        }
+        return;
+    }
+    points_in_region(n.child[0], may_intersect, contains, res, skip);
+    points_in_region(n.child[1], may_intersect, contains, res, skip);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool KdTree::intersects_ray(const vec3d   & p,
+                            const vec3d   & dir,
+                            const RayTest & hit,
+                                  double  & min_t,
+                                  uint    & id,
+                            const Skip    & skip) const
+{
+    if(empty()) return false;
+    min_t = inf_double;
+    id    = ids.size(); // i.e. invalid
+    intersects_ray(0, p, dir, hit, min_t, id, skip);
+    return id < ids.size();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void KdTree::intersects_ray(const uint nid, const vec3d & p, const vec3d & dir, const RayTest & hit, double & min_t, uint & id, const Skip & skip) const
+{
+    const Node & n = nodes.at(nid);
+    if(n.child[0]==0)
+    {
+        for(uint i=n.beg; i<n.end; ++i)
+        {
+            double t;
+            if((!skip || !skip(ids.at(i))) && hit(ids.at(i), t) && t < min_t)
+            {
+                min_t = t;
+                id    = ids.at(i);
+            }
+        }
+        return;
+    }
+
+    // visit the children in the order they are entered by the ray,
+    // skipping those that are entered after the closest hit so far
+    double t[2];
+    vec3d  pos;
+    bool   hits[2];
+    for(uint i=0; i<2; ++i)
+    {
+        hits[i] = nodes.at(n.child[i]).item_box.intersects_ray(p, dir, t[i], pos);
+    }
+    uint first = (!hits[1] || (hits[0] && t[0]<=t[1])) ? 0 : 1;
+    if(hits[  first] && t[  first] <= min_t) intersects_ray(n.child[  first], p, dir, hit, min_t, id, skip);
+    if(hits[1-first] && t[1-first] <= min_t) intersects_ray(n.child[1-first], p, dir, hit, min_t, id, skip);
+}
+
+}
@@ -0,0 +1,156 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_KD_TREE_H
+#define CINO_KD_TREE_H
+
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/aabb.h>
+#include <cinolib/memory_footprint.h>
+#include <functional>
+#include <vector>
+#include <sys/types.h>
+
+namespace cinolib
+{
+
+/* Static, balanced kd-tree over a set of items, each represented by a point
+ * (e.g. vertex position, edge midpoint, poly centroid) and optionally by a
+ * bounding box (the extent of the element the point represents).
+ *
+ * Nodes split the points of their items at the median of the widest axis,
+ * hence the tree has logarithmic depth and queries visit O(log n) nodes
+ * on average. Each node also stores the bounding box of the items it contains,
+ * which is used to answer ray queries against the elements themselves.
+ * Nodes, points and ids live in flat arrays: there are no per node allocations.
+ *
+ * The tree is static: if the items change, build it again. All queries
+ * accept a Skip predicate that discards items on the fly (e.g. hidden
+ * elements), so that filtering does not require any rebuild. Queries
+ * are const and can run concurrently on the same tree.
+*/
+
+class KdTree
+{
+    public:
+
+        // returns true for items that must be ignored by a query
+        typedef std::function<bool(const uint id)> Skip;
+
+        // returns true if the element with the given id is hit by the query
+        // ray, and its parametric distance t along the ray
+        typedef std::function<bool(const uint id, double & t)> RayTest;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        explicit KdTree(const uint items_per_leaf = 8);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // the id of each item is its position in the input list
+        void build(const std::vector<vec3d> & points);
+        void build(const std::vector<vec3d> & points, const std::vector<AABB> & boxes);
+        void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint size()  const { return ids.size();  }
+        bool empty() const { return ids.empty(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        MemoryFootprint memory_footprint() const;
+
+        // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // id and distance of the item whose point is closest to p.
+        // Returns false if no item passes the Skip predicate
+        bool closest_point(const vec3d & p, uint & id, double & dist, const Skip & skip = nullptr) const;
+
+        // all the items whose point is inside the box
+        void points_in_box(const AABB & box, std::vector<uint> & res, const Skip & skip = nullptr) const;
+
+        // all the items whose point is inside an arbitrary region (e.g. the
+        // volume spanned by a lasso drawn on the screen). The region is
+        // described by a point membership test, and by a conservative test
+        // that returns false if a box certainly does not intersect it
+        void points_in_region(const std::function<bool(const AABB  & box)> & may_intersect,
+                              const std::function<bool(const vec3d & p)>   & contains,
+                                    std::vector<uint>                      & res,
+                              const Skip                                   & skip = nullptr) const;
+
+        // first item hit by the ray R(t) := p + t * dir (t >= 0). Only the items
+        // contained in nodes traversed by the ray are tested with hit
+        bool intersects_ray(const vec3d   & p,
+                            const vec3d   & dir,
+                            const RayTest & hit,
+                                  double  & min_t,
+                                  uint    & id,
+                            const Skip    & skip = nullptr) const;
+
+    protected:
+
+        struct Node
+        {
+            AABB point_box; // bounding box of the points of the items in the node
+            AABB item_box;  // bounding box of the items in the node
+            uint beg, end;  // range of items (in ids/points)
+            uint child[2];  // children nodes (0 for leaves, as the root can't be a child)
+        };
+
+        uint num_nodes(const uint n_items) const; // size of the tree built on n_items
+        uint build_node(const uint beg, const uint end, const std::vector<vec3d> & in_points, const std::vector<AABB> & boxes);
+
+        void closest_point   (const uint nid, const vec3d & p, uint & id, double & dist_sqrd, const Skip & skip) const;
+        void points_in_region(const uint nid,
+                              const std::function<bool(const AABB  & box)> & may_intersect,
+                              const std::function<bool(const vec3d & p)>   & contains,
+                                    std::vector<uint>                      & res,
+                              const Skip                                   & skip) const;
+        void intersects_ray  (const uint nid, const vec3d & p, const vec3d & dir, const RayTest & hit, double & min_t, uint & id, const Skip & skip) const;
+
+        uint               items_per_leaf;
+        std::vector<Node>  nodes;  // nodes[0] is the root
+        std::vector<uint>  ids;    // item ids, sorted so that each node spans a contiguous range
+        std::vector<vec3d> points; // item points, in the same order of ids
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "kd_tree.cpp"
+#endif
+
+#endif // CINO_KD_TREE_H
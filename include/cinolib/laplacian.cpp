@@ -35,6 +35,7 @@
 *********************************************************************************/
 #include <cinolib/laplacian.h>
 #include <cinolib/symbols.h>
+#include <cinolib/profiler.h>
 #include <Eigen/Sparse>
 
 namespace cinolib
@@ -87,6 +88,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 Eigen::SparseMatrix<double> laplacian(const AbstractMesh<M,V,E,P> & m, const int mode, const int n)
 {
+    CINO_PROFILE_SCOPE("laplacian");
     std::vector<Entry> entries = laplacian_matrix_entries(m, mode, n);
 
     uint nv = n*m.num_verts();
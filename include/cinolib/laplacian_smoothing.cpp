@@ -0,0 +1,145 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/laplacian_smoothing.h>
+#include <cinolib/graph_coloring.h>
+#include <cinolib/parallel_for.h>
+#include <cmath>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void laplacian_smoothing(AbstractPolygonMesh<M,V,E,P>    & m,
+                         const LaplacianSmoothingOptions & opt)
+{
+    laplacian_smoothing(m, vert_graph_coloring(m), opt);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void laplacian_smoothing(AbstractPolygonMesh<M,V,E,P>         & m,
+                         const std::vector<std::vector<uint>> & vert_colors,
+                         const LaplacianSmoothingOptions      & opt)
+{
+    std::vector<bool> fixed(m.num_verts(), false);
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        if(opt.fix_boundary && m.vert_is_boundary(vid)) fixed.at(vid) = true;
+        if(opt.fix_marked)
+        {
+            for(uint eid : m.adj_v2e(vid))
+            {
+                if(m.edge_data(eid).flags[MARKED]) fixed.at(vid) = true;
+            }
+        }
+    }
+
+    // weight sums below these thresholds denote degenerate fans (e.g. cotangent weights
+    // in fans with (almost) zero or obtuse angles), which are smoothed with uniform weights
+    const double max_weight_cancellation = 0.1;
+    const double min_avg_weight          = 1e-6;
+
+    auto smooth_vert = [&](const uint vid, const double step)
+    {
+        if(fixed.at(vid)) return;
+
+        std::vector<std::pair<uint,double>> wgts;
+        m.vert_weights(vid, opt.laplacian_mode, wgts);
+
+        double sum     = 0.0;
+        double sum_abs = 0.0;
+        for(auto w : wgts)
+        {
+            sum     += w.second;
+            sum_abs += std::fabs(w.second);
+        }
+        if(wgts.empty()) return; // isolated vertex
+
+        // negative weights amplify the displacement by sum_abs/sum w.r.t. a convex combination
+        // of the neighbors, vanishing weights make it numerically meaningless, and infinite
+        // (or NaN) weights produce NaN coordinates. Fall back to uniform weights in all cases
+        if(!std::isfinite(sum_abs)                   ||
+           !(sum >= sum_abs*max_weight_cancellation) ||
+           sum < min_avg_weight*wgts.size())
+        {
+            for(auto & w : wgts) w.second = 1.0;
+            sum = wgts.size();
+        }
+
+        vec3d delta(0,0,0);
+        for(auto w : wgts) delta += w.second * (m.vert(w.first) - m.vert(vid));
+        delta /= sum;
+
+        if(opt.tangential)
+        {
+            const vec3d & n = m.vert_data(vid).normal;
+            delta -= n * delta.dot(n);
+        }
+        m.vert(vid) += step * delta;
+    };
+
+    // deferred normal update
+    auto update_normals = [&]()
+    {
+        PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid) { m.update_p_normal(pid); });
+        PARALLEL_FOR(0, m.num_verts(), 1000, [&](uint vid) { m.update_v_normal(vid); });
+    };
+
+    auto smoothing_step = [&](const double step)
+    {
+        for(const auto & set : vert_colors)
+        {
+            PARALLEL_FOR(0, set.size(), 1000, [&](uint i)
+            {
+                smooth_vert(set[i], step);
+            });
+        }
+        update_normals();
+    };
+
+    for(uint i=0; i<opt.n_iters; ++i)
+    {
+        smoothing_step(opt.lambda);
+        if(opt.taubin) smoothing_step(opt.mu);
+    }
+
+    m.update_bbox();
+}
+
+}
@@ -0,0 +1,112 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_LAPLACIAN_SMOOTHING_H
+#define CINO_LAPLACIAN_SMOOTHING_H
+
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/symbols.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
+
+namespace cinolib
+{
+
+/* Explicit (per vertex) Laplacian smoothing. Each vertex is moved towards the
+ * weighted average of its neighbors:
+ *
+ *     p_i += step * \sum_j w_ij (p_j - p_i) / \sum_j w_ij
+ *
+ * Supported variants are:
+ *
+ *  - uniform or cotangent weights (laplacian_mode);
+ *  - tangential smoothing, where the displacement is projected onto the tangent
+ *    plane at p_i, so as to relocate vertices without altering the shape. See:
+ *
+ *      A Remeshing Approach to Multiresolution Modeling
+ *      M.Botsch, L.Kobbelt
+ *      Symposium on Geomtry Processing, 2004
+ *
+ *  - Taubin smoothing, alternating a shrinking step (lambda > 0) with an inflating
+ *    step (mu < -lambda) to avoid the shrinkage of the classical scheme. See:
+ *
+ *      A Signal Processing Approach to Fair Surface Design
+ *      G.Taubin
+ *      SIGGRAPH 1995
+ *
+ * Vertices are updated in place (Gauss-Seidel style). To do so in parallel the vertex
+ * graph is colored: all the vertices in a color class are independent (i.e., none of
+ * them reads the position of another) and are smoothed concurrently, one class after
+ * the other. Normals are not updated while vertices move, but in a single (parallel)
+ * pass at the end of each step.
+*/
+
+typedef struct
+{
+    uint   n_iters        = 10;
+    int    laplacian_mode = UNIFORM; // UNIFORM, COTANGENT (triangle meshes only)
+    double lambda         = 0.5;     // step size (in [0,1] for stable smoothing)
+    bool   tangential     = false;   // remove the normal component of the displacement
+    bool   taubin         = false;   // alternate lambda and mu steps (Taubin smoothing)
+    double mu             = -0.53;   // inflation step size for Taubin smoothing (mu < -lambda)
+    bool   fix_boundary   = true;    // hold boundary vertices in place
+    bool   fix_marked     = false;   // hold vertices incident to marked edges in place
+}
+LaplacianSmoothingOptions;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void laplacian_smoothing(AbstractPolygonMesh<M,V,E,P>    & m,
+                         const LaplacianSmoothingOptions & opt = LaplacianSmoothingOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but reuses a precomputed coloring of the vertex graph (see vert_graph_coloring).
+// Useful to smooth many times a mesh with fixed connectivity
+template<class M, class V, class E, class P>
+CINO_INLINE
+void laplacian_smoothing(AbstractPolygonMesh<M,V,E,P>         & m,
+                         const std::vector<std::vector<uint>> & vert_colors,
+                         const LaplacianSmoothingOptions      & opt = LaplacianSmoothingOptions());
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "laplacian_smoothing.cpp"
+#endif
+
+#endif // CINO_LAPLACIAN_SMOOTHING_H
@@ -35,6 +35,8 @@
 *********************************************************************************/
 #include <cinolib/linear_solvers.h>
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/profiler.h>
+#include <iostream>
 
 namespace cinolib
 {
@@ -49,6 +51,7 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
                                Eigen::VectorXd             & x,
                          int   solver)
 {
+    CINO_PROFILE_SCOPE("solve_square_system");
     assert(A.rows() == A.cols());
 
     switch (solver)
@@ -80,6 +83,27 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
             break;
         }
 
+        case CONJUGATE_GRADIENT:
+        {
+            // note: uses both triangles of A, which is therefore assumed to be symmetric
+            Eigen::ConjugateGradient< Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper > solver;
+            solver.setTolerance(1e-8);
+            solver.compute(A);
+            if(solver.info() != Eigen::Success)
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : solve_square_system() : CG preconditioner setup failed" << std::endl;
+                x = Eigen::VectorXd::Zero(A.cols());
+                break;
+            }
+            x = solver.solve(b).eval();
+            if(solver.info() != Eigen::Success)
+            {
+                std::cerr << "WARNING: solve_square_system() : CG did not converge (" << solver.iterations()
+                          << " iterations, estimated error " << solver.error() << ")" << std::endl;
+            }
+            break;
+        }
+
         case SparseLU:
         {
             Eigen::SparseMatrix<double> Ac = A;
@@ -104,6 +128,7 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
                                  int   solver)
 {
+    CINO_PROFILE_SCOPE("solve_square_system_with_bc");
     std::vector<int> col_map(A.rows(), -1);
     uint fresh_id = 0;
     for(uint col=0; col<A.cols(); ++col)
@@ -181,6 +206,7 @@ void solve_least_squares(const Eigen::SparseMatrix<double> & A,
                                Eigen::VectorXd             & x,
                          int   solver)
 {
+    CINO_PROFILE_SCOPE("solve_least_squares");
     Eigen::SparseMatrix<double> At  = A.transpose();
     Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
@@ -197,6 +223,7 @@ void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
                                  int   solver)
 {
+    CINO_PROFILE_SCOPE("solve_least_squares_with_bc");
     Eigen::SparseMatrix<double> At  = A.transpose();
     Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
@@ -213,6 +240,7 @@ void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
                                         Eigen::VectorXd             & x,
                                   int   solver)
 {
+    CINO_PROFILE_SCOPE("solve_weighted_least_squares");
     Eigen::SparseMatrix<double> At   = A.transpose();
     Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
@@ -230,6 +258,7 @@ void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                           const std::map<uint,double>       & bc, // Dirichlet boundary conditions
                                           int   solver)
 {
+    CINO_PROFILE_SCOPE("solve_weighted_least_squares_with_bc");
     Eigen::SparseMatrix<double> At   = A.transpose();
     Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
@@ -56,6 +56,9 @@ namespace cinolib
  * --------------------------------------------------------------
  * BiCGSTAB     none
  * (iterative)
+ * --------------------------------------------------------------
+ * CG           symmetric positive definite
+ * (iterative)
  */
 
 enum
@@ -64,16 +67,18 @@ enum
     SIMPLICIAL_LDLT,
     SparseLU,
     BiCGSTAB,
+    CONJUGATE_GRADIENT,
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-static const std::string txt[4] =
+static const std::string txt[5] =
 {
     "SIMPLICIAL_LLT"  ,
     "SIMPLICIAL_LDLT" ,
     "SparseLU",
     "BiCGSTAB",
+    "CONJUGATE_GRADIENT",
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -60,6 +60,14 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
     Eigen::SparseMatrix<double> L  = laplacian(m, COTANGENT);
     Eigen::SparseMatrix<double> MM = mass_matrix(m);
 
+    // the sparsity pattern of the system matrix does not change across iterations
+    // (connectivity is fixed), hence the symbolic analysis is done only once
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> LLT;
+    LLT.analyzePattern(MM - time_scalar * L);
+
+    uint nv = m.num_verts();
+    Eigen::MatrixXd XYZ(nv,3);
+
     for(uint i=1; i<=n_iters; ++i)
     {
         // optimize position and scale to get better numerical precision
@@ -67,29 +75,24 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
         m.center_bbox();        
 
         // backward euler time integration of heat flow equation
-        Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> LLT(MM - time_scalar * L);
-
-        uint nv = m.num_verts();
-        Eigen::VectorXd x(nv);
-        Eigen::VectorXd y(nv);
-        Eigen::VectorXd z(nv);
+        LLT.factorize(MM - time_scalar * L);
 
         for(uint vid=0; vid<nv; ++vid)
         {
             vec3d pos = m.vert(vid);
-            x[vid] = pos.x();
-            y[vid] = pos.y();
-            z[vid] = pos.z();
+            XYZ(vid,0) = pos.x();
+            XYZ(vid,1) = pos.y();
+            XYZ(vid,2) = pos.z();
         }
 
-        x = LLT.solve(MM * x);
-        y = LLT.solve(MM * y);
-        z = LLT.solve(MM * z);
+        // x,y,z are solved at once (multiple right hand sides)
+        Eigen::MatrixXd rhs = MM * XYZ;
+        XYZ = LLT.solve(rhs);
 
         double residual = 0.0;
         for(uint vid=0; vid<m.num_verts(); ++vid)
         {
-            vec3d new_pos(x[vid], y[vid], z[vid]);
+            vec3d new_pos(XYZ(vid,0), XYZ(vid,1), XYZ(vid,2));
             residual += (m.vert(vid) - new_pos).length();
             m.vert(vid) = new_pos;
         }
@@ -0,0 +1,159 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/memory_footprint.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void MemoryFootprint::add(const std::string & name, const size_t used, const size_t allocated)
+{
+    Entry e;
+    e.name      = name;
+    e.used      = used;
+    e.allocated = allocated;
+    items.push_back(e);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class T>
+CINO_INLINE
+void MemoryFootprint::add(const std::string & name, const std::vector<T> & v)
+{
+    add(name, bytes_used(v), bytes_allocated(v));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class T>
+CINO_INLINE
+void MemoryFootprint::add(const std::string & name, const std::vector<std::vector<T>> & v)
+{
+    size_t used      = bytes_used(v);
+    size_t allocated = bytes_allocated(v);
+    for(const std::vector<T> & inner : v)
+    {
+        used      += bytes_used(inner);
+        allocated += bytes_allocated(inner);
+    }
+    add(name, used, allocated);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MemoryFootprint::add(const std::string & prefix, const MemoryFootprint & mf)
+{
+    for(const Entry & e : mf.entries()) add(prefix + "::" + e.name, e.used, e.allocated);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t MemoryFootprint::used() const
+{
+    size_t count = 0;
+    for(const Entry & e : items) count += e.used;
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t MemoryFootprint::allocated() const
+{
+    size_t count = 0;
+    for(const Entry & e : items) count += e.allocated;
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MemoryFootprint::print(const std::string & title) const
+{
+    uint w = 5;
+    for(const Entry & e : items) w = std::max(w, static_cast<uint>(e.name.size()));
+
+    double                  MB    = 1024.0*1024.0;
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize         prec  = std::cout.precision();
+    std::cout << "::::::::::::::: MEMORY FOOTPRINT " << title << " :::::::::::::::" << std::endl;
+    std::cout << std::left << std::setw(w) << "" << std::right
+              << std::setw(14) << "used (MB)"
+              << std::setw(14) << "alloc (MB)"
+              << std::setw(14) << "slack (MB)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for(const Entry & e : items)
+    {
+        std::cout << std::left << std::setw(w) << e.name << std::right
+                  << std::setw(14) << e.used/MB
+                  << std::setw(14) << e.allocated/MB
+                  << std::setw(14) << (e.allocated-e.used)/MB << std::endl;
+    }
+    std::cout << std::left << std::setw(w) << "TOTAL" << std::right
+              << std::setw(14) << used()/MB
+              << std::setw(14) << allocated()/MB
+              << std::setw(14) << slack()/MB << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(prec);
+    std::cout << "::::::::::::::::::::::::::::::::::::::::::::::::::::::::\n" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class T>
+CINO_INLINE
+void shrink_to_fit(std::vector<T> & v)
+{
+    v.shrink_to_fit();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class T>
+CINO_INLINE
+void shrink_to_fit(std::vector<std::vector<T>> & v)
+{
+    for(std::vector<T> & inner : v) inner.shrink_to_fit();
+    v.shrink_to_fit();
+}
+
+}
@@ -0,0 +1,133 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MEMORY_FOOTPRINT_H
+#define CINO_MEMORY_FOOTPRINT_H
+
+#include <cinolib/cino_inline.h>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace cinolib
+{
+
+/* Memory occupied by a data structure, split into its components. For each
+ * component, used counts the bytes of the live elements (size), allocated the
+ * bytes actually reserved on the heap (capacity). Their difference is the slack
+ * that a call to shrink_to_fit() can give back to the system. Nested vectors
+ * (e.g. adjacency lists) include both the outer array and all the inner ones.
+ *
+ * Only the memory owned by std::vectors is accounted for: if custom attributes
+ * own dynamic memory (e.g. strings, containers), it will not be counted.
+ *
+ * Usage:
+ *
+ *     Tetmesh<> m("bunny.mesh");
+ *     m.memory_footprint().print("bunny");
+ *     m.shrink_to_fit();
+*/
+
+class MemoryFootprint
+{
+    public:
+
+        typedef struct
+        {
+            std::string name;
+            size_t      used      = 0; // bytes
+            size_t      allocated = 0; // bytes
+        }
+        Entry;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        explicit MemoryFootprint() {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void add(const std::string & name, const size_t used, const size_t allocated);
+
+        template<class T>
+        void add(const std::string & name, const std::vector<T> & v);
+
+        template<class T>
+        void add(const std::string & name, const std::vector<std::vector<T>> & v);
+
+        // append all the entries of another footprint, prefixing their names
+        void add(const std::string & prefix, const MemoryFootprint & mf);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        const std::vector<Entry> & entries() const { return items; }
+
+        size_t used()      const;
+        size_t allocated() const;
+        size_t slack()     const { return allocated() - used(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void print(const std::string & title = "") const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class T> static size_t bytes_used     (const std::vector<T> & v) { return v.size()     * sizeof(T); }
+        template<class T> static size_t bytes_allocated(const std::vector<T> & v) { return v.capacity() * sizeof(T); }
+        static size_t bytes_used     (const std::vector<bool> & v) { return (v.size()     + 7)/8; }
+        static size_t bytes_allocated(const std::vector<bool> & v) { return (v.capacity() + 7)/8; }
+
+    protected:
+
+        std::vector<Entry> items;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// releases the unused capacity of a vector (and of all its inner vectors)
+template<class T>
+CINO_INLINE
+void shrink_to_fit(std::vector<T> & v);
+
+template<class T>
+CINO_INLINE
+void shrink_to_fit(std::vector<std::vector<T>> & v);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "memory_footprint.cpp"
+#endif
+
+#endif // CINO_MEMORY_FOOTPRINT_H
@@ -0,0 +1,504 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/mesh_reordering.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace cinolib
+{
+
+// quantizes points on a 2^21 grid spanning their bounding box (uniform scaling)
+CINO_INLINE
+void space_filling_curve_coords(const std::vector<vec3d> & points, std::vector<uint32_t> & coords)
+{
+    AABB box(points);
+    double extent = std::max(box.delta_x(), std::max(box.delta_y(), box.delta_z()));
+    double scale  = (extent>0) ? ((1<<21)-1)/extent : 0.0;
+
+    coords.resize(3*points.size());
+    PARALLEL_FOR(0, points.size(), 10000, [&](uint i)
+    {
+        for(uint j=0; j<3; ++j)
+        {
+            double q = (points.at(i)[j] - box.min[j]) * scale;
+            coords[3*i+j] = static_cast<uint32_t>(std::min(std::max(q, 0.0), double((1<<21)-1)));
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// interleaves the lowest 21 bits of x with two zeros (i.e. bit i goes to 3i)
+CINO_INLINE
+uint64_t Morton_spread_bits(const uint64_t x)
+{
+    uint64_t b = x & 0x1fffff;
+    b = (b | b << 32) & 0x1f00000000ffff;
+    b = (b | b << 16) & 0x1f0000ff0000ff;
+    b = (b | b <<  8) & 0x100f00f00f00f00f;
+    b = (b | b <<  4) & 0x10c30c30c30c30c3;
+    b = (b | b <<  2) & 0x1249249249249249;
+    return b;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t Morton_key(const uint32_t x, const uint32_t y, const uint32_t z)
+{
+    return Morton_spread_bits(x) | (Morton_spread_bits(y) << 1) | (Morton_spread_bits(z) << 2);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// J. Skilling, Programming the Hilbert curve, AIP Conference Proceedings, 2004
+CINO_INLINE
+uint64_t Hilbert_key(const uint32_t x, const uint32_t y, const uint32_t z)
+{
+    const uint bits = 21;
+    uint32_t X[3] = { x, y, z };
+
+    // inverse undo excess work (axes to transpose)
+    uint32_t M = 1u << (bits-1);
+    for(uint32_t Q=M; Q>1; Q>>=1)
+    {
+        uint32_t P = Q-1;
+        for(uint i=0; i<3; ++i)
+        {
+            if(X[i] & Q) X[0] ^= P;
+            else
+            {
+                uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    // Gray encode
+    for(uint i=1; i<3; ++i) X[i] ^= X[i-1];
+    uint32_t t = 0;
+    for(uint32_t Q=M; Q>1; Q>>=1) if(X[2] & Q) t ^= Q-1;
+    for(uint i=0; i<3; ++i) X[i] ^= t;
+
+    // the key is the bitwise interleaving of the transposed coordinates
+    uint64_t key = 0;
+    for(int b=bits-1; b>=0; --b)
+    {
+        for(uint i=0; i<3; ++i) key = (key << 1) | ((X[i] >> b) & 1);
+    }
+    return key;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<uint> space_filling_curve_order(const std::vector<vec3d> & points, const bool Hilbert)
+{
+    std::vector<uint32_t> coords;
+    space_filling_curve_coords(points, coords);
+
+    std::vector<std::pair<uint64_t,uint>> keys(points.size());
+    PARALLEL_FOR(0, points.size(), 10000, [&](uint i)
+    {
+        uint64_t k = (Hilbert) ? Hilbert_key(coords[3*i], coords[3*i+1], coords[3*i+2])
+                               : Morton_key (coords[3*i], coords[3*i+1], coords[3*i+2]);
+        keys[i] = std::make_pair(k,i);
+    });
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint> order(points.size());
+    for(uint i=0; i<keys.size(); ++i) order[i] = keys[i].second;
+    return order;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<uint> Morton_order(const std::vector<vec3d> & points)
+{
+    return space_filling_curve_order(points, false);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<uint> Hilbert_order(const std::vector<vec3d> & points)
+{
+    return space_filling_curve_order(points, true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// adj(i) returns the list of nodes adjacent to node i
+template<class Adj>
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const uint n, const Adj & adj)
+{
+    std::vector<uint> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+
+    // breadth first visits used to find pseudo peripheral nodes. Nodes are
+    // marked with the id of the visit, so that marks never need to be reset
+    std::vector<uint> mark(n, 0);
+    uint              stamp = 0;
+    std::vector<uint> level, next;
+    auto last_level = [&](const uint source, uint & eccentricity) -> std::vector<uint>
+    {
+        ++stamp;
+        mark[source] = stamp;
+        level.assign(1, source);
+        eccentricity = 0;
+        while(true)
+        {
+            next.clear();
+            for(uint v : level)
+            for(uint nbr : adj(v))
+            {
+                if(mark[nbr]!=stamp)
+                {
+                    mark[nbr] = stamp;
+                    next.push_back(nbr);
+                }
+            }
+            if(next.empty()) return level;
+            level.swap(next);
+            ++eccentricity;
+        }
+    };
+
+    // seed components from their lowest degree node
+    std::vector<uint> seeds(n);
+    for(uint i=0; i<n; ++i) seeds[i] = i;
+    std::stable_sort(seeds.begin(), seeds.end(), [&](const uint a, const uint b)
+    {
+        return adj(a).size() < adj(b).size();
+    });
+
+    std::vector<uint> nbrs;
+    for(uint seed : seeds)
+    {
+        if(visited[seed]) continue;
+
+        // pseudo peripheral node (George-Liu)
+        uint start = seed, ecc;
+        std::vector<uint> last = last_level(start, ecc);
+        while(true)
+        {
+            uint candidate = *std::min_element(last.begin(), last.end(), [&](const uint a, const uint b)
+            {
+                return adj(a).size() < adj(b).size();
+            });
+            uint candidate_ecc;
+            std::vector<uint> candidate_last = last_level(candidate, candidate_ecc);
+            if(candidate_ecc <= ecc) break;
+            start = candidate;
+            ecc   = candidate_ecc;
+            last.swap(candidate_last);
+        }
+
+        // Cuthill-McKee: breadth first, visiting neighbors by increasing degree
+        uint head = order.size();
+        order.push_back(start);
+        visited[start] = true;
+        while(head < order.size())
+        {
+            uint v = order[head++];
+            nbrs.clear();
+            for(uint nbr : adj(v))
+            {
+                if(!visited[nbr])
+                {
+                    visited[nbr] = true;
+                    nbrs.push_back(nbr);
+                }
+            }
+            std::sort(nbrs.begin(), nbrs.end(), [&](const uint a, const uint b)
+            {
+                return adj(a).size() < adj(b).size() || (adj(a).size() == adj(b).size() && a < b);
+            });
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const std::vector<std::vector<uint>> & adj)
+{
+    return reverse_Cuthill_McKee_order(adj.size(), [&](const uint i) -> const std::vector<uint> & { return adj[i]; });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const AbstractMesh<M,V,E,P> & m)
+{
+    return reverse_Cuthill_McKee_order(m.num_verts(), [&](const uint vid) -> const std::vector<uint> & { return m.adj_v2v(vid); });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void reorder_mesh(Mesh & m, const int mode, MeshReordering & r)
+{
+    std::vector<uint> v_order, p_order;
+    switch(mode)
+    {
+        case MORTON_ORDER:
+        case HILBERT_ORDER:
+        {
+            std::vector<vec3d> centroids(m.num_polys());
+            PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+            {
+                centroids[pid] = m.poly_centroid(pid);
+            });
+            v_order = space_filling_curve_order(m.vector_verts(), mode==HILBERT_ORDER);
+            p_order = space_filling_curve_order(centroids,        mode==HILBERT_ORDER);
+            break;
+        }
+        case RCM_ORDER:
+        {
+            v_order = reverse_Cuthill_McKee_order(m);
+            std::vector<uint> v_map(m.num_verts());
+            for(uint i=0; i<v_order.size(); ++i) v_map[v_order[i]] = i;
+            std::vector<std::pair<uint,uint>> keys(m.num_polys());
+            for(uint pid=0; pid<m.num_polys(); ++pid)
+            {
+                uint min_vid = max_uint;
+                for(uint vid : m.adj_p2v(pid)) min_vid = std::min(min_vid, v_map[vid]);
+                keys[pid] = std::make_pair(min_vid, pid);
+            }
+            std::sort(keys.begin(), keys.end());
+            p_order.resize(keys.size());
+            for(uint i=0; i<keys.size(); ++i) p_order[i] = keys[i].second;
+            break;
+        }
+        default: assert(false && "unknown reordering mode");
+    }
+    reorder_mesh(m, v_order, p_order, r);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void reorder_mesh(AbstractPolygonMesh<M,V,E,P> & m,
+                  const std::vector<uint>      & v_order,
+                  const std::vector<uint>      & p_order,
+                  MeshReordering               & r)
+{
+    assert(v_order.size()==m.num_verts());
+    assert(p_order.size()==m.num_polys());
+
+    r.vert_map.resize(m.num_verts());
+    r.poly_map.resize(m.num_polys());
+    r.edge_map.resize(m.num_edges());
+    r.face_map.clear();
+    for(uint i=0; i<v_order.size(); ++i) r.vert_map[v_order[i]] = i;
+    for(uint i=0; i<p_order.size(); ++i) r.poly_map[p_order[i]] = i;
+
+    // backup everything that will be lost when the mesh is cleared
+    std::vector<vec3d>             verts(m.num_verts());
+    std::vector<std::vector<uint>> polys(m.num_polys());
+    std::vector<V>                 v_data(m.num_verts());
+    std::vector<P>                 p_data(m.num_polys());
+    std::vector<E>                 e_data(m.num_edges());
+    std::vector<uint>              edges(m.vector_edges());
+    M                              m_data = m.mesh_data();
+    for(uint i=0; i<v_order.size(); ++i)
+    {
+        verts[i]  = m.vert(v_order[i]);
+        v_data[i] = m.vert_data(v_order[i]);
+    }
+    for(uint i=0; i<p_order.size(); ++i)
+    {
+        polys[i] = m.poly_verts_id(p_order[i]);
+        for(uint & vid : polys[i]) vid = r.vert_map[vid];
+        p_data[i] = m.poly_data(p_order[i]);
+    }
+    for(uint eid=0; eid<m.num_edges(); ++eid) e_data[eid] = m.edge_data(eid);
+
+    // rebuild
+    m.clear();
+    m.mesh_data() = m_data;
+    m.init(verts, polys);
+
+    for(uint vid=0; vid<m.num_verts(); ++vid) m.vert_data(vid) = v_data[vid];
+    for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid) = p_data[pid];
+    for(uint eid=0; eid<r.edge_map.size(); ++eid)
+    {
+        uint vid0 = r.vert_map[edges[2*eid  ]];
+        uint vid1 = r.vert_map[edges[2*eid+1]];
+        int  e    = m.edge_id(vid0, vid1);
+        if(e==-1) e = m.edge_add(vid0, vid1); // dangling edge
+        r.edge_map[eid] = e;
+        m.edge_data(e)  = e_data[eid];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void reorder_mesh(AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                  const std::vector<uint>           & v_order,
+                  const std::vector<uint>           & p_order,
+                  MeshReordering                    & r)
+{
+    assert(v_order.size()==m.num_verts());
+    assert(p_order.size()==m.num_polys());
+
+    r.vert_map.resize(m.num_verts());
+    r.poly_map.resize(m.num_polys());
+    r.edge_map.resize(m.num_edges());
+    r.face_map.resize(m.num_faces());
+    for(uint i=0; i<v_order.size(); ++i) r.vert_map[v_order[i]] = i;
+    for(uint i=0; i<p_order.size(); ++i) r.poly_map[p_order[i]] = i;
+
+    // backup everything that will be lost when the mesh is cleared
+    std::vector<vec3d>             verts(m.num_verts());
+    std::vector<V>                 v_data(m.num_verts());
+    std::vector<P>                 p_data(m.num_polys());
+    std::vector<E>                 e_data(m.num_edges());
+    std::vector<F>                 f_data(m.num_faces());
+    std::vector<uint>              edges(m.vector_edges());
+    std::vector<std::vector<uint>> faces(m.num_faces());
+    M                              m_data = m.mesh_data();
+    for(uint i=0; i<v_order.size(); ++i)
+    {
+        verts[i]  = m.vert(v_order[i]);
+        v_data[i] = m.vert_data(v_order[i]);
+    }
+    for(uint i=0; i<p_order.size(); ++i) p_data[i] = m.poly_data(p_order[i]);
+    for(uint eid=0; eid<m.num_edges(); ++eid) e_data[eid] = m.edge_data(eid);
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        f_data[fid] = m.face_data(fid);
+        faces[fid]  = m.face_verts_id(fid);
+        for(uint & vid : faces[fid]) vid = r.vert_map[vid];
+    }
+
+    if(m.mesh_type()==POLYHEDRALMESH)
+    {
+        // general polyhedra are defined by their faces, which are numbered
+        // in order of first appearance in the reordered polys
+        std::vector<int>               new_fid(m.num_faces(), -1);
+        std::vector<std::vector<uint>> new_faces;
+        std::vector<std::vector<uint>> new_polys(m.num_polys());
+        std::vector<std::vector<bool>> new_winding(m.num_polys());
+        new_faces.reserve(m.num_faces());
+        for(uint i=0; i<p_order.size(); ++i)
+        {
+            uint pid = p_order[i];
+            for(uint off=0; off<m.faces_per_poly(pid); ++off)
+            {
+                uint fid = m.poly_face_id(pid, off);
+                if(new_fid[fid]==-1)
+                {
+                    new_fid[fid] = new_faces.size();
+                    new_faces.push_back(faces[fid]);
+                }
+                new_polys[i].push_back(new_fid[fid]);
+                new_winding[i].push_back(m.poly_face_winding(pid, fid));
+            }
+        }
+        for(uint fid=0; fid<m.num_faces(); ++fid) // dangling faces
+        {
+            if(new_fid[fid]==-1)
+            {
+                new_fid[fid] = new_faces.size();
+                new_faces.push_back(faces[fid]);
+            }
+        }
+        m.clear();
+        m.mesh_data() = m_data;
+        m.init(verts, new_faces, new_polys, new_winding);
+    }
+    else
+    {
+        // tetrahedra and hexahedra are defined by their vertices (in standard order)
+        std::vector<std::vector<uint>> polys(m.num_polys());
+        for(uint i=0; i<p_order.size(); ++i)
+        {
+            polys[i] = m.adj_p2v(p_order[i]);
+            for(uint & vid : polys[i]) vid = r.vert_map[vid];
+        }
+        m.clear();
+        m.mesh_data() = m_data;
+        m.init(verts, polys);
+    }
+
+    for(uint vid=0; vid<m.num_verts(); ++vid) m.vert_data(vid) = v_data[vid];
+    for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid) = p_data[pid];
+    for(uint fid=0; fid<r.face_map.size(); ++fid)
+    {
+        int f = m.face_id(faces[fid]);
+        if(f==-1) f = m.face_add(faces[fid]); // dangling face
+        r.face_map[fid] = f;
+        m.face_data(f)  = f_data[fid];
+    }
+    for(uint eid=0; eid<r.edge_map.size(); ++eid)
+    {
+        uint vid0 = r.vert_map[edges[2*eid  ]];
+        uint vid1 = r.vert_map[edges[2*eid+1]];
+        int  e    = m.edge_id(vid0, vid1);
+        if(e==-1) e = m.edge_add(vid0, vid1); // dangling edge
+        r.edge_map[eid] = e;
+        m.edge_data(e)  = e_data[eid];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class T>
+CINO_INLINE
+void apply_reordering(const std::vector<uint> & old2new, std::vector<T> & data)
+{
+    assert(old2new.size()==data.size());
+    std::vector<T> tmp(data.size());
+    for(uint i=0; i<data.size(); ++i) tmp[old2new[i]] = data[i];
+    data.swap(tmp);
+}
+
+}
@@ -0,0 +1,134 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESH_REORDERING_H
+#define CINO_MESH_REORDERING_H
+
+#include <cinolib/meshes/meshes.h>
+
+namespace cinolib
+{
+
+enum
+{
+    MORTON_ORDER,  // Z-order space filling curve (vertices and polys)
+    HILBERT_ORDER, // Hilbert space filling curve (vertices and polys)
+    RCM_ORDER,     // reverse Cuthill-McKee on the vertex graph (smaller matrix bandwidth)
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// old-to-new id maps produced by a reordering. Use them (e.g. with
+// apply_reordering) to remap any external per element field
+typedef struct
+{
+    std::vector<uint> vert_map;
+    std::vector<uint> edge_map;
+    std::vector<uint> face_map; // polyhedral meshes only
+    std::vector<uint> poly_map;
+}
+MeshReordering;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* The functions below return a permutation as the list of old ids in their
+ * new order (i.e. the i-th element in the new order is order[i]). Points
+ * are sorted by their position along a space filling curve computed on a
+ * 2^21 x 2^21 x 2^21 grid spanning their bounding box
+*/
+
+CINO_INLINE
+std::vector<uint> Morton_order(const std::vector<vec3d> & points);
+
+CINO_INLINE
+std::vector<uint> Hilbert_order(const std::vector<vec3d> & points);
+
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const std::vector<std::vector<uint>> & adj);
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> reverse_Cuthill_McKee_order(const AbstractMesh<M,V,E,P> & m); // vertex graph
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Permutes vertices and polys of a mesh so that elements that are close in space
+ * (MORTON_ORDER, HILBERT_ORDER) or in the vertex graph (RCM_ORDER) are also close
+ * in memory, improving the locality of adjacency traversals, matrix products and
+ * rendering. With RCM_ORDER polys are sorted by their smallest vertex id. Edges
+ * (and faces) are renumbered in order of first appearance in the new polys. All
+ * the connectivity and the per element attributes (including labels and flags)
+ * are remapped consistently, and the old-to-new maps are returned in r.
+ *
+ * NOTE: the mesh is rebuilt from scratch. Drawable meshes should therefore call
+ * init_drawable_stuff() afterwards, to refresh the slicer and rendering data.
+*/
+
+template<class Mesh>
+CINO_INLINE
+void reorder_mesh(Mesh & m, const int mode, MeshReordering & r);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// reorders the mesh with a prescribed permutation of vertices and polys,
+// expressed as lists of old ids in their new order
+template<class M, class V, class E, class P>
+CINO_INLINE
+void reorder_mesh(AbstractPolygonMesh<M,V,E,P> & m,
+                  const std::vector<uint>      & v_order,
+                  const std::vector<uint>      & p_order,
+                  MeshReordering               & r);
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void reorder_mesh(AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                  const std::vector<uint>           & v_order,
+                  const std::vector<uint>           & p_order,
+                  MeshReordering                    & r);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// remaps a per element field with an old-to-new map (e.g. r.vert_map)
+template<class T>
+CINO_INLINE
+void apply_reordering(const std::vector<uint> & old2new, std::vector<T> & data);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mesh_reordering.cpp"
+#endif
+
+#endif // CINO_MESH_REORDERING_H
@@ -38,6 +38,8 @@
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/textures/textures.h>
 #include <cinolib/color.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/profiler.h>
 
 namespace cinolib
 {
@@ -74,6 +76,9 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::updateGL()
 {
+    CINO_PROFILE_SCOPE("AbstractDrawablePolygonMesh::updateGL");
+    // a full update may follow any edit of the mesh (e.g. moved vertices)
+    slicer.set_dirty();
     updateGL_mesh();
     updateGL_marked();
 }
@@ -126,186 +131,55 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_marked()
         drawlist_marked.seg_colors.push_back(marked_edge_color.b);
         drawlist_marked.seg_colors.push_back(marked_edge_color.a);
     }
+
+    buffer_set_dirty(drawlist_marked);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh(const int attributes)
 {
     drawlist.material = material_;
-    drawlist.tri_coords.clear();
-    drawlist.tris.clear();
-    drawlist.tri_v_norms.clear();
-    drawlist.tri_v_colors.clear();
-    drawlist.tri_text.clear();
-    drawlist.segs.clear();
-    drawlist.seg_coords.clear();
-    drawlist.seg_colors.clear();
 
     if (this->num_polys() == 0) // for point clouds
     {
-        drawlist.tri_coords.reserve(this->num_verts()*3);
-        drawlist.tri_v_colors.reserve(this->num_verts()*4);
-        for(uint vid=0; vid<this->num_verts(); ++vid)
+        buffer_resize(drawlist, 0, 0);
+        drawlist.tri_coords.resize(this->num_verts()*3);
+        drawlist.tri_v_colors.resize(this->num_verts()*4);
+        PARALLEL_FOR(0, this->num_verts(), 1000, [&](uint vid)
         {
-            drawlist.tri_coords.push_back(this->vert(vid).x());
-            drawlist.tri_coords.push_back(this->vert(vid).y());
-            drawlist.tri_coords.push_back(this->vert(vid).z());
-
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.r);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.g);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.b);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.a);
-        }
+            drawlist.tri_coords[3*vid+0] = this->vert(vid).x();
+            drawlist.tri_coords[3*vid+1] = this->vert(vid).y();
+            drawlist.tri_coords[3*vid+2] = this->vert(vid).z();
+
+            drawlist.tri_v_colors[4*vid+0] = this->vert_data(vid).color.r;
+            drawlist.tri_v_colors[4*vid+1] = this->vert_data(vid).color.g;
+            drawlist.tri_v_colors[4*vid+2] = this->vert_data(vid).color.b;
+            drawlist.tri_v_colors[4*vid+3] = this->vert_data(vid).color.a;
+        });
+        return;
     }
-    else
-    {
-        for(uint pid=0; pid<this->num_polys(); ++pid)
-        {
-            if (this->poly_data(pid).flags[HIDDEN]) continue;
-
-            vec3d n = this->poly_data(pid).normal;
 
-            for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i)
-            {
-                uint vid0 = this->poly_tessellation(pid).at(3*i+0);
-                uint vid1 = this->poly_tessellation(pid).at(3*i+1);
-                uint vid2 = this->poly_tessellation(pid).at(3*i+2);
-
-                // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-                auto  vid0_vis_pids = this->vert_adj_visible_polys(vid0, n, 60.0);
-                auto  vid1_vis_pids = this->vert_adj_visible_polys(vid1, n, 60.0);
-                auto  vid2_vis_pids = this->vert_adj_visible_polys(vid2, n, 60.0);
-                float AO_vid0 = 0.0;
-                float AO_vid1 = 0.0;
-                float AO_vid2 = 0.0;
-                for(uint pid : vid0_vis_pids) AO_vid0 += this->poly_data(pid).AO*AO_alpha + (1.0 - AO_alpha);
-                for(uint pid : vid1_vis_pids) AO_vid1 += this->poly_data(pid).AO*AO_alpha + (1.0 - AO_alpha);
-                for(uint pid : vid2_vis_pids) AO_vid2 += this->poly_data(pid).AO*AO_alpha + (1.0 - AO_alpha);
-                AO_vid0 /= static_cast<float>(vid0_vis_pids.size());
-                AO_vid1 /= static_cast<float>(vid1_vis_pids.size());
-                AO_vid2 /= static_cast<float>(vid2_vis_pids.size());
-
-                uint base_addr = drawlist.tri_coords.size()/3;
-
-                drawlist.tris.push_back(base_addr    );
-                drawlist.tris.push_back(base_addr + 1);
-                drawlist.tris.push_back(base_addr + 2);
-
-                drawlist.tri_coords.push_back(this->vert(vid0).x());
-                drawlist.tri_coords.push_back(this->vert(vid0).y());
-                drawlist.tri_coords.push_back(this->vert(vid0).z());
-                drawlist.tri_coords.push_back(this->vert(vid1).x());
-                drawlist.tri_coords.push_back(this->vert(vid1).y());
-                drawlist.tri_coords.push_back(this->vert(vid1).z());
-                drawlist.tri_coords.push_back(this->vert(vid2).x());
-                drawlist.tri_coords.push_back(this->vert(vid2).y());
-                drawlist.tri_coords.push_back(this->vert(vid2).z());
-
-                if (drawlist.draw_mode & DRAW_TRI_SMOOTH)
-                {
-                    // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                    vec3d n_vid0(0,0,0);
-                    vec3d n_vid1(0,0,0);
-                    vec3d n_vid2(0,0,0);
-                    for(uint pid : vid0_vis_pids) n_vid0 += this->poly_data(pid).normal;
-                    for(uint pid : vid1_vis_pids) n_vid1 += this->poly_data(pid).normal;
-                    for(uint pid : vid2_vis_pids) n_vid2 += this->poly_data(pid).normal;
-                    n_vid0 /= static_cast<double>(vid0_vis_pids.size());
-                    n_vid1 /= static_cast<double>(vid1_vis_pids.size());
-                    n_vid2 /= static_cast<double>(vid2_vis_pids.size());
-
-                    drawlist.tri_v_norms.push_back(n_vid0.x());
-                    drawlist.tri_v_norms.push_back(n_vid0.y());
-                    drawlist.tri_v_norms.push_back(n_vid0.z());
-                    drawlist.tri_v_norms.push_back(n_vid1.x());
-                    drawlist.tri_v_norms.push_back(n_vid1.y());
-                    drawlist.tri_v_norms.push_back(n_vid1.z());
-                    drawlist.tri_v_norms.push_back(n_vid2.x());
-                    drawlist.tri_v_norms.push_back(n_vid2.y());
-                    drawlist.tri_v_norms.push_back(n_vid2.z());
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_FLAT)
-                {
-                    drawlist.tri_v_norms.push_back(n.x());
-                    drawlist.tri_v_norms.push_back(n.y());
-                    drawlist.tri_v_norms.push_back(n.z());
-                    drawlist.tri_v_norms.push_back(n.x());
-                    drawlist.tri_v_norms.push_back(n.y());
-                    drawlist.tri_v_norms.push_back(n.z());
-                    drawlist.tri_v_norms.push_back(n.x());
-                    drawlist.tri_v_norms.push_back(n.y());
-                    drawlist.tri_v_norms.push_back(n.z());
-                }
+    int attr = attributes;
 
-                if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
-                {
-                    drawlist.tri_text.push_back(this->vert_data(vid0).uvw[0]);
-                    drawlist.tri_text.push_back(this->vert_data(vid1).uvw[0]);
-                    drawlist.tri_text.push_back(this->vert_data(vid2).uvw[0]);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
-                {
-                    drawlist.tri_text.push_back(this->vert_data(vid0).uvw[0]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid0).uvw[1]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid1).uvw[0]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid1).uvw[1]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid2).uvw[0]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid2).uvw[1]*drawlist.texture.scaling_factor);
-                }
+    // a full update may follow changes in visibility or connectivity, hence the element-to-buffer
+    // maps are recomputed. Partial updates reuse them, unless the draw mode requires a new layout
+    if (attributes == UPDATE_GL_ALL || layout_changed())
+    {
+        attr = UPDATE_GL_ALL;
 
-                if (drawlist.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-                {
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR)
-                {
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_QUALITY)
-                {
-                    float q = this->poly_data(pid).quality;
-                    Color c = Color::red_white_blue_ramp_01(q);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.a);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.a);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.a);
-                }
-            }
+        poly_tri_offset.resize(this->num_polys()+1);
+        poly_tri_offset[0] = 0;
+        for(uint pid=0; pid<this->num_polys(); ++pid)
+        {
+            uint n_tris = (this->poly_data(pid).flags[HIDDEN]) ? 0 : this->poly_tessellation(pid).size()/3;
+            poly_tri_offset[pid+1] = poly_tri_offset[pid] + n_tris;
         }
 
+        edge_seg_offset.resize(this->num_edges()+1);
+        edge_seg_offset[0] = 0;
         for(uint eid=0; eid<this->num_edges(); ++eid)
         {
             bool hidden = true;
@@ -317,32 +191,281 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
                     break;
                 }
             }
-            if(hidden) continue;
-
-            int base_addr = drawlist.seg_coords.size()/3;
-            drawlist.segs.push_back(base_addr    );
-            drawlist.segs.push_back(base_addr + 1);
-
-            vec3d vid0 = this->edge_vert(eid,0);
-            vec3d vid1 = this->edge_vert(eid,1);
-
-            drawlist.seg_coords.push_back(vid0.x());
-            drawlist.seg_coords.push_back(vid0.y());
-            drawlist.seg_coords.push_back(vid0.z());
-            drawlist.seg_coords.push_back(vid1.x());
-            drawlist.seg_coords.push_back(vid1.y());
-            drawlist.seg_coords.push_back(vid1.z());
-
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.a);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.a);
+            edge_seg_offset[eid+1] = edge_seg_offset[eid] + ((hidden) ? 0 : 1);
         }
+
+        buffer_resize(drawlist, poly_tri_offset.back(), edge_seg_offset.back());
+        layout_mode = buffer_layout(drawlist.draw_mode);
+
+        // every element is up to date now
+        poly_dirty.assign(this->num_polys(), 0);
+        edge_dirty.assign(this->num_edges(), 0);
+        dirty_polys.clear();
+        dirty_edges.clear();
     }
+
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](uint pid)
+    {
+        updateGL_poly(pid, attr);
+    });
+    buffer_set_dirty_tris(drawlist, 0, poly_tri_offset.back());
+
+    if (attr & (UPDATE_GL_COORDS | UPDATE_GL_COLORS))
+    {
+        PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+        {
+            updateGL_edge(eid, attr);
+        });
+        buffer_set_dirty_segs(drawlist, 0, edge_seg_offset.back());
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolygonMesh<Mesh>::layout_changed() const
+{
+    return poly_tri_offset.size() != this->num_polys()+1 ||
+           edge_seg_offset.size() != this->num_edges()+1 ||
+           layout_mode != buffer_layout(drawlist.draw_mode);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// writes the selected attributes of poly pid in its range of the buffers.
+// Polys write disjoint ranges, hence it is safe to call it in parallel
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_poly(const uint pid, const int attributes)
+{
+    uint t_beg = poly_tri_offset.at(pid);
+    uint t_end = poly_tri_offset.at(pid+1);
+    if (t_beg == t_end) return; // hidden poly
+
+    bool smooth = (drawlist.draw_mode & DRAW_TRI_SMOOTH);
+    bool norms  = (attributes & UPDATE_GL_NORMALS)  && !drawlist.tri_v_norms.empty();
+    bool colors = (attributes & UPDATE_GL_COLORS)   && !drawlist.tri_v_colors.empty();
+    bool text   = (attributes & UPDATE_GL_TEXTURES) && !drawlist.tri_text.empty();
+    float s     = drawlist.texture.scaling_factor;
+
+    const std::vector<uint> & tess = this->poly_tessellation(pid);
+    vec3d n = this->poly_data(pid).normal;
+
+    for(uint t=t_beg; t<t_end; ++t)
+    for(uint i=0; i<3; ++i)
+    {
+        uint vid = tess.at(3*(t-t_beg)+i);
+        uint c   = 3*t+i; // unshared vertex (triangle corner) in the buffers
+
+        if (attributes & UPDATE_GL_COORDS)
+        {
+            drawlist.tri_coords[3*c+0] = this->vert(vid).x();
+            drawlist.tri_coords[3*c+1] = this->vert(vid).y();
+            drawlist.tri_coords[3*c+2] = this->vert(vid).z();
+        }
+
+        if (!norms && !colors && !text) continue;
+
+        // average AO and normals with adjacent visible faces having dihedral angle lower than 60 degrees
+        float AO   = 1.0;
+        vec3d n_av = n;
+        if ((norms && smooth) || colors)
+        {
+            auto vis_pids = this->vert_adj_visible_polys(vid, n, 60.0);
+            AO   = 0.0;
+            n_av = vec3d(0,0,0);
+            for(uint nbr : vis_pids)
+            {
+                AO   += this->poly_data(nbr).AO*AO_alpha + (1.0 - AO_alpha);
+                n_av += this->poly_data(nbr).normal;
+            }
+            AO   /= static_cast<float>(vis_pids.size());
+            n_av /= static_cast<double>(vis_pids.size());
+        }
+
+        if (norms)
+        {
+            vec3d vn = (smooth) ? n_av : n;
+            drawlist.tri_v_norms[3*c+0] = vn.x();
+            drawlist.tri_v_norms[3*c+1] = vn.y();
+            drawlist.tri_v_norms[3*c+2] = vn.z();
+        }
+
+        if (text)
+        {
+            if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
+            {
+                drawlist.tri_text[c] = this->vert_data(vid).uvw[0];
+            }
+            else
+            {
+                drawlist.tri_text[2*c+0] = this->vert_data(vid).uvw[0]*s;
+                drawlist.tri_text[2*c+1] = this->vert_data(vid).uvw[1]*s;
+            }
+        }
+
+        if (colors)
+        {
+            Color col;
+            if      (drawlist.draw_mode & DRAW_TRI_FACECOLOR) col = this->poly_data(pid).color; // replicate f color on each vertex
+            else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR) col = this->vert_data(vid).color;
+            else                                              col = Color::red_white_blue_ramp_01(this->poly_data(pid).quality);
+
+            drawlist.tri_v_colors[4*c+0] = col.r*AO;
+            drawlist.tri_v_colors[4*c+1] = col.g*AO;
+            drawlist.tri_v_colors[4*c+2] = col.b*AO;
+            drawlist.tri_v_colors[4*c+3] = col.a;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_edge(const uint eid, const int attributes)
+{
+    uint s = edge_seg_offset.at(eid);
+    if (s == edge_seg_offset.at(eid+1)) return; // hidden edge
+
+    if (attributes & UPDATE_GL_COORDS)
+    {
+        vec3d vid0 = this->edge_vert(eid,0);
+        vec3d vid1 = this->edge_vert(eid,1);
+        drawlist.seg_coords[6*s+0] = vid0.x();
+        drawlist.seg_coords[6*s+1] = vid0.y();
+        drawlist.seg_coords[6*s+2] = vid0.z();
+        drawlist.seg_coords[6*s+3] = vid1.x();
+        drawlist.seg_coords[6*s+4] = vid1.y();
+        drawlist.seg_coords[6*s+5] = vid1.z();
+    }
+
+    if (attributes & UPDATE_GL_COLORS)
+    {
+        const Color & c = this->edge_data(eid).color;
+        for(uint i=0; i<2; ++i)
+        {
+            drawlist.seg_colors[8*s+4*i+0] = c.r;
+            drawlist.seg_colors[8*s+4*i+1] = c.g;
+            drawlist.seg_colors[8*s+4*i+2] = c.b;
+            drawlist.seg_colors[8*s+4*i+3] = c.a;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::vert_set_dirty(const uint vid, const int attributes)
+{
+    // moving a vertex changes the normals of its incident polys too
+    int p_attr = (attributes & UPDATE_GL_COORDS) ? (attributes | UPDATE_GL_NORMALS) : attributes;
+    for(uint pid : this->adj_v2p(vid)) poly_set_dirty(pid, p_attr);
+
+    if (attributes & UPDATE_GL_COORDS)
+    {
+        for(uint eid : this->adj_v2e(vid)) edge_set_dirty(eid, UPDATE_GL_COORDS);
+        Mesh::pick_index_set_dirty(); // the slicer cache is updated incrementally
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::pick_index_set_dirty()
+{
+    Mesh::pick_index_set_dirty();
+    slicer.set_dirty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::edge_set_dirty(const uint eid, const int attributes)
+{
+    if (edge_dirty.size() < this->num_edges()) edge_dirty.resize(this->num_edges(), 0);
+    if (edge_dirty.at(eid) == 0) dirty_edges.push_back(eid);
+    edge_dirty.at(eid) |= attributes;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::poly_set_dirty(const uint pid, const int attributes)
+{
+    if (poly_dirty.size() < this->num_polys()) poly_dirty.resize(this->num_polys(), 0);
+
+    auto mark = [&](const uint id, const int attr)
+    {
+        if (poly_dirty.at(id) == 0) dirty_polys.push_back(id);
+        poly_dirty.at(id) |= attr;
+    };
+
+    mark(pid, attributes);
+
+    // geometry, quality or label may have changed
+    if (attributes & (UPDATE_GL_COORDS | UPDATE_GL_COLORS)) slicer.poly_set_dirty(pid);
+
+    // smooth normals and AO are averaged among the visible polys incident to each vertex (with a
+    // threshold on the normal deviation), therefore a new normal for pid affects its whole vertex ring
+    if (attributes & UPDATE_GL_NORMALS)
+    {
+        for(uint vid : this->adj_p2v(pid))
+        for(uint nbr : this->adj_v2p(vid))
+        {
+            if (nbr != pid) mark(nbr, UPDATE_GL_NORMALS | UPDATE_GL_COLORS);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_dirty()
+{
+    CINO_PROFILE_SCOPE("AbstractDrawablePolygonMesh::updateGL_dirty");
+    if (this->num_polys() == 0 || layout_changed())
+    {
+        updateGL();
+        return;
+    }
+
+    drawlist.material = material_;
+
+    PARALLEL_FOR(0, dirty_polys.size(), 100, [&](uint i)
+    {
+        uint pid = dirty_polys.at(i);
+        updateGL_poly(pid, poly_dirty.at(pid));
+    });
+
+    PARALLEL_FOR(0, dirty_edges.size(), 100, [&](uint i)
+    {
+        uint eid = dirty_edges.at(i);
+        updateGL_edge(eid, edge_dirty.at(eid));
+    });
+
+    bool moved = false;
+    for(uint eid : dirty_edges)
+    {
+        if (edge_dirty.at(eid) & UPDATE_GL_COORDS) moved = true;
+        edge_dirty.at(eid) = 0;
+        buffer_set_dirty_segs(drawlist, edge_seg_offset.at(eid), edge_seg_offset.at(eid+1));
+    }
+    for(uint pid : dirty_polys)
+    {
+        poly_dirty.at(pid) = 0;
+        buffer_set_dirty_tris(drawlist, poly_tri_offset.at(pid), poly_tri_offset.at(pid+1));
+    }
+    dirty_polys.clear();
+    dirty_edges.clear();
+
+    if (moved) updateGL_marked();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -351,8 +474,13 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::slice(const SlicerState & s)
 {
-    slicer.update(*this, s); // update per element visibility flags
-    updateGL();
+    // update per element visibility flags. Only the rendering data is regenerated:
+    // a full updateGL() would also discard the index of the slicer
+    if (!slicer.update(*this, s).empty())
+    {
+        updateGL_mesh();
+        updateGL_marked();
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -361,8 +489,7 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::slicer_reset()
 {
-    slicer.reset(*this);
-    updateGL();
+    if (!slicer.reset(*this).empty()) updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -382,7 +509,7 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::show_AO_alpha(const float alpha)
 {
     AO_alpha = alpha;
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -431,7 +558,7 @@ void AbstractDrawablePolygonMesh<Mesh>::show_vert_color()
     drawlist.draw_mode &= ~DRAW_TRI_QUALITY;
     drawlist.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -445,7 +572,7 @@ void AbstractDrawablePolygonMesh<Mesh>::show_poly_color()
     drawlist.draw_mode &= ~DRAW_TRI_QUALITY;
     drawlist.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -470,7 +597,7 @@ void AbstractDrawablePolygonMesh<Mesh>::show_texture1D(const int tex_type)
         case TEXTURE_1D_PARULA_W_ISOLINES : texture_parula_with_isolines(drawlist.texture); break;
         default: assert("Unknown Texture!" && false);
     }
-    updateGL();
+    updateGL_mesh(UPDATE_GL_TEXTURES);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -494,7 +621,7 @@ void AbstractDrawablePolygonMesh<Mesh>::show_texture2D(const int tex_type, const
         case TEXTURE_2D_BITMAP:        texture_bitmap(drawlist.texture, bitmap); break;
         default: assert("Unknown Texture!" && false);
     }
-    updateGL();
+    updateGL_mesh(UPDATE_GL_TEXTURES);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -514,7 +641,6 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::show_wireframe_color(const Color & c)
 {
     this->edge_set_color(c); // NOTE: this will change alpha for ANY adge (both interior and boundary)
-    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -533,7 +659,6 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::show_wireframe_transparency(const float alpha)
 {
     this->edge_set_alpha(alpha); // NOTE: this will change alpha for ANY adge (both interior and boundary)
-    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -575,4 +700,40 @@ void AbstractDrawablePolygonMesh<Mesh>::show_marked_edge_transparency(const floa
     updateGL_marked();
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+MemoryFootprint AbstractDrawablePolygonMesh<Mesh>::memory_footprint() const
+{
+    MemoryFootprint mf = Mesh::memory_footprint();
+    mf.add("drawlist",        buffer_memory_footprint(drawlist));
+    mf.add("drawlist_marked", buffer_memory_footprint(drawlist_marked));
+    mf.add("slicer",          slicer.memory_footprint());
+    mf.add("poly_tri_offset", poly_tri_offset);
+    mf.add("edge_seg_offset", edge_seg_offset);
+    mf.add("poly_dirty",      poly_dirty);
+    mf.add("edge_dirty",      edge_dirty);
+    mf.add("dirty_polys",     dirty_polys);
+    mf.add("dirty_edges",     dirty_edges);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::shrink_to_fit()
+{
+    Mesh::shrink_to_fit();
+    buffer_shrink_to_fit(drawlist);
+    buffer_shrink_to_fit(drawlist_marked);
+    poly_tri_offset.shrink_to_fit();
+    edge_seg_offset.shrink_to_fit();
+    poly_dirty.shrink_to_fit();
+    edge_dirty.shrink_to_fit();
+    dirty_polys.shrink_to_fit();
+    dirty_edges.shrink_to_fit();
+}
+
 }
@@ -57,6 +57,21 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
         Color            marked_edge_color;
         float            AO_alpha = 1.0;
 
+        // element-to-buffer-range maps: the triangles of poly pid occupy the range
+        // [poly_tri_offset[pid], poly_tri_offset[pid+1]) of drawlist, the segments
+        // of edge eid occupy [edge_seg_offset[eid], edge_seg_offset[eid+1]). Hidden
+        // elements have empty ranges. The maps are recomputed at each full update,
+        // partial updates reuse them as long as the buffer layout does not change
+        std::vector<uint> poly_tri_offset;
+        std::vector<uint> edge_seg_offset;
+        int               layout_mode = 0;
+
+        // per element dirty attributes (UPDATE_GL_COORDS, UPDATE_GL_NORMALS, ...)
+        std::vector<int>  poly_dirty;
+        std::vector<int>  edge_dirty;
+        std::vector<uint> dirty_polys;
+        std::vector<uint> dirty_edges;
+
     public:
 
         explicit AbstractDrawablePolygonMesh() : Mesh() {}
@@ -70,12 +85,12 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void vert_set_color(const Color & c) { Mesh::vert_set_color(c); updateGL(); }
-        void edge_set_color(const Color & c) { Mesh::edge_set_color(c); updateGL(); }
-        void poly_set_color(const Color & c) { Mesh::poly_set_color(c); updateGL(); }
-        void vert_set_alpha(const float   a) { Mesh::vert_set_alpha(a); updateGL(); }
-        void edge_set_alpha(const float   a) { Mesh::edge_set_alpha(a); updateGL(); }
-        void poly_set_alpha(const float   a) { Mesh::poly_set_alpha(a); updateGL(); }
+        void vert_set_color(const Color & c) { Mesh::vert_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void edge_set_color(const Color & c) { Mesh::edge_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void poly_set_color(const Color & c) { Mesh::poly_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void vert_set_alpha(const float   a) { Mesh::vert_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
+        void edge_set_alpha(const float   a) { Mesh::edge_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
+        void poly_set_alpha(const float   a) { Mesh::poly_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -83,9 +98,27 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void updateGL();        // regenerates rendering data for both mesh and marked elements
-        void updateGL_mesh();   // regenerates rendering data for mesh elements
-        void updateGL_marked(); // regenerates rendering data for marked mesh elements
+        MemoryFootprint memory_footprint() const override; // mesh + rendering data
+        void            shrink_to_fit() override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void updateGL();                                          // regenerates rendering data for both mesh and marked elements
+        void updateGL_mesh(const int attributes = UPDATE_GL_ALL); // regenerates rendering data for mesh elements (only the selected attributes)
+        void updateGL_marked();                                   // regenerates rendering data for marked mesh elements
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // incremental updates: mark the elements that changed since the last
+        // update, then call updateGL_dirty() to patch only their buffer ranges.
+        // Changes in visibility or connectivity require a full updateGL()
+        void vert_set_dirty(const uint vid, const int attributes = UPDATE_GL_ALL);
+        void edge_set_dirty(const uint eid, const int attributes = UPDATE_GL_ALL);
+        void poly_set_dirty(const uint pid, const int attributes = UPDATE_GL_ALL);
+        void updateGL_dirty();
+
+        // also invalidates the geometry cached by the slicer
+        void pick_index_set_dirty() override;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -116,6 +149,12 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
         void show_marked_edge_color(const Color & c);
         void show_marked_edge_width(const float width);
         void show_marked_edge_transparency(const float alpha);
+
+    protected:
+
+        bool layout_changed() const;
+        void updateGL_poly(const uint pid, const int attributes);
+        void updateGL_edge(const uint eid, const int attributes);
 };
 
 }
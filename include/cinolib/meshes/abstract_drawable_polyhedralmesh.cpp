@@ -38,7 +38,9 @@
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/textures/textures.h>
 #include <cinolib/color.h>
-#include <unordered_set>
+#include <cinolib/parallel_for.h>
+#include <cinolib/stl_container_utilities.h>
+#include <cinolib/profiler.h>
 
 namespace cinolib
 {
@@ -77,9 +79,11 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::updateGL()
 {
+    CINO_PROFILE_SCOPE("AbstractDrawablePolyhedralMesh::updateGL");
+    // a full update may follow any edit of the mesh (e.g. moved vertices)
+    slicer.set_dirty();
     updateGL_marked();
-    updateGL_in();
-    updateGL_out();
+    updateGL_mesh();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -174,447 +178,334 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_marked()
         drawlist_marked.seg_colors.push_back(marked_edge_color.b);
         drawlist_marked.seg_colors.push_back(marked_edge_color.a);
     }
+
+    buffer_set_dirty(drawlist_marked);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_mesh(const int attributes)
 {
+    updateGL_lists(attributes, true, true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in(const int attributes)
+{
+    updateGL_lists(attributes, true, false);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out(const int attributes)
+{
+    updateGL_lists(attributes, false, true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_lists(const int attributes, bool in, bool out)
+{
+    drawlist_in.material  = material_;
     drawlist_out.material = material_;
-    drawlist_out.tris.clear();
-    drawlist_out.tri_coords.clear();
-    drawlist_out.tri_v_norms.clear();
-    drawlist_out.tri_v_colors.clear();
-    drawlist_out.tri_text.clear();
-    drawlist_out.segs.clear();
-    drawlist_out.seg_coords.clear();
-    drawlist_out.seg_colors.clear();
 
-    for(uint fid=0; fid<this->num_faces(); ++fid)
-    {
-        if (!this->face_is_on_srf(fid)) continue;
+    int attr = attributes;
 
-        uint pid_beneath;
-        if(!this->face_is_visible(fid,pid_beneath)) continue;
+    // a full update may follow changes in visibility or connectivity, hence the element-to-buffer
+    // maps are recomputed. Since inner and outer elements are classified together, both lists
+    // are regenerated. Partial updates reuse the maps, unless the draw mode requires a new layout
+    if (attributes == UPDATE_GL_ALL || layout_changed())
+    {
+        update_layout();
+        attr = UPDATE_GL_ALL;
+        in   = true;
+        out  = true;
+    }
 
-        vec3d n = this->poly_face_normal(pid_beneath, fid);
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
+    {
+        bool srf = this->face_is_on_srf(fid);
+        if ((srf && out) || (!srf && in)) updateGL_face(fid, attr);
+    });
 
-        for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+    if (attr & (UPDATE_GL_COORDS | UPDATE_GL_COLORS))
+    {
+        PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
         {
-            uint vid0 = this->face_tessellation(fid).at(3*i+0);
-            uint vid1 = this->face_tessellation(fid).at(3*i+1);
-            uint vid2 = this->face_tessellation(fid).at(3*i+2);
+            bool srf = this->edge_is_on_srf(eid);
+            if ((srf && out) || (!srf && in)) updateGL_edge(eid, attr);
+        });
+    }
 
-            // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-            auto  vid0_vis_fids = this->vert_adj_visible_faces(vid0, n, 60.0);
-            auto  vid1_vis_fids = this->vert_adj_visible_faces(vid1, n, 60.0);
-            auto  vid2_vis_fids = this->vert_adj_visible_faces(vid2, n, 60.0);
-            float AO_vid0 = 0.0;
-            float AO_vid1 = 0.0;
-            float AO_vid2 = 0.0;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
-            AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
-            AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
-
-            int base_addr = drawlist_out.tri_coords.size()/3;
-
-            drawlist_out.tris.push_back(base_addr    );
-            drawlist_out.tris.push_back(base_addr + 1);
-            drawlist_out.tris.push_back(base_addr + 2);
-
-            drawlist_out.tri_coords.push_back(this->vert(vid0).x());
-            drawlist_out.tri_coords.push_back(this->vert(vid0).y());
-            drawlist_out.tri_coords.push_back(this->vert(vid0).z());
-            drawlist_out.tri_coords.push_back(this->vert(vid1).x());
-            drawlist_out.tri_coords.push_back(this->vert(vid1).y());
-            drawlist_out.tri_coords.push_back(this->vert(vid1).z());
-            drawlist_out.tri_coords.push_back(this->vert(vid2).x());
-            drawlist_out.tri_coords.push_back(this->vert(vid2).y());
-            drawlist_out.tri_coords.push_back(this->vert(vid2).z());
-
-            if (drawlist_out.draw_mode & DRAW_TRI_SMOOTH)
-            {
-                // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                vec3d n_vid0(0,0,0);
-                vec3d n_vid1(0,0,0);
-                vec3d n_vid2(0,0,0);
-                for(auto fp : vid0_vis_fids) n_vid0 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid1_vis_fids) n_vid1 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid2_vis_fids) n_vid2 += this->poly_face_normal(fp.second, fp.first);
-                n_vid0 /= static_cast<double>(vid0_vis_fids.size());
-                n_vid1 /= static_cast<double>(vid1_vis_fids.size());
-                n_vid2 /= static_cast<double>(vid2_vis_fids.size());
-
-                drawlist_out.tri_v_norms.push_back(n_vid0.x());
-                drawlist_out.tri_v_norms.push_back(n_vid0.y());
-                drawlist_out.tri_v_norms.push_back(n_vid0.z());
-                drawlist_out.tri_v_norms.push_back(n_vid1.x());
-                drawlist_out.tri_v_norms.push_back(n_vid1.y());
-                drawlist_out.tri_v_norms.push_back(n_vid1.z());
-                drawlist_out.tri_v_norms.push_back(n_vid2.x());
-                drawlist_out.tri_v_norms.push_back(n_vid2.y());
-                drawlist_out.tri_v_norms.push_back(n_vid2.z());
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_FLAT)
-            {
-                drawlist_out.tri_v_norms.push_back(n.x());
-                drawlist_out.tri_v_norms.push_back(n.y());
-                drawlist_out.tri_v_norms.push_back(n.z());
-                drawlist_out.tri_v_norms.push_back(n.x());
-                drawlist_out.tri_v_norms.push_back(n.y());
-                drawlist_out.tri_v_norms.push_back(n.z());
-                drawlist_out.tri_v_norms.push_back(n.x());
-                drawlist_out.tri_v_norms.push_back(n.y());
-                drawlist_out.tri_v_norms.push_back(n.z());
-            }
+    if (in)
+    {
+        buffer_set_dirty_tris(drawlist_in, 0, face_tri_offset_in.back());
+        buffer_set_dirty_segs(drawlist_in, 0, edge_seg_offset_in.back());
+    }
+    if (out)
+    {
+        buffer_set_dirty_tris(drawlist_out, 0, face_tri_offset_out.back());
+        buffer_set_dirty_segs(drawlist_out, 0, edge_seg_offset_out.back());
+    }
+}
 
-            if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE1D)
-            {
-                drawlist_out.tri_text.push_back(this->vert_data(vid0).uvw[0]);
-                drawlist_out.tri_text.push_back(this->vert_data(vid1).uvw[0]);
-                drawlist_out.tri_text.push_back(this->vert_data(vid2).uvw[0]);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE2D)
-            {
-                drawlist_out.tri_text.push_back(this->vert_data(vid0).uvw[0]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid0).uvw[1]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid1).uvw[0]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid1).uvw[1]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid2).uvw[0]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid2).uvw[1]*drawlist_out.texture.scaling_factor);
-            }
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            if (drawlist_out.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-            {
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_VERTCOLOR)
-            {
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_QUALITY)
-            {
-                float q = this->poly_data(pid_beneath).quality;
-                Color c = Color::red_white_blue_ramp_01(q);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.a);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.a);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.a);
-            }
-        }
-    }
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::update_layout()
+{
+    update_visibility();
+    update_offsets();
+
+    // every element will be up to date
+    face_dirty.assign(this->num_faces(), 0);
+    edge_dirty.assign(this->num_edges(), 0);
+    dirty_faces.clear();
+    dirty_edges.clear();
+}
 
-    for(uint eid=0; eid<this->num_edges(); ++eid)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::update_visibility()
+{
+    face_beneath.resize(this->num_faces());
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
     {
-        vec3d vid0 = this->edge_vert(eid,0);
-        vec3d vid1 = this->edge_vert(eid,1);
+        uint pid_beneath;
+        face_beneath[fid] = (this->face_is_visible(fid, pid_beneath)) ? static_cast<int>(pid_beneath) : -1;
+    });
+
+    // edge visibility depends on face visibility, hence it is computed afterwards
+    edge_visible.resize(this->num_edges());
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+    {
+        edge_visible[eid] = edge_is_rendered(eid) ? 1 : 0;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// converts per element visibility into buffer ranges (counts are scattered
+// in the offset arrays, then accumulated with a parallel prefix sum), and
+// allocates the buffers accordingly
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::update_offsets()
+{
+    face_tri_offset_in.resize(this->num_faces()+1);
+    face_tri_offset_out.resize(this->num_faces()+1);
+    face_tri_offset_in[0]  = 0;
+    face_tri_offset_out[0] = 0;
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
+    {
+        uint n_tris = (face_beneath[fid]>=0) ? this->face_tessellation(fid).size()/3 : 0;
+        bool srf    = this->face_is_on_srf(fid);
+        face_tri_offset_in [fid+1] = (srf) ? 0 : n_tris;
+        face_tri_offset_out[fid+1] = (srf) ? n_tris : 0;
+    });
+    PARALLEL_PREFIX_SUM(face_tri_offset_in,  10000);
+    PARALLEL_PREFIX_SUM(face_tri_offset_out, 10000);
+
+    edge_seg_offset_in.resize(this->num_edges()+1);
+    edge_seg_offset_out.resize(this->num_edges()+1);
+    edge_seg_offset_in[0]  = 0;
+    edge_seg_offset_out[0] = 0;
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+    {
+        bool srf = this->edge_is_on_srf(eid);
+        edge_seg_offset_in [eid+1] = (!srf && edge_visible[eid]) ? 1 : 0;
+        edge_seg_offset_out[eid+1] = ( srf && edge_visible[eid]) ? 1 : 0;
+    });
+    PARALLEL_PREFIX_SUM(edge_seg_offset_in,  10000);
+    PARALLEL_PREFIX_SUM(edge_seg_offset_out, 10000);
+
+    buffer_resize(drawlist_in,  face_tri_offset_in.back(),  edge_seg_offset_in.back());
+    buffer_resize(drawlist_out, face_tri_offset_out.back(), edge_seg_offset_out.back());
+    layout_mode_in  = buffer_layout(drawlist_in.draw_mode);
+    layout_mode_out = buffer_layout(drawlist_out.draw_mode);
+}
 
-        if (this->edge_is_on_srf(eid))
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// outer edges are rendered if incident to a visible poly. Inner
+// edges are rendered if incident to a visible inner face
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolyhedralMesh<Mesh>::edge_is_rendered(const uint eid) const
+{
+    if (this->edge_is_on_srf(eid))
+    {
+        for(uint pid : this->adj_e2p(eid))
         {
-            bool hidden = true;
-            for(uint pid : this->adj_e2p(eid))
-            {
-                if(!this->poly_data(pid).flags[HIDDEN])
-                {
-                    hidden = false;
-                    break;
-                }
-            }
-            if(hidden) continue;
-
-            int base_addr = drawlist_out.seg_coords.size()/3;
-            drawlist_out.segs.push_back(base_addr    );
-            drawlist_out.segs.push_back(base_addr + 1);
-
-            drawlist_out.seg_coords.push_back(vid0.x());
-            drawlist_out.seg_coords.push_back(vid0.y());
-            drawlist_out.seg_coords.push_back(vid0.z());
-            drawlist_out.seg_coords.push_back(vid1.x());
-            drawlist_out.seg_coords.push_back(vid1.y());
-            drawlist_out.seg_coords.push_back(vid1.z());
-
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.a);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.a);
+            if(!this->poly_data(pid).flags[HIDDEN]) return true;
         }
-
-        if (this->edge_data(eid).flags[MARKED])
+    }
+    else
+    {
+        for(uint fid : this->adj_e2f(eid))
         {
-            int base_addr = drawlist_marked.seg_coords.size()/3;
-            drawlist_marked.segs.push_back(base_addr    );
-            drawlist_marked.segs.push_back(base_addr + 1);
-
-            drawlist_marked.seg_coords.push_back(vid0.x());
-            drawlist_marked.seg_coords.push_back(vid0.y());
-            drawlist_marked.seg_coords.push_back(vid0.z());
-            drawlist_marked.seg_coords.push_back(vid1.x());
-            drawlist_marked.seg_coords.push_back(vid1.y());
-            drawlist_marked.seg_coords.push_back(vid1.z());
-
-            drawlist_marked.seg_colors.push_back(marked_edge_color.r);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.g);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.b);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.a);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.r);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.g);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.b);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.a);
+            if(!this->face_is_on_srf(fid) && face_beneath.at(fid)>=0) return true;
         }
     }
+    return false;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
+bool AbstractDrawablePolyhedralMesh<Mesh>::layout_changed() const
 {
-    drawlist_in.material = material_;
-    drawlist_in.tris.clear();
-    drawlist_in.tri_coords.clear();
-    drawlist_in.tri_v_norms.clear();
-    drawlist_in.tri_v_colors.clear();
-    drawlist_in.tri_text.clear();
-    drawlist_in.segs.clear();
-    drawlist_in.seg_coords.clear();
-    drawlist_in.seg_colors.clear();
-
-    std::unordered_set<uint> edges_to_render;
+    return face_beneath.size()        != this->num_faces()   ||
+           edge_visible.size()        != this->num_edges()   ||
+           face_tri_offset_in.size()  != this->num_faces()+1 ||
+           edge_seg_offset_in.size()  != this->num_edges()+1 ||
+           layout_mode_in  != buffer_layout(drawlist_in.draw_mode) ||
+           layout_mode_out != buffer_layout(drawlist_out.draw_mode);
+}
 
-    for(uint fid=0; fid<this->num_faces(); ++fid)
-    {
-        if(this->face_is_on_srf(fid)) continue;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        uint pid_beneath;
-        if(!this->face_is_visible(fid, pid_beneath)) continue;
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_face(const uint fid, const int attributes)
+{
+    if (face_beneath.at(fid) < 0) return; // invisible face
 
-        bool is_CW = this->poly_face_is_CW(pid_beneath, fid);
+    bool                      srf   = this->face_is_on_srf(fid);
+    RenderData              & dl    = (srf) ? drawlist_out : drawlist_in;
+    const std::vector<uint> & range = (srf) ? face_tri_offset_out : face_tri_offset_in;
 
-        vec3d n = this->poly_face_normal(pid_beneath, fid);
+    uint t_beg = range.at(fid);
+    uint t_end = range.at(fid+1);
+    uint pid   = face_beneath.at(fid);
+    bool is_CW = !srf && this->poly_face_is_CW(pid, fid);
+
+    bool smooth = (dl.draw_mode & DRAW_TRI_SMOOTH);
+    bool norms  = (attributes & UPDATE_GL_NORMALS)  && !dl.tri_v_norms.empty();
+    bool colors = (attributes & UPDATE_GL_COLORS)   && !dl.tri_v_colors.empty();
+    bool text   = (attributes & UPDATE_GL_TEXTURES) && !dl.tri_text.empty();
+    float s     = dl.texture.scaling_factor;
+
+    const std::vector<uint> & tess = this->face_tessellation(fid);
+    vec3d n = this->poly_face_normal(pid, fid);
+
+    for(uint t=t_beg; t<t_end; ++t)
+    for(uint i=0; i<3; ++i)
+    {
+        uint off = (is_CW && i>0) ? 3-i : i; // flip triangle orientation
+        uint vid = tess.at(3*(t-t_beg)+off);
+        uint c   = 3*t+i; // unshared vertex (triangle corner) in the buffers
 
-        for(uint eid : this->adj_f2e(fid))
+        if (attributes & UPDATE_GL_COORDS)
         {
-            if (this->edge_is_on_srf(eid)) continue; // updateGL_out() will consider it
-            edges_to_render.insert(eid);
+            dl.tri_coords[3*c+0] = this->vert(vid).x();
+            dl.tri_coords[3*c+1] = this->vert(vid).y();
+            dl.tri_coords[3*c+2] = this->vert(vid).z();
         }
 
-        for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+        if (!norms && !colors && !text) continue;
+
+        // average AO and normals with adjacent visible faces having dihedral angle lower than 60 degrees
+        float AO   = 1.0;
+        vec3d n_av = n;
+        if ((norms && smooth) || colors)
         {
-            uint vid0 = this->face_tessellation(fid).at(3*i+0);
-            uint vid1 = this->face_tessellation(fid).at(3*i+1);
-            uint vid2 = this->face_tessellation(fid).at(3*i+2);
-            if (is_CW) std::swap(vid1,vid2); // flip triangle orientation
-
-            // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-            auto  vid0_vis_fids = this->vert_adj_visible_faces(vid0, n, 60.0);
-            auto  vid1_vis_fids = this->vert_adj_visible_faces(vid1, n, 60.0);
-            auto  vid2_vis_fids = this->vert_adj_visible_faces(vid2, n, 60.0);
-            float AO_vid0 = 0.0;
-            float AO_vid1 = 0.0;
-            float AO_vid2 = 0.0;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
-            AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
-            AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
-
-            int base_addr = drawlist_in.tri_coords.size()/3;
-
-            drawlist_in.tris.push_back(base_addr    );
-            drawlist_in.tris.push_back(base_addr + 1);
-            drawlist_in.tris.push_back(base_addr + 2);
-
-            drawlist_in.tri_coords.push_back(this->vert(vid0).x());
-            drawlist_in.tri_coords.push_back(this->vert(vid0).y());
-            drawlist_in.tri_coords.push_back(this->vert(vid0).z());
-            drawlist_in.tri_coords.push_back(this->vert(vid1).x());
-            drawlist_in.tri_coords.push_back(this->vert(vid1).y());
-            drawlist_in.tri_coords.push_back(this->vert(vid1).z());
-            drawlist_in.tri_coords.push_back(this->vert(vid2).x());
-            drawlist_in.tri_coords.push_back(this->vert(vid2).y());
-            drawlist_in.tri_coords.push_back(this->vert(vid2).z());
-
-            if (drawlist_in.draw_mode & DRAW_TRI_SMOOTH)
-            {
-                // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                vec3d n_vid0(0,0,0);
-                vec3d n_vid1(0,0,0);
-                vec3d n_vid2(0,0,0);
-                for(auto fp : vid0_vis_fids) n_vid0 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid1_vis_fids) n_vid1 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid2_vis_fids) n_vid2 += this->poly_face_normal(fp.second, fp.first);
-                n_vid0 /= static_cast<double>(vid0_vis_fids.size());
-                n_vid1 /= static_cast<double>(vid1_vis_fids.size());
-                n_vid2 /= static_cast<double>(vid2_vis_fids.size());
-
-                drawlist_in.tri_v_norms.push_back(n_vid0.x());
-                drawlist_in.tri_v_norms.push_back(n_vid0.y());
-                drawlist_in.tri_v_norms.push_back(n_vid0.z());
-                drawlist_in.tri_v_norms.push_back(n_vid1.x());
-                drawlist_in.tri_v_norms.push_back(n_vid1.y());
-                drawlist_in.tri_v_norms.push_back(n_vid1.z());
-                drawlist_in.tri_v_norms.push_back(n_vid2.x());
-                drawlist_in.tri_v_norms.push_back(n_vid2.y());
-                drawlist_in.tri_v_norms.push_back(n_vid2.z());
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_FLAT)
+            auto vis_fids = this->vert_adj_visible_faces(vid, n, 60.0);
+            AO   = 0.0;
+            n_av = vec3d(0,0,0);
+            for(auto fp : vis_fids)
             {
-                drawlist_in.tri_v_norms.push_back(n.x());
-                drawlist_in.tri_v_norms.push_back(n.y());
-                drawlist_in.tri_v_norms.push_back(n.z());
-                drawlist_in.tri_v_norms.push_back(n.x());
-                drawlist_in.tri_v_norms.push_back(n.y());
-                drawlist_in.tri_v_norms.push_back(n.z());
-                drawlist_in.tri_v_norms.push_back(n.x());
-                drawlist_in.tri_v_norms.push_back(n.y());
-                drawlist_in.tri_v_norms.push_back(n.z());
+                AO   += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
+                n_av += this->poly_face_normal(fp.second, fp.first);
             }
+            AO   /= static_cast<float>(vis_fids.size());
+            n_av /= static_cast<double>(vis_fids.size());
+        }
 
-            if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE1D)
-            {
-                drawlist_in.tri_text.push_back(this->vert_data(vid0).uvw[0]);
-                drawlist_in.tri_text.push_back(this->vert_data(vid1).uvw[0]);
-                drawlist_in.tri_text.push_back(this->vert_data(vid2).uvw[0]);
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE2D)
-            {
-                drawlist_in.tri_text.push_back(this->vert_data(vid0).uvw[0]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid0).uvw[1]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid1).uvw[0]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid1).uvw[1]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid2).uvw[0]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid2).uvw[1]*drawlist_in.texture.scaling_factor);
-            }
+        if (norms)
+        {
+            vec3d vn = (smooth) ? n_av : n;
+            dl.tri_v_norms[3*c+0] = vn.x();
+            dl.tri_v_norms[3*c+1] = vn.y();
+            dl.tri_v_norms[3*c+2] = vn.z();
+        }
 
-            if (drawlist_in.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-            {
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_VERTCOLOR)
+        if (text)
+        {
+            if (dl.draw_mode & DRAW_TRI_TEXTURE1D)
             {
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.a);
+                dl.tri_text[c] = this->vert_data(vid).uvw[0];
             }
-            else if (drawlist_in.draw_mode & DRAW_TRI_QUALITY)
+            else
             {
-                float q = this->poly_data(pid_beneath).quality;
-                Color c = Color::red_white_blue_ramp_01(q);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.a);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.a);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.a);
+                dl.tri_text[2*c+0] = this->vert_data(vid).uvw[0]*s;
+                dl.tri_text[2*c+1] = this->vert_data(vid).uvw[1]*s;
             }
         }
+
+        if (colors)
+        {
+            Color col;
+            if      (dl.draw_mode & DRAW_TRI_FACECOLOR) col = this->poly_data(pid).color; // replicate poly color on each vertex
+            else if (dl.draw_mode & DRAW_TRI_VERTCOLOR) col = this->vert_data(vid).color;
+            else                                        col = Color::red_white_blue_ramp_01(this->poly_data(pid).quality);
+
+            dl.tri_v_colors[4*c+0] = col.r*AO;
+            dl.tri_v_colors[4*c+1] = col.g*AO;
+            dl.tri_v_colors[4*c+2] = col.b*AO;
+            dl.tri_v_colors[4*c+3] = col.a;
+        }
     }
+}
 
-    for(uint eid : edges_to_render)
-    {
-        uint base_addr = drawlist_in.seg_coords.size()/3;
-        drawlist_in.segs.push_back(base_addr    );
-        drawlist_in.segs.push_back(base_addr + 1);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_edge(const uint eid, const int attributes)
+{
+    bool                      srf   = this->edge_is_on_srf(eid);
+    RenderData              & dl    = (srf) ? drawlist_out : drawlist_in;
+    const std::vector<uint> & range = (srf) ? edge_seg_offset_out : edge_seg_offset_in;
 
+    uint s = range.at(eid);
+    if (s == range.at(eid+1)) return; // hidden edge
+
+    if (attributes & UPDATE_GL_COORDS)
+    {
         vec3d vid0 = this->edge_vert(eid,0);
         vec3d vid1 = this->edge_vert(eid,1);
+        dl.seg_coords[6*s+0] = vid0.x();
+        dl.seg_coords[6*s+1] = vid0.y();
+        dl.seg_coords[6*s+2] = vid0.z();
+        dl.seg_coords[6*s+3] = vid1.x();
+        dl.seg_coords[6*s+4] = vid1.y();
+        dl.seg_coords[6*s+5] = vid1.z();
+    }
 
-        drawlist_in.seg_coords.push_back(vid0.x());
-        drawlist_in.seg_coords.push_back(vid0.y());
-        drawlist_in.seg_coords.push_back(vid0.z());
-        drawlist_in.seg_coords.push_back(vid1.x());
-        drawlist_in.seg_coords.push_back(vid1.y());
-        drawlist_in.seg_coords.push_back(vid1.z());
-
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.r);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.g);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.b);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.a);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.r);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.g);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.b);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.a);
-
-//        if (this->edge_data(eid).flags[MARKED] && drawlist_in.draw_mode & DRAW_MARKED_SEGS)
-//        {
-//            int base_addr = drawlist_in.flags[MARKED]_seg_coords.size()/3;
-//            drawlist_in.flags[MARKED]_segs.push_back(base_addr    );
-//            drawlist_in.flags[MARKED]_segs.push_back(base_addr + 1);
-
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.x());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.y());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.z());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.x());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.y());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.z());
-//        }
+    if (attributes & UPDATE_GL_COLORS)
+    {
+        const Color & c = this->edge_data(eid).color;
+        for(uint i=0; i<2; ++i)
+        {
+            dl.seg_colors[8*s+4*i+0] = c.r;
+            dl.seg_colors[8*s+4*i+1] = c.g;
+            dl.seg_colors[8*s+4*i+2] = c.b;
+            dl.seg_colors[8*s+4*i+3] = c.a;
+        }
     }
 }
 
@@ -622,48 +513,285 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::slice(const SlicerState & s)
+void AbstractDrawablePolyhedralMesh<Mesh>::vert_set_dirty(const uint vid, const int attributes)
 {
-    slicer.update(*this, s); // update per element visibility flags
-    updateGL();
+    // moving a vertex changes the normals of its incident faces too
+    int f_attr = (attributes & UPDATE_GL_COORDS) ? (attributes | UPDATE_GL_NORMALS) : attributes;
+    for(uint fid : this->adj_v2f(vid)) face_set_dirty(fid, f_attr);
+
+    if (attributes & UPDATE_GL_COORDS)
+    {
+        for(uint eid : this->adj_v2e(vid)) edge_set_dirty(eid, UPDATE_GL_COORDS);
+        slicer.vert_set_dirty(*this, vid);
+        Mesh::pick_index_set_dirty(); // the slicer cache is updated incrementally
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::slicer_reset()   // either AND or OR
+void AbstractDrawablePolyhedralMesh<Mesh>::pick_index_set_dirty()
 {
-    slicer.reset(*this);
-    updateGL();
+    Mesh::pick_index_set_dirty();
+    slicer.set_dirty();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::show_mesh(const bool b)
+void AbstractDrawablePolyhedralMesh<Mesh>::edge_set_dirty(const uint eid, const int attributes)
 {
-    if (b)
+    if (edge_dirty.size() < this->num_edges()) edge_dirty.resize(this->num_edges(), 0);
+    if (edge_dirty.at(eid) == 0) dirty_edges.push_back(eid);
+    edge_dirty.at(eid) |= attributes;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::face_set_dirty(const uint fid, const int attributes)
+{
+    if (face_dirty.size() < this->num_faces()) face_dirty.resize(this->num_faces(), 0);
+
+    auto mark = [&](const uint id, const int attr)
+    {
+        if (face_dirty.at(id) == 0) dirty_faces.push_back(id);
+        face_dirty.at(id) |= attr;
+    };
+
+    mark(fid, attributes);
+
+    // smooth normals and AO are averaged among the visible faces incident to each vertex (with a
+    // threshold on the normal deviation), therefore a new normal for fid affects its whole vertex ring
+    if (attributes & UPDATE_GL_NORMALS)
     {
-        drawlist_in.draw_mode  |= DRAW_TRIS;
-        drawlist_out.draw_mode |= DRAW_TRIS;
+        for(uint vid : this->adj_f2v(fid))
+        for(uint nbr : this->adj_v2f(vid))
+        {
+            if (nbr != fid) mark(nbr, UPDATE_GL_NORMALS | UPDATE_GL_COLORS);
+        }
     }
-    else
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::poly_set_dirty(const uint pid, const int attributes)
+{
+    for(uint fid : this->adj_p2f(pid)) face_set_dirty(fid, attributes);
+
+    // geometry, quality or label may have changed
+    if (attributes & (UPDATE_GL_COORDS | UPDATE_GL_COLORS)) slicer.poly_set_dirty(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_dirty()
+{
+    CINO_PROFILE_SCOPE("AbstractDrawablePolyhedralMesh::updateGL_dirty");
+    if (layout_changed())
     {
-        drawlist_in.draw_mode  &= ~DRAW_TRIS;
-        drawlist_out.draw_mode &= ~DRAW_TRIS;
+        updateGL();
+        return;
     }
+
+    drawlist_in.material  = material_;
+    drawlist_out.material = material_;
+
+    if (flush_dirty()) updateGL_marked();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// patches the buffer ranges of dirty elements and clears their flags. Returns
+// true if some element moved (i.e. the marked elements must be updated too)
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::show_AO_alpha(const float alpha)
+bool AbstractDrawablePolyhedralMesh<Mesh>::flush_dirty()
 {
-    AO_alpha = alpha;
-    updateGL();
+    PARALLEL_FOR(0, dirty_faces.size(), 100, [&](uint i)
+    {
+        uint fid = dirty_faces.at(i);
+        updateGL_face(fid, face_dirty.at(fid));
+    });
+
+    PARALLEL_FOR(0, dirty_edges.size(), 100, [&](uint i)
+    {
+        uint eid = dirty_edges.at(i);
+        updateGL_edge(eid, edge_dirty.at(eid));
+    });
+
+    bool moved = false;
+    for(uint eid : dirty_edges)
+    {
+        if (edge_dirty.at(eid) & UPDATE_GL_COORDS) moved = true;
+        edge_dirty.at(eid) = 0;
+        buffer_set_dirty_segs(drawlist_in,  edge_seg_offset_in.at(eid),  edge_seg_offset_in.at(eid+1));
+        buffer_set_dirty_segs(drawlist_out, edge_seg_offset_out.at(eid), edge_seg_offset_out.at(eid+1));
+    }
+    for(uint fid : dirty_faces)
+    {
+        if (face_dirty.at(fid) & UPDATE_GL_COORDS) moved = true;
+        face_dirty.at(fid) = 0;
+        buffer_set_dirty_tris(drawlist_in,  face_tri_offset_in.at(fid),  face_tri_offset_in.at(fid+1));
+        buffer_set_dirty_tris(drawlist_out, face_tri_offset_out.at(fid), face_tri_offset_out.at(fid+1));
+    }
+    dirty_faces.clear();
+    dirty_edges.clear();
+
+    return moved;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_visibility(const std::vector<uint> & pids)
+{
+    if (pids.empty()) return;
+
+    // if the layout is not valid or too many polys changed, a (parallel) full update is cheaper
+    if (layout_changed() || pids.size() > this->num_polys()/4)
+    {
+        updateGL_mesh();
+        return;
+    }
+
+    drawlist_in.material  = material_;
+    drawlist_out.material = material_;
+
+    // only faces and edges of the toggled polys may change their visibility
+    std::vector<uint> fids, eids;
+    for(uint pid : pids)
+    {
+        fids.insert(fids.end(), this->adj_p2f(pid).begin(), this->adj_p2f(pid).end());
+        eids.insert(eids.end(), this->adj_p2e(pid).begin(), this->adj_p2e(pid).end());
+    }
+    REMOVE_DUPLICATES_FROM_VEC(fids);
+    REMOVE_DUPLICATES_FROM_VEC(eids);
+
+    // faces that appear, disappear or change the poly beneath are regenerated, along
+    // with their vertex ring (smooth normals and AO depend on the visible neighbors)
+    bool relayout = false;
+    for(uint fid : fids)
+    {
+        uint pid_beneath;
+        int  beneath = (this->face_is_visible(fid, pid_beneath)) ? static_cast<int>(pid_beneath) : -1;
+        if (beneath == face_beneath.at(fid)) continue;
+        if ((beneath<0) != (face_beneath.at(fid)<0)) relayout = true;
+        face_beneath.at(fid) = beneath;
+        face_set_dirty(fid, UPDATE_GL_ALL);
+    }
+    for(uint eid : eids)
+    {
+        char visible = edge_is_rendered(eid) ? 1 : 0;
+        if (visible == edge_visible.at(eid)) continue;
+        relayout = true;
+        edge_visible.at(eid) = visible;
+        edge_set_dirty(eid, UPDATE_GL_ALL);
+    }
+
+    // the set of rendered elements did not change: patch buffers in place
+    if (!relayout)
+    {
+        flush_dirty();
+        return;
+    }
+
+    // otherwise compute the new ranges and move the rendering data of clean elements
+    // from the old ranges to the new ones. Dirty elements are regenerated from scratch
+    std::vector<uint> old_f_in, old_f_out, old_e_in, old_e_out;
+    std::swap(old_f_in,  face_tri_offset_in);
+    std::swap(old_f_out, face_tri_offset_out);
+    std::swap(old_e_in,  edge_seg_offset_in);
+    std::swap(old_e_out, edge_seg_offset_out);
+
+    std::vector<float> old_tri_coords[2], old_tri_v_norms[2], old_tri_v_colors[2], old_tri_text[2];
+    std::vector<float> old_seg_coords[2], old_seg_colors[2];
+    RenderData * dl[2] = { &drawlist_in, &drawlist_out };
+    for(uint i=0; i<2; ++i)
+    {
+        std::swap(old_tri_coords  [i], dl[i]->tri_coords  );
+        std::swap(old_tri_v_norms [i], dl[i]->tri_v_norms );
+        std::swap(old_tri_v_colors[i], dl[i]->tri_v_colors);
+        std::swap(old_tri_text    [i], dl[i]->tri_text    );
+        std::swap(old_seg_coords  [i], dl[i]->seg_coords  );
+        std::swap(old_seg_colors  [i], dl[i]->seg_colors  );
+    }
+
+    update_offsets();
+
+    auto move = [](const std::vector<float> & src, std::vector<float> & dst, const uint src_beg, const uint dst_beg, const uint n)
+    {
+        if (!dst.empty()) std::copy(src.begin()+src_beg, src.begin()+src_beg+n, dst.begin()+dst_beg);
+    };
+
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
+    {
+        if (face_beneath[fid] < 0) return;
+        if (face_dirty[fid] != 0)
+        {
+            updateGL_face(fid, UPDATE_GL_ALL);
+            return;
+        }
+        bool srf = this->face_is_on_srf(fid);
+        uint i   = (srf) ? 1 : 0;
+        uint src = (srf) ? old_f_out[fid] : old_f_in[fid];
+        uint dst = (srf) ? face_tri_offset_out[fid] : face_tri_offset_in[fid];
+        uint n   = ((srf) ? face_tri_offset_out[fid+1] : face_tri_offset_in[fid+1]) - dst;
+        uint t   = (dl[i]->draw_mode & DRAW_TRI_TEXTURE2D) ? 6 : 3;
+        move(old_tri_coords  [i], dl[i]->tri_coords,    9*src,  9*dst,  9*n);
+        move(old_tri_v_norms [i], dl[i]->tri_v_norms,   9*src,  9*dst,  9*n);
+        move(old_tri_v_colors[i], dl[i]->tri_v_colors, 12*src, 12*dst, 12*n);
+        move(old_tri_text    [i], dl[i]->tri_text,      t*src,  t*dst,  t*n);
+    });
+
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+    {
+        if (!edge_visible[eid]) return;
+        if (edge_dirty[eid] != 0)
+        {
+            updateGL_edge(eid, UPDATE_GL_ALL);
+            return;
+        }
+        bool srf = this->edge_is_on_srf(eid);
+        uint i   = (srf) ? 1 : 0;
+        uint src = (srf) ? old_e_out[eid] : old_e_in[eid];
+        uint dst = (srf) ? edge_seg_offset_out[eid] : edge_seg_offset_in[eid];
+        move(old_seg_coords[i], dl[i]->seg_coords, 6*src, 6*dst, 6);
+        move(old_seg_colors[i], dl[i]->seg_colors, 8*src, 8*dst, 8);
+    });
+
+    for(uint fid : dirty_faces) face_dirty.at(fid) = 0;
+    for(uint eid : dirty_edges) edge_dirty.at(eid) = 0;
+    dirty_faces.clear();
+    dirty_edges.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::slice(const SlicerState & s)
+{
+    // update per element visibility flags. The render lists are retained across
+    // slicer states: only cells that changed visibility are processed
+    updateGL_visibility(slicer.update(*this, s));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::slicer_reset()   // either AND or OR
+{
+    updateGL_visibility(slicer.reset(*this));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -728,7 +856,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_vert_color()
     drawlist_out.draw_mode &= ~DRAW_TRI_QUALITY;
     drawlist_out.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist_out.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL_out();
+    updateGL_out(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -742,7 +870,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_vert_color()
     drawlist_in.draw_mode &= ~DRAW_TRI_QUALITY;
     drawlist_in.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist_in.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL_in();
+    updateGL_in(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -765,7 +893,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_poly_color()
     drawlist_out.draw_mode &= ~DRAW_TRI_QUALITY;
     drawlist_out.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist_out.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL_out();
+    updateGL_out(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -779,7 +907,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_poly_quality()
     drawlist_out.draw_mode &= ~DRAW_TRI_VERTCOLOR;
     drawlist_out.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist_out.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL_out();
+    updateGL_out(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -804,7 +932,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_texture1D(const int tex_type
         case TEXTURE_1D_PARULA_W_ISOLINES : texture_parula_with_isolines(drawlist_out.texture); break;
         default: assert("Unknown Texture!" && false);
     }
-    updateGL_out();
+    updateGL_out(UPDATE_GL_TEXTURES);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -828,7 +956,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_texture2D(const int tex_type
         case TEXTURE_2D_BITMAP:        texture_bitmap(drawlist_out.texture, bitmap); break;
         default: assert("Unknown Texture!" && false);
     }
-    updateGL_out();
+    updateGL_out(UPDATE_GL_TEXTURES);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -851,7 +979,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_wireframe_color(const Color
     {
         if (this->edge_is_on_srf(eid)) this->edge_data(eid).color = c;
     }
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -873,7 +1001,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_out_wireframe_transparency(const
     {
         if (this->edge_is_on_srf(eid)) this->edge_data(eid).color.a = alpha;
     }
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -896,7 +1024,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_poly_color()
     drawlist_in.draw_mode &= ~DRAW_TRI_QUALITY;
     drawlist_in.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist_in.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL_in();
+    updateGL_in(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -910,7 +1038,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_poly_quality()
     drawlist_in.draw_mode &= ~DRAW_TRI_VERTCOLOR;
     drawlist_in.draw_mode &= ~DRAW_TRI_TEXTURE1D;
     drawlist_in.draw_mode &= ~DRAW_TRI_TEXTURE2D;
-    updateGL_in();
+    updateGL_in(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -935,7 +1063,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_texture1D(const int tex_type)
         case TEXTURE_1D_PARULA_W_ISOLINES : texture_parula_with_isolines(drawlist_in.texture); break;
         default: assert("Unknown Texture!" && false);
     }
-    updateGL_in();
+    updateGL_in(UPDATE_GL_TEXTURES);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -959,7 +1087,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_texture2D(const int tex_type,
         case TEXTURE_2D_BITMAP:        texture_bitmap(drawlist_in.texture, bitmap); break;
         default: assert("Unknown Texture!" && false);
     }
-    updateGL_in();
+    updateGL_in(UPDATE_GL_TEXTURES);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -982,7 +1110,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_wireframe_color(const Color &
     {
         if (!this->edge_is_on_srf(eid)) this->edge_data(eid).color = c;
     }
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1004,7 +1132,7 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_in_wireframe_transparency(const
     {
         if (!this->edge_is_on_srf(eid)) this->edge_data(eid).color.a = alpha;
     }
-    updateGL();
+    updateGL_mesh(UPDATE_GL_COLORS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1076,4 +1204,50 @@ void AbstractDrawablePolyhedralMesh<Mesh>::show_marked_face_transparency(const f
     updateGL_marked();
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+MemoryFootprint AbstractDrawablePolyhedralMesh<Mesh>::memory_footprint() const
+{
+    MemoryFootprint mf = Mesh::memory_footprint();
+    mf.add("drawlist_in",         buffer_memory_footprint(drawlist_in));
+    mf.add("drawlist_out",        buffer_memory_footprint(drawlist_out));
+    mf.add("drawlist_marked",     buffer_memory_footprint(drawlist_marked));
+    mf.add("slicer",              slicer.memory_footprint());
+    mf.add("face_tri_offset_in",  face_tri_offset_in);
+    mf.add("face_tri_offset_out", face_tri_offset_out);
+    mf.add("edge_seg_offset_in",  edge_seg_offset_in);
+    mf.add("edge_seg_offset_out", edge_seg_offset_out);
+    mf.add("face_beneath",        face_beneath);
+    mf.add("edge_visible",        edge_visible);
+    mf.add("face_dirty",          face_dirty);
+    mf.add("edge_dirty",          edge_dirty);
+    mf.add("dirty_faces",         dirty_faces);
+    mf.add("dirty_edges",         dirty_edges);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::shrink_to_fit()
+{
+    Mesh::shrink_to_fit();
+    buffer_shrink_to_fit(drawlist_in);
+    buffer_shrink_to_fit(drawlist_out);
+    buffer_shrink_to_fit(drawlist_marked);
+    face_tri_offset_in.shrink_to_fit();
+    face_tri_offset_out.shrink_to_fit();
+    edge_seg_offset_in.shrink_to_fit();
+    edge_seg_offset_out.shrink_to_fit();
+    face_beneath.shrink_to_fit();
+    edge_visible.shrink_to_fit();
+    face_dirty.shrink_to_fit();
+    edge_dirty.shrink_to_fit();
+    dirty_faces.shrink_to_fit();
+    dirty_edges.shrink_to_fit();
+}
+
 }
@@ -59,6 +59,27 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
         Color            marked_face_color;
         float            AO_alpha;
 
+        // element-to-buffer-range maps: the triangles of face fid occupy the range
+        // [face_tri_offset_in[fid], face_tri_offset_in[fid+1]) of drawlist_in (and
+        // analogously for drawlist_out and for the segments of each edge). Elements
+        // that do not belong to a list have empty ranges in it. The maps are
+        // recomputed at each full update, partial updates reuse them as long as
+        // the buffer layout does not change
+        std::vector<uint> face_tri_offset_in;
+        std::vector<uint> face_tri_offset_out;
+        std::vector<uint> edge_seg_offset_in;
+        std::vector<uint> edge_seg_offset_out;
+        std::vector<int>  face_beneath; // visible poly beneath each face (-1 for invisible faces)
+        std::vector<char> edge_visible; // 1 if the edge is rendered, 0 otherwise
+        int               layout_mode_in  = 0;
+        int               layout_mode_out = 0;
+
+        // per element dirty attributes (UPDATE_GL_COORDS, UPDATE_GL_NORMALS, ...)
+        std::vector<int>  face_dirty;
+        std::vector<int>  edge_dirty;
+        std::vector<uint> dirty_faces;
+        std::vector<uint> dirty_edges;
+
     public:
 
         void       draw(const float scene_size=1) const;
@@ -68,14 +89,14 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void vert_set_color(const Color & c) { Mesh::vert_set_color(c); updateGL(); }
-        void edge_set_color(const Color & c) { Mesh::edge_set_color(c); updateGL(); }
-        void face_set_color(const Color & c) { Mesh::face_set_color(c); updateGL(); }
-        void poly_set_color(const Color & c) { Mesh::poly_set_color(c); updateGL(); }
-        void vert_set_alpha(const float   a) { Mesh::vert_set_alpha(a); updateGL(); }
-        void edge_set_alpha(const float   a) { Mesh::edge_set_alpha(a); updateGL(); }
-        void face_set_alpha(const float   a) { Mesh::face_set_alpha(a); updateGL(); }
-        void poly_set_alpha(const float   a) { Mesh::poly_set_alpha(a); updateGL(); }
+        void vert_set_color(const Color & c) { Mesh::vert_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void edge_set_color(const Color & c) { Mesh::edge_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void face_set_color(const Color & c) { Mesh::face_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void poly_set_color(const Color & c) { Mesh::poly_set_color(c); updateGL_mesh(UPDATE_GL_COLORS); }
+        void vert_set_alpha(const float   a) { Mesh::vert_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
+        void edge_set_alpha(const float   a) { Mesh::edge_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
+        void face_set_alpha(const float   a) { Mesh::face_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
+        void poly_set_alpha(const float   a) { Mesh::poly_set_alpha(a); updateGL_mesh(UPDATE_GL_COLORS); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -83,10 +104,35 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void updateGL();         // regenerates rendering data for mesh inside/outside and marked elements
-        void updateGL_in();      // regenerates rendering data for mesh inside
-        void updateGL_out();     // regenerates rendering data for mesh outside
-        void updateGL_marked();  // regenerates rendering data for mesh marked elements
+        MemoryFootprint memory_footprint() const override; // mesh + rendering data
+        void            shrink_to_fit() override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void updateGL();                                          // regenerates rendering data for mesh inside/outside and marked elements
+        void updateGL_mesh(const int attributes = UPDATE_GL_ALL); // regenerates rendering data for mesh inside/outside (only the selected attributes)
+        void updateGL_in  (const int attributes = UPDATE_GL_ALL); // regenerates rendering data for mesh inside (only the selected attributes)
+        void updateGL_out (const int attributes = UPDATE_GL_ALL); // regenerates rendering data for mesh outside (only the selected attributes)
+        void updateGL_marked();                                   // regenerates rendering data for mesh marked elements
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // incremental updates: mark the elements that changed since the last
+        // update, then call updateGL_dirty() to patch only their buffer ranges.
+        // Changes in visibility or connectivity require a full updateGL()
+        void vert_set_dirty(const uint vid, const int attributes = UPDATE_GL_ALL);
+        void edge_set_dirty(const uint eid, const int attributes = UPDATE_GL_ALL);
+        void face_set_dirty(const uint fid, const int attributes = UPDATE_GL_ALL);
+        void poly_set_dirty(const uint pid, const int attributes = UPDATE_GL_ALL);
+        void updateGL_dirty();
+
+        // incremental update after toggling the HIDDEN flag of the polys in pids.
+        // Only faces and edges around them are regenerated, the rendering data of
+        // all the other elements is moved to its new position in the buffers
+        void updateGL_visibility(const std::vector<uint> & pids);
+
+        // also invalidates the geometry cached by the slicer
+        void pick_index_set_dirty() override;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -136,6 +182,18 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
         void show_marked_face(const bool b);
         void show_marked_face_color(const Color & c);
         void show_marked_face_transparency(const float alpha);
+
+    protected:
+
+        void update_layout();
+        void update_visibility();
+        void update_offsets();
+        bool layout_changed() const;
+        bool edge_is_rendered(const uint eid) const;
+        bool flush_dirty();
+        void updateGL_lists(const int attributes, bool in, bool out);
+        void updateGL_face(const uint fid, const int attributes);
+        void updateGL_edge(const uint eid, const int attributes);
 };
 
 }
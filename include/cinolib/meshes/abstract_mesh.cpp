@@ -37,6 +37,8 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/geometry/polygon_utils.h>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -94,6 +96,53 @@ void AbstractMesh<M,V,E,P>::clear()
     e2p.clear();
     p2e.clear();
     p2p.clear();
+    //
+    pick_index_set_dirty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+MemoryFootprint AbstractMesh<M,V,E,P>::memory_footprint() const
+{
+    MemoryFootprint mf;
+    mf.add("verts",  verts);
+    mf.add("edges",  edges);
+    mf.add("polys",  polys);
+    mf.add("v_data", v_data);
+    mf.add("e_data", e_data);
+    mf.add("p_data", p_data);
+    mf.add("v2v",    v2v);
+    mf.add("v2e",    v2e);
+    mf.add("v2p",    v2p);
+    mf.add("e2p",    e2p);
+    mf.add("p2e",    p2e);
+    mf.add("p2p",    p2p);
+    mf.add("vert_index", vert_index.memory_footprint());
+    mf.add("edge_index", edge_index.memory_footprint());
+    mf.add("poly_index", poly_index.memory_footprint());
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::shrink_to_fit()
+{
+    cinolib::shrink_to_fit(verts);
+    cinolib::shrink_to_fit(edges);
+    cinolib::shrink_to_fit(polys);
+    cinolib::shrink_to_fit(v_data);
+    cinolib::shrink_to_fit(e_data);
+    cinolib::shrink_to_fit(p_data);
+    cinolib::shrink_to_fit(v2v);
+    cinolib::shrink_to_fit(v2e);
+    cinolib::shrink_to_fit(v2p);
+    cinolib::shrink_to_fit(e2p);
+    cinolib::shrink_to_fit(p2e);
+    cinolib::shrink_to_fit(p2p);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -117,6 +166,7 @@ void AbstractMesh<M,V,E,P>::translate(const vec3d & delta)
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) += delta;
     bb.min += delta;
     bb.max += delta;
+    pick_index_set_dirty();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -136,6 +186,7 @@ void AbstractMesh<M,V,E,P>::rotate(const vec3d & axis, const double angle)
         transform(vert(vid), R);
         vert(vid) += c;
     }
+    pick_index_set_dirty();
     //
     if(m_data.update_bbox)    update_bbox();
     if(m_data.update_normals) update_normals();
@@ -162,6 +213,7 @@ void AbstractMesh<M,V,E,P>::normalize_bbox()
 {
     double s = 1.0/bbox().diag();
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) *= s;
+    pick_index_set_dirty();
     if(m_data.update_bbox) update_bbox();
 }
 
@@ -172,6 +224,7 @@ CINO_INLINE
 void AbstractMesh<M,V,E,P>::update_bbox()
 {
     bb.push(this->verts);
+    pick_index_set_dirty();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -411,6 +464,7 @@ void AbstractMesh<M,V,E,P>::copy_uvw_to_xyz(const int mode)
             default: assert(false);
         }
     }
+    pick_index_set_dirty();
     if(m_data.update_bbox) update_bbox();
 }
 
@@ -424,6 +478,7 @@ void AbstractMesh<M,V,E,P>::swap_xyz_uvw(const bool normals, const bool bbox)
     {
         std::swap(vert(vid),vert_data(vid).uvw);
     }
+    pick_index_set_dirty();
     if(normals) update_normals();
     if(bbox)    update_bbox();
 }
@@ -1220,6 +1275,15 @@ AABB AbstractMesh<M,V,E,P>::poly_aabb(const uint pid) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::poly_is_visible(const uint pid) const
+{
+    return !poly_data(pid).flags[HIDDEN];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractMesh<M,V,E,P>::edge_apply_labels(const std::vector<int> & labels)
@@ -1286,14 +1350,90 @@ void AbstractMesh<M,V,E,P>::edge_mark_sharp_creases(const float thresh)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::pick_index_set_dirty()
+{
+    vert_index.clear();
+    edge_index.clear();
+    poly_index.clear();
+    pick_index_stale = PICK_INDEX_ALL;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const KdTree & AbstractMesh<M,V,E,P>::pick_index_verts() const
+{
+    std::lock_guard<std::mutex> lock(pick_index_mutex.m);
+    if((pick_index_stale & PICK_INDEX_VERTS) || vert_index.size()!=num_verts())
+    {
+        vert_index.build(verts);
+        pick_index_stale &= ~PICK_INDEX_VERTS;
+    }
+    return vert_index;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const KdTree & AbstractMesh<M,V,E,P>::pick_index_edges() const
+{
+    std::lock_guard<std::mutex> lock(pick_index_mutex.m);
+    if((pick_index_stale & PICK_INDEX_EDGES) || edge_index.size()!=num_edges())
+    {
+        std::vector<vec3d> midpoints(num_edges());
+        PARALLEL_FOR(0, num_edges(), 10000, [&](uint eid)
+        {
+            midpoints.at(eid) = (edge_vert(eid,0) + edge_vert(eid,1))*0.5;
+        });
+        edge_index.build(midpoints);
+        pick_index_stale &= ~PICK_INDEX_EDGES;
+    }
+    return edge_index;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const KdTree & AbstractMesh<M,V,E,P>::pick_index_polys() const
+{
+    std::lock_guard<std::mutex> lock(pick_index_mutex.m);
+    if((pick_index_stale & PICK_INDEX_POLYS) || poly_index.size()!=num_polys())
+    {
+        // poly boxes are needed for ray picking on surfaces only
+        std::vector<vec3d> centroids(num_polys());
+        std::vector<AABB>  boxes(mesh_is_surface() ? num_polys() : 0);
+        PARALLEL_FOR(0, num_polys(), 10000, [&](uint pid)
+        {
+            centroids.at(pid) = poly_centroid(pid);
+            if(!boxes.empty()) boxes.at(pid) = poly_aabb(pid);
+        });
+        poly_index.build(centroids, boxes);
+        pick_index_stale &= ~PICK_INDEX_POLYS;
+    }
+    return poly_index;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_vert(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint vid=0; vid<this->num_verts(); ++vid) closest.push_back(std::make_pair(this->vert(vid).dist(p),vid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    uint   vid;
+    double dist;
+    if(!pick_index_verts().closest_point(p, vid, dist, [this](const uint vid)
+    {
+        return vert_data(vid).flags[HIDDEN] || !vert_is_visible(vid);
+    }))
+    {
+        pick_index_verts().closest_point(p, vid, dist);
+    }
+    return vid;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1302,10 +1442,16 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_edge(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint eid=0; eid<this->num_edges(); ++eid) closest.push_back(std::make_pair(this->edge_sample_at(eid, 0.5).dist(p),eid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    uint   eid;
+    double dist;
+    if(!pick_index_edges().closest_point(p, eid, dist, [this](const uint eid)
+    {
+        return edge_data(eid).flags[HIDDEN] || !edge_is_visible(eid);
+    }))
+    {
+        pick_index_edges().closest_point(p, eid, dist);
+    }
+    return eid;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1314,13 +1460,141 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_poly(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    uint   pid;
+    double dist;
+    if(!pick_index_polys().closest_point(p, pid, dist, [this](const uint pid)
+    {
+        return !poly_is_visible(pid);
+    }))
     {
-        if(!this->poly_data(pid).flags[HIDDEN]) closest.push_back(std::make_pair(this->poly_centroid(pid).dist(p),pid));
+        pick_index_polys().closest_point(p, pid, dist);
     }
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    return pid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_verts(const AABB & box) const
+{
+    std::vector<uint> res;
+    pick_index_verts().points_in_box(box, res, [this](const uint vid)
+    {
+        return vert_data(vid).flags[HIDDEN] || !vert_is_visible(vid);
+    });
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_edges(const AABB & box) const
+{
+    std::vector<uint> res;
+    pick_index_edges().points_in_box(box, res, [this](const uint eid)
+    {
+        return edge_data(eid).flags[HIDDEN] || !edge_is_visible(eid);
+    });
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_polys(const AABB & box) const
+{
+    std::vector<uint> res;
+    pick_index_polys().points_in_box(box, res, [this](const uint pid)
+    {
+        return !poly_is_visible(pid);
+    });
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_verts(const std::vector<vec2d>                  & lasso,
+                                                    const std::function<vec2d(const vec3d &)> & project) const
+{
+    return pick_in_lasso(pick_index_verts(), lasso, project, [this](const uint vid)
+    {
+        return vert_data(vid).flags[HIDDEN] || !vert_is_visible(vid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_edges(const std::vector<vec2d>                  & lasso,
+                                                    const std::function<vec2d(const vec3d &)> & project) const
+{
+    return pick_in_lasso(pick_index_edges(), lasso, project, [this](const uint eid)
+    {
+        return edge_data(eid).flags[HIDDEN] || !edge_is_visible(eid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_polys(const std::vector<vec2d>                  & lasso,
+                                                    const std::function<vec2d(const vec3d &)> & project) const
+{
+    return pick_in_lasso(pick_index_polys(), lasso, project, [this](const uint pid)
+    {
+        return !poly_is_visible(pid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<uint> AbstractMesh<M,V,E,P>::pick_in_lasso(const KdTree                              & index,
+                                                       const std::vector<vec2d>                  & lasso,
+                                                       const std::function<vec2d(const vec3d &)> & project,
+                                                       const KdTree::Skip                        & skip) const
+{
+    std::vector<uint> res;
+    if(lasso.size()<3) return res;
+
+    vec2d lasso_min = lasso.front();
+    vec2d lasso_max = lasso.front();
+    for(const vec2d & p : lasso)
+    {
+        lasso_min = lasso_min.min(p);
+        lasso_max = lasso_max.max(p);
+    }
+
+    // a box may intersect the lasso only if the bounding rectangle of its projected corners
+    // overlaps the bounding rectangle of the lasso (for perspective projections too, as long
+    // as the box is in front of the camera)
+    auto may_intersect = [&](const AABB & box)
+    {
+        vec2d box_min( inf_double,  inf_double);
+        vec2d box_max(-inf_double, -inf_double);
+        for(const vec3d & c : box.corners())
+        {
+            vec2d q = project(c);
+            box_min = box_min.min(q);
+            box_max = box_max.max(q);
+        }
+        return box_min.x() <= lasso_max.x() && box_max.x() >= lasso_min.x() &&
+               box_min.y() <= lasso_max.y() && box_max.y() >= lasso_min.y();
+    };
+    auto contains = [&](const vec3d & p)
+    {
+        return polygon_contains(lasso, project(p));
+    };
+    index.points_in_region(may_intersect, contains, res, skip);
+    return res;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1349,6 +1623,32 @@ void AbstractMesh<M,V,E,P>::vert_set_flag(const int flag, const bool b, const st
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::vert_is_visible(const uint vid) const
+{
+    for(uint pid : this->adj_v2p(vid))
+    {
+        if(poly_is_visible(pid)) return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::edge_is_visible(const uint eid) const
+{
+    for(uint pid : this->adj_e2p(eid))
+    {
+        if(poly_is_visible(pid)) return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractMesh<M,V,E,P>::edge_set_flag(const int flag, const bool b)
@@ -38,13 +38,18 @@
 
 #include <set>
 #include <vector>
+#include <functional>
+#include <mutex>
 #include <sys/types.h>
 
 #include <cinolib/geometry/aabb.h>
+#include <cinolib/geometry/vec2.h>
 #include <cinolib/geometry/vec3.h>
+#include <cinolib/kd_tree.h>
 #include <cinolib/color.h>
 #include <cinolib/symbols.h>
 #include <cinolib/ipair.h>
+#include <cinolib/memory_footprint.h>
 
 typedef enum
 {
@@ -87,6 +92,34 @@ class AbstractMesh
         std::vector<std::vector<uint>> p2e; // poly to edge adjacency
         std::vector<std::vector<uint>> p2p; // poly to poly adjacency
 
+        // spatial indices for picking (vert positions, edge midpoints and poly centroids),
+        // built at the first query and released by pick_index_set_dirty. Element insertions
+        // and id switches only set the bits of pick_index_stale (a plain write), and stale
+        // indices are rebuilt at the next query. Lazy builds are guarded by pick_index_mutex,
+        // hence a const mesh can be picked from multiple threads concurrently
+        enum { PICK_INDEX_VERTS = 1, PICK_INDEX_EDGES = 2, PICK_INDEX_POLYS = 4, PICK_INDEX_FACES = 8, PICK_INDEX_ALL = 15 };
+        struct PickIndexMutex // copying a mesh does not copy its lock
+        {
+            std::mutex m;
+            PickIndexMutex() {}
+            PickIndexMutex(const PickIndexMutex &) {}
+            PickIndexMutex & operator=(const PickIndexMutex &) { return *this; }
+        };
+        mutable KdTree         vert_index;
+        mutable KdTree         edge_index;
+        mutable KdTree         poly_index;
+        mutable uint           pick_index_stale = PICK_INDEX_ALL;
+        mutable PickIndexMutex pick_index_mutex;
+
+        const KdTree & pick_index_verts() const;
+        const KdTree & pick_index_edges() const;
+        const KdTree & pick_index_polys() const;
+
+        std::vector<uint> pick_in_lasso(const KdTree                              & index,
+                                        const std::vector<vec2d>                  & lasso,
+                                        const std::function<vec2d(const vec3d &)> & project,
+                                        const KdTree::Skip                        & skip) const;
+
     public:
 
         typedef M M_type;
@@ -108,6 +141,13 @@ class AbstractMesh
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         virtual void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // memory used by each internal structure (coordinates, adjacency, attributes...)
+        // and release of the memory reserved but not used (e.g. after init or editing)
+        virtual MemoryFootprint memory_footprint() const;
+        virtual void            shrink_to_fit();
         virtual void load(const char * filename) = 0;
         virtual void save(const char * filename) const = 0;
 
@@ -204,10 +244,25 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
-        uint pick_vert(const vec3d & p) const;
-        uint pick_edge(const vec3d & p) const;
-        uint pick_poly(const vec3d & p) const;
+        // useful for GUIs with mouse picking. Queries are answered in logarithmic time by
+        // kd-trees built at the first query, and rebuilt after any change in the number of
+        // elements, topological edit or global transformation (translate, rotate, scale...).
+        // After moving vertices by other means (e.g. vert(vid) = p) call pick_index_set_dirty.
+        // Invisible elements (see *_is_visible) are never picked, unless all of them are.
+        // Picking does not modify the mesh, and can run concurrently from multiple threads
+        // (but not concurrently with any edit).
+        // Lasso selections take the lasso in screen coordinates, and a function that projects
+        // points on the screen (e.g. GLcanvas::project). Selections return sorted ids
+        virtual void              pick_index_set_dirty();
+                uint              pick_vert (const vec3d & p) const;
+                uint              pick_edge (const vec3d & p) const;
+                uint              pick_poly (const vec3d & p) const;
+                std::vector<uint> pick_verts(const AABB & box) const;
+                std::vector<uint> pick_edges(const AABB & box) const;
+                std::vector<uint> pick_polys(const AABB & box) const;
+                std::vector<uint> pick_verts(const std::vector<vec2d> & lasso, const std::function<vec2d(const vec3d &)> & project) const;
+                std::vector<uint> pick_edges(const std::vector<vec2d> & lasso, const std::function<vec2d(const vec3d &)> & project) const;
+                std::vector<uint> pick_polys(const std::vector<vec2d> & lasso, const std::function<vec2d(const vec3d &)> & project) const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -232,6 +287,7 @@ class AbstractMesh
         virtual void             vert_weights               (const uint vid, const int type, std::vector<std::pair<uint,double>> & wgts) const;
                 void             vert_set_flag              (const int flag, const bool b);
                 void             vert_set_flag              (const int flag, const bool b, const std::vector<uint> & vids);
+        virtual bool             vert_is_visible            (const uint vid) const; // incident to a visible poly
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -259,6 +315,7 @@ class AbstractMesh
         virtual void                   edge_set_alpha             (const float alpha);
                 void                   edge_set_flag              (const int flag, const bool b);
                 void                   edge_set_flag              (const int flag, const bool b, const std::vector<uint> & eids);
+        virtual bool                   edge_is_visible            (const uint eid) const; // incident to a visible poly
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -288,6 +345,7 @@ class AbstractMesh
                 void               poly_apply_labels          (const std::vector<int> & labels);
                 void               poly_apply_label           (const int label);
                 AABB               poly_aabb                  (const uint pid) const;
+                bool               poly_is_visible            (const uint pid) const; // not HIDDEN
         virtual double             poly_mass                  (const uint pid) const = 0;
         virtual void               poly_set_color             (const Color & c);
         virtual void               poly_set_alpha             (const float alpha);
@@ -41,7 +41,11 @@
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/profiler.h>
+#include <cinolib/parallel_for.h>
 #include <cinolib/deg_rad.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
+#include <algorithm>
 #include <unordered_set>
 #include <queue>
 
@@ -151,11 +155,33 @@ void AbstractPolygonMesh<M,V,E,P>::clear()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+MemoryFootprint AbstractPolygonMesh<M,V,E,P>::memory_footprint() const
+{
+    MemoryFootprint mf = AbstractMesh<M,V,E,P>::memory_footprint();
+    mf.add("poly_triangles", poly_triangles);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::shrink_to_fit()
+{
+    AbstractMesh<M,V,E,P>::shrink_to_fit();
+    cinolib::shrink_to_fit(poly_triangles);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & verts,
                                         const std::vector<std::vector<uint>> & polys)
 {
+    CINO_PROFILE_SCOPE("AbstractPolygonMesh::init");
     std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 
     // pre-allocate memory
@@ -177,10 +203,17 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
     this->p_data.reserve(np);
 
     // initialize mesh connectivity (and normals)
-    for(auto v : verts) this->vert_add(v);
-    for(auto p : polys) this->poly_add(p);
+    {
+        CINO_PROFILE_SCOPE("AbstractPolygonMesh::init::connectivity");
+        for(auto v : verts) this->vert_add(v);
+        for(auto p : polys) this->poly_add(p);
+    }
 
-    if(this->mesh_data().update_normals) this->update_v_normals();
+    if(this->mesh_data().update_normals)
+    {
+        CINO_PROFILE_SCOPE("AbstractPolygonMesh::init::normals");
+        this->update_v_normals();
+    }
 
     this->copy_xyz_to_uvw(UVW_param);
 
@@ -282,10 +315,11 @@ void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & p
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-void AbstractPolygonMesh<M,V,E,P>::update_p_tessellation(const uint pid)
+bool AbstractPolygonMesh<M,V,E,P>::update_p_tessellation(const uint pid)
 {
     // Assume convexity and try trivial tessellation first. If something flips
-    // apply earcut algorithm to get a valid triangulation
+    // apply earcut algorithm to get a valid triangulation. Returns false if the
+    // polygon could not be triangulated (the caller decides whether to warn)
 
     poly_triangles.at(pid).clear();
     std::vector<vec3d> n;
@@ -319,15 +353,10 @@ void AbstractPolygonMesh<M,V,E,P>::update_p_tessellation(const uint pid)
         //
         std::vector<uint> tris;
         poly_triangles.at(pid).clear();
-        if(polygon_triangulate(vlist, tris))
-        {
-            for(uint off : tris) poly_triangles.at(pid).push_back(this->poly_vert_id(pid,off));
-        }
-        else
-        {
-            std::cout << "WARNING: could not triangulate a polygon. Is it degenerate?" << std::endl;
-        }
+        if(!polygon_triangulate(vlist, tris)) return false;
+        for(uint off : tris) poly_triangles.at(pid).push_back(this->poly_vert_id(pid,off));
     }
+    return true;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -341,7 +370,8 @@ void AbstractPolygonMesh<M,V,E,P>::update_v_normal(const uint vid)
     {
         n += this->poly_data(pid).normal;
     }
-    if (n.length()>0) n.normalize();
+    double l = n.length();
+    if (l>0) n /= l;
     this->vert_data(vid).normal = n;
 }
 
@@ -363,10 +393,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_normals()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), PARALLEL_GRAIN_LIGHT, [this](uint pid)
     {
         update_p_normal(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -375,9 +405,17 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_tessellations()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    // failures are collected and reported once, after the loop
+    std::vector<char> failed(this->num_polys(),0); // (char, as vector<bool> is not thread safe)
+    PARALLEL_FOR(0, this->num_polys(), PARALLEL_GRAIN_HEAVY, [this,&failed](uint pid)
     {
-        update_p_tessellation(pid);
+        if(!update_p_tessellation(pid)) failed.at(pid) = 1;
+    });
+
+    uint n_failed = std::count(failed.begin(), failed.end(), 1);
+    if(n_failed>0)
+    {
+        std::cout << "WARNING: could not triangulate " << n_failed << " polygon(s). Are they degenerate?" << std::endl;
     }
 }
 
@@ -387,10 +425,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_v_normals()
 {
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    PARALLEL_FOR(0, this->num_verts(), PARALLEL_GRAIN_LIGHT, [this](uint vid)
     {
         update_v_normal(vid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -780,19 +818,6 @@ std::vector<uint> AbstractPolygonMesh<M,V,E,P>::vert_boundary_edges(const uint v
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M, class V, class E, class P>
-CINO_INLINE
-bool AbstractPolygonMesh<M,V,E,P>::vert_is_visible(const uint vid) const
-{
-    for(uint pid : this->adj_v2p(vid))
-    {
-        if(!this->poly_data(pid).flags[HIDDEN]) return true;
-    }
-    return false;
-}
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::vert_cluster_one_ring(const uint                       vid,
@@ -866,6 +891,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::vert_add(const vec3d & pos)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
@@ -916,6 +942,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     // [28 Aug 2017] Tested on 10K random id switches : PASSED
 
     if (vid0 == vid1) return;
@@ -1083,6 +1110,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     assert(this->edge_id(vid0, vid1)==-1); // make sure it doesn't exist already
     assert(vid0 < this->num_verts());
     assert(vid1 < this->num_verts());
@@ -1115,6 +1143,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::edge_switch_id(const uint eid0, const uint eid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     // [28 Aug 2017] Tested on 10K random id switches : PASSED
 
     if (eid0 == eid1) return;
@@ -1382,6 +1411,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_switch_id(const uint pid0, const uint pid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     // [28 Aug 2017] Tested on 10K random id switches : PASSED
 
     if (pid0 == pid1) return;
@@ -1438,6 +1468,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if(poly_id(vlist)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated poly!" << ANSI_fg_color_default << std::endl;
@@ -1493,7 +1524,10 @@ uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 
     if(this->mesh_data().update_normals) this->update_p_normal(pid);
     this->poly_triangles.push_back(std::vector<uint>());
-    update_p_tessellation(pid);
+    if(!update_p_tessellation(pid))
+    {
+        std::cout << "WARNING: could not triangulate a polygon. Is it degenerate?" << std::endl;
+    }
 
     return pid;
 }
@@ -1604,6 +1638,43 @@ std::vector<ipair> AbstractPolygonMesh<M,V,E,P>::get_boundary_edges() const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractPolygonMesh<M,V,E,P>::pick_poly(const vec3d & p, const vec3d & dir, uint & pid, vec3d & pos) const
+{
+    auto hit = [&](const uint id, double & t)
+    {
+        bool found = false;
+        for(uint i=0; i+2<this->poly_tessellation(id).size(); i+=3)
+        {
+            double tt;
+            vec3d  bary;
+            bool   backside, coplanar;
+            if(Moller_Trumbore_intersection(p, dir, this->vert(this->poly_tessellation(id).at(i  )),
+                                                    this->vert(this->poly_tessellation(id).at(i+1)),
+                                                    this->vert(this->poly_tessellation(id).at(i+2)),
+                                                    backside, coplanar, tt, bary) && tt>=0 && (!found || tt<t))
+            {
+                t     = tt;
+                found = true;
+            }
+        }
+        return found;
+    };
+    double t;
+    if(!this->pick_index_polys().intersects_ray(p, dir, hit, t, pid, [this](const uint id)
+    {
+        return !this->poly_is_visible(id);
+    }))
+    {
+        return false;
+    }
+    pos = p + dir*t;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 std::vector<uint> AbstractPolygonMesh<M,V,E,P>::get_boundary_vertices() const
@@ -68,6 +68,12 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+
+        MemoryFootprint memory_footprint() const override;
+        void            shrink_to_fit() override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & polys);
         void init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -81,7 +87,7 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
                 void update_normals() override;
-                void update_p_tessellation(const uint pid);
+                bool update_p_tessellation(const uint pid);
         virtual void update_p_normal(const uint pid);
                 void update_v_normal(const uint vid);
                 void update_p_tessellations();
@@ -108,6 +114,13 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // ray picking: first visible poly hit by the ray R(t) := p + t * dir,
+        // and hit position (see AbstractMesh for picking by point/box/lasso)
+        using AbstractMesh<M,V,E,P>::pick_poly; // avoid hiding pick_poly(p)
+        bool pick_poly(const vec3d & p, const vec3d & dir, uint & pid, vec3d & pos) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         std::vector<uint>  get_boundary_vertices()         const;
         std::vector<uint>  get_ordered_boundary_vertices() const;
         std::vector<ipair> get_boundary_edges()            const;
@@ -135,7 +148,6 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         uint              vert_add                (const vec3d & pos);
         bool              vert_merge              (const uint vid0, const uint vid1);
         void              vert_cluster_one_ring   (const uint vid, std::vector<std::vector<uint>> & clusters, const bool marked_edges_are_borders);
-        bool              vert_is_visible         (const uint vid) const;
         std::vector<uint> vert_adj_visible_polys  (const uint vid, const vec3d dir, const double ang_thresh = 60.0);
         std::vector<uint> vert_boundary_edges     (const uint vid) const;
         std::vector<uint> vert_verts_link         (const uint vid) const; // see https://en.wikipedia.org/wiki/Simplicial_complex#Closure,_star,_and_link for adefinition of link and star
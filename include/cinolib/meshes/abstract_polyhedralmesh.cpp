@@ -37,6 +37,9 @@
 #include <cinolib/geometry/triangle.h>
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/profiler.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
 #include <unordered_set>
 #include <unordered_map>
 #include <queue>
@@ -62,6 +65,48 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
     f2f.clear();
     f2p.clear();
     p2v.clear();
+    //
+    face_index.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+MemoryFootprint AbstractPolyhedralMesh<M,V,E,F,P>::memory_footprint() const
+{
+    MemoryFootprint mf = AbstractMesh<M,V,E,P>::memory_footprint();
+    mf.add("faces",              faces);
+    mf.add("face_triangles",     face_triangles);
+    mf.add("polys_face_winding", polys_face_winding);
+    mf.add("f_data",             f_data);
+    mf.add("v2f",                v2f);
+    mf.add("e2f",                e2f);
+    mf.add("f2e",                f2e);
+    mf.add("f2f",                f2f);
+    mf.add("f2p",                f2p);
+    mf.add("p2v",                p2v);
+    mf.add("face_index",         face_index.memory_footprint());
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::shrink_to_fit()
+{
+    AbstractMesh<M,V,E,P>::shrink_to_fit();
+    cinolib::shrink_to_fit(faces);
+    cinolib::shrink_to_fit(face_triangles);
+    cinolib::shrink_to_fit(polys_face_winding);
+    cinolib::shrink_to_fit(f_data);
+    cinolib::shrink_to_fit(v2f);
+    cinolib::shrink_to_fit(e2f);
+    cinolib::shrink_to_fit(f2e);
+    cinolib::shrink_to_fit(f2f);
+    cinolib::shrink_to_fit(f2p);
+    cinolib::shrink_to_fit(p2v);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -73,6 +118,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
                                              const std::vector<std::vector<uint>> & polys,
                                              const std::vector<std::vector<bool>> & polys_face_winding)
 {
+    CINO_PROFILE_SCOPE("AbstractPolyhedralMesh::init");
     std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 
     // pre-allocate memory
@@ -103,10 +149,17 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->face_triangles.reserve(nf);
     this->polys_face_winding.reserve(np);
 
-    for(auto v : verts) vert_add(v);
-    for(auto f : faces) face_add(f);
-    for(uint pid=0; pid<polys.size(); ++pid) this->poly_add(polys.at(pid), polys_face_winding.at(pid));
-    if(this->mesh_data().update_normals) this->update_v_normals();
+    {
+        CINO_PROFILE_SCOPE("AbstractPolyhedralMesh::init::connectivity");
+        for(auto v : verts) vert_add(v);
+        for(auto f : faces) face_add(f);
+        for(uint pid=0; pid<polys.size(); ++pid) this->poly_add(polys.at(pid), polys_face_winding.at(pid));
+    }
+    if(this->mesh_data().update_normals)
+    {
+        CINO_PROFILE_SCOPE("AbstractPolyhedralMesh::init::normals");
+        this->update_v_normals();
+    }
 
     this->copy_xyz_to_uvw(UVW_param);
 
@@ -127,6 +180,7 @@ CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
                                              const std::vector<std::vector<uint>> & polys)
 {
+    CINO_PROFILE_SCOPE("AbstractPolyhedralMesh::init");
     std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 
     // pre-allocate memory
@@ -145,9 +199,16 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->p_data.reserve(np);
     this->polys_face_winding.reserve(np);
 
-    for(auto v : verts) vert_add(v);
-    for(auto p : polys) poly_add(p);
-    if(this->mesh_data().update_normals) this->update_v_normals();
+    {
+        CINO_PROFILE_SCOPE("AbstractPolyhedralMesh::init::connectivity");
+        for(auto v : verts) vert_add(v);
+        for(auto p : polys) poly_add(p);
+    }
+    if(this->mesh_data().update_normals)
+    {
+        CINO_PROFILE_SCOPE("AbstractPolyhedralMesh::init::normals");
+        this->update_v_normals();
+    }
 
     this->copy_xyz_to_uvw(UVW_param);
 
@@ -330,10 +391,10 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_normals()
 {
-    for(uint fid=0; fid<num_faces(); ++fid)
+    PARALLEL_FOR(0, num_faces(), PARALLEL_GRAIN_LIGHT, [this](uint fid)
     {
         update_f_normal(fid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -343,10 +404,10 @@ CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_tessellation()
 {
     this->face_triangles.resize(this->num_faces());
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    PARALLEL_FOR(0, this->num_faces(), PARALLEL_GRAIN_HEAVY, [this](uint fid)
     {
         update_f_tessellation(fid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -358,6 +419,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_tessellation(const uint fid)
     // Assume convexity and try trivial tessellation first. If something flips
     // apply earcut algorithm to get a valid triangulation
 
+    face_triangles.at(fid).clear();
     std::vector<vec3d> n;
     for (uint i=2; i<this->verts_per_face(fid); ++i)
     {
@@ -402,10 +464,26 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_v_normals()
 {
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    // gather formulation: outward normals of surface faces are computed
+    // once, then each surface vertex sums the normals of its incident faces
+    std::vector<vec3d> srf_normals(this->num_faces(), vec3d(0,0,0));
+    PARALLEL_FOR(0, this->num_faces(), PARALLEL_GRAIN_LIGHT, [&](uint fid)
     {
-        if(vert_is_on_srf(vid)) update_v_normal(vid);
-    }
+        if(face_is_on_srf(fid))
+        {
+            assert(this->adj_f2p(fid).size()==1);
+            srf_normals[fid] = this->poly_face_normal(this->adj_f2p(fid).front(), fid);
+        }
+    });
+    PARALLEL_FOR(0, this->num_verts(), PARALLEL_GRAIN_LIGHT, [&](uint vid)
+    {
+        if(!vert_is_on_srf(vid)) return;
+        vec3d n(0,0,0);
+        for(uint fid : adj_v2f(vid)) n += srf_normals[fid];
+        double l = n.length();
+        if (l>0) n /= l;
+        this->vert_data(vid).normal = n;
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -440,10 +518,10 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_quality()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), PARALLEL_GRAIN_HEAVY, [this](uint pid)
     {
         update_p_quality(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -462,7 +540,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_v_normal(const uint vid)
             n += this->poly_face_normal(pid,fid);
         }
     }
-    if (n.length()>0) n.normalize();
+    double l = n.length();
+    if (l>0) n /= l;
     this->vert_data(vid).normal = n;
 }
 
@@ -1608,6 +1687,20 @@ double AbstractPolyhedralMesh<M,V,E,F,P>::vert_volume(const uint vid) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool AbstractPolyhedralMesh<M,V,E,F,P>::edge_is_visible(const uint eid) const
+{
+    for(uint fid : this->adj_e2f(eid))
+    {
+        uint pid;
+        if(this->face_is_visible(fid,pid)) return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 bool AbstractPolyhedralMesh<M,V,E,F,P>::vert_is_visible(const uint vid) const
@@ -1933,6 +2026,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const uint vid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if (vid0 == vid1) return;
 
     std::swap(this->verts.at(vid0),   this->verts.at(vid1));
@@ -2035,6 +2129,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::vert_add(const vec3d & pos)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
@@ -2060,6 +2155,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::edge_switch_id(const uint eid0, const uint eid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if (eid0 == eid1) return;
 
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
@@ -2115,6 +2211,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     assert(this->edge_id(vid0, vid1)==-1); // make sure it doesn't exist already
     assert(vid0 < this->num_verts());
     assert(vid1 < this->num_verts());
@@ -2173,6 +2270,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::face_switch_id(const uint fid0, const uint fid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     // should I do something for poly_face_winding?
 
     if (fid0 == fid1) return;
@@ -2243,6 +2341,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::face_add(const std::vector<uint> & f)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if(face_id(f)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated face!" << ANSI_fg_color_default << std::endl;
@@ -2339,6 +2438,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::poly_switch_id(const uint pid0, const uint pid1)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if (pid0 == pid1) return;
 
     std::swap(this->polys.at(pid0),              this->polys.at(pid1));
@@ -2408,6 +2508,7 @@ CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & flist,
                                                  const std::vector<bool> & fwinding)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if(poly_id(flist)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated poly!" << ANSI_fg_color_default << std::endl;
@@ -2476,6 +2577,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & vlist)
 {
+    this->pick_index_stale = this->PICK_INDEX_ALL;
     if(vlist.size()==4) // tetrahedron
     {
         // detect faces
@@ -2570,11 +2672,27 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & vlist
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void AbstractPolyhedralMesh<M,V,E,F,P>::poly_reorder_p2v(const uint pid)
+std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::poly_ordered_verts_id(const uint pid) const
 {
-    if(this->verts_per_poly(pid)==4)
+    // finds the vertex of the top face connected to vid through an edge of the poly
+    // (adjacency alone is not enough in hybrid meshes, where elements of different
+    // type may connect vertices along diagonals)
+    auto top_vert = [&](const uint fid_top, const uint vid)
+    {
+        for(uint v : this->adj_f2v(fid_top))
+        {
+            int eid = this->edge_id(v,vid);
+            if(eid>=0 && this->poly_contains_edge(pid,eid)) return v;
+        }
+        assert(false);
+        return vid;
+    };
+
+    // the topology is checked upfront, as any other element (e.g. a pyramid,
+    // or a six vertex element that is not a prism) has no standard ordering
+    if(this->poly_is_tetrahedron(pid))
     {
-        /* ensures standard tetrahedron vert ordering in the p2v adjacency
+        /* standard tetrahedron vert ordering
 
                     v2
                    /| \
@@ -2594,11 +2712,37 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_reorder_p2v(const uint pid)
         while(this->face_contains_vert(fid,this->poly_vert_id(pid,off))) ++off;
         assert(off<4);
         vlist[3] = this->poly_vert_id(pid,off);
-        this->p2v.at(pid) = vlist;
+        return vlist;
     }
-    else if(this->verts_per_poly(pid)==8)
+    else if(this->verts_per_poly(pid)==6 && this->poly_is_prism(pid))
+    {
+        /* standard prism vert ordering
+
+                v5
+              /  |  \
+            v3-------v4
+            |    |    |
+            |   v2    |
+            | /     \ |
+            v0-------v1
+        */
+        uint off = 0;
+        while(this->verts_per_face(this->poly_face_id(pid,off))!=3) ++off;
+        uint fid_bot = this->poly_face_id(pid,off++);
+        while(this->verts_per_face(this->poly_face_id(pid,off))!=3) ++off;
+        assert(off<5);
+        uint fid_top = this->poly_face_id(pid,off);
+        std::vector<uint> vlist(6);
+        vlist[0] = this->face_vert_id(fid_bot,TET_FACES[0][0]);
+        vlist[1] = this->face_vert_id(fid_bot,TET_FACES[0][1]);
+        vlist[2] = this->face_vert_id(fid_bot,TET_FACES[0][2]);
+        if(this->poly_face_is_CW(pid,fid_bot)) std::swap(vlist[1],vlist[2]);
+        for(uint i=0; i<3; ++i) vlist[3+i] = top_vert(fid_top, vlist[i]);
+        return vlist;
+    }
+    else if(this->poly_is_hexahedron(pid))
     {
-        /* ensures standard hexahedron vert ordering in the p2v adjacency
+        /* standard hexahedron vert ordering
 
                v7------v6
               / |     / |
@@ -2619,17 +2763,20 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_reorder_p2v(const uint pid)
         vlist[2] = this->face_vert_id(fid_bot,HEXA_FACES[0][2]);
         vlist[3] = this->face_vert_id(fid_bot,HEXA_FACES[0][3]);
         if(this->poly_face_is_CW(pid,fid_bot)) std::swap(vlist[1],vlist[3]);
-        for(uint vid : this->face_verts_id(fid_top))
-        {
-            if(this->verts_are_adjacent(vid,vlist[0])) vlist[4] = vid; else
-            if(this->verts_are_adjacent(vid,vlist[1])) vlist[5] = vid; else
-            if(this->verts_are_adjacent(vid,vlist[2])) vlist[6] = vid; else
-            if(this->verts_are_adjacent(vid,vlist[3])) vlist[7] = vid; else
-            assert(false);
-        }
-        this->p2v.at(pid) = vlist;
+        for(uint i=0; i<4; ++i) vlist[4+i] = top_vert(fid_top, vlist[i]);
+        return vlist;
     }
-    else assert(false && "unknown polyhedral element");
+    return std::vector<uint>();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::poly_reorder_p2v(const uint pid)
+{
+    assert(this->verts_per_poly(pid)==4 || this->verts_per_poly(pid)==8);
+    this->p2v.at(pid) = poly_ordered_verts_id(pid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -2967,17 +3114,131 @@ std::vector<bool> AbstractPolyhedralMesh<M,V,E,F,P>::poly_faces_winding(const ui
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::pick_index_set_dirty()
+{
+    AbstractMesh<M,V,E,P>::pick_index_set_dirty();
+    face_index.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+const KdTree & AbstractPolyhedralMesh<M,V,E,F,P>::pick_index_faces() const
+{
+    std::lock_guard<std::mutex> lock(this->pick_index_mutex.m);
+    if((this->pick_index_stale & this->PICK_INDEX_FACES) || face_index.size()!=this->num_faces())
+    {
+        std::vector<vec3d> centroids(this->num_faces());
+        std::vector<AABB>  boxes(this->num_faces());
+        PARALLEL_FOR(0, this->num_faces(), 10000, [&](uint fid)
+        {
+            centroids.at(fid) = this->face_centroid(fid);
+            boxes.at(fid)     = AABB(this->face_verts(fid));
+        });
+        face_index.build(centroids, boxes);
+        this->pick_index_stale &= ~this->PICK_INDEX_FACES;
+    }
+    return face_index;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::pick_face(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    uint   fid;
+    double dist;
+    if(!pick_index_faces().closest_point(p, fid, dist, [this](const uint id)
     {
-        if(!this->face_data(fid).flags[HIDDEN]) closest.push_back(std::make_pair(this->face_centroid(fid).dist(p),fid));
+        uint pid;
+        return this->face_data(id).flags[HIDDEN] || !this->face_is_visible(id,pid);
+    }))
+    {
+        pick_index_faces().closest_point(p, fid, dist);
     }
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    return fid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::pick_faces(const AABB & box) const
+{
+    std::vector<uint> res;
+    pick_index_faces().points_in_box(box, res, [this](const uint id)
+    {
+        uint pid;
+        return this->face_data(id).flags[HIDDEN] || !this->face_is_visible(id,pid);
+    });
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::pick_faces(const std::vector<vec2d>                  & lasso,
+                                                                const std::function<vec2d(const vec3d &)> & project) const
+{
+    return this->pick_in_lasso(pick_index_faces(), lasso, project, [this](const uint id)
+    {
+        uint pid;
+        return this->face_data(id).flags[HIDDEN] || !this->face_is_visible(id,pid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool AbstractPolyhedralMesh<M,V,E,F,P>::pick_face(const vec3d & p, const vec3d & dir, uint & fid, vec3d & pos) const
+{
+    auto hit = [&](const uint id, double & t)
+    {
+        bool found = false;
+        std::vector<uint> tris = this->face_tessellation(id);
+        for(uint i=0; i+2<tris.size(); i+=3)
+        {
+            double tt;
+            vec3d  bary;
+            bool   backside, coplanar;
+            if(Moller_Trumbore_intersection(p, dir, this->vert(tris.at(i)), this->vert(tris.at(i+1)), this->vert(tris.at(i+2)),
+                                            backside, coplanar, tt, bary) && tt>=0 && (!found || tt<t))
+            {
+                t     = tt;
+                found = true;
+            }
+        }
+        return found;
+    };
+    double t;
+    if(!pick_index_faces().intersects_ray(p, dir, hit, t, fid, [this](const uint id)
+    {
+        uint pid;
+        return this->face_data(id).flags[HIDDEN] || !this->face_is_visible(id,pid);
+    }))
+    {
+        return false;
+    }
+    pos = p + dir*t;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool AbstractPolyhedralMesh<M,V,E,F,P>::pick_poly(const vec3d & p, const vec3d & dir, uint & pid, vec3d & pos) const
+{
+    uint fid;
+    if(!pick_face(p, dir, fid, pos)) return false;
+    face_is_visible(fid, pid);
+    return true;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
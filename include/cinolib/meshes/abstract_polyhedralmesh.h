@@ -66,6 +66,10 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<std::vector<uint>> face_triangles; // per face serialized triangulation (e.g., for rendering)
 
+        mutable KdTree face_index; // face centroids, for picking (see AbstractMesh)
+
+        const KdTree & pick_index_faces() const;
+
     public:
 
         typedef F F_type;
@@ -77,6 +81,11 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         void clear() override;
 
+        MemoryFootprint memory_footprint() const override;
+        void            shrink_to_fit() override;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & faces,
                   const std::vector<std::vector<uint>> & polys,
@@ -162,8 +171,16 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
-        uint pick_face(const vec3d & p) const;
+        // useful for GUIs with mouse picking (see AbstractMesh). Only the faces exposed by the
+        // visible polys can be picked. Ray picking returns the first face hit by the ray
+        // R(t) := p + t * dir (resp. the visible poly beneath it) and the hit position
+        void              pick_index_set_dirty() override;
+        uint              pick_face (const vec3d & p) const;
+        std::vector<uint> pick_faces(const AABB & box) const;
+        std::vector<uint> pick_faces(const std::vector<vec2d> & lasso, const std::function<vec2d(const vec3d &)> & project) const;
+        bool              pick_face (const vec3d & p, const vec3d & dir, uint & fid, vec3d & pos) const;
+        using AbstractMesh<M,V,E,P>::pick_poly; // avoid hiding pick_poly(p)
+        bool              pick_poly (const vec3d & p, const vec3d & dir, uint & pid, vec3d & pos) const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -175,7 +192,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         double             vert_mass                  (const uint vid) const override;
         double             vert_volume                (const uint vid) const;
         bool               vert_is_manifold           (const uint vid) const;
-        bool               vert_is_visible            (const uint vid) const;
+        bool               vert_is_visible            (const uint vid) const override;
         int                vert_shared_between_faces  (const std::vector<uint> & fids) const;
         std::vector<uint>  vert_verts_link            (const uint vid) const; // see https://en.wikipedia.org/wiki/Simplicial_complex#Closure,_star,_and_link for adefinition of link and star
         std::vector<uint>  vert_edges_link            (const uint vid) const;
@@ -202,6 +219,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         bool              edge_is_on_srf             (const uint eid) const;
         bool              edge_is_incident_to_srf    (const uint eid) const;
         bool              edge_has_border_on_srf     (const uint eid) const;
+        bool              edge_is_visible            (const uint eid) const override; // incident to a visible face
         std::vector<uint> edge_ordered_poly_ring     (const uint eid) const;
         std::vector<uint> edge_adj_srf_faces         (const uint eid) const;
         std::vector<uint> edge_verts_link            (const uint eid) const;
@@ -293,6 +311,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                 std::vector<uint>  poly_faces_id               (const uint pid, const bool sort_by_fid = false) const;
                 std::vector<bool>  poly_faces_winding          (const uint pid) const;
                 uint               poly_split_along_new_face   (const uint pid, const std::vector<uint> & f);
+                std::vector<uint>  poly_ordered_verts_id       (const uint pid) const; // standard vert ordering for tets, prisms and hexahedra (empty for other elements)
                 void               poly_reorder_p2v            (const uint pid);
                 bool               poly_is_hexahedron          (const uint pid) const;
                 bool               poly_is_tetrahedron         (const uint pid) const;
@@ -41,6 +41,7 @@
 #include <cinolib/standard_elements_tables.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/io/io_utilities.h>
+#include <cinolib/subdivision_hexa_scheme.h>
 
 #include <queue>
 #include <float.h>
@@ -343,34 +344,7 @@ void Hexmesh<M,V,E,F,P>::poly_subdivide(const std::vector<std::vector<std::vecto
 {
     std::vector<vec3d> new_verts;
     std::vector<uint>  new_polys;
-    std::map<std::vector<uint>,uint> v_map;
-
-    for(uint pid=0; pid<this->num_polys(); ++pid)
-    {
-        for(const auto & sub_poly: poly_split_scheme)
-        {
-            assert(sub_poly.size() == 8);
-            for(uint off=0; off<8; ++off)
-            {
-                std::vector<uint> vids;
-                for(uint i : sub_poly.at(off)) vids.push_back(this->poly_vert_id(pid,i));
-                sort(vids.begin(), vids.end());
-
-                auto query = v_map.find(vids);
-                if (query != v_map.end())
-                {
-                    new_polys.push_back(query->second);
-                }
-                else
-                {
-                    uint fresh_id = new_verts.size();
-                    new_verts.push_back(verts_average(vids));
-                    v_map[vids] = fresh_id;
-                    new_polys.push_back(fresh_id);
-                }
-            }
-        }
-    }
+    subdivision_hexa_scheme(*this, poly_split_scheme, new_verts, new_polys);
     *this = Hexmesh<M,V,E,F,P>(new_verts,new_polys);
 }
 
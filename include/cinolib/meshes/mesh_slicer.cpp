@@ -36,6 +36,8 @@
 #include <cinolib/meshes/mesh_slicer.h>
 #include <cinolib/geometry/vec3.h>
 #include <cinolib/meshes/mesh_attributes.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -53,40 +55,192 @@ MeshSlicer<Mesh>::MeshSlicer(Mesh & m)
 
 template<class Mesh>
 CINO_INLINE
-void MeshSlicer<Mesh>::reset(Mesh & m)
-{    
+std::vector<uint> MeshSlicer<Mesh>::reset(Mesh & m)
+{
+    std::vector<uint> changed;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) changed.push_back(pid);
+    }
     m.poly_set_flag(HIDDEN,false); // show all
+
+    // the index is (re)built lazily, at the next update
+    ready = false;
+    return changed;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+std::vector<uint> MeshSlicer<Mesh>::update(Mesh & m, const SlicerState & s)
+{
+    double t[4];
+    thresholds(m, s, t);
+
+    std::vector<uint> changed;
+    auto refresh = [&](const uint pid)
+    {
+        bool hidden = !poly_passes(m, pid, s, t);
+        if(m.poly_data(pid).flags[HIDDEN] != hidden)
+        {
+            m.poly_data(pid).flags[HIDDEN] = hidden;
+            changed.push_back(pid);
+        }
+    };
+
+    bool full = s.X_sign   != state.X_sign   ||
+                s.Y_sign   != state.Y_sign   ||
+                s.Z_sign   != state.Z_sign   ||
+                s.Q_sign   != state.Q_sign   ||
+                s.L_filter != state.L_filter ||
+                s.L_mode   != state.L_mode   ||
+                s.mode     != state.mode;
+
+    std::vector<uint> moved;
+    if(!ready || cache.size() != m.num_polys())
+    {
+        cache.init(m);
+        build_index(m);
+        full = true;
+    }
+    else if(cache.is_dirty())
+    {
+        // polys whose geometry changed may cross any threshold
+        moved = cache.update(m);
+        build_index(m);
+    }
+
+    if(full)
+    {
+        std::vector<char> hidden(m.num_polys());
+        PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+        {
+            hidden[pid] = !poly_passes(m, pid, s, t);
+        });
+        for(uint pid=0; pid<m.num_polys(); ++pid)
+        {
+            if(m.poly_data(pid).flags[HIDDEN] != static_cast<bool>(hidden[pid]))
+            {
+                m.poly_data(pid).flags[HIDDEN] = hidden[pid];
+                changed.push_back(pid);
+            }
+        }
+    }
+    else
+    {
+        for(uint pid : moved) refresh(pid);
+
+        // a filter flips only for polys whose key lies between the old and the new threshold
+        for(uint i=0; i<4; ++i)
+        {
+            if(t[i] == thresh[i]) continue;
+            double lo = std::min(t[i], thresh[i]);
+            double hi = std::max(t[i], thresh[i]);
+            auto beg  = std::lower_bound(keys[i].begin(), keys[i].end(), lo);
+            auto end  = std::upper_bound(beg, keys[i].end(), hi);
+            for(auto it=beg; it!=end; ++it) refresh(order[i].at(it - keys[i].begin()));
+        }
+    }
+
+    state = s;
+    for(uint i=0; i<4; ++i) thresh[i] = t[i];
+    return changed;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::vert_set_dirty(const Mesh & m, const uint vid)
+{
+    cache.vert_set_dirty(m, vid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void MeshSlicer<Mesh>::update(Mesh & m, const SlicerState & s)
+void MeshSlicer<Mesh>::poly_set_dirty(const uint pid)
+{
+    cache.poly_set_dirty(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::build_index(const Mesh & m)
+{
+    PARALLEL_FOR(0, 4, 0, [&](uint i)
+    {
+        std::vector<std::pair<double,uint>> tmp(m.num_polys());
+        for(uint pid=0; pid<m.num_polys(); ++pid)
+        {
+            double key = (i<3) ? cache.centroid(pid)[i] : cache.quality(pid);
+            tmp.at(pid) = std::make_pair(key, pid);
+        }
+        std::sort(tmp.begin(), tmp.end());
+
+        order[i].resize(tmp.size());
+        keys[i].resize(tmp.size());
+        for(uint j=0; j<tmp.size(); ++j)
+        {
+            keys[i].at(j)  = tmp.at(j).first;
+            order[i].at(j) = tmp.at(j).second;
+        }
+    });
+
+    ready = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::thresholds(const Mesh & m, const SlicerState & s, double t[]) const
 {
     float X_thresh = m.bbox().min[0] + m.bbox().delta()[0] * s.X_thresh;
     float Y_thresh = m.bbox().min[1] + m.bbox().delta()[1] * s.Y_thresh;
     float Z_thresh = m.bbox().min[2] + m.bbox().delta()[2] * s.Z_thresh;
 
-    for(uint pid=0; pid<m.num_polys(); ++pid)
-    {
-        vec3d  c = m.poly_centroid(pid);
-        float  q = m.poly_data(pid).quality;
-        int    l = m.poly_data(pid).label;
+    t[0] = X_thresh;
+    t[1] = Y_thresh;
+    t[2] = Z_thresh;
+    t[3] = s.Q_thresh;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool MeshSlicer<Mesh>::poly_passes(const Mesh & m, const uint pid, const SlicerState & s, const double t[]) const
+{
+    const vec3d & c = cache.centroid(pid);
+    float         q = cache.quality(pid);
+    int           l = m.poly_data(pid).label;
 
-        bool pass_X = (s.X_sign == LEQ) ? (c.x() <=   X_thresh) : (c.x() >=   X_thresh);
-        bool pass_Y = (s.Y_sign == LEQ) ? (c.y() <=   Y_thresh) : (c.y() >=   Y_thresh);
-        bool pass_Z = (s.Z_sign == LEQ) ? (c.z() <=   Z_thresh) : (c.z() >=   Z_thresh);
-        bool pass_Q = (s.Q_sign == LEQ) ? (q     <= s.Q_thresh) : (q     >= s.Q_thresh);
-        bool pass_L = (s.L_mode == IS ) ? (l == -1 || l == s.L_filter) : (l == -1 || l != s.L_filter);
+    bool pass_X = (s.X_sign == LEQ) ? (c.x() <= t[0]) : (c.x() >= t[0]);
+    bool pass_Y = (s.Y_sign == LEQ) ? (c.y() <= t[1]) : (c.y() >= t[1]);
+    bool pass_Z = (s.Z_sign == LEQ) ? (c.z() <= t[2]) : (c.z() >= t[2]);
+    bool pass_Q = (s.Q_sign == LEQ) ? (q     <= t[3]) : (q     >= t[3]);
+    bool pass_L = (s.L_mode == IS ) ? (l == -1 || l == s.L_filter) : (l == -1 || l != s.L_filter);
 
-        bool b = (s.mode == AND) ? ( pass_X &&  pass_Y &&  pass_Z &&  pass_L &&  pass_Q)
-                                 : (!pass_X || !pass_Y || !pass_Z || !pass_L || !pass_Q);
+    return (s.mode == AND) ? ( pass_X &&  pass_Y &&  pass_Z &&  pass_L &&  pass_Q)
+                           : (!pass_X || !pass_Y || !pass_Z || !pass_L || !pass_Q);
+}
 
-        m.poly_data(pid).flags[HIDDEN] = !b;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        //std::cout << pass_X << " " << pass_Y << " " << pass_Z << " " << pass_Q << " " << pass_L << std::endl;
-    }
+template<class Mesh>
+CINO_INLINE
+MemoryFootprint MeshSlicer<Mesh>::memory_footprint() const
+{
+    MemoryFootprint mf;
+    mf.add("cache", cache.memory_footprint());
+    for(int i=0; i<4; ++i) mf.add("order[" + std::to_string(i) + "]", order[i]);
+    for(int i=0; i<4; ++i) mf.add("keys["  + std::to_string(i) + "]", keys[i]);
+    return mf;
 }
 
 }
@@ -36,7 +36,10 @@
 #ifndef CINO_MESH_SLICER_H
 #define CINO_MESH_SLICER_H
 
+#include <vector>
+#include <sys/types.h>
 #include <cinolib/symbols.h>
+#include <cinolib/meshes/poly_geometry_cache.h>
 
 namespace cinolib
 {
@@ -62,6 +65,22 @@ SlicerState;
 /* Filter mesh elements according to a number of different criteria.
  * Useful to inspect the interior of volume meshes, or to isolate
  * interesting portions of a complex surface mesh.
+ *
+ * The slicer keeps polys sorted by centroid coordinates and by quality,
+ * so that moving a threshold only re-evaluates the polys that fall between
+ * the old and the new value. Changing sign, label filter or mode triggers
+ * a full (parallel) evaluation. Both update() and reset() return the ids
+ * of the polys that changed visibility, so that callers can refresh their
+ * data incrementally.
+ *
+ * Centroids and qualities are cached (see PolyGeometryCache). Notify local
+ * changes in vertex positions or poly quality with vert_set_dirty or
+ * poly_set_dirty (drawable meshes do it in their own vert/poly_set_dirty),
+ * and global changes with set_dirty, which discards the cache and the index.
+ * Drawable meshes call set_dirty at each full updateGL(), and whenever their
+ * geometry is globally updated (update_bbox, translate, scale, rotate...).
+ * HIDDEN flags are assumed to be controlled by the slicer only: after
+ * changing them by other means, call reset() to resynchronize.
 */
 template<class Mesh>
 class MeshSlicer
@@ -74,11 +93,34 @@ class MeshSlicer
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void reset(Mesh & m);
+        std::vector<uint> reset(Mesh & m);
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void update(Mesh & m, const SlicerState & s);
+        std::vector<uint> update(Mesh & m, const SlicerState & s);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void vert_set_dirty(const Mesh & m, const uint vid);
+        void poly_set_dirty(const uint pid);
+        void set_dirty() { ready = false; } // cache and index are rebuilt at the next update
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        MemoryFootprint memory_footprint() const;
+
+    protected:
+
+        void build_index(const Mesh & m);
+        void thresholds(const Mesh & m, const SlicerState & s, double t[]) const;
+        bool poly_passes(const Mesh & m, const uint pid, const SlicerState & s, const double t[]) const;
+
+        PolyGeometryCache<Mesh> cache;
+        std::vector<uint>       order[4];  // polys sorted by centroid x,y,z and by quality...
+        std::vector<double>     keys[4];   // ...and their sorting keys
+        SlicerState             state;     // last applied state
+        double                  thresh[4]; // last applied (absolute) thresholds
+        bool                    ready = false;
 };
 
 }
@@ -0,0 +1,142 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/meshes/poly_geometry_cache.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+template<class Mesh>
+CINO_INLINE
+PolyGeometryCache<Mesh>::PolyGeometryCache(const Mesh & m)
+{
+    init(m);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void PolyGeometryCache<Mesh>::init(const Mesh & m)
+{
+    centroids.resize(m.num_polys());
+    aabbs.resize(m.num_polys());
+    qualities.resize(m.num_polys());
+    dirty.assign(m.num_polys(), 0);
+    dirty_polys.clear();
+
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        update_poly(m, pid);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void PolyGeometryCache<Mesh>::vert_set_dirty(const Mesh & m, const uint vid)
+{
+    for(uint pid : m.adj_v2p(vid)) poly_set_dirty(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void PolyGeometryCache<Mesh>::poly_set_dirty(const uint pid)
+{
+    if (pid >= dirty.size()) return; // not cached yet, will be computed at init
+    if (dirty.at(pid)) return;
+    dirty.at(pid) = 1;
+    dirty_polys.push_back(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+std::vector<uint> PolyGeometryCache<Mesh>::update(const Mesh & m)
+{
+    if (size() != m.num_polys())
+    {
+        init(m);
+        std::vector<uint> all(m.num_polys());
+        for(uint pid=0; pid<m.num_polys(); ++pid) all.at(pid) = pid;
+        return all;
+    }
+
+    PARALLEL_FOR(0, dirty_polys.size(), 1000, [&](uint i)
+    {
+        update_poly(m, dirty_polys.at(i));
+    });
+
+    std::vector<uint> updated;
+    std::swap(updated, dirty_polys);
+    for(uint pid : updated) dirty.at(pid) = 0;
+    return updated;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void PolyGeometryCache<Mesh>::update_poly(const Mesh & m, const uint pid)
+{
+    AABB bb;
+    for(uint vid : m.adj_p2v(pid)) bb.push(m.vert(vid));
+
+    centroids.at(pid) = m.poly_centroid(pid);
+    aabbs.at(pid)     = bb;
+    qualities.at(pid) = m.poly_data(pid).quality;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+MemoryFootprint PolyGeometryCache<Mesh>::memory_footprint() const
+{
+    MemoryFootprint mf;
+    mf.add("centroids",   centroids);
+    mf.add("aabbs",       aabbs);
+    mf.add("qualities",   qualities);
+    mf.add("dirty",       dirty);
+    mf.add("dirty_polys", dirty_polys);
+    return mf;
+}
+
+}
@@ -0,0 +1,103 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_POLY_GEOMETRY_CACHE_H
+#define CINO_POLY_GEOMETRY_CACHE_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/memory_footprint.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec3.h>
+#include <cinolib/geometry/aabb.h>
+
+namespace cinolib
+{
+
+/* Per poly cache of geometric quantities (centroid, bounding box and quality)
+ * for algorithms that query them many times, such as the MeshSlicer. The cache
+ * does not observe the mesh: after moving vertices or changing poly qualities,
+ * invalidate the affected elements with vert_set_dirty/poly_set_dirty and call
+ * update() to recompute them (or init() to recompute everything)
+*/
+template<class Mesh>
+class PolyGeometryCache
+{
+    public:
+
+        explicit PolyGeometryCache() {}
+
+        explicit PolyGeometryCache(const Mesh & m);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void init(const Mesh & m);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void              vert_set_dirty(const Mesh & m, const uint vid); // invalidates all polys incident to vid
+        void              poly_set_dirty(const uint pid);
+        bool              is_dirty() const { return !dirty_polys.empty(); }
+        std::vector<uint> update(const Mesh & m); // recomputes invalid polys, and returns their ids
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint          size()                    const { return centroids.size();   }
+        const vec3d & centroid(const uint pid)  const { return centroids.at(pid);  }
+        const AABB  & aabb    (const uint pid)  const { return aabbs.at(pid);      }
+        float         quality (const uint pid)  const { return qualities.at(pid);  }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        MemoryFootprint memory_footprint() const;
+
+    protected:
+
+        void update_poly(const Mesh & m, const uint pid);
+
+        std::vector<vec3d> centroids;
+        std::vector<AABB>  aabbs;
+        std::vector<float> qualities;
+        std::vector<char>  dirty;
+        std::vector<uint>  dirty_polys;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "poly_geometry_cache.cpp"
+#endif
+
+#endif // CINO_POLY_GEOMETRY_CACHE_H
@@ -36,6 +36,7 @@
 #include <cinolib/octree.h>
 #include <cinolib/how_many_seconds.h>
 #include <cinolib/parallel_for.h>
+#include <cinolib/profiler.h>
 #include <stack>
 
 namespace cinolib
@@ -87,6 +88,7 @@ Octree::~Octree()
 CINO_INLINE
 void Octree::build()
 {
+    CINO_PROFILE_SCOPE("Octree::build");
     typedef std::chrono::high_resolution_clock Time;
     Time::time_point t0 = Time::now();
 
@@ -266,6 +268,69 @@ void Octree::debug_mode(const bool b)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+MemoryFootprint Octree::memory_footprint() const
+{
+    size_t items_bytes = 0;
+    for(const SpatialDataStructureItem *it : items)
+    {
+        switch(it->item_type)
+        {
+            case SEGMENT     : items_bytes += sizeof(Segment);     break;
+            case TRIANGLE    : items_bytes += sizeof(Triangle);    break;
+            case TETRAHEDRON : items_bytes += sizeof(Tetrahedron); break;
+            default          : items_bytes += sizeof(SpatialDataStructureItem);
+        }
+    }
+
+    size_t nodes_bytes = 0;
+    size_t index_used  = 0;
+    size_t index_alloc = 0;
+    if(root!=nullptr)
+    {
+        std::stack<const OctreeNode*> q;
+        q.push(root);
+        while(!q.empty())
+        {
+            const OctreeNode *node = q.top();
+            q.pop();
+            nodes_bytes += sizeof(OctreeNode);
+            index_used  += MemoryFootprint::bytes_used(node->item_indices);
+            index_alloc += MemoryFootprint::bytes_allocated(node->item_indices);
+            for(int i=0; i<8; ++i) if(node->children[i]!=nullptr) q.push(node->children[i]);
+        }
+    }
+
+    MemoryFootprint mf;
+    mf.add("items",        items);
+    mf.add("item_objects", items_bytes, items_bytes);
+    mf.add("nodes",        nodes_bytes, nodes_bytes);
+    mf.add("item_indices", index_used, index_alloc);
+    mf.add("leaves",       leaves);
+    return mf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::shrink_to_fit()
+{
+    items.shrink_to_fit();
+    leaves.shrink_to_fit();
+    if(root==nullptr) return;
+    std::stack<OctreeNode*> q;
+    q.push(root);
+    while(!q.empty())
+    {
+        OctreeNode *node = q.top();
+        q.pop();
+        node->item_indices.shrink_to_fit();
+        for(int i=0; i<8; ++i) if(node->children[i]!=nullptr) q.push(node->children[i]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void Octree::print_query_info(const std::string & s,
                               const double        t,
@@ -507,7 +572,7 @@ bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, double & min_t,
                         {
                             Obj obj;
                             obj.node  = child;
-                            obj.index = items.at(i)->id;
+                            obj.index = i;
                             obj.dist  = t;
                             q.push(obj);
                         }
@@ -38,6 +38,7 @@
 
 #include <cinolib/geometry/spatial_data_structure_item.h>
 #include <cinolib/meshes/meshes.h>
+#include <cinolib/memory_footprint.h>
 #include <queue>
 
 namespace cinolib
@@ -168,6 +169,12 @@ class Octree
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // memory used by items, nodes and per node index lists
+        virtual MemoryFootprint memory_footprint() const;
+        virtual void            shrink_to_fit();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         void print_query_info(const std::string & s,
                               const double        t,
                               const uint          aabb_queries,
@@ -37,6 +37,7 @@
 #include <thread>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -96,4 +97,52 @@ static void PARALLEL_FOR(      uint   beg,
 #endif
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+static void PARALLEL_PREFIX_SUM(      std::vector<T> & v,
+                                const uint             serial_if_less_than)
+{
+    uint n = v.size();
+
+#ifndef SERIALIZE_PARALLEL_FOR
+    if(n>=serial_if_less_than && n>1)
+    {
+        const static unsigned n_threads_hint = std::thread::hardware_concurrency();
+        const static unsigned n_threads      = (n_threads_hint==0u) ? 8u : n_threads_hint;
+
+        uint n_chunks = std::min(n_threads, n);
+        uint chunk    = (n + n_chunks - 1) / n_chunks;
+
+        // scan each chunk independently
+        std::vector<T> sums(n_chunks, T(0));
+        PARALLEL_FOR(0, n_chunks, 0, [&](uint c)
+        {
+            uint beg = c*chunk;
+            uint end = std::min(beg+chunk, n);
+            T    sum = T(0);
+            for(uint i=beg; i<end; ++i)
+            {
+                sum += v[i];
+                v[i] = sum;
+            }
+            sums[c] = sum;
+        });
+
+        // offset of each chunk
+        for(uint c=1; c<n_chunks; ++c) sums[c] += sums[c-1];
+
+        PARALLEL_FOR(1, n_chunks, 0, [&](uint c)
+        {
+            uint beg = c*chunk;
+            uint end = std::min(beg+chunk, n);
+            for(uint i=beg; i<end; ++i) v[i] += sums[c-1];
+        });
+        return;
+    }
+#endif
+    for(uint i=1; i<n; ++i) v[i] += v[i-1];
+}
+
 }
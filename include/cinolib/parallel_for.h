@@ -37,6 +37,7 @@
 #define CINO_PARALLEL_FOR_H
 
 #include <sys/types.h>
+#include <vector>
 #include <cinolib/cino_inline.h>
 
 namespace cinolib
@@ -73,12 +74,37 @@ namespace cinolib
  * the loop will be executed in standard serial mode.
 */
 
+// Grain sizes (i.e. serial_if_less_than thresholds) for whole mesh updates. Below
+// these sizes loops run serially, because the per element work does not pay off the
+// overhead of spawning threads. Light kernels (e.g. normals) need larger ranges than
+// heavy ones (e.g. polygon tessellation, element quality)
+static const uint PARALLEL_GRAIN_LIGHT = 10000;
+static const uint PARALLEL_GRAIN_HEAVY = 1000;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<typename Func>
 CINO_INLINE
 static void PARALLEL_FOR(      uint   beg,
                                uint   end,
                          const uint   serial_if_less_than,
                          const Func & func);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* In place inclusive prefix sum (v[i] = v[0] + ... + v[i]), typically used
+ * to convert per element counts into offsets. The vector is split into one
+ * chunk per thread: chunks are scanned in parallel, their totals accumulated
+ * serially, and then added back to each chunk in parallel.
+ *
+ * NOTE: if symbol SERIALIZE_PARALLEL_FOR is defined at compilation time,
+ * the scan will be executed in standard serial mode.
+*/
+
+template<typename T>
+CINO_INLINE
+static void PARALLEL_PREFIX_SUM(      std::vector<T> & v,
+                                const uint             serial_if_less_than);
 }
 
 #ifndef  CINO_STATIC_LIB
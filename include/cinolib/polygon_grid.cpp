@@ -0,0 +1,322 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/polygon_grid.h>
+#include <cinolib/predicates.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <cmath>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void PolygonGrid::build(const std::vector<vec2d> & verts,
+                        const std::vector<uint>  & edges,
+                        const uint                 edges_per_cell)
+{
+    clear();
+    if(edges.empty()) return;
+    assert(edges.size()%2==0);
+
+    this->verts = verts;
+    this->edges = edges;
+
+    bb_min = vec2d( inf_double,  inf_double);
+    bb_max = vec2d(-inf_double, -inf_double);
+    for(uint vid : edges)
+    {
+        bb_min = bb_min.min(verts.at(vid));
+        bb_max = bb_max.max(verts.at(vid));
+    }
+
+    // choose the resolution so as to have roughly square cells, and about
+    // edges_per_cell edges per cell. Degenerate (flat) boxes get one row/column
+    vec2d  delta   = bb_max - bb_min;
+    double n_cells = std::max(1.0, static_cast<double>(num_edges())/std::max(1u,edges_per_cell));
+    if(delta.x()>0 && delta.y()>0)
+    {
+        nx = std::max(1.0, std::round(std::sqrt(n_cells * delta.x()/delta.y())));
+        ny = std::max(1.0, std::round(n_cells/nx));
+    }
+    else if(delta.x()>0) { nx = n_cells; ny = 1; }
+    else if(delta.y()>0) { nx = 1; ny = n_cells; }
+    else                 { nx = 1; ny = 1;       }
+    cell_size = vec2d((delta.x()>0) ? delta.x()/nx : 1.0,
+                      (delta.y()>0) ? delta.y()/ny : 1.0);
+
+    // bin edges in cells and rows (CSR). First pass counts, second pass fills
+    cell_beg.assign(nx*ny+1, 0);
+    row_beg.assign(ny+1, 0);
+    for(uint eid=0; eid<num_edges(); ++eid)
+    {
+        for_each_cell(eid, [&](const uint i, const uint j){ ++cell_beg.at(j*nx+i+1); },
+                           [&](const uint j)               { ++row_beg.at(j+1);        });
+    }
+    for(uint c=0; c<nx*ny; ++c) cell_beg.at(c+1) += cell_beg.at(c);
+    for(uint j=0; j<ny;    ++j) row_beg.at(j+1)  += row_beg.at(j);
+
+    cell_edges.resize(cell_beg.back());
+    row_edges.resize(row_beg.back());
+    std::vector<uint> cell_pos(cell_beg.begin(), cell_beg.end()-1);
+    std::vector<uint> row_pos (row_beg.begin(),  row_beg.end()-1);
+    for(uint eid=0; eid<num_edges(); ++eid)
+    {
+        for_each_cell(eid, [&](const uint i, const uint j){ cell_edges.at(cell_pos.at(j*nx+i)++) = eid; },
+                           [&](const uint j)               { row_edges.at(row_pos.at(j)++)         = eid; });
+    }
+
+    classify_centers();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PolygonGrid::clear()
+{
+    nx = ny = 0;
+    verts.clear();
+    edges.clear();
+    cell_beg.clear();
+    cell_edges.clear();
+    row_beg.clear();
+    row_edges.clear();
+    center.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool PolygonGrid::contains(const vec2d & p, const bool border_counts) const
+{
+    if(empty()) return false;
+    if(p.x()<bb_min.x() || p.x()>bb_max.x() ||
+       p.y()<bb_min.y() || p.y()>bb_max.y()) return false;
+
+    uint i = cell_x(p.x());
+    uint j = cell_y(p.y());
+    uint c = j*nx+i;
+
+    // edges passing through p are necessarily binned in its cell
+    for(uint k=cell_beg.at(c); k<cell_beg.at(c+1); ++k)
+    {
+        if(on_edge(cell_edges.at(k), p)) return border_counts;
+    }
+
+    if(center.at(c)==ON_BORDER) return ray_cast(j,p);
+
+    // count the crossings between the edges in the cell and the segment
+    // connecting p to the center of the cell (whose status is known)
+    vec2d o      = cell_center(i,j);
+    bool  inside = (center.at(c)==INSIDE);
+    for(uint k=cell_beg.at(c); k<cell_beg.at(c+1); ++k)
+    {
+        uint          eid = cell_edges.at(k);
+        const vec2d & a   = verts.at(edges.at(2*eid  ));
+        const vec2d & b   = verts.at(edges.at(2*eid+1));
+        double o_a = orient2d(o,p,a);
+        double o_b = orient2d(o,p,b);
+
+        // the segment passes through a vertex: parity is ill defined
+        if(o_a==0 && a.x()>=std::min(o.x(),p.x()) && a.x()<=std::max(o.x(),p.x()) &&
+                     a.y()>=std::min(o.y(),p.y()) && a.y()<=std::max(o.y(),p.y())) return ray_cast(j,p);
+        if(o_b==0 && b.x()>=std::min(o.x(),p.x()) && b.x()<=std::max(o.x(),p.x()) &&
+                     b.y()>=std::min(o.y(),p.y()) && b.y()<=std::max(o.y(),p.y())) return ray_cast(j,p);
+
+        if((o_a>0 && o_b<0) || (o_a<0 && o_b>0))
+        {
+            double o_o = orient2d(a,b,o);
+            double o_p = orient2d(a,b,p);
+            if((o_o>0 && o_p<0) || (o_o<0 && o_p>0)) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PolygonGrid::contains(const std::vector<vec2d> & points,
+                                 std::vector<bool>  & res,
+                           const bool                 border_counts) const
+{
+    // std::vector<bool> packs bits, and cannot be written concurrently
+    std::vector<uint8_t> tmp(points.size());
+    PARALLEL_FOR(0, points.size(), 1000, [&](uint i)
+    {
+        tmp.at(i) = contains(points.at(i), border_counts);
+    });
+    res.assign(tmp.begin(), tmp.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint PolygonGrid::cell_x(const double x) const
+{
+    double i = std::floor((x - bb_min.x())/cell_size.x());
+    return static_cast<uint>(std::min(std::max(i, 0.0), static_cast<double>(nx-1)));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint PolygonGrid::cell_y(const double y) const
+{
+    double j = std::floor((y - bb_min.y())/cell_size.y());
+    return static_cast<uint>(std::min(std::max(j, 0.0), static_cast<double>(ny-1)));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool PolygonGrid::on_edge(const uint eid, const vec2d & p) const
+{
+    const vec2d & a = verts.at(edges.at(2*eid  ));
+    const vec2d & b = verts.at(edges.at(2*eid+1));
+    return p.x()>=std::min(a.x(),b.x()) && p.x()<=std::max(a.x(),b.x()) &&
+           p.y()>=std::min(a.y(),b.y()) && p.y()<=std::max(a.y(),b.y()) &&
+           orient2d(a,b,p)==0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool PolygonGrid::ray_cast(const uint row, const vec2d & p) const
+{
+    // edges crossing the horizontal line through p are necessarily binned in its row
+    // (same crossing rule of polygon_contains(), in geometry/polygon_utils.h)
+    bool inside = false;
+    for(uint k=row_beg.at(row); k<row_beg.at(row+1); ++k)
+    {
+        uint          eid = row_edges.at(k);
+        const vec2d & a   = verts.at(edges.at(2*eid  ));
+        const vec2d & b   = verts.at(edges.at(2*eid+1));
+        if((a.y() > p.y()) != (b.y() > p.y()) &&
+           p.x() < a.x() + (b.x()-a.x()) * (p.y()-a.y()) / (b.y()-a.y()))
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec2d PolygonGrid::cell_center(const uint i, const uint j) const
+{
+    return vec2d(bb_min.x() + (i+0.5)*cell_size.x(),
+                 bb_min.y() + (j+0.5)*cell_size.y());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void PolygonGrid::classify_centers()
+{
+    // all the centers of a row lie on the same horizontal line: sort
+    // the crossings once, and classify them with a binary search each
+    center.resize(nx*ny);
+    PARALLEL_FOR(0, ny, 64, [&](uint j)
+    {
+        double y = cell_center(0,j).y();
+        std::vector<double> crossings;
+        for(uint k=row_beg.at(j); k<row_beg.at(j+1); ++k)
+        {
+            uint          eid = row_edges.at(k);
+            const vec2d & a   = verts.at(edges.at(2*eid  ));
+            const vec2d & b   = verts.at(edges.at(2*eid+1));
+            if((a.y() > y) != (b.y() > y))
+            {
+                crossings.push_back(a.x() + (b.x()-a.x()) * (y-a.y()) / (b.y()-a.y()));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        for(uint i=0; i<nx; ++i)
+        {
+            vec2d o = cell_center(i,j);
+            uint  c = j*nx+i;
+            uint  n = crossings.end() - std::upper_bound(crossings.begin(), crossings.end(), o.x());
+            center.at(c) = (n%2==1) ? INSIDE : OUTSIDE;
+            for(uint k=cell_beg.at(c); k<cell_beg.at(c+1); ++k)
+            {
+                if(on_edge(cell_edges.at(k), o)) { center.at(c) = ON_BORDER; break; }
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename CellFunc, typename RowFunc>
+CINO_INLINE
+void PolygonGrid::for_each_cell(const uint eid, const CellFunc & cell_func, const RowFunc & row_func) const
+{
+    const vec2d & a = verts.at(edges.at(2*eid  ));
+    const vec2d & b = verts.at(edges.at(2*eid+1));
+
+    // cells are closed, and slightly enlarged to be robust against round off
+    // in the computation of the cell of a point. Binning is therefore conservative
+    double pad_x = 1e-6*cell_size.x();
+    double pad_y = 1e-6*cell_size.y();
+
+    uint j_min = cell_y(std::min(a.y(),b.y()) - pad_y);
+    uint j_max = cell_y(std::max(a.y(),b.y()) + pad_y);
+    for(uint j=j_min; j<=j_max; ++j)
+    {
+        row_func(j);
+
+        // portion of the edge within the row
+        double x0 = a.x();
+        double x1 = b.x();
+        if(a.y()!=b.y())
+        {
+            double y_lo = bb_min.y() +  j   *cell_size.y() - pad_y;
+            double y_hi = bb_min.y() + (j+1)*cell_size.y() + pad_y;
+            double t0   = std::min(std::max((y_lo - a.y())/(b.y()-a.y()), 0.0), 1.0);
+            double t1   = std::min(std::max((y_hi - a.y())/(b.y()-a.y()), 0.0), 1.0);
+            x0 = a.x() + t0*(b.x()-a.x());
+            x1 = a.x() + t1*(b.x()-a.x());
+        }
+        uint i_min = cell_x(std::min(x0,x1) - pad_x);
+        uint i_max = cell_x(std::max(x0,x1) + pad_x);
+        for(uint i=i_min; i<=i_max; ++i) cell_func(i,j);
+    }
+}
+
+}
@@ -0,0 +1,139 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_POLYGON_GRID_H
+#define CINO_POLYGON_GRID_H
+
+#include <cinolib/geometry/vec2.h>
+#include <sys/types.h>
+#include <vector>
+#include <stdint.h>
+
+namespace cinolib
+{
+
+/* Uniform grid of edge bins for fast point in polygon queries on planar regions
+ * bounded by a set of closed rings (e.g. the outer and inner boundaries of a multi
+ * polygon). Each cell stores the edges that intersect it, and the inside/outside
+ * status of its center. A point is classified by counting the crossings between
+ * the edges in its cell and the segment connecting it to the cell center, hence
+ * queries cost O(edges per cell) instead of O(edges). Degenerate configurations
+ * (e.g. the segment passing through a vertex) are resolved with a standard ray
+ * casting restricted to the edges that span the row of the cell.
+ *
+ * The region is interpreted with the even-odd rule. Queries are thread safe, and
+ * can be issued in parallel.
+ *
+ * Usage:
+ *
+ *     std::vector<vec2d> verts;
+ *     std::vector<uint>  edges;
+ *     polygon_get_edges(multi_poly, verts, edges);
+ *     PolygonGrid grid;
+ *     grid.build(verts, edges);
+ *     bool inside = grid.contains(p);
+*/
+
+class PolygonGrid
+{
+    public:
+
+        explicit PolygonGrid() {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // edges are stored as a serialized list of vertex pairs. The grid has
+        // roughly one cell every edges_per_cell edges
+        void build(const std::vector<vec2d> & verts,
+                   const std::vector<uint>  & edges,
+                   const uint                 edges_per_cell = 2);
+
+        void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool empty()     const { return edges.empty();     }
+        uint num_edges() const { return edges.size()/2;    }
+        uint num_cells() const { return nx*ny;             }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // points lying on the boundary are inside iff border_counts is true
+        bool contains(const vec2d & p, const bool border_counts = true) const;
+
+        // batch version. Points are classified in parallel
+        void contains(const std::vector<vec2d> & points,
+                            std::vector<bool>  & res,
+                      const bool                 border_counts = true) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint cell_x(const double x) const;
+        uint cell_y(const double y) const;
+
+    protected:
+
+        bool  on_edge           (const uint eid, const vec2d & p) const;
+        bool  ray_cast          (const uint row, const vec2d & p) const;
+        vec2d cell_center       (const uint i, const uint j) const;
+        void  classify_centers  ();
+
+        // calls cell_func(i,j) for each cell and row_func(j) for each row intersected by edge eid
+        template<typename CellFunc, typename RowFunc>
+        void for_each_cell(const uint eid, const CellFunc & cell_func, const RowFunc & row_func) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        enum { OUTSIDE = 0, INSIDE = 1, ON_BORDER = 2 };
+
+        vec2d              bb_min, bb_max;  // bounding box of the vertices
+        vec2d              cell_size;
+        uint               nx = 0, ny = 0;  // grid resolution
+        std::vector<vec2d> verts;
+        std::vector<uint>  edges;
+        std::vector<uint>  cell_beg;        // cell => [cell_beg[c],cell_beg[c+1]) range in cell_edges
+        std::vector<uint>  cell_edges;
+        std::vector<uint>  row_beg;         // row  => [row_beg[j],row_beg[j+1]) range in row_edges
+        std::vector<uint>  row_edges;
+        std::vector<uint8_t> center;        // per cell status of the cell center
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "polygon_grid.cpp"
+#endif
+
+#endif // CINO_POLYGON_GRID_H
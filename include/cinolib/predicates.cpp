@@ -1034,8 +1034,8 @@ SimplexIntersection triangle_triangle_intersect_2d(const double * t00,
     // Otherwise they are verte-adjacent and form a valid simplicial complex
     if(t0_count == 1 && t1_count == 1)
     {
-        uint v0; // index of the shared vertex in t0
-        uint v1; // index of the shared vertex in t1
+        uint v0 = 0; // index of the shared vertex in t0
+        uint v1 = 0; // index of the shared vertex in t1
         for(uint i = 0; i < 3; ++i)
         {
             if(t0_shared[i]) v0 = i;
@@ -1197,8 +1197,8 @@ SimplexIntersection triangle_triangle_intersect_3d(const double * t00,
     // Otherwise they are vertex-adjacent and form a valid simplicial complex
     if(t0_count == 1)
     {
-        uint v0; // index of the shared vertex in t0
-        uint v1; // index of the shared vertex in t1
+        uint v0 = 0; // index of the shared vertex in t0
+        uint v1 = 0; // index of the shared vertex in t1
         for(uint i = 0; i < 3; ++i)
         {
             if(t0_shared[i]) v0 = i;
@@ -35,6 +35,9 @@
 *********************************************************************************/
 #include <cinolib/profiler.h>
 #include <cinolib/cino_inline.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
 #include <set>
 #include <iostream>
 
@@ -119,4 +122,237 @@ double Profiler::delta_s(const uint id) const
     return delta.count();
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::chrono::steady_clock::time_point ProfilerTrace::epoch()
+{
+    static const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    return t0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t ProfilerTrace::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now() - epoch()).count();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::mutex & ProfilerTrace::registry_mutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<ProfilerThreadBuffer*> & ProfilerTrace::buffers()
+{
+    // buffers are never released, so that events recorded by threads that
+    // already terminated remain available, and so that the thread local
+    // pointers below never dangle (not even during static destruction)
+    static std::vector<ProfilerThreadBuffer*> *b = new std::vector<ProfilerThreadBuffer*>();
+    return *b;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ProfilerThreadBuffer & ProfilerTrace::thread_buffer()
+{
+    static thread_local ProfilerThreadBuffer *buf = nullptr;
+    if(buf==nullptr)
+    {
+        epoch(); // make sure the time origin precedes any event
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        buf = new ProfilerThreadBuffer();
+        buf->thread_id = buffers().size();
+        buffers().push_back(buf);
+    }
+    return *buf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ProfilerTrace::clear()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for(ProfilerThreadBuffer *buf : buffers()) buf->events.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint ProfilerTrace::num_events()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    uint count = 0;
+    for(const ProfilerThreadBuffer *buf : buffers()) count += buf->events.size();
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<ProfilerEvent> ProfilerTrace::sorted_events(const ProfilerThreadBuffer & buf)
+{
+    // events are stored when scopes close (i.e. children before fathers).
+    // Sorting by start time (and depth, to break ties) restores the call order
+    std::vector<ProfilerEvent> events(buf.events.begin(), buf.events.end());
+    std::sort(events.begin(), events.end(), [](const ProfilerEvent & a, const ProfilerEvent & b)
+    {
+        return (a.begin<b.begin) || (a.begin==b.begin && a.depth<b.depth);
+    });
+    return events;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::string ProfilerTrace::json_escape(const char *key)
+{
+    std::string s;
+    for(const char *c=key; *c!='\0'; ++c)
+    {
+        if(*c=='"' || *c=='\\') s += '\\';
+        s += *c;
+    }
+    return s;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ProfilerTrace::write_chrome_trace(const std::string & filename)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    std::ofstream f(filename.c_str());
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_chrome_trace() : couldn't open output file " << filename << std::endl;
+        return;
+    }
+
+    f << std::fixed << std::setprecision(3);
+    f << "{\"traceEvents\":[\n";
+    bool first = true;
+    for(const ProfilerThreadBuffer *buf : buffers())
+    {
+        f << (first ? "" : ",\n")
+          << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buf->thread_id
+          << ",\"args\":{\"name\":\"thread " << buf->thread_id << "\"}}";
+        first = false;
+
+        for(const ProfilerEvent & e : sorted_events(*buf))
+        {
+            f << ",\n{\"name\":\"" << json_escape(e.key) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buf->thread_id
+              << ",\"ts\":"  << 1e-3 * e.begin
+              << ",\"dur\":" << 1e-3 * (e.end - e.begin) << "}";
+        }
+    }
+    f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ProfilerTrace::write_folded_stacks(const std::string & filename)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    std::map<std::string,uint64_t> self_time; // ns, per call path
+    for(const ProfilerThreadBuffer *buf : buffers())
+    {
+        std::vector<ProfilerEvent> events = sorted_events(*buf);
+        std::vector<std::string>   paths(events.size());
+        std::vector<uint64_t>      self (events.size());
+        std::vector<uint>          stack;
+        for(uint i=0; i<events.size(); ++i)
+        {
+            const ProfilerEvent & e = events.at(i);
+            self.at(i) = e.end - e.begin;
+            // events that were open when recording started have no father
+            while(!stack.empty() && events.at(stack.back()).depth >= e.depth) stack.pop_back();
+            if(!stack.empty())
+            {
+                uint father = stack.back();
+                self.at(father) -= std::min(self.at(father), self.at(i));
+                paths.at(i) = paths.at(father) + ";";
+            }
+            paths.at(i) += e.key;
+            stack.push_back(i);
+        }
+        for(uint i=0; i<events.size(); ++i) self_time[paths.at(i)] += self.at(i);
+    }
+
+    std::ofstream f(filename.c_str());
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_folded_stacks() : couldn't open output file " << filename << std::endl;
+        return;
+    }
+    for(const auto & obj : self_time)
+    {
+        uint64_t us = obj.second/1000;
+        if(us>0) f << obj.first << " " << us << "\n";
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ProfilerTrace::report()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    // open counts the enclosing scopes with the same key: recursive calls
+    // contribute to the total time only at their outermost level
+    struct Stats { uint calls = 0, open = 0; double total = 0, self = 0; };
+    std::map<std::string,Stats> stats;
+    for(const ProfilerThreadBuffer *buf : buffers())
+    {
+        std::vector<ProfilerEvent> events = sorted_events(*buf);
+        std::vector<uint> stack;
+        for(uint i=0; i<events.size(); ++i)
+        {
+            const ProfilerEvent & e = events.at(i);
+            while(!stack.empty() && events.at(stack.back()).depth >= e.depth)
+            {
+                stats[events.at(stack.back()).key].open -= 1;
+                stack.pop_back();
+            }
+            double t = 1e-9 * (e.end - e.begin);
+            Stats & s = stats[e.key];
+            s.calls += 1;
+            s.self  += t;
+            if(s.open==0) s.total += t;
+            if(!stack.empty()) stats[events.at(stack.back()).key].self -= t;
+            s.open += 1;
+            stack.push_back(i);
+        }
+        for(uint i : stack) stats[events.at(i).key].open -= 1;
+    }
+
+    std::set<std::pair<double,std::string>,std::greater<std::pair<double,std::string>>> ordered_items; // most time consuming first
+    for(const auto & obj : stats) ordered_items.insert(std::make_pair(obj.second.total,obj.first));
+
+    std::cout << "::::::::::::::: PROFILER TRACE (" << buffers().size() << " threads) :::::::::::::::" << std::endl;
+    for(const auto & obj : ordered_items)
+    {
+        const Stats & s = stats.at(obj.second);
+        std::cout << s.total << "s\t(self " << s.self << "s)\t" << obj.second << " (called " << s.calls << " times)" << std::endl;
+    }
+    std::cout << ":::::::::::::::::::::::::::::::::::::::::::::::::::\n" << std::endl;
+}
+
 }
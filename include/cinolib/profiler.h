@@ -38,7 +38,10 @@
 
 #include <cinolib/tree.h>
 #include <chrono>
+#include <cstdint>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
 
 namespace cinolib
@@ -86,6 +89,139 @@ class Profiler
         uint                         tree_ptr;
 };
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Scoped instrumentation of the library. Differently from the Profiler above,
+ * which is meant for interactive use in the examples, this machinery is thread
+ * safe and cheap enough to be left in the core routines. It is compiled in only
+ * if CINOLIB_PROFILER_ENABLED is defined, otherwise the macros below expand to
+ * nothing. Usage:
+ *
+ *     void my_function()
+ *     {
+ *         CINO_PROFILE_SCOPE("my_function");
+ *         ...
+ *         {
+ *             CINO_PROFILE_SCOPE("my_function::inner_loop");
+ *             ...
+ *         }
+ *     }
+ *
+ *     ProfilerTrace::write_chrome_trace("trace.json"); // chrome://tracing, Perfetto, Speedscope
+ *     ProfilerTrace::write_folded_stacks("trace.txt"); // flamegraph.pl, Speedscope
+ *     ProfilerTrace::report();                         // per key statistics
+ *
+ * Keys are NOT copied, hence they must have static storage (string literals).
+ * Each thread appends its events to its own buffer, with no locking (the global
+ * registry is accessed only the first time a thread records an event). Buffers
+ * are read by the output routines, which must not run concurrently with any
+ * instrumented code.
+*/
+
+#ifdef CINOLIB_PROFILER_ENABLED
+#define CINO_PROFILE_CONCAT_IMPL(a,b) a##b
+#define CINO_PROFILE_CONCAT(a,b)      CINO_PROFILE_CONCAT_IMPL(a,b)
+#define CINO_PROFILE_SCOPE(key)       cinolib::ProfilerScope CINO_PROFILE_CONCAT(cino_profile_scope_,__LINE__)(key)
+#define CINO_PROFILE_FUNCTION()       CINO_PROFILE_SCOPE(__func__)
+#else
+#define CINO_PROFILE_SCOPE(key)
+#define CINO_PROFILE_FUNCTION()
+#endif
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+typedef struct
+{
+    const char *key;
+    uint64_t    begin; // nanoseconds since ProfilerTrace::epoch()
+    uint64_t    end;
+    uint        depth; // nesting level within the thread
+}
+ProfilerEvent;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+typedef struct
+{
+    uint                      thread_id; // progressive, in order of first use
+    uint                      depth = 0; // number of open scopes
+    std::deque<ProfilerEvent> events;    // a deque never relocates its items
+}
+ProfilerThreadBuffer;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class ProfilerTrace
+{
+    public:
+
+        static uint64_t now(); // nanoseconds since epoch()
+        static std::chrono::steady_clock::time_point epoch();
+
+        // buffer of the calling thread (registered at first use)
+        static ProfilerThreadBuffer & thread_buffer();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        static void clear();
+        static uint num_events();
+
+        // complete events ("ph":"X") in the Chrome Trace Event format
+        static void write_chrome_trace(const std::string & filename);
+
+        // one line per call path ("root;child;grandchild self_time_us"),
+        // merging all threads. This is the input of flamegraph.pl
+        static void write_folded_stacks(const std::string & filename);
+
+        // calls, total and self time for each key, most time consuming first.
+        // Time spent in recursive calls of the same key is counted once
+        static void report();
+
+    protected:
+
+        static std::mutex                          & registry_mutex();
+        static std::vector<ProfilerThreadBuffer*> & buffers();
+        static std::vector<ProfilerEvent> sorted_events(const ProfilerThreadBuffer & buf);
+        static std::string                json_escape(const char *key);
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class ProfilerScope
+{
+    public:
+
+        explicit ProfilerScope(const char *key) : buf(ProfilerTrace::thread_buffer())
+        {
+            this->key = key;
+            depth     = buf.depth++;
+            begin     = ProfilerTrace::now();
+        }
+
+        ~ProfilerScope()
+        {
+            ProfilerEvent e;
+            e.key   = key;
+            e.begin = begin;
+            e.end   = ProfilerTrace::now();
+            e.depth = depth;
+            buf.events.push_back(e);
+            --buf.depth;
+        }
+
+        ProfilerScope(const ProfilerScope &) = delete;
+        ProfilerScope & operator=(const ProfilerScope &) = delete;
+
+    protected:
+
+        ProfilerThreadBuffer & buf;
+        const char           *key;
+        uint64_t              begin;
+        uint                  depth;
+};
+
 }
 
 #ifndef  CINO_STATIC_LIB
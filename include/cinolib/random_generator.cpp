@@ -34,6 +34,9 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/random_generator.h>
+#include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
+#include <cmath>
 
 namespace cinolib
 {
@@ -84,4 +87,196 @@ double random_double(const  uint seed, const double min, const double max)
     return (max-min)*random_uint(seed)/static_cast<double>(max_uint) + min;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::array<uint32_t,4> philox4x32(const std::array<uint32_t,4> & ctr,
+                                  const std::array<uint32_t,2> & key)
+{
+    std::array<uint32_t,4> c = ctr;
+    std::array<uint32_t,2> k = key;
+    for(int round=0; round<10; ++round)
+    {
+        uint64_t p0 = uint64_t(0xD2511F53u) * c[0];
+        uint64_t p1 = uint64_t(0xCD9E8D57u) * c[2];
+        c = {{ uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1),
+               uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0) }};
+        k[0] += 0x9E3779B9u;
+        k[1] += 0xBB67AE85u;
+    }
+    return c;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+RandomStream::RandomStream(const uint64_t seed, const uint64_t stream_id)
+    : key({{ uint32_t(seed), uint32_t(seed >> 32) }})
+    , id(stream_id)
+    , pos(0)
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+RandomStream RandomStream::split(const uint64_t sub_id) const
+{
+    // the id of the child stream is a random function of the parent id and
+    // of sub_id, computed with a different key to decorrelate it from the
+    // values drawn by the parent
+    std::array<uint32_t,2> k = {{ key[0] ^ 0x5851F42Du, key[1] ^ 0x4C957F2Du }};
+    std::array<uint32_t,4> r = philox4x32({{ uint32_t(sub_id), uint32_t(sub_id >> 32), uint32_t(id), uint32_t(id >> 32) }}, k);
+    RandomStream child(0, (uint64_t(r[1]) << 32) | r[0]);
+    child.key = key;
+    return child;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::array<uint32_t,4> RandomStream::block_at(const uint64_t b) const
+{
+    return philox4x32({{ uint32_t(b), uint32_t(b >> 32), uint32_t(id), uint32_t(id >> 32) }}, key);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint32_t RandomStream::uint_at(const uint64_t i) const
+{
+    return block_at(i/4)[i%4];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double RandomStream::double_at(const uint64_t i) const
+{
+    return (uint_at(i) + 0.5) * (1.0/4294967296.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double RandomStream::normal_at(const uint64_t i) const
+{
+    std::array<uint32_t,4> b = block_at(i/2);
+    uint   off = 2*(i%2);
+    double u1  = (b[off  ] + 0.5) * (1.0/4294967296.0);
+    double u2  = (b[off+1] + 0.5) * (1.0/4294967296.0);
+    return std::sqrt(-2.0*std::log(u1)) * std::cos(2.0*M_PI*u2);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint32_t RandomStream::next_uint()
+{
+    return uint_at(pos++);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double RandomStream::next_double()
+{
+    return double_at(pos++);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double RandomStream::next_double(const double min, const double max)
+{
+    return min + (max-min)*next_double();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double RandomStream::next_normal()
+{
+    // normal variates use aligned pairs of draws
+    pos += pos%2;
+    double n = normal_at(pos/2);
+    pos += 2;
+    return n;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+double RandomStream::next_normal(const double mean, const double std_dev)
+{
+    return mean + std_dev*next_normal();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T, typename Conv>
+CINO_INLINE
+void RandomStream::fill(std::vector<T> & v, const uint per_block, const Conv & conv) const
+{
+    // each philox block yields per_block values. If the first value is aligned to
+    // a block boundary blocks are computed once, otherwise values are computed one
+    // by one (conv(block,offset) converts the offset-th value of a block)
+    uint64_t first = pos/(4/per_block);
+    PARALLEL_FOR(0, (v.size()+per_block-1)/per_block, 1000, [&](uint b)
+    {
+        uint end = std::min<uint64_t>(per_block*(b+1), v.size());
+        if(first%per_block==0)
+        {
+            std::array<uint32_t,4> r = block_at(first/per_block + b);
+            for(uint i=per_block*b; i<end; ++i) v[i] = conv(r, i-per_block*b);
+        }
+        else
+        {
+            for(uint i=per_block*b; i<end; ++i)
+            {
+                uint64_t k = first + i;
+                v[i] = conv(block_at(k/per_block), k%per_block);
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void RandomStream::fill_uint(std::vector<uint32_t> & v)
+{
+    fill(v, 4, [](const std::array<uint32_t,4> & r, const uint off) -> uint32_t
+    {
+        return r[off];
+    });
+    pos += v.size();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void RandomStream::fill_double(std::vector<double> & v)
+{
+    fill(v, 4, [](const std::array<uint32_t,4> & r, const uint off) -> double
+    {
+        return (r[off] + 0.5) * (1.0/4294967296.0);
+    });
+    pos += v.size();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void RandomStream::fill_normal(std::vector<double> & v)
+{
+    pos += pos%2;
+    fill(v, 2, [](const std::array<uint32_t,4> & r, const uint off) -> double
+    {
+        double u1 = (r[2*off  ] + 0.5) * (1.0/4294967296.0);
+        double u2 = (r[2*off+1] + 0.5) * (1.0/4294967296.0);
+        return std::sqrt(-2.0*std::log(u1)) * std::cos(2.0*M_PI*u2);
+    });
+    pos += 2*v.size();
+}
+
 }
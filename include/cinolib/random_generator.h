@@ -38,6 +38,9 @@
 
 #include <cinolib/cino_inline.h>
 #include <sys/types.h>
+#include <stdint.h>
+#include <array>
+#include <vector>
 
 namespace cinolib
 {
@@ -69,6 +72,96 @@ double random_double(const uint seed);
 CINO_INLINE
 double random_double(const  uint seed, const double min, const double max);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Philox4x32-10 counter based random number generator, from:
+ *
+ * Parallel Random Numbers: As Easy as 1, 2, 3
+ * J.K. Salmon, M.A. Moraes, R.O. Dror, D.E. Shaw
+ * Supercomputing (SC), 2011
+ *
+ * It maps a 128 bits counter and a 64 bits key to four 32 bits random words.
+ * There is no internal state: any element of any sequence can be computed
+ * directly, which is what makes parallel sampling reproducible.
+*/
+
+CINO_INLINE
+std::array<uint32_t,4> philox4x32(const std::array<uint32_t,4> & ctr,
+                                  const std::array<uint32_t,2> & key);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Stream of random numbers generated with philox4x32. A stream is identified by
+ * a seed (the key) and a 64 bits stream id (half of the counter), the other half
+ * of the counter being the position along the stream. Therefore:
+ *
+ *  - split(id) gives a new, independent stream (e.g. one per thread, per element
+ *    or per iteration). Results depend only on the ids, not on the thread count;
+ *  - *_at(i) gives the i-th 32 bits draw of the stream, without changing its state
+ *    (block_at(b) gives four consecutive draws, at the cost of a single one);
+ *  - fill_*() generate long sequences in parallel, with the same values that
+ *    the equivalent sequence of next_*() calls would produce.
+ *
+ * Uniform doubles lie in (0,1) and have 32 bits of resolution. Normal variates
+ * are obtained with the Box-Muller transform, and take two draws each.
+ *
+ * Usage:
+ *
+ *     RandomStream rs(seed);
+ *     PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+ *     {
+ *         RandomStream prs = rs.split(pid);
+ *         double u = prs.next_double();
+ *         ...
+ *     });
+*/
+
+class RandomStream
+{
+    public:
+
+        explicit RandomStream(const uint64_t seed = 0, const uint64_t stream_id = 0);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        RandomStream split(const uint64_t sub_id) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint32_t next_uint();
+        double   next_double();
+        double   next_double(const double min, const double max);
+        double   next_normal();
+        double   next_normal(const double mean, const double std_dev);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint32_t               uint_at  (const uint64_t i) const;
+        double                 double_at(const uint64_t i) const;
+        double                 normal_at(const uint64_t i) const; // uses draws 2i and 2i+1
+        std::array<uint32_t,4> block_at (const uint64_t b) const; // draws 4b...4b+3
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void fill_uint  (std::vector<uint32_t> & v);
+        void fill_double(std::vector<double>   & v);
+        void fill_normal(std::vector<double>   & v);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint64_t position() const { return pos; } // number of draws consumed so far
+        void     skip(const uint64_t n_draws) { pos += n_draws; }
+
+    protected:
+
+        template<typename T, typename Conv>
+        void fill(std::vector<T> & v, const uint per_block, const Conv & conv) const;
+
+        std::array<uint32_t,2> key;
+        uint64_t               id;
+        uint64_t               pos;
+};
+
 }
 
 #ifndef  CINO_STATIC_LIB
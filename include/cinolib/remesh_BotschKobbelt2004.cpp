@@ -34,7 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/remesh_BotschKobbelt2004.h>
-#include <cinolib/tangential_smoothing.h>
+#include <cinolib/laplacian_smoothing.h>
 
 namespace cinolib
 {
@@ -49,9 +49,9 @@ namespace cinolib
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
-                                const double               target_edge_length,
-                                const bool                 preserve_marked_features)
+void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
+                                const double       target_edge_length,
+                                const bool         preserve_marked_features)
 {
     double l = (target_edge_length>0) ? target_edge_length : m.edge_avg_length();
 
@@ -164,15 +164,15 @@ void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
 
     // 4) relocate vertices by tangential smoothing
     //
-    for(uint vid=0; vid<m.num_verts(); ++vid)
-    {
-        bool anchored = false;
-        for(uint eid : m.adj_v2e(vid))
-        {
-            if (preserve_marked_features && m.edge_data(eid).flags[MARKED]) anchored = true;
-        }
-        if (!anchored) tangential_smoothing(m,vid);
-    }
+    // (one step with uniform weights, in parallel by independent sets of vertices)
+    LaplacianSmoothingOptions opt;
+    opt.n_iters        = 1;
+    opt.laplacian_mode = UNIFORM;
+    opt.lambda         = 1.0;
+    opt.tangential     = true;
+    opt.fix_boundary   = true;
+    opt.fix_marked     = preserve_marked_features;
+    laplacian_smoothing(m, opt);
     std::cout << "\ttangential smoothing" << std::endl;
 }
 
@@ -36,8 +36,7 @@
 #ifndef CINO_REMESH_BOTSCH_KOBBELT_2004_H
 #define CINO_REMESH_BOTSCH_KOBBELT_2004_H
 
-#include <cinolib/meshes/drawable_trimesh.h>
-#include <cinolib/gui/qt/glcanvas.h>
+#include <cinolib/meshes/trimesh.h>
 
 namespace cinolib
 {
@@ -52,9 +51,9 @@ namespace cinolib
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
-                                const double               target_edge_length = -1,
-                                const bool                 preserve_marked_features = true);
+void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
+                                const double       target_edge_length = -1,
+                                const bool         preserve_marked_features = true);
 }
 
 #ifndef  CINO_STATIC_LIB
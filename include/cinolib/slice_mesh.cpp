@@ -0,0 +1,250 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/slice_mesh.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/geometry/triangle_utils.h>
+#include <cinolib/min_max_inf.h>
+#include <unordered_map>
+#include <algorithm>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_mesh(const Trimesh<M,V,E,P>                             & m,
+                const std::vector<double>                          & z_levels,
+                      std::vector<std::vector<std::vector<vec3d>>> & loops)
+{
+    assert(std::is_sorted(z_levels.begin(), z_levels.end()));
+
+    uint nl = z_levels.size();
+    loops.clear();
+    loops.resize(nl);
+
+    // sort triangles by their lowest z
+    std::vector<std::pair<double,uint>> order(m.num_polys());
+    std::vector<double> z_max(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        double z0 = m.poly_vert(pid,0).z();
+        double z1 = m.poly_vert(pid,1).z();
+        double z2 = m.poly_vert(pid,2).z();
+        order.at(pid) = std::make_pair(std::min(z0,std::min(z1,z2)), pid);
+        z_max.at(pid) = std::max(z0,std::max(z1,z2));
+    }
+    std::sort(order.begin(), order.end());
+
+    // sweep the planes, and store the triangles crossed by each of them (CSR).
+    // A triangle crosses plane z iff it has a vertex below z and one at or above it
+    std::vector<uint> layer_beg(nl+1, 0);
+    std::vector<uint> layer_tris;
+    std::vector<uint> active;
+    uint next = 0;
+    for(uint l=0; l<nl; ++l)
+    {
+        double z = z_levels.at(l);
+        while(next<order.size() && order.at(next).first<z)
+        {
+            active.push_back(order.at(next).second);
+            ++next;
+        }
+        active.erase(std::remove_if(active.begin(), active.end(), [&](const uint pid)
+        {
+            return z_max.at(pid)<z;
+        }), active.end());
+        layer_tris.insert(layer_tris.end(), active.begin(), active.end());
+        layer_beg.at(l+1) = layer_tris.size();
+    }
+
+    // intersect and chain, one plane at a time
+    std::vector<uint> n_open(nl, 0);
+    PARALLEL_FOR(0, nl, 2, [&](uint l)
+    {
+        double z = z_levels.at(l);
+
+        // each crossed triangle contributes a segment going from the edge where the boundary
+        // goes from above to below the plane, to the edge where it goes from below to above.
+        // For outward oriented triangles, this leaves the interior of the section on the left
+        std::unordered_map<uint,uint> seg_next;
+        seg_next.reserve(layer_beg.at(l+1) - layer_beg.at(l));
+        for(uint k=layer_beg.at(l); k<layer_beg.at(l+1); ++k)
+        {
+            uint pid = layer_tris.at(k);
+            int  from = -1, to = -1;
+            for(uint i=0; i<3; ++i)
+            {
+                uint vid0  = m.poly_vert_id(pid,i);
+                uint vid1  = m.poly_vert_id(pid,(i+1)%3);
+                bool above0 = (m.vert(vid0).z() >= z);
+                bool above1 = (m.vert(vid1).z() >= z);
+                if( above0 && !above1) from = m.poly_edge_id(pid, vid0, vid1);
+                if(!above0 &&  above1) to   = m.poly_edge_id(pid, vid0, vid1);
+            }
+            assert(from>=0 && to>=0);
+            seg_next[from] = to;
+        }
+
+        auto edge_point = [&](const uint eid) -> vec3d
+        {
+            vec3d a = m.edge_vert(eid,0);
+            vec3d b = m.edge_vert(eid,1);
+            if(a.z()>=z) std::swap(a,b);
+            if(b.z()==z) return b; // vertex on the plane: exact
+            double t = (z - a.z())/(b.z() - a.z());
+            vec3d p = a + (b-a)*t;
+            p.z() = z;
+            return p;
+        };
+
+        // follow the chains in triangle order (for determinism), consuming
+        // segments as they are visited. Chains that do not close are discarded
+        for(uint k=layer_beg.at(l); k<layer_beg.at(l+1); ++k)
+        {
+            uint pid   = layer_tris.at(k);
+            int  start = -1;
+            for(uint i=0; i<3; ++i)
+            {
+                uint vid0 = m.poly_vert_id(pid,i);
+                uint vid1 = m.poly_vert_id(pid,(i+1)%3);
+                if(m.vert(vid0).z()>=z && m.vert(vid1).z()<z) start = m.poly_edge_id(pid, vid0, vid1);
+            }
+            if(seg_next.find(start)==seg_next.end()) continue; // already visited
+
+            std::vector<vec3d> loop;
+            uint eid    = start;
+            bool closed = false;
+            while(true)
+            {
+                auto it = seg_next.find(eid);
+                if(it==seg_next.end()) break;
+                vec3d p = edge_point(eid);
+                if(loop.empty() || !(p==loop.back())) loop.push_back(p);
+                eid = it->second;
+                seg_next.erase(it);
+                if(eid==(uint)start) { closed = true; break; }
+            }
+            if(!closed) { ++n_open.at(l); continue; }
+            if(loop.size()>1 && loop.front()==loop.back()) loop.pop_back();
+            if(loop.size()>2) loops.at(l).push_back(loop);
+        }
+    });
+
+    uint tot_open = 0;
+    for(uint n : n_open) tot_open += n;
+    if(tot_open>0) std::cout << "WARNING: slice_mesh discarded " << tot_open << " open chains (is the mesh watertight?)" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<double> slice_levels_uniform(const double z_min,
+                                         const double z_max,
+                                         const double layer_height)
+{
+    assert(layer_height>0);
+    std::vector<double> levels;
+    uint n = std::ceil((z_max - z_min)/layer_height);
+    levels.reserve(n);
+    for(uint i=0; i<n; ++i)
+    {
+        double z = z_min + (i+0.5)*layer_height;
+        if(z<z_max) levels.push_back(z);
+    }
+    return levels;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<double> slice_levels_adaptive(const Trimesh<M,V,E,P> & m,
+                                          const double             min_height,
+                                          const double             max_height,
+                                          const double             max_cusp)
+{
+    assert(min_height>0 && min_height<=max_height && max_cusp>0);
+
+    // per triangle height bound (cusp = height * |n_z|), triangles sorted by lowest z
+    std::vector<std::pair<double,uint>> order(m.num_polys());
+    std::vector<double> z_min(m.num_polys());
+    std::vector<double> z_max(m.num_polys());
+    std::vector<double> h_max(m.num_polys());
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        vec3d  A  = m.poly_vert(pid,0);
+        vec3d  B  = m.poly_vert(pid,1);
+        vec3d  C  = m.poly_vert(pid,2);
+        double nz = std::fabs(triangle_normal(A,B,C).z());
+        z_min.at(pid) = std::min(A.z(),std::min(B.z(),C.z()));
+        z_max.at(pid) = std::max(A.z(),std::max(B.z(),C.z()));
+        order.at(pid) = std::make_pair(z_min.at(pid), pid);
+        h_max.at(pid) = (nz>0) ? max_cusp/nz : inf_double;
+    });
+    std::sort(order.begin(), order.end());
+
+    std::vector<double> levels;
+    std::vector<uint>   active;
+    uint   next = 0;
+    double z    = m.bbox().min.z();
+    double top  = m.bbox().max.z();
+    while(z<top)
+    {
+        while(next<order.size() && order.at(next).first<=z+max_height)
+        {
+            active.push_back(order.at(next).second);
+            ++next;
+        }
+        active.erase(std::remove_if(active.begin(), active.end(), [&](const uint pid)
+        {
+            return z_max.at(pid)<z;
+        }), active.end());
+
+        // the layer is [z,z+h]: shrink h so that all the triangles it spans satisfy the cusp bound
+        double h = max_height;
+        for(uint pid : active)
+        {
+            if(z_min.at(pid)<=z+h) h = std::min(h, h_max.at(pid));
+        }
+        h = std::max(h, min_height);
+        // the last layer ends at the top of the mesh, so that its plane still cuts it
+        levels.push_back(z + 0.5*std::min(h, top-z));
+        z += h;
+    }
+    return levels;
+}
+
+}
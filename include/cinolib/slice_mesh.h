@@ -0,0 +1,95 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SLICE_MESH_H
+#define CINO_SLICE_MESH_H
+
+#include <cinolib/meshes/trimesh.h>
+
+namespace cinolib
+{
+
+/* Planar slicer. Intersects a triangle mesh with the horizontal planes z = z_levels[i],
+ * and returns, for each plane, the closed loops of the cross section. Triangles are
+ * sorted by their lowest z, and planes are swept bottom to top, maintaining the set
+ * of active triangles (i.e. triangles that span the current plane). Crossed triangles
+ * are then processed in parallel, one plane at a time. Segments are chained into loops
+ * through the ids of the mesh edges they start/end at, hence no geometric tolerance is
+ * involved. Vertices lying exactly on a plane are considered above it.
+ *
+ * If the mesh is closed and consistently oriented (outward normals), outer boundaries
+ * are counterclockwise and holes are clockwise. Open chains (e.g. due to holes in the
+ * mesh) are discarded. z_levels must be sorted in ascending order.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_mesh(const Trimesh<M,V,E,P>                             & m,
+                const std::vector<double>                          & z_levels,
+                      std::vector<std::vector<std::vector<vec3d>>> & loops); // per level closed loops
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// planes at the middle of layers of constant height spanning [z_min,z_max]
+CINO_INLINE
+std::vector<double> slice_levels_uniform(const double z_min,
+                                         const double z_max,
+                                         const double layer_height);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* planes at the middle of layers of variable height, in between min_height and max_height.
+ * Each layer is as thick as possible, provided that the cusp height (i.e. the maximum
+ * distance between the surface and the staircase approximation of it) of all triangles
+ * spanned by the layer does not exceed max_cusp. The last layer is cut at the top of
+ * the mesh (hence it may be thinner than min_height). Reference:
+ *
+ * Slicing procedures for layered manufacturing techniques
+ * E. Dolenc and I. Makela
+ * Computer-Aided Design, 1994
+*/
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<double> slice_levels_adaptive(const Trimesh<M,V,E,P> & m,
+                                          const double             min_height,
+                                          const double             max_height,
+                                          const double             max_cusp);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "slice_mesh.cpp"
+#endif
+
+#endif // CINO_SLICE_MESH_H
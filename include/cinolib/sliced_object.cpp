@@ -38,6 +38,7 @@
 #include <cinolib/triangle_wrap.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/ANSI_color_codes.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -73,6 +74,44 @@ SlicedObj<M,V,E,P>::SlicedObj(const std::vector<std::vector<std::vector<vec3d>>>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+SlicedObj<M,V,E,P>::SlicedObj(const Trimesh<M,V,E,P>    & m,
+                              const std::vector<double> & z_levels,
+                              const double                thick_radius)
+    : Trimesh<M,V,E,P>()
+    , thick_radius(thick_radius)
+{
+    std::vector<std::vector<std::vector<vec3d>>> loops;
+    slice_mesh(m, z_levels, loops);
+
+    std::vector<BoostMultiPolygon> tmp_slices(z_levels.size());
+    std::vector<float>             tmp_z(z_levels.begin(), z_levels.end());
+    PARALLEL_FOR(0, z_levels.size(), 2, [&](uint sid)
+    {
+        // even-odd rule: robust to any nesting of outer boundaries and holes. Loops
+        // are chained along the mesh orientation, which must therefore be consistent
+        BoostMultiPolygon mp;
+        for(const auto & loop : loops.at(sid)) mp = polygon_symmetric_difference(mp, make_polygon(loop));
+        if(thick_radius>0) mp = polygon_simplify(mp, 0.1*thick_radius);
+        tmp_slices.at(sid) = mp;
+    });
+
+    init(tmp_z, tmp_slices);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+SlicedObj<M,V,E,P>::SlicedObj(const Trimesh<M,V,E,P> & m,
+                              const double             layer_height,
+                              const double             thick_radius)
+    : SlicedObj(m, slice_levels_uniform(m.bbox().min.z(), m.bbox().max.z(), layer_height), thick_radius)
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 BoostMultiPolygon SlicedObj<M,V,E,P>::slice_as_boost_poly(const uint sid) const
@@ -88,37 +127,54 @@ void SlicedObj<M,V,E,P>::init(const std::vector<std::vector<std::vector<vec3d>>>
                               const std::vector<std::vector<std::vector<vec3d>>> & slice_holes,
                               const std::vector<std::vector<std::vector<vec3d>>> & supports)
 {
+    // slices are independent: process them in parallel
     uint num_slices = slice_polys.size();
-
-    for(uint sid=0; sid<num_slices; ++sid)
+    std::vector<BoostMultiPolygon> tmp_slices(num_slices);
+    std::vector<float>             tmp_z     (num_slices);
+    PARALLEL_FOR(0, num_slices, 2, [&](uint sid)
     {
         uint np = slice_holes.at(sid).size();
-        uint nh = slice_polys.at(sid).size();
         uint ns = (thick_radius>0) ? supports.at(sid).size() : 0;
 
-        std::cout << "processing slice " << sid << " out of " << num_slices << "\t(" << np << " polys / " << nh << " holes / "  << ns << " supports)" << std::endl;
-
-        if(np>0) z.push_back(slice_holes.at(sid).front().front().z()); else
-        if(ns>0) z.push_back(supports.at(sid).front().front().z());    else
-        continue; // empty slice, skip it
+        if(np>0) tmp_z.at(sid) = slice_holes.at(sid).front().front().z(); else
+        if(ns>0) tmp_z.at(sid) = supports.at(sid).front().front().z();    else
+        return; // empty slice, skip it
 
         std::vector<BoostPolygon> polys;
         std::vector<BoostPolygon> holes;
-        for(auto p : slice_holes.at(sid)) polys.push_back(make_polygon(p));
-        for(auto h : slice_polys.at(sid)) holes.push_back(make_polygon(h));
+        for(const auto & p : slice_holes.at(sid)) polys.push_back(make_polygon(p));
+        for(const auto & h : slice_polys.at(sid)) holes.push_back(make_polygon(h));
         if(thick_radius>0)
         {
-            for(auto s : supports.at(sid)) polys.push_back(make_polygon(s, thick_radius));
+            for(const auto & s : supports.at(sid)) polys.push_back(make_polygon(s, thick_radius));
         }
 
         BoostMultiPolygon mp;
-        for(auto p : polys) mp = polygon_union(mp, p);
-        for(auto p : holes) mp = polygon_difference(mp, p);
+        for(const auto & p : polys) mp = polygon_union(mp, p);
+        for(const auto & p : holes) mp = polygon_difference(mp, p);
         mp = polygon_simplify(mp, 0.1*thick_radius);
-
         assert(mp.size()>0);
-        slices.push_back(mp);
+        tmp_slices.at(sid) = mp;
+    });
+
+    init(tmp_z, tmp_slices);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void SlicedObj<M,V,E,P>::init(const std::vector<float>             & slice_z,
+                                    std::vector<BoostMultiPolygon> & slice_mps)
+{
+    // keep the non empty slices, preserving their ordering
+    for(uint sid=0; sid<slice_mps.size(); ++sid)
+    {
+        if(slice_mps.at(sid).empty()) continue;
+        z.push_back(slice_z.at(sid));
+        slices.push_back(std::move(slice_mps.at(sid)));
     }
+    std::cout << "processed " << slice_mps.size() << " slices (" << slice_mps.size()-slices.size() << " empty)" << std::endl;
 
     triangulate_slices();
 }
@@ -129,18 +185,41 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void SlicedObj<M,V,E,P>::triangulate_slices()
 {
-    for(uint sid=0; sid<slices.size(); ++sid)
+    // tessellate slices in parallel, each one in its own buffers (point location grids are built
+    // along the way). Triangle is not reentrant, hence triangle_wrap serializes the calls to it,
+    // but polygon preprocessing and grid construction still run concurrently
+    std::vector<std::vector<vec3d>> verts(num_slices());
+    std::vector<std::vector<uint>>  tris (num_slices());
+    grids.resize(num_slices());
+    PARALLEL_FOR(0, num_slices(), 2, [&](uint sid)
     {
-        const BoostMultiPolygon & mp = slices.at(sid);
-
-        std::vector<vec3d> verts;
-        std::vector<uint>  tris;
-        triangulate_polygon(mp, "Q", z.at(sid), verts, tris);
+        triangulate_polygon(slices.at(sid), "Q", z.at(sid), verts.at(sid), tris.at(sid));
+
+        std::vector<vec2d> grid_verts;
+        std::vector<uint>  grid_edges;
+        polygon_get_edges(slices.at(sid), grid_verts, grid_edges);
+        grids.at(sid).build(grid_verts, grid_edges);
+    });
+
+    // merge per slice buffers into the mesh (serially, in slice order)
+    uint nv = 0;
+    uint np = 0;
+    for(uint sid=0; sid<num_slices(); ++sid)
+    {
+        nv += verts.at(sid).size();
+        np += tris.at(sid).size()/3;
+    }
+    this->verts.reserve(nv);
+    this->v_data.reserve(nv);
+    this->polys.reserve(np);
+    this->p_data.reserve(np);
 
+    for(uint sid=0; sid<num_slices(); ++sid)
+    {
         uint base_addr = this->num_verts();
-        uint n_tris = tris.size()/3;
+        uint n_tris    = tris.at(sid).size()/3;
 
-        for(auto p : verts)
+        for(const vec3d & p : verts.at(sid))
         {
             uint vid = this->vert_add(p);
             this->vert_data(vid).uvw[0] = static_cast<double>(sid)/static_cast<double>(num_slices());
@@ -148,12 +227,14 @@ void SlicedObj<M,V,E,P>::triangulate_slices()
         }
         for(uint i=0; i<n_tris; ++i)
         {
-            uint pid = this->poly_add(base_addr + tris.at(3*i+0),
-                                      base_addr + tris.at(3*i+1),
-                                      base_addr + tris.at(3*i+2));
+            uint pid = this->poly_add(base_addr + tris.at(sid).at(3*i+0),
+                                      base_addr + tris.at(sid).at(3*i+1),
+                                      base_addr + tris.at(sid).at(3*i+2));
             this->poly_data(pid).label = sid;
             for(uint eid : this->adj_p2e(pid)) this->edge_data(eid).label = sid;
         }
+        std::vector<vec3d>().swap(verts.at(sid));
+        std::vector<uint>().swap(tris.at(sid));
     }
     std::cout << "new sliced object (" << num_slices() << " slices)" << std::endl;
     this->edge_mark_boundaries();
@@ -231,7 +312,18 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 bool SlicedObj<M,V,E,P>::slice_contains(const uint sid, const vec2d & p) const
 {
-    return polygon_contains(slices.at(sid), p, true);
+    return grids.at(sid).contains(p, true);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void SlicedObj<M,V,E,P>::slice_contains(const uint                 sid,
+                                        const std::vector<vec2d> & p,
+                                              std::vector<bool>  & res) const
+{
+    grids.at(sid).contains(p, res, true);
 }
 
 }
@@ -38,9 +38,20 @@
 
 #include <cinolib/meshes/trimesh.h>
 #include <cinolib/boost_polygon_wrap.h>
+#include <cinolib/polygon_grid.h>
+#include <cinolib/slice_mesh.h>
 
 /* This class represents a sliced object as a stack of polygons.
  * Silces are also triangulated for ease of processing, IO and rendering.
+ * Slices are independent, and are constructed in parallel. Triangulation is
+ * serialized instead, as Triangle is not reentrant (see triangle_wrap.h).
+ * Each slice is also equipped with a grid of edge bins (see polygon_grid.h)
+ * for fast point location queries.
+ *
+ * Sliced objects can be read from CLI files, or obtained directly from a closed
+ * triangle mesh, slicing it at given heights (see slice_mesh.h), e.g.:
+ *
+ *     SlicedObj<> obj(m, slice_levels_adaptive(m, 0.05, 0.3, 0.02));
 */
 
 namespace cinolib
@@ -70,6 +81,19 @@ class SlicedObj : public Trimesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // slices m at heights z_levels (or with constant layer_height). m must be closed and
+        // consistently oriented (see slice_mesh.h). Here thick_radius is only used to control
+        // the simplification of the cross sections
+        explicit SlicedObj(const Trimesh<M,V,E,P>    & m,
+                           const std::vector<double> & z_levels,
+                           const double                thick_radius = 0.01);
+
+        explicit SlicedObj(const Trimesh<M,V,E,P>    & m,
+                           const double                layer_height,
+                           const double                thick_radius = 0.01);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         uint num_slices() const { return slices.size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -79,6 +103,7 @@ class SlicedObj : public Trimesh<M,V,E,P>
         float             slice_z            (const uint sid) const;
         float             slice_thickness    (const uint sid) const;
         bool              slice_contains     (const uint sid, const vec2d & p) const;
+        void              slice_contains     (const uint sid, const std::vector<vec2d> & p, std::vector<bool> & res) const; // parallel
         float             slice_avg_thickness() const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -89,6 +114,10 @@ class SlicedObj : public Trimesh<M,V,E,P>
                   const std::vector<std::vector<std::vector<vec3d>>> & slice_holes,
                   const std::vector<std::vector<std::vector<vec3d>>> & supports);
 
+        // keeps the non empty slices, and triangulates them
+        void init(const std::vector<float>             & slice_z,
+                        std::vector<BoostMultiPolygon> & slice_mps);
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void triangulate_slices();
@@ -98,6 +127,7 @@ class SlicedObj : public Trimesh<M,V,E,P>
         double                                       thick_radius; // supports thickening radius
         std::vector<float>                           z;            // per slice z-coord
         std::vector<BoostMultiPolygon>               slices;       // slices (included thickened supports)
+        std::vector<PolygonGrid>                     grids;        // per slice point location
         std::vector<std::vector<std::vector<vec3d>>> hatches;      // unused so far, just keeping them
 };
 
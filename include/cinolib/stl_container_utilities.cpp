@@ -38,6 +38,7 @@
 #include <numeric>
 #include <random>
 #include <iterator>
+#include <iostream>
 
 namespace cinolib
 {
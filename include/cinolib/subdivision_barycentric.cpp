@@ -34,28 +34,34 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/subdivision_barycentric.h>
-#include <unordered_map>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
 
 /* Implementation of barycentric subdivision for simplicial complexes of dimension 3.
  * See also: https://en.wikipedia.org/wiki/Barycentric_subdivision
+ *
+ * New vertices are laid out as [ input verts | edge midpoints | face centroids | poly centroids ],
+ * hence their ids derive directly from entity ids, and each tet can be split independently
 */
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m)
 {
-    std::unordered_map<uint,uint> e_map; // edge midpoints
-    std::unordered_map<uint,uint> f_map; // face centroids
-    std::unordered_map<uint,uint> p_map; // poly centroids
+    uint nv = m.num_verts();
+    uint ne = m.num_edges();
+    uint nf = m.num_faces();
+    uint np = m.num_polys();
 
-    for(uint eid=0; eid<m.num_edges(); ++eid) e_map[eid] = m.vert_add(m.edge_sample_at(eid,0.5));
-    for(uint fid=0; fid<m.num_faces(); ++fid) f_map[fid] = m.vert_add(m.face_centroid(fid));
-    for(uint pid=0; pid<m.num_polys(); ++pid) p_map[pid] = m.vert_add(m.poly_centroid(pid));
+    std::vector<vec3d> verts(nv+ne+nf+np);
+    std::copy(m.vector_verts().begin(), m.vector_verts().end(), verts.begin());
+    PARALLEL_FOR(0, ne, 1000, [&](uint eid) { verts[nv+eid]       = m.edge_sample_at(eid,0.5); });
+    PARALLEL_FOR(0, nf, 1000, [&](uint fid) { verts[nv+ne+fid]    = m.face_centroid(fid);      });
+    PARALLEL_FOR(0, np, 1000, [&](uint pid) { verts[nv+ne+nf+pid] = m.poly_centroid(pid);      });
 
-    uint np = m.num_polys();
-    for(uint pid=0; pid<np; ++pid)
+    std::vector<uint> tets(4*24*np);
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
     {
         // tet verts
         uint v[4] =
@@ -66,62 +72,47 @@ void subdivision_barycentric(Tetmesh<M,V,E,F,P> & m)
             m.poly_vert_id(pid,3),
         };
 
-        // tet faces
-        uint f[4][3] =
-        {
-            { v[TET_FACES[0][0]], v[TET_FACES[0][1]], v[TET_FACES[0][2]] },
-            { v[TET_FACES[1][0]], v[TET_FACES[1][1]], v[TET_FACES[1][2]] },
-            { v[TET_FACES[2][0]], v[TET_FACES[2][1]], v[TET_FACES[2][2]] },
-            { v[TET_FACES[3][0]], v[TET_FACES[3][1]], v[TET_FACES[3][2]] },
-        };
-
-        // tet edges (sorted per face)
-        uint e[4][3] =
-        {
-            { e_map.at(m.edge_id(f[0][0], f[0][1])),
-              e_map.at(m.edge_id(f[0][1], f[0][2])),
-              e_map.at(m.edge_id(f[0][2], f[0][0])) },
-
-            { e_map.at(m.edge_id(f[1][0], f[1][1])),
-              e_map.at(m.edge_id(f[1][1], f[1][2])),
-              e_map.at(m.edge_id(f[1][2], f[1][0])) },
-
-            { e_map.at(m.edge_id(f[2][0], f[2][1])),
-              e_map.at(m.edge_id(f[2][1], f[2][2])),
-              e_map.at(m.edge_id(f[2][2], f[2][0])) },
-
-            { e_map.at(m.edge_id(f[3][0], f[3][1])),
-              e_map.at(m.edge_id(f[3][1], f[3][2])),
-              e_map.at(m.edge_id(f[3][2], f[3][0])) }
-        };
-
-        // face centroids
-        uint fc[4] =
-        {
-            f_map.at(m.face_id({f[0][0], f[0][1], f[0][2]})),
-            f_map.at(m.face_id({f[1][0], f[1][1], f[1][2]})),
-            f_map.at(m.face_id({f[2][0], f[2][1], f[2][2]})),
-            f_map.at(m.face_id({f[3][0], f[3][1], f[3][2]}))
-        };
-
         // tet centroid
-        uint c = p_map.at(pid);
+        uint c = nv + ne + nf + pid;
 
+        uint * out = tets.data() + 4*24*pid;
         for(uint i=0; i<4; ++i)
         {
+            // i^th face, its centroid and edges (in face order)
+            uint f[3] = { v[TET_FACES[i][0]], v[TET_FACES[i][1]], v[TET_FACES[i][2]] };
+            uint fc   = nv + ne + m.poly_face_opposite_to(pid, v[3-i]);
+            uint e[3] =
+            {
+                nv + m.poly_edge_id(pid, f[0], f[1]),
+                nv + m.poly_edge_id(pid, f[1], f[2]),
+                nv + m.poly_edge_id(pid, f[2], f[0]),
+            };
+
             // split i^th face
-            m.poly_add({c, f[i][0], e[i][0], fc[i]});
-            m.poly_add({c, e[i][0], f[i][1], fc[i]});
-            m.poly_add({c, f[i][1], e[i][1], fc[i]});
-            m.poly_add({c, e[i][1], f[i][2], fc[i]});
-            m.poly_add({c, f[i][2], e[i][2], fc[i]});
-            m.poly_add({c, e[i][2], f[i][0], fc[i]});
+            uint sub[6][4] =
+            {
+                { c, f[0], e[0], fc },
+                { c, e[0], f[1], fc },
+                { c, f[1], e[1], fc },
+                { c, e[1], f[2], fc },
+                { c, f[2], e[2], fc },
+                { c, e[2], f[0], fc },
+            };
+            for(uint j=0; j<6; ++j)
+            for(uint k=0; k<4; ++k) *out++ = sub[j][k];
         }
-    }
+    });
 
-    // remove the old polys
-    for(int pid=np-1; pid>=0; --pid) m.poly_remove(pid);
-}
+    // build the subdivided mesh in one go, preserving
+    // mesh and vertex attributes of the input mesh
+    M              m_data = m.mesh_data();
+    std::vector<V> v_data(nv);
+    for(uint vid=0; vid<nv; ++vid) v_data[vid] = m.vert_data(vid);
 
+    m = Tetmesh<M,V,E,F,P>(verts, tets);
+
+    m.mesh_data() = m_data;
+    for(uint vid=0; vid<nv; ++vid) m.vert_data(vid) = v_data[vid];
+}
 
 }
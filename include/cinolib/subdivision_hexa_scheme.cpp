@@ -0,0 +1,331 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/subdivision_hexa_scheme.h>
+#include <cinolib/standard_elements_tables.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <map>
+
+namespace cinolib
+{
+
+enum
+{
+    HEXA_SCHEME_VERT,
+    HEXA_SCHEME_EDGE,
+    HEXA_SCHEME_FACE,
+    HEXA_SCHEME_CELL,
+};
+
+// a point of a split scheme, with its weights w.r.t. the 8 hexa corners
+typedef struct
+{
+    int  type     = HEXA_SCHEME_CELL;
+    uint entity   = 0;   // local vert/edge/face id (or index among the cell points)
+    uint count[8] = {0,0,0,0,0,0,0,0};
+    uint n        = 0;   // sum of counts
+}
+HexaSchemePoint;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sorted weights of a group of scheme points w.r.t. a list of hexa corners
+CINO_INLINE
+std::vector<std::vector<uint>> hexa_scheme_signature(const std::vector<HexaSchemePoint> & points,
+                                                     const std::vector<uint>            & pts,
+                                                     const std::vector<uint>            & corners)
+{
+    std::vector<std::vector<uint>> sig;
+    for(uint pt : pts)
+    {
+        std::vector<uint> w;
+        for(uint c : corners) w.push_back(points.at(pt).count[c]);
+        sig.push_back(w);
+    }
+    std::sort(sig.begin(), sig.end());
+    return sig;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// true if the points of the scheme are the same on all the corners, edges and faces of the hexa,
+// regardless of the direction they are seen from (i.e. under all the symmetries of the square for
+// faces, and of the segment for edges). This is what adjacent elements (which may share an entity
+// with any relative orientation) need to agree on the points along it by ranking their weights
+CINO_INLINE
+bool hexa_scheme_is_symmetric(const std::vector<HexaSchemePoint> & points,
+                              const std::vector<uint>              edge_pts[12],
+                              const std::vector<uint>              face_pts[6])
+{
+    // one point per corner, all with the same weight (points are identified by their weights)
+    std::vector<uint> corner_n(8,0);
+    for(const HexaSchemePoint & pt : points)
+    {
+        if(pt.type!=HEXA_SCHEME_VERT) continue;
+        if(corner_n.at(pt.entity)>0) return false;
+        corner_n.at(pt.entity) = pt.n;
+    }
+    for(uint vid=1; vid<8; ++vid) if(corner_n.at(vid)!=corner_n.at(0)) return false;
+
+    auto ref = hexa_scheme_signature(points, edge_pts[0], {HEXA_EDGES[0][0], HEXA_EDGES[0][1]});
+    for(uint e=0; e<12; ++e)
+    {
+        if(hexa_scheme_signature(points, edge_pts[e], {HEXA_EDGES[e][0], HEXA_EDGES[e][1]})!=ref) return false;
+        if(hexa_scheme_signature(points, edge_pts[e], {HEXA_EDGES[e][1], HEXA_EDGES[e][0]})!=ref) return false;
+    }
+
+    ref = hexa_scheme_signature(points, face_pts[0], {HEXA_FACES[0][0], HEXA_FACES[0][1], HEXA_FACES[0][2], HEXA_FACES[0][3]});
+    for(uint f=0; f<6; ++f)
+    for(uint r=0; r<4; ++r)
+    {
+        std::vector<uint> ccw, cw;
+        for(uint i=0; i<4; ++i)
+        {
+            ccw.push_back(HEXA_FACES[f][(r+i  )%4]);
+            cw .push_back(HEXA_FACES[f][(r+4-i)%4]);
+        }
+        if(hexa_scheme_signature(points, face_pts[f], ccw)!=ref) return false;
+        if(hexa_scheme_signature(points, face_pts[f], cw )!=ref) return false;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// general (serial) version: points are shared among elements if they have the
+// same weights w.r.t. the same global vertices, which are used as key in a map
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_hexa_scheme_map(const AbstractPolyhedralMesh<M,V,E,F,P>             & m,
+                                 const std::vector<std::vector<std::vector<uint>>> & scheme,
+                                       std::vector<vec3d>                          & verts,
+                                       std::vector<uint>                           & hexas)
+{
+    verts.clear();
+    hexas.clear();
+    hexas.reserve(8*scheme.size()*m.num_polys());
+    std::map<std::vector<uint>,uint> v_map;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        for(const auto & sub_poly : scheme)
+        {
+            for(uint off=0; off<8; ++off)
+            {
+                std::vector<uint> vids;
+                for(uint i : sub_poly.at(off)) vids.push_back(m.poly_vert_id(pid,i));
+                std::sort(vids.begin(), vids.end());
+
+                auto query = v_map.find(vids);
+                if(query!=v_map.end())
+                {
+                    hexas.push_back(query->second);
+                }
+                else
+                {
+                    vec3d p(0,0,0);
+                    for(uint vid : vids) p += m.vert(vid);
+                    v_map[vids] = verts.size();
+                    hexas.push_back(verts.size());
+                    verts.push_back(p/static_cast<double>(vids.size()));
+                }
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_hexa_scheme(const AbstractPolyhedralMesh<M,V,E,F,P>             & m,
+                             const std::vector<std::vector<std::vector<uint>>> & scheme,
+                                   std::vector<vec3d>                          & verts,
+                                   std::vector<uint>                           & hexas)
+{
+    // 1) classify the (unique) points of the scheme. This only depends on the scheme
+    std::vector<HexaSchemePoint>   points;
+    std::vector<std::vector<uint>> sub(scheme.size(), std::vector<uint>(8)); // sub hexa => scheme points
+    std::map<std::vector<uint>,uint> unique;
+    for(uint s=0; s<scheme.size(); ++s)
+    {
+        assert(scheme.at(s).size()==8);
+        for(uint i=0; i<8; ++i)
+        {
+            std::vector<uint> key = scheme[s][i];
+            std::sort(key.begin(), key.end());
+            auto it = unique.find(key);
+            if(it==unique.end())
+            {
+                HexaSchemePoint pt;
+                for(uint vid : key) ++pt.count[vid];
+                pt.n = key.size();
+                it = unique.insert(std::make_pair(key, points.size())).first;
+                points.push_back(pt);
+            }
+            sub[s][i] = it->second;
+        }
+    }
+
+    std::vector<uint> edge_pts[12];
+    std::vector<uint> face_pts[6];
+    uint k_c = 0;
+    for(uint i=0; i<points.size(); ++i)
+    {
+        HexaSchemePoint & pt = points[i];
+        auto support_in = [&](const std::vector<uint> & vids)
+        {
+            for(uint vid=0; vid<8; ++vid)
+            {
+                if(pt.count[vid]>0 && std::find(vids.begin(), vids.end(), vid)==vids.end()) return false;
+            }
+            return true;
+        };
+        bool found = false;
+        for(uint vid=0; vid<8 && !found; ++vid)
+        {
+            if(pt.count[vid]==pt.n) { pt.type = HEXA_SCHEME_VERT; pt.entity = vid; found = true; }
+        }
+        for(uint e=0; e<12 && !found; ++e)
+        {
+            if(support_in({HEXA_EDGES[e][0], HEXA_EDGES[e][1]}))
+            {
+                pt.type = HEXA_SCHEME_EDGE; pt.entity = e; found = true;
+                edge_pts[e].push_back(i);
+            }
+        }
+        for(uint f=0; f<6 && !found; ++f)
+        {
+            if(support_in({HEXA_FACES[f][0], HEXA_FACES[f][1], HEXA_FACES[f][2], HEXA_FACES[f][3]}))
+            {
+                pt.type = HEXA_SCHEME_FACE; pt.entity = f; found = true;
+                face_pts[f].push_back(i);
+            }
+        }
+        if(!found) { pt.type = HEXA_SCHEME_CELL; pt.entity = k_c++; }
+    }
+    if(!hexa_scheme_is_symmetric(points, edge_pts, face_pts))
+    {
+        subdivision_hexa_scheme_map(m, scheme, verts, hexas);
+        return;
+    }
+    uint k_e = edge_pts[0].size(); // points per edge
+    uint k_f = face_pts[0].size(); // points per face
+
+    // 2) output size and id offsets
+    uint nv     = m.num_verts();
+    uint base_e = nv;
+    uint base_f = base_e + m.num_edges()*k_e;
+    uint base_c = base_f + m.num_faces()*k_f;
+    verts.resize(base_c + m.num_polys()*k_c);
+    hexas.resize(8*scheme.size()*m.num_polys());
+    std::copy(m.vector_verts().begin(), m.vector_verts().end(), verts.begin());
+
+    // 3) fill coordinates and hexahedra. Points shared among elements are
+    //    positioned only by the first element incident to their edge/face
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        uint v[8];
+        for(uint i=0; i<8; ++i) v[i] = m.poly_vert_id(pid,i);
+
+        std::vector<uint> gid(points.size());
+        auto position = [&](const HexaSchemePoint & pt)
+        {
+            vec3d p(0,0,0);
+            for(uint i=0; i<8; ++i) if(pt.count[i]>0) p += m.vert(v[i]) * static_cast<double>(pt.count[i]);
+            return p / static_cast<double>(pt.n);
+        };
+
+        // the rank of a point shared with other elements is given by its
+        // weights w.r.t. the entity vertices, sorted by global vertex id
+        auto rank = [&](const std::vector<uint> & pts, const std::vector<uint> & corners, const uint base, const bool owner)
+        {
+            std::vector<uint> order(corners.size());
+            for(uint i=0; i<corners.size(); ++i) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](const uint a, const uint b) { return v[corners[a]] < v[corners[b]]; });
+
+            std::vector<std::pair<std::vector<uint>,uint>> sig;
+            for(uint pt : pts)
+            {
+                std::vector<uint> w;
+                for(uint i : order) w.push_back(points[pt].count[corners[i]]);
+                sig.push_back(std::make_pair(w,pt));
+            }
+            std::sort(sig.begin(), sig.end());
+            for(uint r=0; r<sig.size(); ++r)
+            {
+                gid[sig[r].second] = base + r;
+                if(owner) verts[base + r] = position(points[sig[r].second]);
+            }
+        };
+
+        for(uint i=0; i<points.size(); ++i)
+        {
+            if(points[i].type==HEXA_SCHEME_VERT) gid[i] = v[points[i].entity];
+        }
+        if(k_e>0)
+        for(uint e=0; e<12; ++e)
+        {
+            uint eid = m.poly_edge_id(pid, v[HEXA_EDGES[e][0]], v[HEXA_EDGES[e][1]]);
+            rank(edge_pts[e], {HEXA_EDGES[e][0], HEXA_EDGES[e][1]}, base_e + eid*k_e, m.adj_e2p(eid).front()==pid);
+        }
+        if(k_f>0)
+        for(uint f=0; f<6; ++f)
+        {
+            uint fid = 0;
+            for(uint id : m.adj_p2f(pid))
+            {
+                if(m.face_contains_vert(id, v[HEXA_FACES[f][0]]) &&
+                   m.face_contains_vert(id, v[HEXA_FACES[f][2]])) { fid = id; break; }
+            }
+            rank(face_pts[f], {HEXA_FACES[f][0], HEXA_FACES[f][1], HEXA_FACES[f][2], HEXA_FACES[f][3]}, base_f + fid*k_f, m.adj_f2p(fid).front()==pid);
+        }
+        for(uint i=0; i<points.size(); ++i)
+        {
+            if(points[i].type!=HEXA_SCHEME_CELL) continue;
+            gid[i] = base_c + pid*k_c + points[i].entity;
+            verts[gid[i]] = position(points[i]);
+        }
+
+        uint * out = hexas.data() + 8*scheme.size()*pid;
+        for(uint s=0; s<scheme.size(); ++s)
+        for(uint i=0; i<8; ++i)
+        {
+            *out++ = gid[sub[s][i]];
+        }
+    });
+}
+
+}
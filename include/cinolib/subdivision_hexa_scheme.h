@@ -0,0 +1,76 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SUBDIVISION_HEXA_SCHEME_H
+#define CINO_SUBDIVISION_HEXA_SCHEME_H
+
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+
+namespace cinolib
+{
+
+/* Applies a split scheme (see subdivision_legacy_hexa_schemes.h for the format) to all
+ * the hexahedra of a mesh, returning the vertices and the (serialized) hexahedra of the
+ * subdivided mesh, ready to be passed to the Hexmesh constructor.
+ *
+ * Each point of the scheme is classified once, according to the smallest hexa entity
+ * (vertex, edge, face or cell) that contains it, and the ids of the output vertices are
+ * computed directly from the ids of these entities:
+ *
+ *   [ input verts | points along edges | points inside faces | points inside cells ]
+ *
+ * hence the output size is known in advance, no global map is needed to share vertices
+ * among adjacent elements, and both coordinates and hexahedra are filled in parallel.
+ * Points along edges and faces are ranked according to their weights w.r.t. the global
+ * ids of the entity vertices. This is possible only if the scheme looks the same from all
+ * its corners, edges and faces, in any orientation (e.g. the regular grid schemes), as
+ * adjacent elements may share an entity with any relative orientation. Any other scheme is
+ * applied (serially) with a global map keyed by the mesh vertices defining each point,
+ * hence two points are shared only if they have the same weights w.r.t. the same vertices.
+*/
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_hexa_scheme(const AbstractPolyhedralMesh<M,V,E,F,P>             & m,
+                             const std::vector<std::vector<std::vector<uint>>> & scheme,
+                                   std::vector<vec3d>                          & verts,
+                                   std::vector<uint>                           & hexas);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "subdivision_hexa_scheme.cpp"
+#endif
+
+#endif // CINO_SUBDIVISION_HEXA_SCHEME_H
@@ -34,8 +34,10 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/subdivision_midpoint.h>
-#include <cinolib/sort_poly_vertices.h>
-#include <map>
+#include <cinolib/subdivision_hexa_scheme.h>
+#include <cinolib/subdivision_legacy_hexa_schemes.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -45,116 +47,179 @@ CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 AbstractPolyhedralMesh<M,V,E,F,P> & m_out)
 {
-    std::unordered_map<uint,uint> edge_verts;
-    std::unordered_map<uint,uint> face_verts;
-    std::unordered_map<uint,uint> poly_verts;
-    subdivision_midpoint(m_in, m_out, edge_verts, face_verts, poly_verts);
-}
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
-template<class M, class V, class E, class F, class P>
-CINO_INLINE
-void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
-                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
-                                std::unordered_map<uint,uint>     & edge_verts,
-                                std::unordered_map<uint,uint>     & face_verts,
-                                std::unordered_map<uint,uint>     & poly_verts)
-{
-    edge_verts.clear();
-    face_verts.clear();
-    poly_verts.clear();
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint nf = m_in.num_faces();
+    uint np = m_in.num_polys();
 
-    std::vector<vec3d>             verts = m_in.vector_verts();
-    std::vector<std::vector<uint>> faces;
-    std::vector<std::vector<uint>> polys;
-    std::vector<std::vector<bool>> polys_winding;
-
-    // 1) add one new vert for each edge/face/poly
-    //
-    for(uint eid=0; eid<m_in.num_edges(); ++eid) { edge_verts[eid] = verts.size(); verts.push_back(m_in.edge_sample_at(eid,0.5)); }
-    for(uint fid=0; fid<m_in.num_faces(); ++fid) { face_verts[fid] = verts.size(); verts.push_back(m_in.face_centroid(fid)); }
-    for(uint pid=0; pid<m_in.num_polys(); ++pid) { poly_verts[pid] = verts.size(); verts.push_back(m_in.poly_centroid(pid)); }
-
-    // 2) for each pair (edge,poly), make a quad with:
-    //      - poly centroid
-    //      - incident face centroids
-    //      - edge midpoint
+    // new vertices are laid out as [ input verts | edge midpoints | face centroids | poly centroids ]
     //
-    std::map<ipair,uint> eid_pid_fmap;
-    for(uint pid=0; pid<m_in.num_polys(); ++pid)
-    for(uint eid : m_in.adj_p2e(pid))
+    if(m_in.mesh_type()==HEXMESH)
     {
-        std::vector<uint> inc_f = m_in.poly_e2f(pid,eid);
-        std::vector<uint> f;
-        f.push_back(poly_verts.at(pid));
-        f.push_back(face_verts.at(inc_f.front()));
-        f.push_back(edge_verts.at(eid));
-        f.push_back(face_verts.at(inc_f.back()));
-        eid_pid_fmap[std::make_pair(eid,pid)] = faces.size();
-        faces.push_back(f);
+        std::vector<vec3d> verts;
+        std::vector<uint>  hexas;
+        subdivision_hexa_scheme(m_in, hex_to_grid_2x2x2, verts, hexas);
+        m_out = Hexmesh<M,V,E,F,P>(verts, hexas);
+        return;
     }
 
-    // 3) for each pair (vert,face), make a quad with:
-    //      - poly centroid
-    //      - incident face centroids
-    //      - edge midpoint
-    //
-    std::map<ipair,uint> vid_fid_fmap;
-    for(uint fid = 0; fid<m_in.num_faces(); ++fid)
-    for(uint vid : m_in.adj_f2v(fid))
-    {
-        std::vector<uint> e = m_in.face_v2e(fid,vid);
-        std::vector<uint> f;
-        f.push_back(face_verts.at(fid));
-        f.push_back(edge_verts.at(e.front()));
-        f.push_back(vid);
-        f.push_back(edge_verts.at(e.back()));
-        vid_fid_fmap[std::make_pair(vid,fid)] = faces.size();
-        faces.push_back(f);
-    }
+    std::vector<vec3d> verts(nv+ne+nf+np);
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid) { verts[vid]          = m_in.vert(vid);               });
+    PARALLEL_FOR(0, ne, 1000, [&](uint eid) { verts[nv+eid]       = m_in.edge_sample_at(eid,0.5); });
+    PARALLEL_FOR(0, nf, 1000, [&](uint fid) { verts[nv+ne+fid]    = m_in.face_centroid(fid);      });
+    PARALLEL_FOR(0, np, 1000, [&](uint pid) { verts[nv+ne+nf+pid] = m_in.poly_centroid(pid);      });
 
-    // 4) for each vertex of each poly, make a new polyhedron
-    //    using the faces created at steps (2) and (3)
-    //
-    for(uint pid = 0; pid<m_in.num_polys(); ++pid)
+    switch(m_in.mesh_type())
     {
-        for(uint vid : m_in.adj_p2v(pid))
+        case TETMESH :
         {
-            std::vector<uint> f;
-            std::vector<bool> w;
-            for(uint fid : m_in.poly_v2f(pid,vid))
-            {
-                f.push_back(vid_fid_fmap.at(std::make_pair(vid,fid)));                                
-                // TODO: fix winding order
-                w.push_back(true);
-            }
-            for(uint eid : m_in.poly_v2e(pid,vid))
+            // each tet is split into four hexahedra, one per corner. Corner v, with
+            // the other tet verts a,b,c ordered as in the (positively oriented) tet,
+            // spans the hexa (v, e_va, f_vab, e_vb, e_vc, f_vac, centroid, f_vbc)
+            static const uint corners[4][4] = {{0,1,2,3}, {1,0,3,2}, {2,3,0,1}, {3,2,1,0}};
+            std::vector<uint> hexas(32*np);
+            PARALLEL_FOR(0, np, 1000, [&](uint pid)
             {
-                f.push_back(eid_pid_fmap.at(std::make_pair(eid,pid)));
-                // TODO: check on what side the vertex stays w.r.t. oriented plane to assign correct winding
-                w.push_back(true);
-            }
-            polys.push_back(f);
-            polys_winding.push_back(w);
+                uint v[4];
+                for(uint i=0; i<4; ++i) v[i] = m_in.poly_vert_id(pid,i);
+
+                auto e = [&](const uint i, const uint j)
+                {
+                    return nv + m_in.poly_edge_id(pid, v[i], v[j]);
+                };
+                auto f = [&](const uint opp) // face opposite to vertex opp
+                {
+                    for(uint fid : m_in.adj_p2f(pid))
+                    {
+                        if(!m_in.face_contains_vert(fid, v[opp])) return nv + ne + fid;
+                    }
+                    assert(false);
+                    return 0u;
+                };
+
+                uint * out = hexas.data() + 32*pid;
+                for(uint i=0; i<4; ++i)
+                {
+                    uint a = corners[i][1];
+                    uint b = corners[i][2];
+                    uint c = corners[i][3];
+                    uint vid = corners[i][0];
+                    *out++ = v[vid];
+                    *out++ = e(vid,a);
+                    *out++ = f(c);
+                    *out++ = e(vid,b);
+                    *out++ = e(vid,c);
+                    *out++ = f(b);
+                    *out++ = nv + ne + nf + pid;
+                    *out++ = f(a);
+                }
+            });
+            m_out = Hexmesh<M,V,E,F,P>(verts, hexas);
+            break;
         }
-    }
 
-    switch(m_in.mesh_type())
-    {
-        case TETMESH :
-        case HEXMESH :
+        case POLYHEDRALMESH :
         {
-            std::vector<std::vector<uint>> hexas;
-            sort_poly_vertices_as_hexa(faces, polys, polys_winding, hexas);
-            m_out = Hexmesh<M,V,E,F,P>(verts, hexas);
+            // offsets of the (edge,poly) and (vert,face) quads, and of the sub polys
+            std::vector<uint> ep_off(np+1,0), vf_off(nf+1,0), pv_off(np+1,0);
+            PARALLEL_FOR(0, np, 1000, [&](uint pid) { ep_off[pid+1] = m_in.edges_per_poly(pid); pv_off[pid+1] = m_in.verts_per_poly(pid); });
+            PARALLEL_FOR(0, nf, 1000, [&](uint fid) { vf_off[fid+1] = m_in.verts_per_face(fid); });
+            PARALLEL_PREFIX_SUM(ep_off, 1000);
+            PARALLEL_PREFIX_SUM(vf_off, 1000);
+            PARALLEL_PREFIX_SUM(pv_off, 1000);
+            uint n_ep = ep_off.back();
+
+            std::vector<std::vector<uint>> faces(n_ep + vf_off.back());
+            std::vector<std::vector<uint>> polys(pv_off.back());
+            std::vector<std::vector<bool>> polys_winding(pv_off.back());
+
+            // for each pair (edge,poly), make a quad with:
+            //   - poly centroid
+            //   - incident face centroids
+            //   - edge midpoint
+            //
+            PARALLEL_FOR(0, np, 1000, [&](uint pid)
+            {
+                uint off = ep_off[pid];
+                for(uint eid : m_in.adj_p2e(pid))
+                {
+                    std::vector<uint> inc_f = m_in.poly_e2f(pid,eid);
+                    faces[off++] = { nv+ne+nf+pid, nv+ne+inc_f.front(), nv+eid, nv+ne+inc_f.back() };
+                }
+            });
+
+            // for each pair (vert,face), make a quad with:
+            //   - face centroid
+            //   - incident edge midpoints
+            //   - vertex
+            //
+            PARALLEL_FOR(0, nf, 1000, [&](uint fid)
+            {
+                uint off = n_ep + vf_off[fid];
+                for(uint vid : m_in.adj_f2v(fid))
+                {
+                    std::vector<uint> e = m_in.face_v2e(fid,vid);
+                    faces[off++] = { nv+ne+fid, nv+e.front(), vid, nv+e.back() };
+                }
+            });
+
+            // for each vertex of each poly, make a new polyhedron
+            // using the quads created above
+            //
+            PARALLEL_FOR(0, np, 1000, [&](uint pid)
+            {
+                uint off = pv_off[pid];
+                const std::vector<uint> & p2e = m_in.adj_p2e(pid);
+                for(uint vid : m_in.adj_p2v(pid))
+                {
+                    std::vector<uint> & f = polys[off];
+                    for(uint fid : m_in.poly_v2f(pid,vid))
+                    {
+                        f.push_back(n_ep + vf_off[fid] + m_in.face_vert_offset(fid,vid));
+                    }
+                    for(uint eid : m_in.poly_v2e(pid,vid))
+                    {
+                        f.push_back(ep_off[pid] + std::find(p2e.begin(), p2e.end(), eid) - p2e.begin());
+                    }
+                    // TODO: fix winding order (i.e. check on what side the vertex
+                    // stays w.r.t. each oriented face to assign correct winding)
+                    polys_winding[off++] = std::vector<bool>(f.size(), true);
+                }
+            });
+            m_out = Polyhedralmesh<M,V,E,F,P>(verts, faces, polys, polys_winding);
             break;
         }
-        case POLYHEDRALMESH : m_out = Polyhedralmesh<M,V,E,F,P>(verts, faces, polys, polys_winding);
-                              break;
 
         default : assert(false);
     }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
+                                AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
+                                std::unordered_map<uint,uint>     & edge_verts,
+                                std::unordered_map<uint,uint>     & face_verts,
+                                std::unordered_map<uint,uint>     & poly_verts)
+{
+    uint nv = m_in.num_verts();
+    uint ne = m_in.num_edges();
+    uint nf = m_in.num_faces();
+    uint np = m_in.num_polys();
+
+    subdivision_midpoint(m_in, m_out);
+
+    edge_verts.clear();
+    face_verts.clear();
+    poly_verts.clear();
+    edge_verts.reserve(ne);
+    face_verts.reserve(nf);
+    poly_verts.reserve(np);
+    for(uint eid=0; eid<ne; ++eid) edge_verts[eid] = nv + eid;
+    for(uint fid=0; fid<nf; ++fid) face_verts[fid] = nv + ne + fid;
+    for(uint pid=0; pid<np; ++pid) poly_verts[pid] = nv + ne + nf + pid;
+}
+
 }
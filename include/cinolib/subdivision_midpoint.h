@@ -37,6 +37,7 @@
 #define CINO_SUBDIVISION_MIDPOINT_H
 
 #include <cinolib/meshes/meshes.h>
+#include <unordered_map>
 
 namespace cinolib
 {
@@ -46,6 +47,11 @@ namespace cinolib
  * Hexahedral Meshing Using Midpoint Subdivision and Integer Programming
  * T.S. Li, R.M. McKeag, C.G. Armstrong
  * Computer Methods in Applied Mechanics and Engineering, 1995
+ *
+ * Tetrahedra and hexahedra are split into hexahedra, general polyhedra into polyhedra.
+ * New vertex ids are assigned directly from the ids of the entities they stem from,
+ * as [ input verts | edge midpoints | face centroids | poly centroids ], so that
+ * the output mesh is filled in parallel and assembled with a single bulk constructor
 */
 
 template<class M, class V, class E, class F, class P>
@@ -59,9 +65,9 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void subdivision_midpoint(const AbstractPolyhedralMesh<M,V,E,F,P> & m_in,
                                 AbstractPolyhedralMesh<M,V,E,F,P> & m_out,
-                                std::map<uint,uint>               & edge_verts,
-                                std::map<uint,uint>               & face_verts,
-                                std::map<uint,uint>               & poly_verts);
+                                std::unordered_map<uint,uint>     & edge_verts,  // edge => midpoint id
+                                std::unordered_map<uint,uint>     & face_verts,  // face => centroid id
+                                std::unordered_map<uint,uint>     & poly_verts); // poly => centroid id
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -39,5 +39,6 @@
 #include <cinolib/subdivision_midpoint.h>
 #include <cinolib/subdivision_barycentric.h>
 #include <cinolib/subdivision_legacy_hexa_schemes.h>
+#include <cinolib/subdivision_hexa_scheme.h>
 
 #endif // CINO_SUBDIVISION_SCHEMAS_H
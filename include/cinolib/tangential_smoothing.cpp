@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/tangential_smoothing.h>
+#include <cinolib/laplacian_smoothing.h>
 
 namespace cinolib
 {
@@ -77,10 +78,15 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void tangential_smoothing(Trimesh<M,V,E,P> & m)
 {
-    for(uint vid=0; vid<m.num_verts(); ++vid)
-    {
-        tangential_smoothing(m,vid);
-    }
+    // the per vertex weights used above (i.e. the area of vid) are all equal,
+    // hence this is a tangential smoothing step with uniform weights
+    LaplacianSmoothingOptions opt;
+    opt.n_iters        = 1;
+    opt.laplacian_mode = UNIFORM;
+    opt.lambda         = 1.0;
+    opt.tangential     = true;
+    opt.fix_boundary   = true;
+    laplacian_smoothing(m, opt);
 }
 
 }
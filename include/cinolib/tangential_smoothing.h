@@ -56,6 +56,9 @@ void tangential_smoothing(Trimesh<M,V,E,P> & m, const uint vid);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// smooths all the (non boundary) vertices of the mesh. Vertices are processed in
+// parallel, by independent sets, and normals are updated once at the end of the
+// pass (see laplacian_smoothing)
 template<class M, class V, class E, class P>
 CINO_INLINE
 void tangential_smoothing(Trimesh<M,V,E,P> & m);
@@ -35,6 +35,9 @@
 *********************************************************************************/
 #include <cinolib/tetrahedralization.h>
 #include <cinolib/ipair.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/vector_serialization.h>
+#include <algorithm>
 #include <set>
 
 namespace cinolib
@@ -49,19 +52,124 @@ CINO_INLINE
 void hex_to_tets(const Hexmesh<M,V,E,F,P> & hm,
                        Tetmesh<M,V,E,F,P> & tm)
 {
-    for(uint vid=0; vid<hm.num_verts(); ++vid)
+    std::vector<uint> tet2hex;
+    hex_to_tets(hm, tm, tet2hex);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void hex_to_tets(const Hexmesh<M,V,E,F,P> & hm,
+                       Tetmesh<M,V,E,F,P> & tm,
+                       std::vector<uint>  & tet2hex)
+{
+    // split each hexa into a fixed size slot (at most 6 tets),
+    // then compact the slots into the flat list of tetrahedra
+    uint np = hm.num_polys();
+    std::vector<uint> slots(24*np);
+    std::vector<uint> offsets(np+1,0);
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
     {
-        tm.vert_add(hm.vert(vid));
-    }
+        offsets[pid+1] = hex_to_tets(hm.adj_p2v(pid).data(), slots.data()+24*pid);
+    });
+    PARALLEL_PREFIX_SUM(offsets, 1000);
 
-    for(uint pid=0; pid<hm.num_polys(); ++pid)
+    std::vector<uint> tets(4*offsets.back());
+    tet2hex.resize(offsets.back());
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
     {
-        std::vector<uint> tets;
-        hex_to_tets(hm.poly_verts_id(pid),tets);
+        std::copy(slots.begin() + 24*pid, slots.begin() + 24*pid + 4*(offsets[pid+1]-offsets[pid]), tets.begin() + 4*offsets[pid]);
+        std::fill(tet2hex.begin() + offsets[pid], tet2hex.begin() + offsets[pid+1], pid);
+    });
+    slots.clear();
+    slots.shrink_to_fit();
+
+    tm.clear();
+    tm.init(hm.vector_verts(), polys_from_serialized_vids(tets,4));
+    transfer_attributes_to_tets(hm, tm, tet2hex);
+}
 
-        auto t = polys_from_serialized_vids(tets,4);
-        for(auto tet : t) tm.poly_add(tet);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool hybrid_to_tets(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                          Tetmesh<M,V,E,F,P>                & tm,
+                          std::vector<uint>                 & tet2poly)
+{
+    uint np = m.num_polys();
+    std::vector<uint> slots(24*np);
+    std::vector<uint> offsets(np+1,0);
+    std::vector<char> unsupported(np,0); // (char, as vector<bool> is not thread safe)
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
+    {
+        uint * t = slots.data() + 24*pid;
+        std::vector<uint> vlist = m.poly_ordered_verts_id(pid);
+        switch(vlist.size())
+        {
+            case 4 : std::copy(vlist.begin(), vlist.end(), t);
+                     offsets[pid+1] = 1;
+                     break;
+            case 6 : prism_to_tets(vlist.data(), t);
+                     offsets[pid+1] = 3;
+                     break;
+            case 8 : offsets[pid+1] = hex_to_tets(vlist.data(), t);
+                     break;
+            default: unsupported[pid] = 1; // e.g. pyramids, or six vertex elements that are not prisms
+        }
+    });
+    uint n_unsupported = std::count(unsupported.begin(), unsupported.end(), 1);
+    if(n_unsupported>0)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : hybrid_to_tets() : "
+                  << n_unsupported << " elements are neither tets, prisms nor hexahedra (e.g. poly "
+                  << std::find(unsupported.begin(), unsupported.end(), 1) - unsupported.begin() << ")" << std::endl;
+        tet2poly.clear();
+        return false;
     }
+    PARALLEL_PREFIX_SUM(offsets, 1000);
+
+    std::vector<uint> tets(4*offsets.back());
+    tet2poly.resize(offsets.back());
+    PARALLEL_FOR(0, np, 1000, [&](uint pid)
+    {
+        std::copy(slots.begin() + 24*pid, slots.begin() + 24*pid + 4*(offsets[pid+1]-offsets[pid]), tets.begin() + 4*offsets[pid]);
+        std::fill(tet2poly.begin() + offsets[pid], tet2poly.begin() + offsets[pid+1], pid);
+    });
+    slots.clear();
+    slots.shrink_to_fit();
+
+    tm.clear();
+    tm.init(m.vector_verts(), polys_from_serialized_vids(tets,4));
+    transfer_attributes_to_tets(m, tm, tet2poly);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void transfer_attributes_to_tets(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                       Tetmesh<M,V,E,F,P>                & tm,
+                                 const std::vector<uint>                 & tet2poly)
+{
+    // copy vert and poly attributes, retaining the
+    // normals and quality computed for the new mesh
+    assert(tm.num_verts()==m.num_verts());
+    assert(tm.num_polys()==tet2poly.size());
+    PARALLEL_FOR(0, tm.num_verts(), 1000, [&](uint vid)
+    {
+        vec3d n = tm.vert_data(vid).normal;
+        tm.vert_data(vid) = m.vert_data(vid);
+        tm.vert_data(vid).normal = n;
+    });
+    PARALLEL_FOR(0, tm.num_polys(), 1000, [&](uint pid)
+    {
+        float q = tm.poly_data(pid).quality;
+        tm.poly_data(pid) = m.poly_data(tet2poly[pid]);
+        tm.poly_data(pid).quality = q;
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -72,15 +180,12 @@ void hex_to_tets(const Hexmesh<M,V,E,F,P> & hm,
 // mesh, where diagonals of quad faces are compatible across
 // face-adjacent hexahedra
 CINO_INLINE
-void hex_to_tets(const std::vector<uint> & hex,
-                       std::vector<uint> & tets)
+uint hex_to_tets(const uint * hex,
+                       uint * tets)
 {
-    assert(hex.size()==8);
-    tets.clear();
-
     // see Table 4 in "How to Subdivide Pyramids, Prisms and Hexahedra into Tetrahedra"
     uint ref_h[8];
-    switch(INDEX_OF(hex, std::min_element(hex.begin(),hex.end())))
+    switch(std::min_element(hex,hex+8) - hex)
     {
         case 0: ref_h[0] = hex[0];
                 ref_h[1] = hex[1];
@@ -206,130 +311,142 @@ void hex_to_tets(const std::vector<uint> & hex,
     switch(n)
     {
         case 0: // t0
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[5]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[5];
                 // t1
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[5]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[5];
                 // t2
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[3]);
-                tets.push_back(ref_h[7]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[3];
+                *tets++ = ref_h[7];
                 // t3
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[4]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[4];
                 // t4
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[6];
                 break;
 
         case 1: // t0
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[4]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[4];
                 // t1
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[5]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[5];
                 // t2
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[5]);
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[5];
                 // t3
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[3]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[3];
                 // t4
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[2]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[2];
                 // t5
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[2]);
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[2];
                 break;
 
         case 2: // t0
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[4]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[4];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[6];
                 // t1
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[3]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[3];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[6];
                 // t2
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[4]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[4];
+                *tets++ = ref_h[6];
                 // t3
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[5]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[5];
                 // t4
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[3]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[2]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[3];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[2];
                 // t5
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[2]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[2];
                 break;
 
         case 3: // t0
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[3]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[3];
+                *tets++ = ref_h[6];
                 // t1
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[3]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[3];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[6];
                 // t2
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[7]);
-                tets.push_back(ref_h[4]);
-                tets.push_back(ref_h[6]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[7];
+                *tets++ = ref_h[4];
+                *tets++ = ref_h[6];
                 // t3
-                tets.push_back(ref_h[0]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[4]);
+                *tets++ = ref_h[0];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[4];
                 // t4
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[5]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[0]);
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[5];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[0];
                 // t5
-                tets.push_back(ref_h[1]);
-                tets.push_back(ref_h[6]);
-                tets.push_back(ref_h[2]);
-                tets.push_back(ref_h[0]);
+                *tets++ = ref_h[1];
+                *tets++ = ref_h[6];
+                *tets++ = ref_h[2];
+                *tets++ = ref_h[0];
                 break;
 
         default: assert(false);
     }
+    return (n==0) ? 5 : 6;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void hex_to_tets(const std::vector<uint> & hex,
+                       std::vector<uint> & tets)
+{
+    assert(hex.size()==8);
+    tets.resize(24);
+    tets.resize(4*hex_to_tets(hex.data(), tets.data()));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -338,21 +455,18 @@ void hex_to_tets(const std::vector<uint> & hex,
 // Prism vertices are assumed in the following order:
 //
 //      v2             v5
-//    /    \         /    \
-//  v0 --- v1      v3 --- v4
+//    /    \         /    \     (v3, v4, v5 lie
+//  v0 --- v1      v3 --- v4     above v0, v1, v2)
 //
 //   bot base       top base
 //
 CINO_INLINE
-void prism_to_tets(const std::vector<uint> & prism,
-                         std::vector<uint> & tets)
+void prism_to_tets(const uint * prism,
+                         uint * tets)
 {
-    assert(prism.size()==6);
-    tets.clear();
-
     // see Table 2 in "How to Subdivide Pyramids, Prisms and Hexahedra into Tetrahedra"
     uint ref_p[6];
-    switch(INDEX_OF(prism, std::min_element(prism.begin(),prism.end())))
+    switch(std::min_element(prism,prism+6) - prism)
     {
         case 0: ref_p[0] = prism[0];
                 ref_p[1] = prism[1];
@@ -409,34 +523,45 @@ void prism_to_tets(const std::vector<uint> & prism,
     if(std::min(ref_p[1],ref_p[5]) < std::min(ref_p[2],ref_p[4]))
     {
         // t0
-        tets.push_back(ref_p[0]);
-        tets.push_back(ref_p[1]);
-        tets.push_back(ref_p[2]);
-        tets.push_back(ref_p[5]);
+        *tets++ = ref_p[0];
+        *tets++ = ref_p[1];
+        *tets++ = ref_p[2];
+        *tets++ = ref_p[5];
         // t1
-        tets.push_back(ref_p[0]);
-        tets.push_back(ref_p[1]);
-        tets.push_back(ref_p[5]);
-        tets.push_back(ref_p[4]);
+        *tets++ = ref_p[0];
+        *tets++ = ref_p[1];
+        *tets++ = ref_p[5];
+        *tets++ = ref_p[4];
     }
     else
     {
         // t0
-        tets.push_back(ref_p[0]);
-        tets.push_back(ref_p[1]);
-        tets.push_back(ref_p[2]);
-        tets.push_back(ref_p[4]);
+        *tets++ = ref_p[0];
+        *tets++ = ref_p[1];
+        *tets++ = ref_p[2];
+        *tets++ = ref_p[4];
         // t1
-        tets.push_back(ref_p[0]);
-        tets.push_back(ref_p[4]);
-        tets.push_back(ref_p[2]);
-        tets.push_back(ref_p[5]);
+        *tets++ = ref_p[0];
+        *tets++ = ref_p[4];
+        *tets++ = ref_p[2];
+        *tets++ = ref_p[5];
     }
     // t2
-    tets.push_back(ref_p[0]);
-    tets.push_back(ref_p[4]);
-    tets.push_back(ref_p[5]);
-    tets.push_back(ref_p[3]);
+    *tets++ = ref_p[0];
+    *tets++ = ref_p[4];
+    *tets++ = ref_p[5];
+    *tets++ = ref_p[3];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void prism_to_tets(const std::vector<uint> & prism,
+                         std::vector<uint> & tets)
+{
+    assert(prism.size()==6);
+    tets.resize(12);
+    prism_to_tets(prism.data(), tets.data());
 }
 
 }
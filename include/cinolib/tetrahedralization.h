@@ -52,11 +52,44 @@ namespace cinolib
 
 // Transforms a hexahedral mesh into a conforming tetrahedral
 // mesh, splitting all hexahedra into five or six tetrahedra.
+// Hexahedra are split in parallel into a flat list of tets,
+// and vert/poly attributes (e.g. labels) are inherited from
+// the input mesh. tet2hex maps each tet to its hexahedron
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void hex_to_tets(const Hexmesh<M,V,E,F,P> & hm,
                        Tetmesh<M,V,E,F,P> & tm);
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void hex_to_tets(const Hexmesh<M,V,E,F,P> & hm,
+                       Tetmesh<M,V,E,F,P> & tm,
+                       std::vector<uint>  & tet2hex);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Same as above, for hybrid meshes made of tetrahedra, prisms with
+// triangular base and hexahedra. Prisms and hexahedra are split with
+// the same diagonal rule, hence the output mesh is conforming also
+// across prism/hexa faces. tet2poly maps each tet to its source poly.
+// If the mesh contains any other element (e.g. a pyramid) it returns
+// false, leaving tm untouched
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool hybrid_to_tets(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                          Tetmesh<M,V,E,F,P>                & tm,
+                          std::vector<uint>                 & tet2poly);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Copies vert and poly attributes of m into its tetrahedralization tm
+// (vertices are shared, tet2poly maps each tet to its source poly)
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void transfer_attributes_to_tets(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                                       Tetmesh<M,V,E,F,P>                & tm,
+                                 const std::vector<uint>                 & tet2poly);
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 // Subdivides a hexahedron either into 5 tets or into 6 tets
@@ -68,20 +101,31 @@ CINO_INLINE
 void hex_to_tets(const std::vector<uint> & hex,
                        std::vector<uint> & tets);
 
+// Same as above, writing the tets into a buffer of (at least) 24
+// elements. Returns the number of tets (i.e. five or six)
+CINO_INLINE
+uint hex_to_tets(const uint * hex,
+                       uint * tets);
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 // Subdivides a prism with triangular base into 3 tets.
 // Prism vertices are assumed in the following order:
 //
 //      v2             v5
-//    /    \         /    \
-//  v0 --- v1      v3 --- v4
+//    /    \         /    \     (v3, v4, v5 lie
+//  v0 --- v1      v3 --- v4     above v0, v1, v2)
 //
 //   bot base       top base
 //
 CINO_INLINE
 void prism_to_tets(const std::vector<uint> & prism,
                          std::vector<uint> & tets);
+
+// Same as above, writing the tets into a buffer of (at least) 12 elements
+CINO_INLINE
+void prism_to_tets(const uint * prism,
+                         uint * tets);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -222,10 +222,10 @@ void texture_parula_with_isolines(Texture & texture)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+#ifdef CINOLIB_USES_QT
 CINO_INLINE
 void texture_bitmap(Texture & texture, const char *bitmap)
 {
-#ifdef CINOLIB_USES_QT
     // https://stackoverflow.com/questions/20245865/render-qimage-with-opengl
     QImage img = QGLWidget::convertToGLFormat(QImage(bitmap));
     if (img.height()!=img.width())
@@ -240,9 +240,13 @@ void texture_bitmap(Texture & texture, const char *bitmap)
     texture.size = img.height();
     texture.data = new uint8_t[texture.size*texture.size*4];
     std::copy(img.bits(), img.bits()+(texture.size*texture.size*4), texture.data);
+}
 #else
+CINO_INLINE
+void texture_bitmap(Texture & /*texture*/, const char * /*bitmap*/)
+{
     std::cerr << "ERROR : Qt missing. Install Qt and recompile defining symbol CINOLIB_USES_QT" << std::endl;
-#endif
 }
+#endif
 
 }
@@ -56,7 +56,7 @@ template<class T>
 CINO_INLINE
 uint Tree<T>::add_children(T item, uint father)
 {
-    assert(father >= 0 && father < tree.size());
+    assert(father < tree.size());
 
     uint fresh_id = tree.size();
     node(father).children.push_back(fresh_id);
@@ -36,6 +36,7 @@
 #include <cinolib/triangle_wrap.h>
 #include <cinolib/geometry/vec3.h>
 #include <cinolib/vector_serialization.h>
+#include <mutex>
 
 #ifdef CINOLIB_USES_TRIANGLE
     /*
@@ -124,7 +125,13 @@ void triangle_wrap(const std::vector<double> & coords_in,
 
     std::string s = flags + "pzB";
 
-    triangulate(const_cast<char*>(s.c_str()), &in, &out, NULL);
+    // Triangle keeps part of its state in global variables (e.g. the seed used to
+    // sample point location starting points), hence calls cannot run concurrently
+    static std::mutex triangle_mutex;
+    {
+        std::lock_guard<std::mutex> lock(triangle_mutex);
+        triangulate(const_cast<char*>(s.c_str()), &in, &out, NULL);
+    }
 
     coords_out.reserve(out.numberofpoints*2);
     for(int vid=0; vid<out.numberofpoints; ++vid)
@@ -47,6 +47,12 @@
 namespace cinolib
 {
 
+/* Calls to Triangle are serialized with a process wide mutex, as the library is
+ * not reentrant. Hence, these functions can be safely used from multiple threads,
+ * but they will not triangulate concurrently: in parallel loops, only the work
+ * done before and after each call (e.g. input conversion) runs in parallel.
+*/
+
 CINO_INLINE
 void triangle_wrap(const std::vector<double> & coords_in,  // serialized input xy coordinates
                    const std::vector<uint>   & segs_in,    // serialized segments
@@ -0,0 +1,128 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/union_find.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+CINO_INLINE
+UnionFind::UnionFind(const uint n)
+{
+    init(n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void UnionFind::init(const uint n)
+{
+    std::vector<std::atomic<uint>> tmp(n);
+    parent.swap(tmp);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        parent[i].store(i, std::memory_order_relaxed);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint UnionFind::find(uint i)
+{
+    uint p = parent[i].load(std::memory_order_relaxed);
+    while(p!=i)
+    {
+        // path halving: point i to its grandparent. Parents only move towards
+        // the root, so a failed exchange just means someone else did the job
+        uint gp = parent[p].load(std::memory_order_relaxed);
+        if(gp!=p) parent[i].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        i = p;
+        p = parent[i].load(std::memory_order_relaxed);
+    }
+    return i;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool UnionFind::merge(uint i, uint j)
+{
+    while(true)
+    {
+        i = find(i);
+        j = find(j);
+        if(i==j) return false;
+        if(i<j) std::swap(i,j);
+        // link the larger root under the smaller one. If i is no longer a root
+        // (another thread linked it meanwhile) the exchange fails and we retry
+        uint expected = i;
+        if(parent[i].compare_exchange_strong(expected, j, std::memory_order_relaxed)) return true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint UnionFind::labels(std::vector<int> & labels, const std::vector<bool> & mask)
+{
+    uint n = parent.size();
+    if(n==0)
+    {
+        labels.clear();
+        return 0;
+    }
+
+    // flatten the forest, and enumerate the roots with a prefix sum
+    std::vector<uint> root_rank(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        uint r = find(i);
+        parent[i].store(r, std::memory_order_relaxed);
+        root_rank[i] = (r==i && (mask.empty() || !mask[i])) ? 1 : 0;
+    });
+    PARALLEL_PREFIX_SUM(root_rank, 10000);
+
+    labels.resize(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        if(!mask.empty() && mask[i]) labels[i] = -1;
+        else labels[i] = int(root_rank[parent[i].load(std::memory_order_relaxed)]) - 1;
+    });
+    return root_rank.back();
+}
+
+}
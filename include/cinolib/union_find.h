@@ -0,0 +1,99 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_UNION_FIND_H
+#define CINO_UNION_FIND_H
+
+#include <cinolib/cino_inline.h>
+#include <sys/types.h>
+#include <atomic>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Lock-free disjoint set forest. merge() and find() can be called concurrently
+ * from multiple threads (e.g. inside a PARALLEL_FOR over the edges of a graph):
+ * roots are linked with compare-and-swap, and paths are compressed by halving.
+ * Roots are always linked to the root with smaller id, hence at the end the root
+ * of each set is its element with lowest id, regardless of the merge order.
+ *
+ * Usage:
+ *
+ *     UnionFind uf(n);
+ *     PARALLEL_FOR(0, edges.size(), 1000, [&](uint i)
+ *     {
+ *         uf.merge(edges[i].first, edges[i].second);
+ *     });
+ *     std::vector<int> labels;
+ *     uint n_sets = uf.labels(labels);
+*/
+
+class UnionFind
+{
+    public:
+
+        explicit UnionFind(const uint n = 0);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void init(const uint n);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint size() const { return parent.size(); }
+        uint find (uint i);
+        bool merge(uint i, uint j); // returns false if i,j were already in the same set
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // labels each element with the index of its set, in [0,#sets). Sets are
+        // numbered in order of their lowest element. Elements flagged in mask
+        // (if not empty) get label -1 and are not counted. Returns the number of sets.
+        // Must not be called concurrently with merge()
+        uint labels(std::vector<int> & labels, const std::vector<bool> & mask = std::vector<bool>());
+
+    protected:
+
+        std::vector<std::atomic<uint>> parent;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "union_find.cpp"
+#endif
+
+#endif // CINO_UNION_FIND_H
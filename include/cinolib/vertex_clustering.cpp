@@ -34,48 +34,135 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/vertex_clustering.h>
-#include <cinolib/bfs.h>
+#include <cinolib/hash_grid.h>
+#include <cinolib/union_find.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
 
+template<class real>
+CINO_INLINE
+vec3d vertex_clustering_point(const vec3<real> & p)
+{
+    return vec3d(p.x(), p.y(), p.z());
+}
+
+template<class real>
+CINO_INLINE
+vec3d vertex_clustering_point(const vec2<real> & p)
+{
+    return vec3d(p.x(), p.y(), 0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Vertex>
 CINO_INLINE
 void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters)
 {
-    // build v2v connectivity based on point proximity
-    std::vector<std::vector<uint>> v2v(points.size());
-    for(uint vid0=0;      vid0<points.size()-1; ++vid0)
-    for(uint vid1=vid0+1; vid1<points.size();   ++vid1)
+    std::vector<int> cluster_id;
+    uint n_clusters = vertex_clustering(points, proximity_thresh, cluster_id);
+    uint offset     = clusters.size();
+    clusters.resize(offset + n_clusters);
+    for(uint vid=0; vid<points.size(); ++vid)
     {
-        if (points.at(vid0).dist(points.at(vid1)) < proximity_thresh)
+        clusters.at(offset + cluster_id.at(vid)).insert(vid);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Vertex>
+CINO_INLINE
+uint vertex_clustering(const std::vector<Vertex> & points,
+                       const double                proximity_thresh,
+                       std::vector<int>          & cluster_id)
+{
+    UnionFind uf(points.size());
+
+    if(proximity_thresh>0)
+    {
+        std::vector<vec3d> pos(points.size());
+        PARALLEL_FOR(0, points.size(), 10000, [&](uint vid)
         {
-            v2v.at(vid0).push_back(vid1);
-            v2v.at(vid1).push_back(vid0);
-        }
+            pos.at(vid) = vertex_clustering_point(points.at(vid));
+        });
+
+        HashGrid grid(proximity_thresh);
+        grid.build(pos);
+
+        double thresh_sqrd = proximity_thresh*proximity_thresh;
+        grid.for_each_pair_in_range(proximity_thresh, [&](const uint vid0, const uint vid1, const double dist_sqrd)
+        {
+            if(dist_sqrd<thresh_sqrd) uf.merge(vid0,vid1);
+        });
     }
 
-    // visit the resulting graph with BFS to
-    // isolate clusters of adjacent vertices
-    uint nv   = points.size();
-    uint seed = 0;
-    std::vector<bool> visited(nv, false);
-    do
+    return uf.labels(cluster_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void weld_vertices(const std::vector<vec3d>             & verts,
+                   const std::vector<std::vector<uint>> & polys,
+                   const double                           proximity_thresh,
+                         std::vector<vec3d>             & welded_verts,
+                         std::vector<std::vector<uint>> & welded_polys)
+{
+    std::vector<int> cluster_id;
+    uint n_clusters = vertex_clustering(verts, proximity_thresh, cluster_id);
+
+    // clusters are numbered by lowest vertex id, so the first
+    // vertex met for each cluster is its representative
+    welded_verts.clear();
+    welded_verts.reserve(n_clusters);
+    for(uint vid=0; vid<verts.size(); ++vid)
     {
-        std::unordered_set<uint> cluster;
-        bfs(v2v, seed, cluster);
+        if(cluster_id.at(vid)==(int)welded_verts.size()) welded_verts.push_back(verts.at(vid));
+    }
 
-        clusters.push_back(cluster);
-        for(uint vid : cluster) visited.at(vid) = true;
+    std::vector<std::vector<uint>> tmp(polys.size());
+    std::vector<char>              valid(polys.size());
+    PARALLEL_FOR(0, polys.size(), 10000, [&](uint pid)
+    {
+        std::vector<uint> & p = tmp.at(pid);
+        p.reserve(polys.at(pid).size());
+        for(uint vid : polys.at(pid))
+        {
+            uint cid = cluster_id.at(vid);
+            if(p.empty() || p.back()!=cid) p.push_back(cid);
+        }
+        while(p.size()>1 && p.back()==p.front()) p.pop_back();
+        valid.at(pid) = (p.size()>=3);
+    });
 
-        seed = 0;
-        while (seed < nv && visited.at(seed)) ++seed;
+    welded_polys.clear();
+    welded_polys.reserve(polys.size());
+    for(uint pid=0; pid<polys.size(); ++pid)
+    {
+        if(valid.at(pid)) welded_polys.push_back(std::move(tmp.at(pid)));
     }
-    while (seed < nv);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void weld_vertices(const std::vector<vec3d>             & verts,
+                   const std::vector<std::vector<uint>> & polys,
+                   const double                           proximity_thresh,
+                   AbstractPolygonMesh<M,V,E,P>         & m)
+{
+    std::vector<vec3d>             welded_verts;
+    std::vector<std::vector<uint>> welded_polys;
+    weld_vertices(verts, polys, proximity_thresh, welded_verts, welded_polys);
+
+    m.clear();
+    m.init(welded_verts, welded_polys);
 }
 
+}
@@ -40,6 +40,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
 
 
 namespace cinolib
@@ -48,7 +49,7 @@ namespace cinolib
 /* Groups a list of vertices in clusters of elements closer
  * to each other less than a given proximity threshold
  *
- * NOTE: class Vertex should implement the dist() operator
+ * NOTE: class Vertex should be either a vec2 or a vec3
 */
 
 template<class Vertex>
@@ -57,6 +58,45 @@ void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Same as above, but clusters are returned as a flat array of per point
+ * cluster ids in [0,#clusters), numbered in order of their lowest point id.
+ * Close pairs are found with a HashGrid, and merged in parallel with a
+ * UnionFind, hence the cost is roughly linear in the number of points.
+ * Returns the number of clusters.
+*/
+
+template<class Vertex>
+CINO_INLINE
+uint vertex_clustering(const std::vector<Vertex> & points,
+                       const double                proximity_thresh,
+                       std::vector<int>          & cluster_id);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Welds a polygon soup (e.g. the output of read_STL without vertex merging),
+ * merging the vertices in each cluster (see above) into the one with lowest id.
+ * Consecutive repeated vertices are removed from the polygons, and polygons left
+ * with less than three vertices are discarded.
+*/
+
+CINO_INLINE
+void weld_vertices(const std::vector<vec3d>             & verts,
+                   const std::vector<std::vector<uint>> & polys,
+                   const double                           proximity_thresh,
+                         std::vector<vec3d>             & welded_verts,
+                         std::vector<std::vector<uint>> & welded_polys);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void weld_vertices(const std::vector<vec3d>             & verts,
+                   const std::vector<std::vector<uint>> & polys,
+                   const double                           proximity_thresh,
+                   AbstractPolygonMesh<M,V,E,P>         & m);
+
 }
 
 #ifndef  CINO_STATIC_LIB
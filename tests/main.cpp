@@ -0,0 +1,32 @@
+/* Runs all the registered regression tests (or only the ones whose
+ * name contains the string passed as first argument), and returns
+ * the number of failed tests.
+ *
+ * Usage: ./run_tests [name_filter]
+*/
+
+#include <chrono>
+#include "tests.h"
+
+int main(int argc, char ** argv)
+{
+    std::string filter = (argc>1) ? argv[1] : "";
+
+    int failed_tests = 0;
+    for(const cinolib_tests::Test & t : cinolib_tests::registry())
+    {
+        if(t.name.find(filter)==std::string::npos) continue;
+
+        unsigned int before = cinolib_tests::num_failed_checks();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        t.run();
+        auto t1 = std::chrono::high_resolution_clock::now();
+        bool ok = (cinolib_tests::num_failed_checks()==before);
+        if(!ok) ++failed_tests;
+
+        std::cerr << (ok ? "[  OK  ] " : "[FAILED] ") << t.name << " ("
+                  << std::chrono::duration<double>(t1-t0).count() << "s)" << std::endl;
+    }
+    std::cerr << failed_tests << " failed test(s)" << std::endl;
+    return failed_tests;
+}
@@ -0,0 +1,90 @@
+#include "tests.h"
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/Poisson_sampling.h>
+#include <cinolib/hash_grid.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// true if no two samples are closer than radius
+bool min_dist_ok(const std::vector<vec3d> & samples, const double radius)
+{
+    HashGrid grid(radius);
+    grid.build(samples);
+    bool ok = true;
+    grid.for_each_pair_in_range(radius, [&](const uint, const uint, const double d_sqrd)
+    {
+        if(d_sqrd < radius*radius*(1-1e-12)) ok = false;
+    });
+    return ok;
+}
+
+// square of side l, made of two triangles, with lower left corner at o
+void push_square(const vec3d & o, const double l, std::vector<vec3d> & verts, std::vector<uint> & tris)
+{
+    uint base = verts.size();
+    verts.push_back(o);
+    verts.push_back(o + vec3d(l,0,0));
+    verts.push_back(o + vec3d(l,l,0));
+    verts.push_back(o + vec3d(0,l,0));
+    tris.insert(tris.end(), {base, base+1, base+2, base, base+2, base+3});
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// no two samples are closer than the radius, also when the domain spans
+// many more cells than fit in a 64 bits key (e.g. far apart components)
+CINO_TEST(Poisson_sampling_min_distance)
+{
+    Trimesh<> m(DATA_PATH "bunny.obj");
+    double radius = m.bbox().diag()*0.01;
+    std::vector<vec3d> samples;
+    Poisson_sampling(m, radius, samples);
+    CINO_CHECK(samples.size()>100);
+    CINO_CHECK(min_dist_ok(samples, radius));
+
+    std::vector<vec2d> samples2d;
+    Poisson_sampling<2,vec2d>(0.05, vec2d(-1,-1), vec2d(1,1), samples2d);
+    std::vector<vec3d> lifted;
+    for(const vec2d & p : samples2d) lifted.push_back(vec3d(p.x(), p.y(), 0));
+    CINO_CHECK(lifted.size()>100);
+    CINO_CHECK(min_dist_ok(lifted, 0.05));
+
+    // two squares 2^21 and 2^22 cells away from the first one
+    radius = 1.0;
+    std::vector<vec3d> verts;
+    std::vector<uint>  tris;
+    push_square(vec3d(0,0,0),                    20, verts, tris);
+    push_square(vec3d(double(1<<21),0,0),        20, verts, tris);
+    push_square(vec3d(double(1<<22),0,0),        20, verts, tris);
+    Trimesh<> far(verts, tris);
+    Poisson_sampling(far, radius, samples);
+    CINO_CHECK(samples.size()>300);
+    CINO_CHECK(min_dist_ok(samples, radius));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// the same seed gives the same samples, different seeds different ones
+CINO_TEST(Poisson_sampling_seed_reproducibility)
+{
+    Trimesh<> m(DATA_PATH "bunny.obj");
+    double radius = m.bbox().diag()*0.02;
+    std::vector<vec3d> s0, s1, s2;
+    Poisson_sampling(m, radius, s0, 7);
+    Poisson_sampling(m, radius, s1, 7);
+    Poisson_sampling(m, radius, s2, 8);
+    CINO_CHECK(s0==s1);
+    CINO_CHECK(s0!=s2);
+
+    std::vector<vec3d> b0, b1;
+    Poisson_sampling<3,vec3d>(0.1, vec3d(0,0,0), vec3d(1,1,1), b0, 3);
+    Poisson_sampling<3,vec3d>(0.1, vec3d(0,0,0), vec3d(1,1,1), b1, 3);
+    CINO_CHECK(!b0.empty() && b0==b1);
+}
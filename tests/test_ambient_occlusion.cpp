@@ -0,0 +1,43 @@
+#include "tests.h"
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/ambient_occlusion_cpu.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// a plane covering half of the hemisphere above the origin occludes exactly half
+// of the cosine weighted directions. The estimate must be unbiased for any number
+// of rays, including the ones that are not perfect squares
+CINO_TEST(ao_unbiased_for_any_number_of_rays)
+{
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> tris;
+    uint   n = 40;
+    double l = 2000;
+    for(uint i=0; i<=n; ++i)
+    for(uint j=0; j<=n; ++j) verts.push_back(vec3d(-l+2*l*i/n, l*j/n, 1));
+    for(uint i=0; i<n; ++i)
+    for(uint j=0; j<n; ++j)
+    {
+        uint a = i*(n+1)+j;
+        uint b = a+n+1;
+        tris.push_back({a,b,b+1});
+        tris.push_back({a,b+1,a+1});
+    }
+    Trimesh<> occluder(verts, tris);
+    Octree octree;
+    octree.build_from_mesh_polys(occluder);
+
+    for(uint n_dirs : {7u, 200u, 255u, 256u})
+    {
+        double avg = 0;
+        uint   n_trials = 300;
+        for(uint seed=0; seed<n_trials; ++seed)
+        {
+            avg += AO_unoccluded_rays(octree, vec3d(0,0,0), vec3d(0,0,1), seed, 0, n_dirs, inf_double)/double(n_dirs);
+        }
+        avg /= n_trials;
+        CINO_CHECK(std::fabs(avg-0.5)<0.01);
+    }
+}
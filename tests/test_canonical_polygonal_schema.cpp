@@ -0,0 +1,183 @@
+#include "tests.h"
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/homotopy_basis.h>
+#include <cinolib/canonical_polygonal_schema.h>
+#include <cinolib/harmonic_map.h>
+#include <cinolib/geometry/n_sided_poygon.h>
+#include <cinolib/sampling.h>
+#include <cinolib/stl_container_utilities.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// the original cut, which re-adds every polygon around a cut vertex
+void reference_cut(Trimesh<> & m, std::unordered_map<uint,std::vector<uint>> & v_map)
+{
+    m.vert_set_flag(MARKED,false);
+    v_map.clear();
+
+    uint nv = m.num_verts();
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        if(m.vert_data(vid).flags[MARKED]) continue;
+        m.vert_data(vid).flags[MARKED] = true;
+
+        std::vector<std::vector<uint>> clusters;
+        m.vert_cluster_one_ring(vid, clusters, true);
+
+        std::vector<uint> to_remove;
+        for(uint i=1; i<clusters.size(); ++i)
+        {
+            uint new_vid = m.vert_add(m.vert(vid));
+            m.vert_data(new_vid) = m.vert_data(vid);
+            v_map[vid].push_back(new_vid);
+
+            for(uint pid : clusters.at(i))
+            {
+                auto verts = m.poly_verts_id(pid);
+                for(uint & id : verts) if(id==vid) id = new_vid;
+                m.poly_add(verts);
+                to_remove.push_back(pid);
+            }
+        }
+        if(!to_remove.empty()) m.polys_remove(to_remove);
+    }
+}
+
+// canonical_polygonal_schema as it was before the in place cut
+void reference_cps(Trimesh<> & m_in, const HomotopyBasisData & basis, Trimesh<> & m_out)
+{
+    int genus = m_in.genus();
+    m_in.vert_apply_label(-1);
+    for(uint lid=0; lid<basis.loops.size(); ++lid)
+    {
+        for(uint vid : basis.loops.at(lid)) m_in.vert_data(vid).label = lid;
+    }
+    std::unordered_map<uint,std::vector<uint>> v_map;
+    reference_cut(m_in, v_map);
+
+    std::vector<uint> copies_of_root = v_map.at(basis.root);
+    copies_of_root.push_back(basis.root);
+    m_in.vert_set_flag(MARKED,false);
+    for(uint vid : copies_of_root) m_in.vert_data(vid).flags[MARKED] = true;
+
+    std::vector<uint> split_list;
+    for(uint eid=0; eid<m_in.num_edges(); ++eid)
+    {
+        if(m_in.edge_is_boundary(eid)) continue;
+        uint v0 = m_in.edge_vert_id(eid,0);
+        uint v1 = m_in.edge_vert_id(eid,1);
+        if(m_in.vert_is_boundary(v0) && m_in.vert_is_boundary(v1) &&
+          (m_in.vert_data(v0).label==m_in.vert_data(v1).label))
+        {
+            split_list.push_back(eid);
+        }
+    }
+    for(uint eid : split_list) m_in.edge_split(eid);
+
+    std::vector<uint> border = m_in.get_ordered_boundary_vertices();
+    CIRCULAR_SHIFT_VEC(border, copies_of_root.front());
+
+    std::vector<std::vector<uint>> edges;
+    for(uint i=0; i<border.size(); ++i)
+    {
+        std::vector<uint> e = { border.at(i) };
+        for(uint j=i+1; j<border.size() && !m_in.vert_data(border.at(j)).flags[MARKED]; ++j,++i)
+        {
+            e.push_back(border.at(j));
+        }
+        e.push_back(border.at((i+1)%border.size()));
+        edges.push_back(e);
+    }
+
+    std::vector<vec3d> poly = n_sided_polygon(genus*4, CIRCLE);
+    for(auto & p : poly) rotate(p, vec3d(0,0,1), M_PI*0.25);
+    std::map<uint,vec3d> dirichlet_bcs;
+    for(uint i=0; i<poly.size(); ++i)
+    {
+        std::vector<vec3d> e_bcs = sample_within_interval(poly.at(i), poly.at((i+1)%poly.size()), edges.at(i).size());
+        for(uint j=0; j<e_bcs.size(); ++j) dirichlet_bcs[edges.at(i).at(j)] = e_bcs.at(j);
+    }
+
+    m_out = m_in;
+    m_out.vector_verts() = harmonic_map_3d(m_in, dirichlet_bcs, 1, COTANGENT);
+}
+
+// copies of a vertex share the same position, but not the same incident polygons.
+// A vertex is identified by its position and the centroid of its incident polygons
+vec3d star_centroid(const Trimesh<> & m, const uint vid)
+{
+    vec3d c(0,0,0);
+    for(uint pid : m.adj_v2p(vid)) c += m.poly_centroid(pid);
+    return c/static_cast<double>(m.adj_v2p(vid).size());
+}
+
+// finds the vertex of m that corresponds to vertex vid of m_ref (with respect to the
+// cut mesh of each path, m_in and m_ref_in)
+uint match(const Trimesh<> & m_in, const Trimesh<> & m_ref_in, const uint vid)
+{
+    vec3d p = m_ref_in.vert(vid);
+    vec3d c = star_centroid(m_ref_in, vid);
+    for(uint i=0; i<m_in.num_verts(); ++i)
+    {
+        if(m_in.vert(i).dist(p)<1e-12 && star_centroid(m_in,i).dist(c)<1e-9) return i;
+    }
+    return m_in.num_verts();
+}
+
+bool same_schema(const char * mesh, const uint root)
+{
+    Trimesh<> m(mesh);
+    HomotopyBasisData basis;
+    basis.globally_shortest = false;
+    basis.root              = root;
+    basis.detach_loops      = true;
+    basis.split_strategy    = EDGE_SPLIT_STRATEGY;
+    homotopy_basis(m, basis);
+
+    Trimesh<> m_ref = m, m_ref_uv;
+    reference_cps(m_ref, basis, m_ref_uv);
+    Trimesh<> m_uv;
+    canonical_polygonal_schema(m, basis, m_uv);
+
+    // same counts
+    if(m.num_verts()!=m_ref.num_verts() || m.num_edges()!=m_ref.num_edges() || m.num_polys()!=m_ref.num_polys()) return false;
+    if(m_uv.num_verts()!=m_ref_uv.num_verts()) return false;
+
+    // same boundary loop, visited from the same corner (the first copy of the root)
+    std::vector<uint> b_ref = m_ref.get_ordered_boundary_vertices();
+    std::vector<uint> b     = m.get_ordered_boundary_vertices();
+    if(b.size()!=b_ref.size()) return false;
+    uint first = match(m, m_ref, b_ref.front());
+    if(DOES_NOT_CONTAIN_VEC(b, first)) return false;
+    CIRCULAR_SHIFT_VEC(b, first);
+    for(uint i=0; i<b.size(); ++i)
+    {
+        if(match(m, m_ref, b_ref.at(i))!=b.at(i)) return false;
+        if(m.vert_data(b.at(i)).flags[MARKED]!=m_ref.vert_data(b_ref.at(i)).flags[MARKED]) return false;
+    }
+
+    // every vertex, and therefore every polygon corner, lands at the same place
+    for(uint vid=0; vid<m_ref.num_verts(); ++vid)
+    {
+        uint i = match(m, m_ref, vid);
+        if(i>=m.num_verts() || m_uv.vert(i).dist(m_ref_uv.vert(vid))>1e-6) return false;
+    }
+    return true;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// the in place cut must produce the same canonical polygonal schema as the
+// original cut, with the 4g-gon corners in the same order
+CINO_TEST(canonical_polygonal_schema_matches_reference)
+{
+    CINO_CHECK(same_schema(DATA_PATH "torus.obj", 152));
+    CINO_CHECK(same_schema(DATA_PATH "3holes.obj", 0));
+}
@@ -0,0 +1,67 @@
+#include "tests.h"
+#include <cinolib/hash_grid.h>
+#include <algorithm>
+#include <random>
+#include <mutex>
+#include <set>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// compares ball and pair queries against brute force, for point sets spanning
+// from a few cells to (many) more than 2^20 cells per side, where cell coordinates
+// would overflow or alias if the cell size was not adjusted
+CINO_TEST(hash_grid_matches_brute_force)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> rnd(-1,1);
+
+    for(double scale : {1.0, 1e3, 1e9})
+    for(double cell  : {0.05, 1e-9})
+    {
+        std::vector<vec3d> points;
+        for(uint i=0; i<1000; ++i) points.push_back(vec3d(rnd(rng),rnd(rng),rnd(rng))*scale);
+        for(uint i=0; i<100;  ++i) points.push_back(points.at(i) + vec3d(rnd(rng),rnd(rng),rnd(rng))*cell*0.3);
+
+        HashGrid grid(cell);
+        grid.build(points);
+        double radius = std::max(cell, 0.05*scale);
+
+        std::set<std::pair<uint,uint>> pairs, pairs_bf;
+        std::mutex mutex;
+        bool duplicates = false;
+        grid.for_each_pair_in_range(radius, [&](const uint id0, const uint id1, const double)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!pairs.insert(std::make_pair(std::min(id0,id1), std::max(id0,id1))).second) duplicates = true;
+        });
+        for(uint i=0;   i<points.size(); ++i)
+        for(uint j=i+1; j<points.size(); ++j)
+        {
+            if(points.at(i).dist_squared(points.at(j))<=radius*radius) pairs_bf.insert(std::make_pair(i,j));
+        }
+        CINO_CHECK(!duplicates);
+        CINO_CHECK(pairs==pairs_bf);
+
+        for(uint q=0; q<100; ++q)
+        {
+            vec3d  p(rnd(rng)*scale*3, rnd(rng)*scale*3, rnd(rng)*scale*3);
+            double r = (q%3==0) ? 1e30 : radius*(q%7);
+            std::vector<uint> ids;
+            grid.points_in_ball(p, r, ids);
+            uint count = 0;
+            for(const vec3d & x : points) if(x.dist_squared(p)<=r*r) ++count;
+            CINO_CHECK(std::set<uint>(ids.begin(),ids.end()).size()==ids.size());
+            CINO_CHECK(ids.size()==count);
+        }
+    }
+
+    // query points far outside the grid
+    HashGrid grid(1e-12);
+    grid.build({vec3d(0,0,0), vec3d(1,1,1)});
+    std::vector<uint> ids;
+    grid.points_in_ball(vec3d(1e300,0,0), 1, ids);
+    CINO_CHECK(ids.empty());
+    CINO_CHECK(grid.closest_point(vec3d(1,1,1+1e-13), 1)==1);
+}
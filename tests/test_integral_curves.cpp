@@ -0,0 +1,71 @@
+#include "tests.h"
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/integral_curves.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// n x n grid of squares (two triangles each) in [-1,1]^2
+Trimesh<> planar_grid(const uint n)
+{
+    std::vector<vec3d> verts;
+    std::vector<uint>  tris;
+    for(uint i=0; i<=n; ++i)
+    for(uint j=0; j<=n; ++j)
+    {
+        verts.push_back(vec3d(2.0*i/n-1, 2.0*j/n-1, 0));
+    }
+    for(uint i=0; i<n; ++i)
+    for(uint j=0; j<n; ++j)
+    {
+        uint v00 = i*(n+1)+j, v10 = v00+n+1, v01 = v00+1, v11 = v10+1;
+        tris.insert(tris.end(), {v00, v10, v11, v00, v11, v01});
+    }
+    return Trimesh<>(verts, tris);
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// curves of a rotational field never reach a maximum nor the border: they must be
+// stopped as soon as they loop, rather than when the step budget is exhausted
+CINO_TEST(integral_curves_end_on_loop)
+{
+    Trimesh<> m = planar_grid(40);
+    VectorField field(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        vec3d c = m.poly_centroid(pid);
+        field.set(pid, vec3d(-c.y(), c.x(), 0));
+    }
+
+    std::vector<IntegralCurveSample> seeds;
+    for(uint vid=0; vid<m.num_verts(); vid+=37)
+    {
+        if(m.vert(vid).length()>0.2 && m.vert(vid).length()<0.8) seeds.push_back(integral_curve_seed(m, vid));
+    }
+
+    IntegralCurves curves;
+    trace_integral_curves(m, field, seeds, curves);
+    CINO_CHECK(curves.num_curves()==seeds.size());
+    for(uint cid=0; cid<curves.num_curves(); ++cid)
+    {
+        CINO_CHECK(curves.status.at(cid)==INTEGRAL_CURVE_END_ON_LOOP);
+        CINO_CHECK(curves.curve_size(cid)<m.num_polys());
+    }
+
+    // a gradient field is not affected
+    for(uint pid=0; pid<m.num_polys(); ++pid) field.set(pid, vec3d(1,0.3,0));
+    trace_integral_curves(m, field, seeds, curves);
+    for(uint cid=0; cid<curves.num_curves(); ++cid)
+    {
+        CINO_CHECK(curves.status.at(cid)==INTEGRAL_CURVE_END_ON_BORDER);
+        vec3d p = curves.points.at(curves.offsets.at(cid+1)-1);
+        CINO_CHECK(std::max(p.x(),p.y())>1-1e-9);
+    }
+}
@@ -0,0 +1,127 @@
+#include "tests.h"
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/isocontours.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// a smooth field, optionally quantized so that many levels pass exactly through
+// vertices and whole triangles lie on a level
+template<class Mesh>
+void set_field(Mesh & m, const double quantum)
+{
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        const vec3d & p = m.vert(vid);
+        double f = std::sin(3*p.x()) + std::cos(2*p.y()) + p.z();
+        if(quantum>0) f = std::round(f/quantum)*quantum;
+        m.vert_data(vid).uvw[0] = f;
+    }
+}
+
+std::vector<double> levels(const double f_min, const double f_max, const double step)
+{
+    std::vector<double> res;
+    for(double iso=std::ceil(f_min/step)*step; iso<=f_max; iso+=step) res.push_back(std::round(iso/step)*step);
+    return res;
+}
+
+// on a closed mesh every polyline is closed, and polylines use every segment once
+bool all_chains_closed(const Isocontours<> & iso)
+{
+    for(uint lid=0; lid<iso.num_levels(); ++lid)
+    {
+        uint n_segs = 0;
+        for(const std::vector<uint> & chain : iso.polylines(lid))
+        {
+            if(chain.size()<3 || chain.front()!=chain.back()) return false;
+            n_segs += chain.size()-1;
+        }
+        if(n_segs!=iso.num_segs(lid)) return false;
+    }
+    return iso.num_levels()>0;
+}
+
+double total_area(const Trimesh<> & m)
+{
+    double area = 0;
+    for(uint pid=0; pid<m.num_polys(); ++pid) area += m.poly_area(pid);
+    return area;
+}
+
+// after the tessellation no triangle has a level strictly within its field range,
+// and the contours extracted again only pass through mesh vertices
+bool contours_follow_edges(const Trimesh<> & m, const Isocontours<> & iso)
+{
+    std::vector<double> isos;
+    for(uint lid=0; lid<iso.num_levels(); ++lid) isos.push_back(iso.iso_value(lid));
+    std::sort(isos.begin(), isos.end());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        double f_min = inf_double, f_max = -inf_double;
+        for(uint vid : m.adj_p2v(pid))
+        {
+            f_min = std::min(f_min, m.vert_data(vid).uvw[0]);
+            f_max = std::max(f_max, m.vert_data(vid).uvw[0]);
+        }
+        if(std::upper_bound(isos.begin(), isos.end(), f_min) < std::lower_bound(isos.begin(), isos.end(), f_max)) return false;
+    }
+
+    Isocontours<> iso_after(m, isos);
+    for(uint vid=0; vid<iso_after.num_verts(); ++vid)
+    {
+        uint eid = iso_after.vert_edge(vid);
+        if(iso_after.vert(vid).dist(m.edge_vert(eid,0))>0 &&
+           iso_after.vert(vid).dist(m.edge_vert(eid,1))>0) return false;
+    }
+    return all_chains_closed(iso_after);
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// contours of a closed triangle mesh and of a closed general polygon mesh, for
+// generic levels and for levels passing through vertices, are closed polylines
+CINO_TEST(isocontours_chains_closed)
+{
+    Trimesh<>     tri (DATA_PATH "bunny.obj");
+    Polygonmesh<> poly(DATA_PATH "lion_vase_poly.off");
+    for(double quantum : {0.0, 0.05})
+    {
+        set_field(tri,  quantum);
+        set_field(poly, quantum);
+        CINO_CHECK(all_chains_closed(Isocontours<>(tri,  40u)));
+        CINO_CHECK(all_chains_closed(Isocontours<>(tri,  levels(-3, 3, 0.05))));
+        CINO_CHECK(all_chains_closed(Isocontours<>(poly, 40u)));
+        CINO_CHECK(all_chains_closed(Isocontours<>(poly, levels(-3, 3, 0.05))));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// tessellating along many levels (also repeated, and passing through vertices)
+// preserves the surface area, and no triangle is left crossing a contour
+CINO_TEST(isocontours_tessellate)
+{
+    for(double quantum : {0.0, 0.05})
+    {
+        Trimesh<> m(DATA_PATH "bunny.obj");
+        set_field(m, quantum);
+        std::vector<double> isos = levels(-3, 3, 0.05);
+        isos.push_back(isos.at(isos.size()/2));
+        double area = total_area(m);
+
+        Isocontours<> iso(m, isos);
+        std::vector<uint> new_vids = iso.tessellate(m);
+        CINO_CHECK(!new_vids.empty());
+        CINO_CHECK(std::fabs(total_area(m) - area) < 1e-9*area);
+        CINO_CHECK(contours_follow_edges(m, iso));
+    }
+}
@@ -0,0 +1,39 @@
+#include "tests.h"
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/laplacian_smoothing.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// an interior vertex surrounded by a fan containing a degenerate triangle (i.e. with
+// a zero angle, hence a huge cotangent weight) must still be moved inside the
+// convex hull of its neighbors, as it would be with uniform weights
+CINO_TEST(laplacian_smoothing_degenerate_cotangent_fan)
+{
+    std::vector<vec3d> verts =
+    {
+        vec3d( 0.0, 0.0, 0.0), // center
+        vec3d( 1.0, 0.0, 0.0),
+        vec3d( 2.0, 0.0, 0.0), // collinear with the center and vertex 1
+        vec3d( 0.0, 1.0, 0.0),
+        vec3d(-2.0, 0.0, 0.0),
+        vec3d( 0.0,-1.0, 0.0),
+    };
+    std::vector<std::vector<uint>> tris = {{0,1,2}, {0,2,3}, {0,3,4}, {0,4,5}, {0,5,1}};
+
+    for(int mode : {UNIFORM, COTANGENT})
+    {
+        Trimesh<> m(verts, tris);
+        LaplacianSmoothingOptions opt;
+        opt.laplacian_mode = mode;
+        opt.n_iters        = 1;
+        opt.fix_boundary   = true;
+        laplacian_smoothing(m, opt);
+
+        AABB box(std::vector<vec3d>(verts.begin()+1, verts.end()));
+        vec3d p = m.vert(0);
+        CINO_CHECK(!p.is_nan());
+        CINO_CHECK(box.contains(p));
+    }
+}
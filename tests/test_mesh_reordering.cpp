@@ -0,0 +1,251 @@
+#include "tests.h"
+#include <cinolib/mesh_reordering.h>
+#include <algorithm>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// labels every element with its id, and flags some of them
+template<class Mesh>
+void tag_common_elements(Mesh & m)
+{
+    for(uint vid=0; vid<m.num_verts(); ++vid) { m.vert_data(vid).label = vid; m.vert_data(vid).flags[MARKED] = (vid%3==0); }
+    for(uint eid=0; eid<m.num_edges(); ++eid) { m.edge_data(eid).label = eid; m.edge_data(eid).flags[MARKED] = (eid%5==0); }
+    for(uint pid=0; pid<m.num_polys(); ++pid) { m.poly_data(pid).label = pid; m.poly_data(pid).flags[MARKED] = (pid%7==0); }
+}
+
+template<class Mesh>
+void tag_faces(Mesh & m)
+{
+    for(uint fid=0; fid<m.num_faces(); ++fid) { m.face_data(fid).label = fid; m.face_data(fid).flags[MARKED] = (fid%4==0); }
+}
+
+bool is_permutation(const std::vector<uint> & map, const uint n)
+{
+    std::vector<uint> tmp = map;
+    std::sort(tmp.begin(), tmp.end());
+    for(uint i=0; i<tmp.size(); ++i) if(tmp.at(i)!=i) return false;
+    return tmp.size()==n;
+}
+
+std::vector<uint> mapped(std::vector<uint> ids, const std::vector<uint> & map, const bool sort)
+{
+    for(uint & id : ids) id = map.at(id);
+    if(sort) std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::vector<uint> sorted(std::vector<uint> ids)
+{
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// a cycle of ids, rotated to start from the smallest one
+std::vector<uint> cycle(std::vector<uint> ids)
+{
+    std::rotate(ids.begin(), std::min_element(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+// vertices of face fid, in the order induced by the winding of poly pid
+template<class Mesh>
+std::vector<uint> oriented_face(const Mesh & m, const uint pid, const uint fid)
+{
+    std::vector<uint> f = m.face_verts_id(fid);
+    if(!m.poly_face_winding(pid,fid)) std::reverse(f.begin(), f.end());
+    return f;
+}
+
+// composition of two old-to-new maps (first a, then b)
+std::vector<uint> compose(const std::vector<uint> & a, const std::vector<uint> & b)
+{
+    std::vector<uint> res;
+    for(uint id : a) res.push_back(b.at(id));
+    return res;
+}
+
+MeshReordering compose(const MeshReordering & a, const MeshReordering & b)
+{
+    MeshReordering r;
+    r.vert_map = compose(a.vert_map, b.vert_map);
+    r.edge_map = compose(a.edge_map, b.edge_map);
+    r.face_map = compose(a.face_map, b.face_map);
+    r.poly_map = compose(a.poly_map, b.poly_map);
+    return r;
+}
+
+// vertices, edges and polys of m correspond to those of the original mesh m0 through
+// the maps in r: same positions, attributes, connectivity and adjacency
+template<class Mesh>
+bool common_elements_match(const Mesh & m0, const Mesh & m, const MeshReordering & r, const bool ordered_polys)
+{
+    if(!is_permutation(r.vert_map, m0.num_verts()) || m.num_verts()!=m0.num_verts()) return false;
+    if(!is_permutation(r.edge_map, m0.num_edges()) || m.num_edges()!=m0.num_edges()) return false;
+    if(!is_permutation(r.poly_map, m0.num_polys()) || m.num_polys()!=m0.num_polys()) return false;
+
+    for(uint vid=0; vid<m0.num_verts(); ++vid)
+    {
+        uint i = r.vert_map.at(vid);
+        if(m.vert(i).dist(m0.vert(vid))>0) return false;
+        if(m.vert_data(i).label!=m0.vert_data(vid).label || m.vert_data(i).flags!=m0.vert_data(vid).flags) return false;
+        if(sorted(m.adj_v2v(i))!=mapped(m0.adj_v2v(vid), r.vert_map, true)) return false;
+    }
+    for(uint eid=0; eid<m0.num_edges(); ++eid)
+    {
+        uint i = r.edge_map.at(eid);
+        if(sorted(m.edge_vert_ids(i))!=mapped(m0.edge_vert_ids(eid), r.vert_map, true)) return false;
+        if(m.edge_data(i).label!=m0.edge_data(eid).label || m.edge_data(i).flags!=m0.edge_data(eid).flags) return false;
+        if(sorted(m.adj_e2p(i))!=mapped(m0.adj_e2p(eid), r.poly_map, true)) return false;
+    }
+    for(uint pid=0; pid<m0.num_polys(); ++pid)
+    {
+        uint i = r.poly_map.at(pid);
+        std::vector<uint> p2v = m.adj_p2v(i);
+        if(!ordered_polys) std::sort(p2v.begin(), p2v.end());
+        if(p2v!=mapped(m0.adj_p2v(pid), r.vert_map, !ordered_polys)) return false;
+        if(m.poly_data(i).label!=m0.poly_data(pid).label || m.poly_data(i).flags!=m0.poly_data(pid).flags) return false;
+        if(sorted(m.adj_p2p(i))!=mapped(m0.adj_p2p(pid), r.poly_map, true)) return false;
+    }
+
+    // an external per vertex field follows the vertices
+    std::vector<double> field;
+    for(uint vid=0; vid<m0.num_verts(); ++vid) field.push_back(m0.vert(vid).x());
+    apply_reordering(r.vert_map, field);
+    for(uint vid=0; vid<m.num_verts(); ++vid) if(field.at(vid)!=m.vert(vid).x()) return false;
+    return true;
+}
+
+// same as above, for the faces of a volume mesh. A face may be stored with the
+// opposite orientation (it is created by the first poly using it), hence polys
+// are compared through their faces as oriented by their winding
+template<class M, class V, class E, class P>
+bool faces_match(const AbstractPolygonMesh<M,V,E,P> &, const AbstractPolygonMesh<M,V,E,P> &, const MeshReordering & r)
+{
+    return r.face_map.empty();
+}
+
+template<class M, class V, class E, class F, class P>
+bool faces_match(const AbstractPolyhedralMesh<M,V,E,F,P> & m0, const AbstractPolyhedralMesh<M,V,E,F,P> & m, const MeshReordering & r)
+{
+    if(!is_permutation(r.face_map, m0.num_faces()) || m.num_faces()!=m0.num_faces()) return false;
+    for(uint fid=0; fid<m0.num_faces(); ++fid)
+    {
+        uint i = r.face_map.at(fid);
+        if(sorted(m.face_verts_id(i))!=mapped(m0.face_verts_id(fid), r.vert_map, true)) return false;
+        if(m.face_data(i).label!=m0.face_data(fid).label || m.face_data(i).flags!=m0.face_data(fid).flags) return false;
+    }
+    for(uint pid=0; pid<m0.num_polys(); ++pid)
+    {
+        uint i = r.poly_map.at(pid);
+        if(sorted(m.adj_p2f(i))!=mapped(m0.adj_p2f(pid), r.face_map, true)) return false;
+        for(uint fid : m0.adj_p2f(pid))
+        {
+            if(cycle(oriented_face(m, i, r.face_map.at(fid)))!=cycle(mapped(oriented_face(m0, pid, fid), r.vert_map, false))) return false;
+        }
+    }
+    return true;
+}
+
+// reorders m0 with every mode, then back to the original order with the inverse
+// permutations, checking that the elements correspond through the returned maps.
+// Poly vertices are compared in order only if ordered_polys is true (the standard
+// ordering of tets is recomputed from their faces, and may start from another vertex)
+template<class Mesh>
+bool reorderings_round_trip(const Mesh & m0, const bool ordered_polys)
+{
+    auto check = [&](const Mesh & m, const MeshReordering & r)
+    {
+        return common_elements_match(m0, m, r, ordered_polys) && faces_match(m0, m, r);
+    };
+    for(int mode : {MORTON_ORDER, HILBERT_ORDER, RCM_ORDER})
+    {
+        Mesh m = m0;
+        MeshReordering r;
+        reorder_mesh(m, mode, r);
+        if(!check(m, r)) return false;
+
+        // in the reordered mesh, the i-th element of the original one has id map[i]
+        MeshReordering r_back;
+        reorder_mesh(m, r.vert_map, r.poly_map, r_back);
+        MeshReordering round_trip = compose(r, r_back);
+        for(uint vid=0; vid<m0.num_verts(); ++vid) if(round_trip.vert_map.at(vid)!=vid) return false;
+        for(uint pid=0; pid<m0.num_polys(); ++pid) if(round_trip.poly_map.at(pid)!=pid) return false;
+        if(!check(m, round_trip)) return false;
+    }
+    return true;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// surface meshes (triangles and general polygons)
+CINO_TEST(mesh_reordering_surface_round_trip)
+{
+    Trimesh<> tm(DATA_PATH "bunny.obj");
+    tag_common_elements(tm);
+    CINO_CHECK(reorderings_round_trip(tm, true));
+
+    Polygonmesh<> pm(DATA_PATH "lion_vase_poly.off");
+    tag_common_elements(pm);
+    CINO_CHECK(reorderings_round_trip(pm, true));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// volume meshes made of tets, hexes and general polyhedra (pairs of hexes merged
+// into a single poly, so that their shared face is left dangling)
+CINO_TEST(mesh_reordering_volume_round_trip)
+{
+    Tetmesh<> tm(DATA_PATH "sphere.mesh");
+    tag_common_elements(tm);
+    tag_faces(tm);
+    CINO_CHECK(reorderings_round_trip(tm, false));
+
+    const uint n = 5;
+    auto id = [n](const uint i, const uint j, const uint k) { return i + (n+1)*(j + (n+1)*k); };
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> hexes;
+    for(uint k=0; k<=n; ++k)
+    for(uint j=0; j<=n; ++j)
+    for(uint i=0; i<=n; ++i) verts.push_back(vec3d(i + 0.1*j, j + 0.1*k, k + 0.1*i));
+    for(uint k=0; k<n; ++k)
+    for(uint j=0; j<n; ++j)
+    for(uint i=0; i<n; ++i)
+    {
+        hexes.push_back({ id(i,j,k), id(i+1,j,k), id(i+1,j+1,k), id(i,j+1,k), id(i,j,k+1), id(i+1,j,k+1), id(i+1,j+1,k+1), id(i,j+1,k+1) });
+    }
+    Hexmesh<> hm(verts, hexes);
+    tag_common_elements(hm);
+    tag_faces(hm);
+    CINO_CHECK(reorderings_round_trip(hm, true));
+
+    std::vector<std::vector<uint>> polys;
+    std::vector<std::vector<bool>> winding;
+    for(uint pid=0; pid<hm.num_polys(); ++pid)
+    {
+        // hexes are sorted by x first: merge the hex at even x with the one after it
+        std::vector<uint> group = { pid };
+        if(pid%n%2==0 && pid%n+1<n) group.push_back(++pid);
+        std::vector<uint> p_faces;
+        std::vector<bool> p_winding;
+        for(uint h : group)
+        for(uint fid : hm.adj_p2f(h))
+        {
+            if(group.size()==2 && hm.poly_contains_face(group.at(0),fid) && hm.poly_contains_face(group.at(1),fid)) continue;
+            p_faces.push_back(fid);
+            p_winding.push_back(hm.poly_face_winding(h,fid));
+        }
+        polys.push_back(p_faces);
+        winding.push_back(p_winding);
+    }
+    Polyhedralmesh<> pm(hm.vector_verts(), hm.vector_faces(), polys, winding);
+    tag_common_elements(pm);
+    tag_faces(pm);
+    CINO_CHECK(reorderings_round_trip(pm, false));
+}
@@ -0,0 +1,154 @@
+#include "tests.h"
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/meshes/mesh_slicer.h>
+#include <random>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// number of polys whose HIDDEN flag differs from the one computed
+// with the original (uncached, per poly) slicing predicates
+template<class Mesh>
+static uint slicer_mismatches(const Mesh & m, const SlicerState & s)
+{
+    float X_thresh = m.bbox().min[0] + m.bbox().delta()[0] * s.X_thresh;
+    float Y_thresh = m.bbox().min[1] + m.bbox().delta()[1] * s.Y_thresh;
+    float Z_thresh = m.bbox().min[2] + m.bbox().delta()[2] * s.Z_thresh;
+
+    uint count = 0;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        vec3d c = m.poly_centroid(pid);
+        float q = m.poly_data(pid).quality;
+        int   l = m.poly_data(pid).label;
+
+        bool pass_X = (s.X_sign == LEQ) ? (c.x() <=   X_thresh) : (c.x() >=   X_thresh);
+        bool pass_Y = (s.Y_sign == LEQ) ? (c.y() <=   Y_thresh) : (c.y() >=   Y_thresh);
+        bool pass_Z = (s.Z_sign == LEQ) ? (c.z() <=   Z_thresh) : (c.z() >=   Z_thresh);
+        bool pass_Q = (s.Q_sign == LEQ) ? (q     <= s.Q_thresh) : (q     >= s.Q_thresh);
+        bool pass_L = (s.L_mode == IS ) ? (l == -1 || l == s.L_filter) : (l == -1 || l != s.L_filter);
+
+        bool b = (s.mode == AND) ? ( pass_X &&  pass_Y &&  pass_Z &&  pass_L &&  pass_Q)
+                                 : (!pass_X || !pass_Y || !pass_Z || !pass_L || !pass_Q);
+
+        if(m.poly_data(pid).flags[HIDDEN] == b) ++count;
+    }
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+static SlicerState random_slicer_state(std::mt19937 & rng, const SlicerState & prev)
+{
+    std::uniform_real_distribution<float> rnd(0,1);
+    SlicerState s = prev;
+    switch(rng()%6)
+    {
+        case 0 : s.X_thresh = rnd(rng); break;
+        case 1 : s.Y_thresh = rnd(rng); break;
+        case 2 : s.Z_thresh = rnd(rng); break;
+        case 3 : s.Q_thresh = rnd(rng); break;
+        case 4 : s.X_sign   = (rng()%2) ? LEQ : GEQ; s.Q_sign = (rng()%2) ? LEQ : GEQ; break;
+        case 5 : s.mode     = (rng()%2) ? AND : OR;  break;
+    }
+    return s;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// incremental slicing, with local edits notified to the slicer and
+// global ones followed by set_dirty
+CINO_TEST(mesh_slicer_matches_reference)
+{
+    Tetmesh<> m(DATA_PATH "sphere.mesh");
+    for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid).label = pid%3;
+
+    std::mt19937     rng(7);
+    MeshSlicer<Tetmesh<>> slicer(m);
+    SlicerState      s;
+    uint             mismatches = 0;
+    for(uint i=0; i<300; ++i)
+    {
+        if(i%10==3)
+        {
+            uint vid = rng()%m.num_verts();
+            m.vert(vid) += vec3d(0.01,0.02,-0.01)*m.bbox().diag();
+            for(uint pid : m.adj_v2p(vid)) m.update_p_quality(pid);
+            slicer.vert_set_dirty(m, vid);
+        }
+        if(i%50==7)
+        {
+            m.scale(1.1);
+            m.update_quality();
+            slicer.set_dirty();
+        }
+        s = random_slicer_state(rng, s);
+        slicer.update(m, s);
+        mismatches += slicer_mismatches(m, s);
+    }
+    CINO_CHECK(mismatches==0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL
+
+// surface meshes do not have a quality metric: use a quantity that changes with the geometry
+template<class M, class V, class E, class P>
+static void refresh_quality(AbstractPolygonMesh<M,V,E,P> & m)
+{
+    for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid).quality = std::fabs(m.poly_centroid(pid).x());
+}
+
+template<class M, class V, class E, class F, class P>
+static void refresh_quality(AbstractPolyhedralMesh<M,V,E,F,P> & m)
+{
+    m.update_quality();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// drawable meshes must keep slicing correctly when vertices are moved through
+// the plain mesh API (i.e. without vert_set_dirty), and the drawable is then
+// refreshed with a full updateGL(), or just with update_bbox()
+template<class Mesh>
+static uint drawable_slicer_mismatches(Mesh & m, const bool use_update_bbox)
+{
+    std::mt19937 rng(11);
+    SlicerState  s;
+    uint         mismatches = 0;
+    double       step       = 0.1*m.edge_avg_length();
+    for(uint i=0; i<50; ++i)
+    {
+        if(i%10==3)
+        {
+            for(uint vid=0; vid<m.num_verts(); ++vid)
+            {
+                m.vert(vid) += vec3d(std::sin(vid+i), std::cos(vid*i), 0.5)*step;
+            }
+            refresh_quality(m);
+            if(use_update_bbox) m.update_bbox();
+            else                m.updateGL();
+        }
+        s = random_slicer_state(rng, s);
+        m.slice(s);
+        mismatches += slicer_mismatches(m, s);
+    }
+    return mismatches;
+}
+
+CINO_TEST(mesh_slicer_drawables_follow_mesh_edits)
+{
+    for(bool use_update_bbox : {false, true})
+    {
+        DrawableTetmesh<> tm(DATA_PATH "sphere.mesh");
+        CINO_CHECK(drawable_slicer_mismatches(tm, use_update_bbox)==0);
+
+        DrawableTrimesh<> m(DATA_PATH "bunny.obj");
+        refresh_quality(m);
+        CINO_CHECK(drawable_slicer_mismatches(m, use_update_bbox)==0);
+    }
+}
+
+#endif // CINOLIB_USES_OPENGL
@@ -0,0 +1,209 @@
+#include "tests.h"
+#include <cinolib/meshes/meshes.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <thread>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// brute force counterparts of the kd-tree picking queries. Nearest queries
+// are compared by distance, as ties may legitimately return different ids
+
+template<class Mesh>
+double bf_vert_dist(const Mesh & m, const vec3d & p)
+{
+    double d = inf_double;
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        if(m.vert_data(vid).flags[HIDDEN] || !m.vert_is_visible(vid)) continue;
+        d = std::min(d, p.dist(m.vert(vid)));
+    }
+    return d;
+}
+
+template<class Mesh>
+double bf_edge_dist(const Mesh & m, const vec3d & p)
+{
+    double d = inf_double;
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        if(m.edge_data(eid).flags[HIDDEN] || !m.edge_is_visible(eid)) continue;
+        d = std::min(d, p.dist((m.edge_vert(eid,0) + m.edge_vert(eid,1))*0.5));
+    }
+    return d;
+}
+
+template<class Mesh>
+double bf_poly_dist(const Mesh & m, const vec3d & p)
+{
+    double d = inf_double;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(!m.poly_is_visible(pid)) continue;
+        d = std::min(d, p.dist(m.poly_centroid(pid)));
+    }
+    return d;
+}
+
+template<class Mesh>
+std::vector<uint> bf_verts_in_box(const Mesh & m, const AABB & box)
+{
+    std::vector<uint> res;
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        if(m.vert_data(vid).flags[HIDDEN] || !m.vert_is_visible(vid)) continue;
+        if(box.contains(m.vert(vid))) res.push_back(vid);
+    }
+    return res;
+}
+
+template<class Mesh>
+std::vector<uint> bf_polys_in_box(const Mesh & m, const AABB & box)
+{
+    std::vector<uint> res;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_is_visible(pid) && box.contains(m.poly_centroid(pid))) res.push_back(pid);
+    }
+    return res;
+}
+
+bool same_dist(const double a, const double b)
+{
+    return std::fabs(a-b) <= 1e-12*std::max(1.0,b);
+}
+
+std::vector<uint> sorted(std::vector<uint> v)
+{
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// random points around the mesh, and boxes centered at mesh vertices
+template<class Mesh>
+bool picks_match_brute_force(const Mesh & m, std::mt19937 & rng)
+{
+    const AABB & bb = m.bbox();
+    std::uniform_real_distribution<double> rnd(-0.2,1.2);
+    std::uniform_int_distribution<uint>    rnd_vid(0, m.num_verts()-1);
+    bool ok = true;
+    for(uint i=0; i<200; ++i)
+    {
+        vec3d p = bb.min + vec3d(rnd(rng),rnd(rng),rnd(rng))*bb.delta();
+        ok &= same_dist(p.dist(m.vert(m.pick_vert(p))), bf_vert_dist(m,p));
+        ok &= same_dist(p.dist((m.edge_vert(m.pick_edge(p),0) + m.edge_vert(m.pick_edge(p),1))*0.5), bf_edge_dist(m,p));
+        ok &= same_dist(p.dist(m.poly_centroid(m.pick_poly(p))), bf_poly_dist(m,p));
+    }
+    for(uint i=0; i<20; ++i)
+    {
+        vec3d c = m.vert(rnd_vid(rng));
+        AABB  box(c - bb.delta()*0.1, c + bb.delta()*0.1);
+        ok &= sorted(m.pick_verts(box)) == bf_verts_in_box(m,box);
+        ok &= sorted(m.pick_polys(box)) == bf_polys_in_box(m,box);
+    }
+    return ok;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// kd-tree picking on a surface mesh against brute force, before and after
+// hiding polygons, and after edits that must invalidate the pick indices
+CINO_TEST(picking_surface_matches_brute_force)
+{
+    std::mt19937 rng(1);
+    Trimesh<> m(DATA_PATH "bunny.obj");
+    CINO_CHECK(picks_match_brute_force(m, rng));
+
+    for(uint pid=0; pid<m.num_polys(); pid+=3) m.poly_data(pid).flags[HIDDEN] = true;
+    CINO_CHECK(picks_match_brute_force(m, rng));
+
+    // a new triangle far from the mesh must be picked as soon as it is added
+    vec3d far = m.bbox().max + m.bbox().delta();
+    uint v0 = m.vert_add(far);
+    uint v1 = m.vert_add(far + vec3d(1,0,0));
+    uint v2 = m.vert_add(far + vec3d(0,1,0));
+    uint pid = m.poly_add(v0,v1,v2);
+    CINO_CHECK(m.pick_vert(far) == v0);
+    CINO_CHECK(m.pick_poly(m.poly_centroid(pid)) == pid);
+    CINO_CHECK(picks_match_brute_force(m, rng));
+
+    m.vert(v0) = m.bbox().min - m.bbox().delta();
+    m.update_bbox();
+    CINO_CHECK(m.pick_vert(m.vert(v0)) == v0);
+    CINO_CHECK(picks_match_brute_force(m, rng));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above for a volume mesh, including face picking
+CINO_TEST(picking_volume_matches_brute_force)
+{
+    std::mt19937 rng(2);
+    Tetmesh<> m(DATA_PATH "sphere.mesh");
+    CINO_CHECK(picks_match_brute_force(m, rng));
+
+    for(uint pid=0; pid<m.num_polys(); pid+=2) m.poly_data(pid).flags[HIDDEN] = true;
+    CINO_CHECK(picks_match_brute_force(m, rng));
+
+    const AABB & bb = m.bbox();
+    std::uniform_real_distribution<double> rnd(-0.2,1.2);
+    bool ok = true;
+    for(uint i=0; i<200; ++i)
+    {
+        vec3d  p = bb.min + vec3d(rnd(rng),rnd(rng),rnd(rng))*bb.delta();
+        double d = inf_double;
+        for(uint fid=0; fid<m.num_faces(); ++fid)
+        {
+            uint pid;
+            if(m.face_data(fid).flags[HIDDEN] || !m.face_is_visible(fid,pid)) continue;
+            d = std::min(d, p.dist(m.face_centroid(fid)));
+        }
+        ok &= same_dist(p.dist(m.face_centroid(m.pick_face(p))), d);
+    }
+    CINO_CHECK(ok);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// picking from several threads on a const mesh with stale indices must
+// build each index once and answer exactly as serial picking does
+CINO_TEST(picking_concurrent_queries)
+{
+    Trimesh<> m(DATA_PATH "bunny.obj");
+    const AABB & bb = m.bbox();
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> rnd(-0.2,1.2);
+    std::vector<vec3d> queries;
+    for(uint i=0; i<2000; ++i) queries.push_back(bb.min + vec3d(rnd(rng),rnd(rng),rnd(rng))*bb.delta());
+
+    typedef std::array<uint,3> Picks;
+    std::vector<Picks> serial;
+    for(const vec3d & p : queries) serial.push_back({m.pick_vert(p), m.pick_edge(p), m.pick_poly(p)});
+
+    m.pick_index_set_dirty();
+    const Trimesh<> & cm = m;
+    const uint n_threads = 4;
+    std::vector<std::vector<Picks>> parallel(n_threads, std::vector<Picks>(queries.size()));
+    std::vector<std::thread> threads;
+    for(uint t=0; t<n_threads; ++t)
+    {
+        threads.emplace_back([&,t]()
+        {
+            for(uint i=0; i<queries.size(); ++i)
+            {
+                const vec3d & p = queries.at(i);
+                parallel.at(t).at(i) = {cm.pick_vert(p), cm.pick_edge(p), cm.pick_poly(p)};
+            }
+        });
+    }
+    for(std::thread & t : threads) t.join();
+    for(uint t=0; t<n_threads; ++t) CINO_CHECK(parallel.at(t) == serial);
+}
@@ -0,0 +1,142 @@
+#include "tests.h"
+#include <cinolib/polygon_grid.h>
+#include <cinolib/pi.h>
+#include <algorithm>
+#include <random>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// ring vertices are multiples of 1/SCALE, and query points (e.g. edge midpoints)
+// multiples of 1/(2*SCALE), so that the reference below can classify them exactly
+// in integer arithmetic
+const double SCALE = 1024;
+
+enum { OUTSIDE = 0, INSIDE = 1, ON_BORDER = 2 };
+
+// exact even-odd classification: counts the crossings of the ray from p towards +x
+int reference(const std::vector<vec2d> & verts, const std::vector<uint> & edges, const vec2d & p)
+{
+    auto to_int = [](const double d) { return static_cast<int64_t>(std::llround(d*SCALE*2)); };
+    int64_t px = to_int(p.x()), py = to_int(p.y());
+    bool inside = false;
+    for(uint i=0; i<edges.size(); i+=2)
+    {
+        int64_t ax = to_int(verts.at(edges.at(i  )).x()), ay = to_int(verts.at(edges.at(i  )).y());
+        int64_t bx = to_int(verts.at(edges.at(i+1)).x()), by = to_int(verts.at(edges.at(i+1)).y());
+        int64_t orient = (bx-ax)*(py-ay) - (by-ay)*(px-ax);
+        if(orient==0 && px>=std::min(ax,bx) && px<=std::max(ax,bx) &&
+                        py>=std::min(ay,by) && py<=std::max(ay,by)) return ON_BORDER;
+        if((ay>py)!=(by>py) && ((by>ay) ? orient>0 : orient<0)) inside = !inside;
+    }
+    return inside ? INSIDE : OUTSIDE;
+}
+
+void add_ring(const std::vector<vec2d> & ring, std::vector<vec2d> & verts, std::vector<uint> & edges)
+{
+    uint base = verts.size();
+    for(uint i=0; i<ring.size(); ++i)
+    {
+        verts.push_back(ring.at(i));
+        edges.push_back(base + i);
+        edges.push_back(base + (i+1)%ring.size());
+    }
+}
+
+double snap(const double d)
+{
+    return std::round(d*SCALE)/SCALE;
+}
+
+bool matches_reference(const std::vector<vec2d> & verts,
+                       const std::vector<uint>  & edges,
+                       const std::vector<vec2d> & points,
+                       const uint                 edges_per_cell)
+{
+    PolygonGrid grid;
+    grid.build(verts, edges, edges_per_cell);
+
+    std::vector<bool> batch;
+    grid.contains(points, batch);
+    if(batch.size()!=points.size()) return false;
+
+    for(uint i=0; i<points.size(); ++i)
+    {
+        int ref = reference(verts, edges, points.at(i));
+        bool with_border    = (ref!=OUTSIDE);
+        bool without_border = (ref==INSIDE);
+        if(grid.contains(points.at(i), true )!=with_border   ) return false;
+        if(grid.contains(points.at(i), false)!=without_border) return false;
+        if(batch.at(i)!=with_border) return false;
+    }
+    return true;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// integer rings (an outer boundary, a hole, an island in the hole and a ring
+// overlapping the others) queried on a half integer lattice, so that many points
+// lie on vertices, on edges, or at the same height of vertices
+CINO_TEST(polygon_grid_degenerate_queries)
+{
+    std::vector<vec2d> verts;
+    std::vector<uint>  edges;
+    add_ring({vec2d(0,0), vec2d(12,0), vec2d(12,4), vec2d(9,4), vec2d(9,8), vec2d(12,8), vec2d(12,12), vec2d(0,12)}, verts, edges);
+    add_ring({vec2d(2,2), vec2d(2,10), vec2d(7,10), vec2d(7,2)}, verts, edges);
+    add_ring({vec2d(3,3), vec2d(6,3), vec2d(6,6), vec2d(3,6)}, verts, edges);
+    add_ring({vec2d(5,5), vec2d(10,6), vec2d(5,11), vec2d(4,8)}, verts, edges);
+
+    std::vector<vec2d> points;
+    for(int i=-2; i<=26; ++i)
+    for(int j=-2; j<=26; ++j) points.push_back(vec2d(i*0.5, j*0.5));
+
+    for(uint epc : {1, 2, 8, 1000}) CINO_CHECK(matches_reference(verts, edges, points, epc));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// random (possibly overlapping) star shaped rings, queried at random points,
+// at the vertices and at the midpoints of the edges
+CINO_TEST(polygon_grid_random_multipolygons)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> rnd(0,1);
+    for(uint test=0; test<20; ++test)
+    {
+        std::vector<vec2d> verts;
+        std::vector<uint>  edges;
+        uint n_rings = 1 + test%4;
+        for(uint r=0; r<n_rings; ++r)
+        {
+            vec2d  c(snap(rnd(rng)*10), snap(rnd(rng)*10));
+            double radius = 1 + rnd(rng)*4;
+            uint   n      = 3 + static_cast<uint>(rnd(rng)*60);
+            std::vector<double> angles;
+            for(uint i=0; i<n; ++i) angles.push_back(rnd(rng)*2*M_PI);
+            std::sort(angles.begin(), angles.end());
+            std::vector<vec2d> ring;
+            for(double a : angles)
+            {
+                double rr = radius*(0.3 + 0.7*rnd(rng));
+                ring.push_back(vec2d(snap(c.x() + rr*cos(a)), snap(c.y() + rr*sin(a))));
+            }
+            add_ring(ring, verts, edges);
+        }
+
+        std::vector<vec2d> points;
+        for(uint i=0; i<2000; ++i) points.push_back(vec2d(snap(rnd(rng)*18-4), snap(rnd(rng)*18-4)));
+        for(const vec2d & v : verts) points.push_back(v);
+        for(uint i=0; i<edges.size(); i+=2)
+        {
+            points.push_back((verts.at(edges.at(i)) + verts.at(edges.at(i+1)))*0.5);
+        }
+
+        CINO_CHECK(matches_reference(verts, edges, points, 2));
+    }
+}
@@ -0,0 +1,84 @@
+#include "tests.h"
+#include <cinolib/meshes/polygonmesh.h>
+#include <cinolib/parallel_for.h>
+#include <sstream>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// non convex polygons (where the trivial fan flips) and polygons lying on a line,
+// whose fan normals are rounding noise. The latter may fail to triangulate, depending
+// on how rounding goes, so the test below does not hard code which ones fail
+Polygonmesh<> make_mesh(const uint n)
+{
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> polys;
+    for(uint i=0; i<n; ++i)
+    {
+        double x = (i%40)*3.0;
+        double y = (i/40)*3.0;
+        std::vector<vec3d> p;
+        if(i%5==4) p = { vec3d(x,y,0), vec3d(x+0.3,y+0.03,0), vec3d(x+0.7,y+0.07,0), vec3d(x+0.6,y+0.06,0) };
+        else       p = { vec3d(x,y,0), vec3d(x+2,y,0), vec3d(x+2,y+2,0), vec3d(x+1,y+0.5,0), vec3d(x,y+2,0) };
+        std::vector<uint> poly;
+        for(const vec3d & v : p)
+        {
+            poly.push_back(verts.size());
+            verts.push_back(v);
+        }
+        polys.push_back(poly);
+    }
+    return Polygonmesh<>(verts, polys);
+}
+
+double tessellation_area(const Polygonmesh<> & m, const uint pid)
+{
+    double area = 0;
+    const std::vector<uint> & tris = m.poly_tessellation(pid);
+    for(uint i=0; i<tris.size(); i+=3)
+    {
+        area += (m.vert(tris.at(i+1)) - m.vert(tris.at(i))).cross(m.vert(tris.at(i+2)) - m.vert(tris.at(i))).length()*0.5;
+    }
+    return area;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// tessellating above the parallel grain size must give the same triangles as the
+// serial per polygon update, preserve the area, and report all the polygons that
+// could not be triangulated with a single warning
+CINO_TEST(polygon_tessellation_parallel)
+{
+    const uint n = 4*PARALLEL_GRAIN_HEAVY;
+    std::stringstream ss;
+    std::streambuf *cout_buf = std::cout.rdbuf(ss.rdbuf());
+    Polygonmesh<> m = make_mesh(n);
+    ss.str("");
+    m.update_p_tessellations();
+    std::cout.rdbuf(cout_buf);
+
+    std::vector<std::vector<uint>> parallel;
+    for(uint pid=0; pid<m.num_polys(); ++pid) parallel.push_back(m.poly_tessellation(pid));
+
+    uint n_failed = 0;
+    bool ok = true;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        bool success = m.update_p_tessellation(pid);
+        ok &= (m.poly_tessellation(pid) == parallel.at(pid));
+        ok &= (success != m.poly_tessellation(pid).empty());
+        if(!success) ++n_failed;
+        if(pid%5!=4) ok &= (m.poly_tessellation(pid).size()==9 && std::fabs(tessellation_area(m,pid) - 2.5)<1e-12);
+    }
+    CINO_CHECK(ok);
+
+    std::string out = ss.str();
+    if(n_failed>0) CINO_CHECK(out == "WARNING: could not triangulate " + std::to_string(n_failed) + " polygon(s). Are they degenerate?\n");
+    else           CINO_CHECK(out.empty());
+}
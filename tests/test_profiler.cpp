@@ -0,0 +1,50 @@
+#include "tests.h"
+#include <cinolib/profiler.h>
+#include <chrono>
+#include <sstream>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+void recursive_scope(const uint depth)
+{
+    ProfilerScope scope("recursive_scope");
+    if(depth>0) recursive_scope(depth-1);
+    else
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        while(std::chrono::steady_clock::now()-t0 < std::chrono::milliseconds(50)) {}
+    }
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// nested scopes with the same key must not count the same time more than once
+CINO_TEST(profiler_trace_report_recursion)
+{
+    ProfilerTrace::clear();
+    recursive_scope(3);
+
+    std::stringstream ss;
+    std::streambuf *cout_buf = std::cout.rdbuf(ss.rdbuf());
+    ProfilerTrace::report();
+    std::cout.rdbuf(cout_buf);
+    ProfilerTrace::clear();
+
+    std::string line;
+    bool found = false;
+    while(std::getline(ss,line))
+    {
+        if(line.find("recursive_scope (called 4 times)")==std::string::npos) continue;
+        double total = std::stod(line);
+        CINO_CHECK(total>=0.05 && total<0.1);
+        found = true;
+    }
+    CINO_CHECK(found);
+}
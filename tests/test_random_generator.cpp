@@ -0,0 +1,139 @@
+#include "tests.h"
+#include <cinolib/random_generator.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <thread>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+double correlation(const std::vector<double> & a, const std::vector<double> & b)
+{
+    double ma = 0, mb = 0;
+    for(uint i=0; i<a.size(); ++i) { ma += a.at(i); mb += b.at(i); }
+    ma /= a.size();
+    mb /= b.size();
+    double ab = 0, aa = 0, bb = 0;
+    for(uint i=0; i<a.size(); ++i)
+    {
+        ab += (a.at(i)-ma)*(b.at(i)-mb);
+        aa += (a.at(i)-ma)*(a.at(i)-ma);
+        bb += (b.at(i)-mb)*(b.at(i)-mb);
+    }
+    return ab/std::sqrt(aa*bb);
+}
+
+// first two draws of a stream, as a 64 bits word
+uint64_t head(const RandomStream & rs)
+{
+    return (uint64_t(rs.uint_at(0)) << 32) | rs.uint_at(1);
+}
+
+std::vector<double> draws(RandomStream rs, const uint n)
+{
+    std::vector<double> v;
+    for(uint i=0; i<n; ++i) v.push_back(rs.next_double());
+    return v;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// known answers of Philox4x32-10, from the kat_vectors file of Random123
+CINO_TEST(philox4x32_known_answers)
+{
+    typedef std::array<uint32_t,4> Ctr;
+    typedef std::array<uint32_t,2> Key;
+    CINO_CHECK((philox4x32(Ctr{{0x00000000,0x00000000,0x00000000,0x00000000}}, Key{{0x00000000,0x00000000}}) ==
+                           Ctr{{0x6627e8d5,0xe169c58d,0xbc57ac4c,0x9b00dbd8}}));
+    CINO_CHECK((philox4x32(Ctr{{0xffffffff,0xffffffff,0xffffffff,0xffffffff}}, Key{{0xffffffff,0xffffffff}}) ==
+                           Ctr{{0x408f276d,0x41c83b0e,0xa20bc7c6,0x6d5451fd}}));
+    CINO_CHECK((philox4x32(Ctr{{0x243f6a88,0x85a308d3,0x13198a2e,0x03707344}}, Key{{0xa4093822,0x299f31d0}}) ==
+                           Ctr{{0xd16cfe09,0x94fdcceb,0x5001e420,0x24126ea1}}));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// split streams depend only on the seed and on the ids (not on the order in
+// which, or on the thread where, they are created), and random access, serial
+// draws and parallel fills agree, also from unaligned positions
+CINO_TEST(random_stream_split_reproducible)
+{
+    RandomStream rs(42);
+    const uint n_threads = 4, n_splits = 64;
+    std::vector<std::vector<double>> parallel(n_splits);
+    std::vector<std::thread> threads;
+    for(uint t=0; t<n_threads; ++t)
+    {
+        threads.emplace_back([&,t]()
+        {
+            // (each thread creates its streams in reverse order)
+            for(uint j=t; j<n_splits; j+=n_threads) parallel.at(n_splits-1-j) = draws(rs.split(n_splits-1-j), 100);
+        });
+    }
+    for(std::thread & t : threads) t.join();
+
+    bool ok = true;
+    for(uint i=0; i<n_splits; ++i)
+    {
+        ok &= (parallel.at(i) == draws(RandomStream(42).split(i), 100));
+        ok &= (draws(rs.split(i).split(7), 100) == draws(RandomStream(42).split(i).split(7), 100));
+    }
+    CINO_CHECK(ok);
+
+    RandomStream a = rs.split(3);
+    a.skip(5);
+    std::vector<uint32_t> u(3001);
+    std::vector<double>   d(3001), g(3001);
+    RandomStream b = a;
+    b.fill_uint(u);
+    b.fill_double(d);
+    b.fill_normal(g);
+    for(uint i=0; i<u.size(); ++i) ok &= (u.at(i) == a.next_uint());
+    for(uint i=0; i<d.size(); ++i) ok &= (d.at(i) == a.next_double());
+    for(uint i=0; i<g.size(); ++i) ok &= (g.at(i) == a.next_normal());
+    ok &= (a.position() == b.position());
+    CINO_CHECK(ok);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// streams obtained with different ids (or at different depths) never coincide,
+// and the values they produce are uniform and uncorrelated with one another
+CINO_TEST(random_stream_split_independent)
+{
+    RandomStream rs(7);
+    std::set<uint64_t> heads;
+    for(uint i=0; i<100000; ++i) heads.insert(head(rs.split(i)));
+    heads.insert(head(rs));
+    heads.insert(head(rs.split(0).split(0)));
+    CINO_CHECK(heads.size() == 100002);
+
+    const uint n = 100000;
+    std::vector<std::vector<double>> v =
+    {
+        draws(rs, n),
+        draws(rs.split(0), n),
+        draws(rs.split(1), n),
+        draws(rs.split(0).split(1), n),
+        draws(RandomStream(8).split(0), n),
+    };
+    bool ok = true;
+    for(uint i=0; i<v.size(); ++i)
+    {
+        double mean = 0;
+        for(double x : v.at(i)) mean += x;
+        mean /= n;
+        ok &= std::fabs(mean - 0.5) < 0.005;
+        ok &= (*std::min_element(v.at(i).begin(), v.at(i).end()) > 0.0);
+        ok &= (*std::max_element(v.at(i).begin(), v.at(i).end()) < 1.0);
+        for(uint j=i+1; j<v.size(); ++j) ok &= std::fabs(correlation(v.at(i), v.at(j))) < 0.015;
+    }
+    CINO_CHECK(ok);
+}
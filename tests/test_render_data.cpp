@@ -0,0 +1,133 @@
+/* Offscreen rendering tests. They need an OpenGL context, which is created
+ * headless with EGL (e.g. on top of Mesa's software rasterizer, llvmpipe),
+ * and are compiled only if CINOLIB_USES_OPENGL and CINOLIB_GL_STATS are
+ * defined (see tests.pro).
+*/
+
+#if defined(CINOLIB_USES_OPENGL) && defined(CINOLIB_GL_STATS)
+
+#include "tests.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cinolib/meshes/drawable_trimesh.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// makes current an OpenGL context bound to a small pbuffer. The surfaceless
+// platform is tried first, as it does not need any display server
+static bool offscreen_context(const int width, const int height)
+{
+    static bool ready = false;
+    if(ready) return true;
+
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(get_platform_display!=nullptr) dpy = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if(dpy==EGL_NO_DISPLAY) dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(dpy==EGL_NO_DISPLAY || !eglInitialize(dpy, nullptr, nullptr)) return false;
+    if(!eglBindAPI(EGL_OPENGL_API)) return false;
+
+    EGLint cfg_attr[] =
+    {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE,   8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE,  8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig cfg;
+    EGLint    n_cfg = 0;
+    if(!eglChooseConfig(dpy, cfg_attr, &cfg, 1, &n_cfg) || n_cfg==0) return false;
+
+    EGLint     pb_attr[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    EGLSurface srf       = eglCreatePbufferSurface(dpy, cfg, pb_attr);
+    EGLContext ctx       = eglCreateContext(dpy, cfg, EGL_NO_CONTEXT, nullptr);
+    if(srf==EGL_NO_SURFACE || ctx==EGL_NO_CONTEXT) return false;
+    ready = eglMakeCurrent(dpy, srf, srf, ctx);
+    return ready;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// gives access to the GPU buffers of the mesh. Note: the mesh is a virtual
+// base of the drawable, hence it must be initialized by the most derived class
+class DrawableTrimeshProbe : public DrawableTrimesh<>
+{
+    public:
+        explicit DrawableTrimeshProbe(const char * filename) : Trimesh<>(filename), DrawableTrimesh<>() {}
+        const GLBuffers & gpu() const { return this->drawlist.gpu; }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// renders the mesh to the offscreen buffer, and returns the number of covered pixels
+static uint render_and_count_pixels(const DrawableTrimeshProbe & m, const int size)
+{
+    glViewport(0, 0, size, size);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    vec3d c = m.scene_center();
+    float r = m.scene_radius();
+    glOrtho(c.x()-r, c.x()+r, c.y()-r, c.y()+r, -c.z()-r, -c.z()+r);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glClearColor(0,0,0,1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_LIGHT0);
+
+    m.draw();
+    glFinish();
+
+    std::vector<unsigned char> rgb(3*size*size);
+    glReadPixels(0, 0, size, size, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+    uint count = 0;
+    for(int i=0; i<size*size; ++i) if(rgb[3*i]>0 || rgb[3*i+1]>0 || rgb[3*i+2]>0) ++count;
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// a static mesh must be uploaded at the first rendering only, whereas
+// editing a single poly must transfer (much) less data than the whole mesh
+CINO_TEST(render_data_redraw_without_uploads)
+{
+    const int size = 64;
+    if(!offscreen_context(size,size))
+    {
+        std::cerr << "render_data_redraw_without_uploads: no offscreen OpenGL context available, skipped" << std::endl;
+        return;
+    }
+
+    DrawableTrimeshProbe m(DATA_PATH "bunny.obj");
+
+    uint pixels = render_and_count_pixels(m, size);
+    CINO_CHECK(pixels>0);
+    CINO_CHECK(glGetError()==GL_NO_ERROR);
+    uint   uploads = m.gpu().num_uploads;
+    size_t bytes   = m.gpu().uploaded_bytes;
+    CINO_CHECK(uploads>0);
+
+    CINO_CHECK(render_and_count_pixels(m, size)==pixels);
+    CINO_CHECK(m.gpu().num_uploads==uploads);
+    CINO_CHECK(m.gpu().uploaded_bytes==bytes);
+
+    m.poly_data(0).color = Color::RED();
+    m.poly_set_dirty(0, UPDATE_GL_COLORS);
+    m.updateGL_dirty();
+    render_and_count_pixels(m, size);
+    CINO_CHECK(glGetError()==GL_NO_ERROR);
+    CINO_CHECK(m.gpu().num_uploads>uploads);
+    CINO_CHECK(m.gpu().uploaded_bytes-bytes < bytes/100);
+
+    uploads = m.gpu().num_uploads;
+    bytes   = m.gpu().uploaded_bytes;
+    render_and_count_pixels(m, size);
+    CINO_CHECK(m.gpu().num_uploads==uploads);
+    CINO_CHECK(m.gpu().uploaded_bytes==bytes);
+}
+
+#endif // CINOLIB_USES_OPENGL && CINOLIB_GL_STATS
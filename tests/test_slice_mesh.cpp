@@ -0,0 +1,24 @@
+#include "tests.h"
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/slice_mesh.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// adaptive levels must be increasing and strictly inside the z range of the mesh,
+// also when the last layer would extend past its top
+CINO_TEST(slice_levels_adaptive_within_bbox)
+{
+    Trimesh<> m(DATA_PATH "bunny.obj");
+    double dz = m.bbox().delta_z();
+
+    for(double max_height : {0.01, 0.07, 0.3, 2.0})
+    {
+        std::vector<double> levels = slice_levels_adaptive(m, 0.005*dz, max_height*dz, 0.01*dz);
+        CINO_CHECK(!levels.empty());
+        for(uint i=1; i<levels.size(); ++i) CINO_CHECK(levels.at(i-1)<levels.at(i));
+        CINO_CHECK(levels.front()>m.bbox().min.z());
+        CINO_CHECK(levels.back() <m.bbox().max.z());
+    }
+}
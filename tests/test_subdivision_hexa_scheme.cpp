@@ -0,0 +1,150 @@
+#include "tests.h"
+#include <cinolib/meshes/hexmesh.h>
+#include <cinolib/subdivision_schemas.h>
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// reference implementation: each new point is identified by the (sorted)
+// list of mesh vertices that define it, and shared through a global map
+void subdivide_with_map(const Hexmesh<>                                   & m,
+                        const std::vector<std::vector<std::vector<uint>>> & scheme,
+                              std::vector<vec3d>                          & verts,
+                              std::vector<uint>                           & hexas)
+{
+    std::map<std::vector<uint>,uint> v_map;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    for(const auto & sub_poly : scheme)
+    for(uint off=0; off<8; ++off)
+    {
+        std::vector<uint> vids;
+        for(uint i : sub_poly.at(off)) vids.push_back(m.poly_vert_id(pid,i));
+        std::sort(vids.begin(), vids.end());
+        auto query = v_map.find(vids);
+        if(query==v_map.end())
+        {
+            query = v_map.insert(std::make_pair(vids, uint(verts.size()))).first;
+            verts.push_back(m.verts_average(vids));
+        }
+        hexas.push_back(query->second);
+    }
+}
+
+// n x n x n grid of hexahedra, with shuffled vertex ids and each hexahedron
+// listing its vertices starting from a random corner (in one of the 24 ways
+// that preserve its orientation), so that adjacent elements see the entities
+// they share in all possible relative orientations
+Hexmesh<> shuffled_grid(const uint n, std::mt19937 & rng)
+{
+    auto vid = [&](const uint i, const uint j, const uint k) { return (i*(n+1)+j)*(n+1)+k; };
+
+    std::vector<uint> perm((n+1)*(n+1)*(n+1));
+    for(uint i=0; i<perm.size(); ++i) perm.at(i) = i;
+    std::shuffle(perm.begin(), perm.end(), rng);
+
+    std::vector<vec3d> verts(perm.size());
+    for(uint i=0; i<=n; ++i)
+    for(uint j=0; j<=n; ++j)
+    for(uint k=0; k<=n; ++k)
+    {
+        verts.at(perm.at(vid(i,j,k))) = vec3d(i,j,k) + vec3d(0.1*std::sin(i+2*j+3*k), 0.1*std::cos(3*i+j+k), 0);
+    }
+
+    // corner offsets, in the standard hexa order
+    const int c[8][3] = {{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}};
+
+    // the 24 rotations of the cube, as signed permutation matrices with positive determinant
+    std::vector<std::vector<int>> rotations;
+    const uint axes[6][3] = {{0,1,2},{1,2,0},{2,0,1},{0,2,1},{2,1,0},{1,0,2}};
+    for(uint a=0; a<6; ++a)
+    for(uint s=0; s<8; ++s)
+    {
+        std::vector<int> R(9,0);
+        for(uint r=0; r<3; ++r) R.at(3*r+axes[a][r]) = (s>>r & 1) ? -1 : 1;
+        int det = R[0]*(R[4]*R[8]-R[5]*R[7]) - R[1]*(R[3]*R[8]-R[5]*R[6]) + R[2]*(R[3]*R[7]-R[4]*R[6]);
+        if(det>0) rotations.push_back(R);
+    }
+
+    std::vector<uint> hexas;
+    for(uint i=0; i<n; ++i)
+    for(uint j=0; j<n; ++j)
+    for(uint k=0; k<n; ++k)
+    {
+        const std::vector<int> & R = rotations.at(rng()%rotations.size());
+        for(uint v=0; v<8; ++v)
+        {
+            // rotate the corner around the center of the cell (coordinates doubled)
+            int p[3], q[3];
+            for(uint d=0; d<3; ++d) p[d] = 2*c[v][d]-1;
+            for(uint d=0; d<3; ++d) q[d] = R[3*d]*p[0] + R[3*d+1]*p[1] + R[3*d+2]*p[2];
+            hexas.push_back(perm.at(vid(i+(q[0]+1)/2, j+(q[1]+1)/2, k+(q[2]+1)/2)));
+        }
+    }
+    return Hexmesh<>(verts, hexas);
+}
+
+// same number of vertices and hexahedra, and same corner positions for each hexahedron
+bool same_subdivision(const Hexmesh<> & m, const std::vector<std::vector<std::vector<uint>>> & scheme)
+{
+    std::vector<vec3d> verts, ref_verts;
+    std::vector<uint>  hexas, ref_hexas;
+    subdivision_hexa_scheme(m, scheme, verts, hexas);
+    subdivide_with_map(m, scheme, ref_verts, ref_hexas);
+
+    if(hexas.size()!=ref_hexas.size()) return false;
+    std::vector<bool> used(verts.size(), false);
+    for(uint vid : hexas) used.at(vid) = true;
+    if(std::count(used.begin(), used.end(), true)!=(int)ref_verts.size()) return false;
+
+    for(uint i=0; i<hexas.size(); ++i)
+    {
+        if(verts.at(hexas.at(i)).dist(ref_verts.at(ref_hexas.at(i)))>1e-10) return false;
+    }
+    return true;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// all the legacy schemes must produce the same subdivision as the map based
+// engine, both for symmetric schemes (processed in parallel, ranking shared
+// points) and for the other ones (which fall back to a global map)
+CINO_TEST(subdivision_hexa_scheme_matches_map)
+{
+    std::mt19937 rng(5);
+    std::vector<std::vector<std::vector<std::vector<uint>>>> schemes =
+    {
+        no_subdivision,
+        hex_to_grid_2x2x2,
+        hex_to_grid_3x3x3,
+        hex_to_grid_4x4x4,
+        hex_to_grid_4x4x4_old,
+        hex_to_cone_1x1_to_2x2,
+        hex_to_cone_1x1_to_3x3,
+        hex_to_cone_2x2_to_4x4,
+        hex_to_cone_2x2_to_4x4_old,
+    };
+
+    for(uint trial=0; trial<3; ++trial)
+    {
+        Hexmesh<> m = shuffled_grid(3, rng);
+        for(uint s=0; s<schemes.size(); ++s)
+        {
+            bool same = same_subdivision(m, schemes.at(s));
+            if(!same) std::cerr << "scheme #" << s << " differs from the map based subdivision" << std::endl;
+            CINO_CHECK(same);
+        }
+    }
+
+    Hexmesh<> m(DATA_PATH "rockerarm.mesh");
+    CINO_CHECK(same_subdivision(m, hex_to_grid_2x2x2));
+    CINO_CHECK(same_subdivision(m, hex_to_grid_4x4x4_old));
+}
@@ -0,0 +1,336 @@
+#include "tests.h"
+#include <cinolib/tetrahedralization.h>
+#include <cinolib/export_hexahedra.h>
+#include <cinolib/quality_hex.h>
+#include <cinolib/quality_tet.h>
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+typedef std::vector<std::vector<uint>> Cell; // list of faces
+
+Cell tet_cell(const uint * t)
+{
+    Cell c;
+    for(uint i=0; i<4; ++i) c.push_back({t[TET_FACES[i][0]], t[TET_FACES[i][1]], t[TET_FACES[i][2]]});
+    return c;
+}
+
+Cell prism_cell(const uint * p)
+{
+    return {{p[0],p[1],p[2]}, {p[3],p[4],p[5]}, {p[0],p[1],p[4],p[3]}, {p[1],p[2],p[5],p[4]}, {p[2],p[0],p[3],p[5]}};
+}
+
+Cell hex_cell(const uint * h)
+{
+    Cell c;
+    for(uint i=0; i<6; ++i) c.push_back({h[HEXA_FACES[i][0]], h[HEXA_FACES[i][1]], h[HEXA_FACES[i][2]], h[HEXA_FACES[i][3]]});
+    return c;
+}
+
+// assembles a polyhedral mesh from cells given as face lists. Shared faces are
+// stored once, and the winding of each face is set from its geometric orientation
+Polyhedralmesh<> make_mesh(const std::vector<vec3d> & verts, const std::vector<Cell> & cells)
+{
+    std::map<std::vector<uint>,uint> f_ids;
+    std::vector<std::vector<uint>>   faces, polys;
+    std::vector<std::vector<bool>>   winding;
+    for(const Cell & c : cells)
+    {
+        vec3d centroid(0,0,0);
+        uint  n = 0;
+        for(const auto & f : c) for(uint vid : f) { centroid += verts.at(vid); ++n; }
+        centroid /= static_cast<double>(n);
+
+        polys.push_back({});
+        winding.push_back({});
+        for(const auto & f : c)
+        {
+            std::vector<uint> key = f;
+            std::sort(key.begin(), key.end());
+            auto it = f_ids.find(key);
+            if(it==f_ids.end())
+            {
+                it = f_ids.insert(std::make_pair(key, faces.size())).first;
+                faces.push_back(f);
+            }
+            const std::vector<uint> & sf = faces.at(it->second);
+            vec3d fc(0,0,0), fn(0,0,0);
+            for(uint vid : sf) fc += verts.at(vid);
+            fc /= static_cast<double>(sf.size());
+            for(uint i=0; i<sf.size(); ++i) fn += (verts.at(sf.at(i))-fc).cross(verts.at(sf.at((i+1)%sf.size()))-fc);
+            polys.back().push_back(it->second);
+            winding.back().push_back(fn.dot(fc-centroid)>0);
+        }
+    }
+    return Polyhedralmesh<>(verts, faces, polys, winding);
+}
+
+// a n*n*n grid of unit cubes with jittered interior vertices
+std::vector<vec3d> grid_verts(const uint n, std::mt19937 & rng)
+{
+    std::uniform_real_distribution<double> jitter(-0.15,0.15);
+    std::vector<vec3d> verts;
+    for(uint k=0; k<=n; ++k)
+    for(uint j=0; j<=n; ++j)
+    for(uint i=0; i<=n; ++i)
+    {
+        vec3d p(i,j,k);
+        if(i>0 && j>0 && k>0 && i<n && j<n && k<n) p += vec3d(jitter(rng),jitter(rng),jitter(rng));
+        verts.push_back(p);
+    }
+    return verts;
+}
+
+// standard ordering of the cube at (i,j,k)
+std::vector<uint> grid_cube(const uint n, const uint i, const uint j, const uint k)
+{
+    auto id = [n](const uint i, const uint j, const uint k) { return i + (n+1)*(j + (n+1)*k); };
+    return { id(i,j,k), id(i+1,j,k), id(i+1,j+1,k), id(i,j+1,k), id(i,j,k+1), id(i+1,j,k+1), id(i+1,j+1,k+1), id(i,j+1,k+1) };
+}
+
+// a grid made of hexahedra, prisms and tets. A conforming hybrid mesh without
+// pyramids can only connect tets and prisms through triangles, and prisms and
+// hexahedra through quads, hence: the top layer is made of prisms along x, the
+// last column of prisms along z, and the cubes in both are split into tets.
+// Diagonals contain the min vertex of each face, as in the split rules
+Polyhedralmesh<> hybrid_grid(const uint n, std::mt19937 & rng)
+{
+    std::vector<vec3d> verts = grid_verts(n, rng);
+    std::vector<Cell>  cells;
+    for(uint k=0; k<n; ++k)
+    for(uint j=0; j<n; ++j)
+    for(uint i=0; i<n; ++i)
+    {
+        std::vector<uint> c = grid_cube(n,i,j,k);
+        if(i<n-1 && k<n-1)
+        {
+            cells.push_back(hex_cell(c.data()));
+        }
+        else if(i<n-1)
+        {
+            uint p0[6] = { c[0], c[3], c[7], c[1], c[2], c[6] };
+            uint p1[6] = { c[0], c[7], c[4], c[1], c[6], c[5] };
+            cells.push_back(prism_cell(p0));
+            cells.push_back(prism_cell(p1));
+        }
+        else
+        {
+            uint p[2][6] = {{ c[0], c[1], c[2], c[4], c[5], c[6] }, { c[0], c[2], c[3], c[4], c[6], c[7] }};
+            for(uint h=0; h<2; ++h)
+            {
+                if(k<n-1) cells.push_back(prism_cell(p[h]));
+                else
+                {
+                    uint t[12];
+                    prism_to_tets(p[h], t);
+                    for(uint l=0; l<3; ++l) cells.push_back(tet_cell(t+4*l));
+                }
+            }
+        }
+    }
+    return make_mesh(verts, cells);
+}
+
+// boundary faces of a grid, counted in triangles
+template<class Mesh>
+uint srf_tris(const Mesh & m)
+{
+    uint count = 0;
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        if(m.face_is_on_srf(fid)) count += m.verts_per_face(fid)-2;
+    }
+    return count;
+}
+
+// a tetrahedralization of a convex domain is conforming if its surface faces are
+// exactly the boundary faces of the input (one per triangle, two per quad), and
+// it is valid if all tets are positively oriented and fill the same volume
+template<class Mesh>
+bool is_conforming_tetrahedralization(const Mesh & m, const Tetmesh<> & tm, const double volume)
+{
+    if(srf_tris(tm)!=srf_tris(m)) return false;
+
+    double vol = 0;
+    for(uint pid=0; pid<tm.num_polys(); ++pid)
+    {
+        double v = tet_volume(tm.poly_vert(pid,0), tm.poly_vert(pid,1), tm.poly_vert(pid,2), tm.poly_vert(pid,3));
+        if(v<=0) return false;
+        vol += v;
+    }
+    return std::fabs(vol-volume)<1e-9;
+}
+
+// each tet must be made of vertices of its source element, and inherit its attributes
+template<class Mesh>
+bool provenance_is_consistent(const Mesh & m, const Tetmesh<> & tm, const std::vector<uint> & tet2poly)
+{
+    if(tet2poly.size()!=tm.num_polys()) return false;
+    for(uint pid=0; pid<tm.num_polys(); ++pid)
+    {
+        uint src = tet2poly.at(pid);
+        if(src>=m.num_polys()) return false;
+        if(tm.poly_data(pid).label!=m.poly_data(src).label) return false;
+        for(uint vid : tm.adj_p2v(pid)) if(!m.poly_contains_vert(src,vid)) return false;
+    }
+    for(uint vid=0; vid<tm.num_verts(); ++vid)
+    {
+        if(tm.vert_data(vid).label!=m.vert_data(vid).label) return false;
+    }
+    return true;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_TEST(hex_to_tets_conforming_with_provenance)
+{
+    const uint n = 4;
+    std::mt19937 rng(1);
+    std::vector<std::vector<uint>> hexes;
+    for(uint k=0; k<n; ++k)
+    for(uint j=0; j<n; ++j)
+    for(uint i=0; i<n; ++i) hexes.push_back(grid_cube(n,i,j,k));
+    Hexmesh<> hm(grid_verts(n,rng), hexes);
+    for(uint pid=0; pid<hm.num_polys(); ++pid) hm.poly_data(pid).label = 10+pid;
+    for(uint vid=0; vid<hm.num_verts(); ++vid) hm.vert_data(vid).label = 7*vid;
+
+    Tetmesh<> tm;
+    std::vector<uint> tet2hex;
+    hex_to_tets(hm, tm, tet2hex);
+    CINO_CHECK(tm.num_verts()==hm.num_verts());
+    CINO_CHECK(is_conforming_tetrahedralization(hm, tm, n*n*n));
+    CINO_CHECK(provenance_is_consistent(hm, tm, tet2hex));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_TEST(hybrid_to_tets_conforming_with_provenance)
+{
+    const uint n = 4;
+    std::mt19937 rng(2);
+    Polyhedralmesh<> m = hybrid_grid(n, rng);
+    uint n_tets = 0, n_prisms = 0, n_hexes = 0;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        m.poly_data(pid).label = 10+pid;
+        n_tets   += m.poly_is_tetrahedron(pid);
+        n_prisms += m.verts_per_poly(pid)==6 && m.poly_is_prism(pid);
+        n_hexes  += m.poly_is_hexahedron(pid);
+    }
+    for(uint vid=0; vid<m.num_verts(); ++vid) m.vert_data(vid).label = 7*vid;
+    CINO_CHECK(n_tets>0 && n_prisms>0 && n_hexes>0);
+    CINO_CHECK(srf_tris(m)==12*n*n); // the input is conforming
+
+    Tetmesh<> tm;
+    std::vector<uint> tet2poly;
+    CINO_CHECK(hybrid_to_tets(m, tm, tet2poly));
+    CINO_CHECK(tm.num_polys()>=n_tets + 3*n_prisms + 5*n_hexes);
+    CINO_CHECK(tm.num_polys()<=n_tets + 3*n_prisms + 6*n_hexes);
+    CINO_CHECK(is_conforming_tetrahedralization(m, tm, n*n*n));
+    CINO_CHECK(provenance_is_consistent(m, tm, tet2poly));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// pyramids and six vertex elements that are not prisms have no standard
+// vertex ordering, and must be rejected at runtime, not only in debug
+CINO_TEST(hybrid_to_tets_rejects_unsupported_elements)
+{
+    std::vector<vec3d> verts = { vec3d(0,0,0), vec3d(1,0,0), vec3d(1,1,0), vec3d(0,1,0), vec3d(0.5,0.5,1), vec3d(0.5,0.5,-1) };
+    uint pyramid[4][3] = {{0,1,4}, {1,2,4}, {2,3,4}, {3,0,4}};
+    Cell octahedron, pyr;
+    for(uint i=0; i<4; ++i)
+    {
+        octahedron.push_back({pyramid[i][0], pyramid[i][1], pyramid[i][2]});
+        octahedron.push_back({pyramid[i][1], pyramid[i][0], 5});
+        pyr.push_back({pyramid[i][0], pyramid[i][1], pyramid[i][2]});
+    }
+    pyr.push_back({0,3,2,1});
+
+    // a prism with one of its quads split into two triangles
+    std::vector<vec3d> pverts = { vec3d(0,0,0), vec3d(1,0,0), vec3d(0,1,0), vec3d(0,0,1), vec3d(1,0,1), vec3d(0,1,1) };
+    uint p[6] = {0,1,2,3,4,5};
+    Cell split_prism = prism_cell(p);
+    split_prism.erase(split_prism.begin()+2);
+    split_prism.push_back({0,1,4});
+    split_prism.push_back({0,4,3});
+
+    std::vector<Polyhedralmesh<>> meshes;
+    meshes.push_back(make_mesh(verts,  {pyr}));
+    meshes.push_back(make_mesh(verts,  {octahedron}));
+    meshes.push_back(make_mesh(pverts, {split_prism}));
+    for(const auto & m : meshes)
+    {
+        CINO_CHECK(m.poly_ordered_verts_id(0).empty());
+        Tetmesh<> tm(pverts, std::vector<std::vector<uint>>{{0,1,2,3}});
+        uint nv = tm.num_verts();
+        std::vector<uint> tet2poly(1);
+        CINO_CHECK(!hybrid_to_tets(m, tm, tet2poly));
+        CINO_CHECK(tm.num_verts()==nv);
+        CINO_CHECK(tet2poly.empty());
+    }
+
+    // the well formed prism is still accepted
+    Polyhedralmesh<> m = make_mesh(pverts, {prism_cell(p)});
+    CINO_CHECK(m.poly_ordered_verts_id(0).size()==6);
+    Tetmesh<> tm;
+    std::vector<uint> tet2poly;
+    CINO_CHECK(hybrid_to_tets(m, tm, tet2poly) && tm.num_polys()==3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// exported hexahedra must map back to their source element and vertices,
+// and have standard (i.e. not inverted) vertex ordering
+CINO_TEST(export_hexahedra_provenance_and_orientation)
+{
+    const uint n = 4;
+    std::mt19937 rng(3);
+    Polyhedralmesh<> m = hybrid_grid(n, rng);
+    for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid).label = 10+pid;
+
+    Hexmesh<> hm;
+    std::vector<int>  v_map;
+    std::vector<uint> hex2poly;
+    export_hexahedra(m, hm, v_map, hex2poly);
+
+    uint n_hexes = 0;
+    for(uint pid=0; pid<m.num_polys(); ++pid) n_hexes += m.poly_is_hexahedron(pid);
+    CINO_CHECK(hm.num_polys()==n_hexes);
+    CINO_CHECK(hex2poly.size()==n_hexes);
+    CINO_CHECK(v_map.size()==m.num_verts());
+
+    bool ok = true;
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        bool touches_hexa = false;
+        for(uint pid : m.adj_v2p(vid)) touches_hexa |= m.poly_is_hexahedron(pid);
+        if(touches_hexa!=(v_map.at(vid)>=0)) ok = false;
+        if(touches_hexa && hm.vert(v_map.at(vid)).dist(m.vert(vid))>0) ok = false;
+    }
+    for(uint hid=0; hid<hm.num_polys(); ++hid)
+    {
+        uint pid = hex2poly.at(hid);
+        if(!m.poly_is_hexahedron(pid) || hm.poly_data(hid).label!=m.poly_data(pid).label) ok = false;
+        std::vector<uint> src = m.adj_p2v(pid);
+        for(uint & vid : src) vid = v_map.at(vid);
+        std::vector<uint> dst = hm.adj_p2v(hid);
+        std::sort(src.begin(), src.end());
+        std::sort(dst.begin(), dst.end());
+        if(src!=dst) ok = false;
+        const auto & h = hm.adj_p2v(hid);
+        if(hex_scaled_jacobian(hm.vert(h[0]), hm.vert(h[1]), hm.vert(h[2]), hm.vert(h[3]),
+                               hm.vert(h[4]), hm.vert(h[5]), hm.vert(h[6]), hm.vert(h[7]))<=0) ok = false;
+    }
+    CINO_CHECK(ok);
+}
@@ -0,0 +1,83 @@
+#include "tests.h"
+#include <cinolib/vertex_clustering.h>
+#include <cinolib/union_find.h>
+#include <algorithm>
+#include <random>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace
+{
+
+// O(n^2) reference, with clusters numbered by lowest point id
+std::vector<int> brute_force_clusters(const std::vector<vec3d> & points, const double thresh)
+{
+    UnionFind uf(points.size());
+    for(uint i=0;   i<points.size(); ++i)
+    for(uint j=i+1; j<points.size(); ++j)
+    {
+        if(points.at(i).dist_squared(points.at(j))<thresh*thresh) uf.merge(i,j);
+    }
+    std::vector<int> labels;
+    uf.labels(labels);
+    return labels;
+}
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// clusters must match brute force also when the point set spans way more
+// than 2^20 thresholds per side, and when it is far from the origin
+CINO_TEST(vertex_clustering_matches_brute_force)
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> rnd(-1,1);
+
+    for(double scale  : {1.0, 1e4, 1e9})
+    for(double thresh : {0.1, 1e-7})
+    for(double offset : {0.0, 1e12})
+    {
+        std::vector<vec3d> points;
+        for(uint i=0; i<800; ++i) points.push_back(vec3d(rnd(rng),rnd(rng),rnd(rng))*scale + vec3d(offset,0,0));
+        // chains of close points (each within the threshold from the previous one)
+        for(uint i=0; i<200; ++i) points.push_back(points.at(i%50) + vec3d(rnd(rng),rnd(rng),rnd(rng))*thresh*0.25);
+
+        std::vector<int> cluster_id;
+        uint n_clusters = vertex_clustering(points, thresh, cluster_id);
+        std::vector<int> ref = brute_force_clusters(points, thresh);
+        CINO_CHECK(cluster_id==ref);
+        CINO_CHECK(n_clusters==*std::max_element(ref.begin(),ref.end())+1u);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// a large point set with a tiny threshold w.r.t. its extent (i.e. way
+// more than 2^20 thresholds per side) must be clustered correctly, and
+// welding must restore the connectivity of a polygon soup
+CINO_TEST(weld_vertices_large_extent_small_thresh)
+{
+    uint n = 300; // n x n quads, spanning 1e6 units
+    double size = 1e6/n;
+    std::vector<vec3d> verts;
+    std::vector<std::vector<uint>> polys;
+    for(uint i=0; i<n; ++i)
+    for(uint j=0; j<n; ++j)
+    {
+        uint base = verts.size();
+        verts.push_back(vec3d( i   *size,  j   *size, 0) + vec3d(1e-9, 0, 0));
+        verts.push_back(vec3d((i+1)*size,  j   *size, 0));
+        verts.push_back(vec3d((i+1)*size, (j+1)*size, 0) + vec3d(0, 1e-9, 0));
+        verts.push_back(vec3d( i   *size, (j+1)*size, 0));
+        polys.push_back({base, base+1, base+2, base+3});
+    }
+
+    std::vector<vec3d>             welded_verts;
+    std::vector<std::vector<uint>> welded_polys;
+    weld_vertices(verts, polys, 1e-7, welded_verts, welded_polys);
+    CINO_CHECK(welded_verts.size()==(n+1)*(n+1));
+    CINO_CHECK(welded_polys.size()==n*n);
+}
@@ -0,0 +1,55 @@
+/* Minimal test harness for the headless regression tests in this folder.
+ * Each test is a function registered with CINO_TEST(name), which uses
+ * CINO_CHECK(cond) to report failures without aborting the run.
+*/
+
+#ifndef CINO_TESTS_H
+#define CINO_TESTS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef DATA_PATH
+#define DATA_PATH "../examples/data/"
+#endif
+
+namespace cinolib_tests
+{
+
+typedef struct
+{
+    std::string name;
+    void      (*run)();
+}
+Test;
+
+inline std::vector<Test> & registry()
+{
+    static std::vector<Test> tests;
+    return tests;
+}
+
+inline unsigned int & num_failed_checks()
+{
+    static unsigned int count = 0;
+    return count;
+}
+
+struct Register
+{
+    Register(const char * name, void (*run)()) { registry().push_back({name, run}); }
+};
+
+}
+
+#define CINO_TEST(name) \
+    static void name(); \
+    static cinolib_tests::Register name##_registration(#name, name); \
+    static void name()
+
+#define CINO_CHECK(cond) \
+    do { if(!(cond)) { ++cinolib_tests::num_failed_checks(); \
+         std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #cond << std::endl; } } while(0)
+
+#endif // CINO_TESTS_H
@@ -0,0 +1,53 @@
+# Headless regression tests. To compile and run them open a terminal
+# in this folder and type:
+#
+#  qmake .
+#  make -j4
+#  ./run_tests [name_filter]
+#
+# The program returns a non zero exit code if any of the checks fails.
+
+TEMPLATE        = app
+TARGET          = $$PWD/run_tests
+CONFIG         += c++11 release console
+CONFIG         -= app_bundle qt
+INCLUDEPATH    += $$PWD/../external/eigen
+INCLUDEPATH    += $$PWD/../include
+DATA_PATH       = \\\"$$PWD/../examples/data/\\\"
+DEFINES        += DATA_PATH=$$DATA_PATH
+HEADERS        += tests.h
+SOURCES        += main.cpp
+SOURCES        += test_ambient_occlusion.cpp
+SOURCES        += test_canonical_polygonal_schema.cpp
+SOURCES        += test_hash_grid.cpp
+SOURCES        += test_integral_curves.cpp
+SOURCES        += test_isocontours.cpp
+SOURCES        += test_laplacian_smoothing.cpp
+SOURCES        += test_mesh_reordering.cpp
+SOURCES        += test_Poisson_sampling.cpp
+SOURCES        += test_mesh_slicer.cpp
+SOURCES        += test_picking.cpp
+SOURCES        += test_polygon_grid.cpp
+SOURCES        += test_polygon_tessellation.cpp
+SOURCES        += test_random_generator.cpp
+SOURCES        += test_profiler.cpp
+SOURCES        += test_slice_mesh.cpp
+SOURCES        += test_subdivision_hexa_scheme.cpp
+SOURCES        += test_tetrahedralization.cpp
+SOURCES        += test_vertex_clustering.cpp
+
+# just for Linux
+unix:!macx {
+LIBS    += -pthread
+}
+
+# OPTIONAL: offscreen rendering tests. They require OpenGL and EGL (e.g. Mesa,
+# which also provides a software rasterizer). Comment these lines to skip them.
+# CINOLIB_GL_STATS enables the GPU upload counters checked by the tests
+DEFINES        += CINOLIB_USES_OPENGL
+DEFINES        += CINOLIB_GL_STATS
+SOURCES        += test_render_data.cpp
+unix:!macx {
+DEFINES += GL_GLEXT_PROTOTYPES
+LIBS    += -lEGL -lGL -lGLU
+}